@@ -0,0 +1,340 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "pch.h"
+
+#include "interfaces.h"
+
+namespace toolkit::input {
+
+    constexpr uint32_t HandCount = 2;
+
+    // The state of an action for one hand. This is the destination of the gestures values.
+    struct SubAction {
+        Hand hand;
+        std::string path;
+
+        // Whether the action set is active for the current sync.
+        bool active{false};
+        bool synced{false};
+
+        float floatValue{0.0f};
+        XrTime timeFloatValueChanged{0};
+        bool floatValueChanged{false};
+
+        bool boolValue{false};
+        XrTime timeBoolValueChanged{0};
+        bool boolValueChanged{false};
+    };
+
+    struct Action {
+        XrActionSet actionSet;
+
+        // The indices of the sub-actions for each hand, UINT32_MAX when the hand is not bound.
+        uint32_t subActions[HandCount]{UINT32_MAX, UINT32_MAX};
+
+        // The sub-action to use when the sub-action path is not bound.
+        uint32_t getDefaultSubAction() const {
+            return subActions[0] != UINT32_MAX ? subActions[0] : subActions[1];
+        }
+    };
+
+    // The sub-actions receiving a gesture (or other source of values) for one hand.
+    struct Route {
+        uint32_t first;
+        uint32_t count;
+    };
+
+    // Delivers the values of the gestures to the actions bound by the application. The bindings are flattened into a
+    // vector of sub-actions, and the sub-actions receiving each source of values are resolved into a table when the
+    // bindings or the sources change, so that no string comparison is needed when recording values.
+    class ActionRouter {
+      public:
+        static constexpr std::string_view SystemClickPath = "/input/system/click";
+
+        // Clear any previous mappings.
+        void clearBindings() {
+            m_actions.clear();
+            m_subActions.clear();
+            m_systemClickAction.reset();
+            m_needUpdateRoutes = true;
+        }
+
+        // Returns false for the paths of other devices than the hands, which are ignored.
+        bool bind(XrAction action, XrActionSet actionSet, const std::string& fullPath) {
+            Hand hand;
+            if (fullPath.find("/user/hand/left") == 0) {
+                hand = Hand::Left;
+            } else if (fullPath.find("/user/hand/right") == 0) {
+                hand = Hand::Right;
+            } else {
+                return false;
+            }
+
+            // Keep track of the /input/system/click path.
+            if (EndsWith(fullPath, SystemClickPath)) {
+                m_systemClickAction = action;
+            }
+
+            auto actionIt = m_actions.find(action);
+            if (actionIt == m_actions.end()) {
+                Action entry;
+                entry.actionSet = actionSet;
+                actionIt = m_actions.insert_or_assign(action, entry).first;
+            }
+
+            SubAction subAction;
+            subAction.hand = hand;
+            subAction.path = fullPath;
+            setSubAction(actionIt->second, subAction);
+            m_needUpdateRoutes = true;
+
+            return true;
+        }
+
+        // Dummy action to keep track of /input/system/click in case the application does not register it (which is
+        // likely in fact). Must be invoked after all the bindings.
+        void bindSystemClick() {
+            if (m_systemClickAction) {
+                return;
+            }
+
+            Action systemClick;
+            systemClick.actionSet = XR_NULL_HANDLE;
+            for (uint32_t side = 0; side < HandCount; side++) {
+                SubAction subAction;
+                subAction.hand = (Hand)side;
+                subAction.path = (side ? "/user/hand/right" : "/user/hand/left") + std::string(SystemClickPath);
+                setSubAction(systemClick, subAction);
+            }
+
+            m_actions.insert_or_assign(XR_NULL_HANDLE, systemClick);
+            m_systemClickAction = XR_NULL_HANDLE;
+            m_needUpdateRoutes = true;
+        }
+
+        // The bound gestures (with their action path for each hand, empty when unbound) are the first sources of
+        // values, followed by the haptics and the keepalive actions.
+        void setSources(std::vector<std::array<std::string, HandCount>> gestureActions,
+                        const std::string& hapticsAction,
+                        const std::string& keepaliveAction) {
+            m_sources = std::move(gestureActions);
+            m_sources.push_back({hapticsAction, hapticsAction});
+            m_sources.push_back({keepaliveAction, keepaliveAction});
+            m_needUpdateRoutes = true;
+        }
+
+        uint32_t getHapticsSource() const {
+            return (uint32_t)m_sources.size() - 2;
+        }
+
+        uint32_t getKeepaliveSource() const {
+            return (uint32_t)m_sources.size() - 1;
+        }
+
+        // Look up the sub-action for a hand, or the sub-action of any hand when the action is not bound for this one.
+        const SubAction* find(XrAction action, std::optional<Hand> hand) const {
+            const auto actionIt = m_actions.find(action);
+            if (actionIt == m_actions.cend()) {
+                return nullptr;
+            }
+
+            uint32_t index = hand ? actionIt->second.subActions[(uint32_t)hand.value()] : UINT32_MAX;
+            if (index == UINT32_MAX) {
+                index = actionIt->second.getDefaultSubAction();
+            }
+
+            return index != UINT32_MAX ? &m_subActions[index] : nullptr;
+        }
+
+        // Must be invoked before recording the values for a sync. Only the actions of the synced action sets receive
+        // values.
+        void beginSync(const XrActionsSyncInfo& syncInfo) {
+            for (const auto& action : m_actions) {
+                bool foundActionSet = false;
+                for (uint32_t i = 0; i < syncInfo.countActiveActionSets; i++) {
+                    if (action.second.actionSet == XR_NULL_HANDLE ||
+                        action.second.actionSet == syncInfo.activeActionSets[i].actionSet) {
+                        // TODO: We ignore the subActionPath at this time. This is largely OK and mean we might be
+                        // non-compliant to some edge cases.
+                        foundActionSet = true;
+                        break;
+                    }
+                }
+
+                for (const uint32_t index : action.second.subActions) {
+                    if (index != UINT32_MAX) {
+                        m_subActions[index].active = foundActionSet;
+                    }
+                }
+            }
+            for (auto& subAction : m_subActions) {
+                subAction.synced = false;
+            }
+
+            if (m_needUpdateRoutes) {
+                updateRoutes();
+                m_needUpdateRoutes = false;
+            }
+        }
+
+        void record(Hand hand, uint32_t source, float value, float clickThreshold, XrTime now) {
+            if (isnan(value)) {
+                return;
+            }
+
+            const Route& route = m_routes[(uint32_t)hand * m_sources.size() + source];
+            for (uint32_t i = route.first; i < route.first + route.count; i++) {
+                SubAction& subAction = m_subActions[m_routeSubActions[i]];
+                if (!subAction.active) {
+                    continue;
+                }
+
+                // If multiple gestures are bound to the same action, pick the highest value.
+                const float newFloatValue = subAction.synced ? std::max(subAction.floatValue, value) : value;
+                const bool newBoolValue = newFloatValue >= clickThreshold;
+
+                if (std::abs(subAction.floatValue - newFloatValue) > FLT_EPSILON) {
+                    subAction.floatValue = newFloatValue;
+                    subAction.timeFloatValueChanged = now;
+                    subAction.floatValueChanged = true;
+                }
+                if (subAction.boolValue != newBoolValue) {
+                    subAction.boolValue = newBoolValue;
+                    subAction.timeBoolValueChanged = now;
+                    subAction.boolValueChanged = true;
+                }
+                subAction.synced = true;
+            }
+        }
+
+        // Whether /input/system/click was pressed on either hand.
+        bool isSystemClickPressed() const {
+            const auto systemClickIt =
+                m_systemClickAction ? m_actions.find(m_systemClickAction.value()) : m_actions.cend();
+            if (systemClickIt == m_actions.cend()) {
+                return false;
+            }
+
+            bool didChange = false;
+            bool value = false;
+            for (const uint32_t index : systemClickIt->second.subActions) {
+                if (index != UINT32_MAX) {
+                    didChange = didChange || m_subActions[index].boolValueChanged;
+                    value = value || m_subActions[index].boolValue;
+                }
+            }
+
+            return didChange && value;
+        }
+
+        // Zero all the actions of a hand. Returns whether any value changed.
+        bool zero(Hand hand, XrTime now) {
+            bool changed = false;
+            for (auto& subAction : m_subActions) {
+                if (subAction.hand != hand) {
+                    continue;
+                }
+
+                // We must only set changed if the value is actually different.
+                subAction.floatValueChanged = std::abs(subAction.floatValue) > FLT_EPSILON;
+                subAction.floatValue = 0.f;
+                if (subAction.floatValueChanged) {
+                    subAction.timeFloatValueChanged = now;
+                    changed = true;
+                }
+
+                subAction.boolValueChanged = subAction.boolValue;
+                subAction.boolValue = false;
+                if (subAction.boolValueChanged) {
+                    subAction.timeBoolValueChanged = now;
+                    changed = true;
+                }
+            }
+
+            return changed;
+        }
+
+        // The number of sub-actions receiving a source of values for one hand.
+        uint32_t getNumRoutedSubActions(Hand hand, uint32_t source) const {
+            return m_routes[(uint32_t)hand * m_sources.size() + source].count;
+        }
+
+      private:
+        static bool EndsWith(const std::string& path, std::string_view suffix) {
+            return path.length() >= suffix.length() &&
+                   path.compare(path.length() - suffix.length(), suffix.length(), suffix) == 0;
+        }
+
+        void setSubAction(Action& action, const SubAction& subAction) {
+            uint32_t& index = action.subActions[(uint32_t)subAction.hand];
+            if (index == UINT32_MAX) {
+                index = (uint32_t)m_subActions.size();
+                m_subActions.push_back(subAction);
+            } else {
+                m_subActions[index] = subAction;
+            }
+        }
+
+        // Resolve the action path of each source for each hand into the list of sub-actions to update.
+        void updateRoutes() {
+            m_routes.clear();
+            m_routeSubActions.clear();
+
+            for (uint32_t side = 0; side < HandCount; side++) {
+                for (const auto& source : m_sources) {
+                    const std::string& actionPath = source[side];
+
+                    Route route{(uint32_t)m_routeSubActions.size(), 0};
+                    if (!actionPath.empty()) {
+                        for (const auto& action : m_actions) {
+                            const uint32_t index = action.second.subActions[side];
+                            if (index != UINT32_MAX && EndsWith(m_subActions[index].path, actionPath)) {
+                                m_routeSubActions.push_back(index);
+                                route.count++;
+                            }
+                        }
+                    }
+                    m_routes.push_back(route);
+                }
+            }
+        }
+
+        std::unordered_map<XrAction, Action> m_actions;
+        std::vector<SubAction> m_subActions;
+        std::optional<XrAction> m_systemClickAction;
+
+        // The action path for each hand, for each source of values. Initially, only the (unset) haptics and
+        // keepalive actions.
+        std::vector<std::array<std::string, HandCount>> m_sources{2};
+
+        // For each hand, then for each source of values (see record()), the range of sub-actions in m_routeSubActions
+        // to update.
+        std::vector<Route> m_routes;
+        std::vector<uint32_t> m_routeSubActions;
+        bool m_needUpdateRoutes{true};
+    };
+
+} // namespace toolkit::input
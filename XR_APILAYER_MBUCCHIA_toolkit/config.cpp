@@ -37,78 +37,124 @@ namespace {
     constexpr unsigned int WriteDelay = 22; // 1s in bad VR.
 
     struct ConfigValue {
+        std::string name;
         int value;
         int defaultValue{0};
 
-        bool changedSinceLastQuery{false};
+        // The value last read from or written to the backend.
+        std::optional<int> persistedValue;
+
         unsigned int writeCountdown{0};
     };
 
-    // A very simple registry/DWORD backed configuration manager.
-    // Handles deferred writes (to only commit values after a few game loops completed).
+    // The legacy storage, one DWORD value per setting. The companion app relies on it.
+    class RegistryConfigBackend : public IConfigBackend {
+      public:
+        RegistryConfigBackend(const std::string& appName)
+            : m_baseKey(xr::utf8_to_wide(RegPrefix + "\\" + appName)) {
+        }
+
+        std::optional<int> read(const std::string& name) const override {
+            return RegGetDword(HKEY_CURRENT_USER, m_baseKey, xr::utf8_to_wide(name));
+        }
+
+        std::optional<int> readGlobal(const std::string& name) const override {
+            return RegGetDword(HKEY_LOCAL_MACHINE, xr::utf8_to_wide(RegPrefix), xr::utf8_to_wide(name));
+        }
+
+        void write(const std::vector<std::pair<std::string, int>>& values) override {
+            for (const auto& value : values) {
+                RegSetDword(HKEY_CURRENT_USER, m_baseKey, xr::utf8_to_wide(value.first), value.second);
+            }
+        }
+
+        void erase(const std::string& name) override {
+            RegDeleteValue(HKEY_CURRENT_USER, m_baseKey, xr::utf8_to_wide(name));
+        }
+
+        void eraseAll() override {
+            RegDeleteKey(HKEY_CURRENT_USER, m_baseKey);
+        }
+
+        bool pollChanges() override {
+            // Only watch the key once polled: the other backends also use this one for its global values.
+            if (!m_isWatching) {
+                m_isWatching = true;
+                try {
+                    m_watcher = wil::make_registry_watcher(
+                        HKEY_CURRENT_USER, m_baseKey.c_str(), true, [&](wil::RegistryChangeKind changeType) {
+                            // This is also invoked for our own writes.
+                            m_hasChanged = true;
+                        });
+                } catch (std::exception&) {
+                    // Ignore errors that can happen with UWP applications not able to write to the registry.
+                }
+            }
+
+            return m_hasChanged.exchange(false);
+        }
+
+      private:
+        const std::wstring m_baseKey;
+        std::atomic<bool> m_hasChanged{false};
+        bool m_isWatching{false};
+        wil::unique_registry_watcher m_watcher;
+    };
+
+    // A very simple configuration manager on top of a storage backend.
+    // Handles deferred writes (to only commit values after a few game loops completed), batched into a single commit.
+    // The setting names are interned: the values are stored in a flat array indexed by SettingHandle, and whether they
+    // changed since they were last queried is kept in a bitset.
     class ConfigManager : public IConfigManager {
       public:
-        ConfigManager(const std::string& appName) : m_appName(appName) {
+        ConfigManager(std::shared_ptr<IConfigBackend> backend) : m_backend(backend) {
             // Check for safe mode.
-            m_safeMode = RegGetDword(HKEY_LOCAL_MACHINE, xr::utf8_to_wide(RegPrefix), L"safe_mode").value_or(0);
-            m_developer = RegGetDword(HKEY_LOCAL_MACHINE, xr::utf8_to_wide(RegPrefix), L"developer").value_or(0);
-
-            std::string baseKey = RegPrefix + "\\" + appName;
-            m_baseKey = xr::utf8_to_wide(baseKey);
-
-            try {
-                m_watcher = wil::make_registry_watcher(
-                    HKEY_CURRENT_USER, m_baseKey.c_str(), true, [&](wil::RegistryChangeKind changeType) {
-                        // TODO: Every call to writeValue() will also cause us to invoke this (unnecessarily).
-                        m_needRefresh = true;
-                    });
-            } catch (std::exception&) {
-                // Ignore errors that can happen with UWP applications not able to write to the registry.
-            }
+            m_safeMode = m_backend->readGlobal("safe_mode").value_or(0);
+            m_developer = m_backend->readGlobal("developer").value_or(0);
         }
 
         ~ConfigManager() override {
             // Log all unwritten values.
-            for (auto& value : m_values) {
-                ConfigValue& entry = value.second;
-
+            for (const auto& entry : m_values) {
                 if (entry.writeCountdown > 0) {
                     Log("Config value '%s' was discarded due to quickly exiting after changing its value\n",
-                        value.first.c_str());
+                        entry.name.c_str());
                 }
             }
         }
 
         void tick() override {
-            const bool m_wasNeedRefresh = m_needRefresh;
+            const bool needRefresh = m_backend->pollChanges();
 
-            for (auto& value : m_values) {
-                const std::string& name = value.first;
-                ConfigValue& entry = value.second;
+            std::vector<std::pair<std::string, int>> pendingWrites;
+            for (uint32_t index = 0; index < m_values.size(); index++) {
+                ConfigValue& entry = m_values[index];
 
-                if (m_wasNeedRefresh && !m_ignoreRefresh.count(name)) {
-                    refreshValue(name, entry);
+                if (needRefresh) {
+                    refreshValue(index);
                 }
 
                 if (entry.writeCountdown > 0) {
                     entry.writeCountdown--;
 
                     if (entry.writeCountdown == 0) {
-                        writeValue(name, entry);
-
-                        // Delete any backup created by the companion tool. This is to avoid bad statefulness.
-                        deleteValue(name + "_bak");
-
-                        // Don't refresh this value, since we just wrote it!
-                        m_ignoreRefresh.insert(name);
+                        TraceLoggingWrite(g_traceProvider,
+                                          "Config_WriteValue",
+                                          TLArg(entry.name.c_str(), "Name"),
+                                          TLArg(entry.value, "Value"));
+                        pendingWrites.emplace_back(entry.name, entry.value);
+                        entry.persistedValue = entry.value;
                     }
                 }
             }
 
-            // Only clear the need for refresh if the whole tick update saw the changes.
-            m_needRefresh = m_wasNeedRefresh != m_needRefresh;
-            if (!m_needRefresh) {
-                m_ignoreRefresh.clear();
+            if (!pendingWrites.empty()) {
+                m_backend->write(pendingWrites);
+
+                // Delete any backup created by the companion tool. This is to avoid bad statefulness.
+                for (const auto& write : pendingWrites) {
+                    m_backend->erase(write.first + "_bak");
+                }
             }
         }
 
@@ -117,77 +163,71 @@ namespace {
         }
 
         void setDefault(const std::string& name, int value) override {
-            auto it = m_values.find(name);
-
-            if (it != m_values.end()) {
+            const auto it = m_handles.find(name);
+            if (it != m_handles.end()) {
                 Log("Config value '%s' is assigned a default after being used\n", name.c_str());
+                m_values[it->second].defaultValue = value;
+                return;
             }
 
-            ConfigValue newEntry;
-            ConfigValue& entry = it != m_values.end() ? it->second : newEntry;
-            entry.defaultValue = value;
-            if (it == m_values.end()) {
-                readValue(name, entry);
-                m_values.insert_or_assign(name, entry);
-            }
+            intern(name, value);
+        }
+
+        SettingHandle getHandle(const std::string& name) const override {
+            const auto it = m_handles.find(name);
+            return {it != m_handles.end() ? it->second : intern(name, 0)};
         }
 
         int getValue(const std::string& name) const override {
-            auto it = m_values.find(name);
-
-            ConfigValue newEntry;
-            ConfigValue& entry = it != m_values.end() ? it->second : newEntry;
-            if (it != m_values.end()) {
-                entry.changedSinceLastQuery = false;
-            } else {
-                readValue(name, entry);
-                m_values.insert_or_assign(name, entry);
-            }
+            return getValue(getHandle(name));
+        }
 
-            return entry.value;
+        int getValue(SettingHandle handle) const override {
+            clearChanged(handle.index);
+            return m_values[handle.index].value;
         }
 
         int peekValue(const std::string& name) const override {
-            auto it = m_values.find(name);
-
-            ConfigValue newEntry;
-            ConfigValue& entry = it != m_values.end() ? it->second : newEntry;
-            if (it == m_values.end()) {
-                readValue(name, entry);
-                m_values.insert_or_assign(name, entry);
-            }
+            return peekValue(getHandle(name));
+        }
 
-            return entry.value;
+        int peekValue(SettingHandle handle) const override {
+            return m_values[handle.index].value;
         }
 
         void setValue(const std::string& name, int value, bool noCommitDelay) override {
-            auto it = m_values.find(name);
+            setValue(getHandle(name), value, noCommitDelay);
+        }
 
-            ConfigValue newEntry;
-            ConfigValue& entry = it != m_values.end() ? it->second : newEntry;
+        void setValue(SettingHandle handle, int value, bool noCommitDelay) override {
+            ConfigValue& entry = m_values[handle.index];
             entry.value = value;
-            entry.changedSinceLastQuery = true;
             entry.writeCountdown = noCommitDelay ? 1 : WriteDelay;
-            if (it == m_values.end()) {
-                m_values.insert_or_assign(name, entry);
-            }
+            markChanged(handle.index);
         }
 
         bool hasChanged(const std::string& name) const override {
-            auto it = m_values.find(name);
-
-            if (it != m_values.end()) {
-                ConfigValue& entry = it->second;
+            const auto it = m_handles.find(name);
+            return it != m_handles.end() && isChanged(it->second);
+        }
 
-                return entry.changedSinceLastQuery;
-            }
+        bool hasChanged(SettingHandle handle) const override {
+            return isChanged(handle.index);
+        }
 
-            return false;
+        uint64_t getChangeGeneration() const override {
+            return m_changeGeneration;
         }
 
         void deleteValue(const std::string& name) override {
-            RegDeleteValue(HKEY_CURRENT_USER, m_baseKey, xr::utf8_to_wide(name));
-            m_values.erase(name);
+            m_backend->erase(name);
+
+            // Handles must remain valid: go back to the global or default value instead of forgetting the setting.
+            const auto it = m_handles.find(name);
+            if (it != m_handles.end()) {
+                m_values[it->second].writeCountdown = 0;
+                readValue(it->second);
+            }
         }
 
         void resetToDefaults() override {
@@ -203,71 +243,94 @@ namespace {
         }
 
         void hardReset() override {
-            RegDeleteKey(HKEY_CURRENT_USER, m_baseKey);
-            for (auto& value : m_values) {
-                ConfigValue& entry = value.second;
+            m_backend->eraseAll();
+            for (uint32_t index = 0; index < m_values.size(); index++) {
+                ConfigValue& entry = m_values[index];
 
                 entry.value = entry.defaultValue;
-                entry.changedSinceLastQuery = true;
+                entry.persistedValue.reset();
                 entry.writeCountdown = 0;
+                markChanged(index);
             }
         }
 
       private:
-        std::optional<int> readRegistry(const std::string& name) const {
-            auto value = RegGetDword(HKEY_CURRENT_USER, m_baseKey, xr::utf8_to_wide(name));
-            if (!value) {
-                // Fallback to HKLM for global options.
-                value = RegGetDword(HKEY_LOCAL_MACHINE, xr::utf8_to_wide(RegPrefix), xr::utf8_to_wide(name));
+        uint32_t intern(const std::string& name, int defaultValue) const {
+            const uint32_t index = (uint32_t)m_values.size();
+            ConfigValue& entry = m_values.emplace_back();
+            entry.name = name;
+            entry.defaultValue = defaultValue;
+            m_handles.insert_or_assign(name, index);
+            if (m_changed.size() * 64 <= index) {
+                m_changed.push_back(0);
             }
-            return value;
+
+            readValue(index);
+
+            return index;
+        }
+
+        void markChanged(uint32_t index) const {
+            m_changed[index / 64] |= 1ull << (index % 64);
+            m_changeGeneration++;
+        }
+
+        void clearChanged(uint32_t index) const {
+            m_changed[index / 64] &= ~(1ull << (index % 64));
+        }
+
+        bool isChanged(uint32_t index) const {
+            return m_changed[index / 64] & (1ull << (index % 64));
         }
 
-        void readValue(const std::string& name, ConfigValue& entry) const {
+        void readValue(uint32_t index) const {
+            ConfigValue& entry = m_values[index];
+            markChanged(index);
+
             if (m_safeMode) {
                 entry.value = entry.defaultValue;
-                entry.changedSinceLastQuery = true;
                 return;
             }
 
-            const auto value = readRegistry(name);
-            entry.value = value.value_or(entry.defaultValue);
-            entry.changedSinceLastQuery = true;
+            entry.persistedValue = readPersistedValue(entry.name);
+            entry.value = entry.persistedValue.value_or(entry.defaultValue);
 
             TraceLoggingWrite(
-                g_traceProvider, "Config_ReadValue", TLArg(name.c_str(), "Name"), TLArg(entry.value, "Value"));
+                g_traceProvider, "Config_ReadValue", TLArg(entry.name.c_str(), "Name"), TLArg(entry.value, "Value"));
+        }
+
+        std::optional<int> readPersistedValue(const std::string& name) const {
+            const auto value = m_backend->read(name);
+            return value ? value : m_backend->readGlobal(name);
         }
 
-        void refreshValue(const std::string& name, ConfigValue& entry) const {
+        void refreshValue(uint32_t index) const {
             if (m_safeMode) {
                 return;
             }
 
-            const auto value = readRegistry(name);
-            if (value && entry.value != value.value_or(entry.defaultValue)) {
-                entry.value = value.value_or(entry.defaultValue);
-                entry.changedSinceLastQuery = true;
+            // Only external modifications are of interest: the backend also notifies us of our own writes.
+            ConfigValue& entry = m_values[index];
+            const auto value = readPersistedValue(entry.name);
+            if (value && value != entry.persistedValue) {
+                entry.value = value.value();
+                entry.persistedValue = value;
+                markChanged(index);
 
                 // Cancel pending writes.
                 entry.writeCountdown = 0;
             }
         }
 
-        void writeValue(const std::string& name, ConfigValue& entry) const {
-            TraceLoggingWrite(
-                g_traceProvider, "Config_WriteValue", TLArg(name.c_str(), "Name"), TLArg(entry.value, "Value"));
-            RegSetDword(HKEY_CURRENT_USER, m_baseKey, xr::utf8_to_wide(name), entry.value);
-        }
-
-        const std::string m_appName;
-        std::wstring m_baseKey;
+        const std::shared_ptr<IConfigBackend> m_backend;
         bool m_safeMode;
         bool m_developer;
-        wil::unique_registry_watcher m_watcher;
-        bool m_needRefresh{false};
-        std::set<std::string> m_ignoreRefresh;
 
-        mutable std::map<std::string, ConfigValue> m_values;
+        // Indexed by SettingHandle.
+        mutable std::vector<ConfigValue> m_values;
+        mutable std::unordered_map<std::string, uint32_t> m_handles;
+        mutable std::vector<uint64_t> m_changed;
+        mutable uint64_t m_changeGeneration{0};
     };
 
 } // namespace
@@ -275,7 +338,27 @@ namespace {
 namespace toolkit::config {
 
     std::shared_ptr<IConfigManager> CreateConfigManager(const std::string& appName) {
-        return std::make_shared<ConfigManager>(appName);
+        // The file storage is opt-in, since the companion app only knows about the registry.
+        const bool useConfigFile =
+            RegGetDword(HKEY_LOCAL_MACHINE, xr::utf8_to_wide(RegPrefix), L"use_config_file").value_or(0);
+        if (useConfigFile) {
+            std::string fileName = appName;
+            std::replace_if(
+                fileName.begin(), fileName.end(), [](char c) { return strchr("<>:\"/\\|?*", c) != nullptr; }, '_');
+            // The companion app only writes the global options to the registry.
+            return CreateConfigManager(CreateFileConfigBackend(localAppData / "settings" / (fileName + ".cfg"),
+                                                               CreateRegistryConfigBackend(appName)));
+        }
+
+        return CreateConfigManager(CreateRegistryConfigBackend(appName));
+    }
+
+    std::shared_ptr<IConfigManager> CreateConfigManager(std::shared_ptr<IConfigBackend> backend) {
+        return std::make_shared<ConfigManager>(backend);
+    }
+
+    std::shared_ptr<IConfigBackend> CreateRegistryConfigBackend(const std::string& appName) {
+        return std::make_shared<RegistryConfigBackend>(appName);
     }
 
 } // namespace toolkit::config
@@ -0,0 +1,198 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+#include "log.h"
+
+namespace {
+
+    using namespace toolkit;
+    using namespace toolkit::config;
+    using namespace toolkit::log;
+
+    // Do not stat the file on every frame.
+    constexpr auto PollInterval = std::chrono::milliseconds(500);
+
+    // A plain text file storage, with one "name=value" line per setting. The whole file is loaded at once and every
+    // commit rewrites it atomically.
+    class FileConfigBackend : public IConfigBackend {
+      public:
+        FileConfigBackend(const std::filesystem::path& path, std::shared_ptr<const IConfigBackend> globalBackend)
+            : m_path(path), m_globalBackend(globalBackend) {
+            load();
+            m_lastPoll = std::chrono::steady_clock::now();
+        }
+
+        std::optional<int> read(const std::string& name) const override {
+            const auto it = m_values.find(name);
+            if (it == m_values.cend()) {
+                return {};
+            }
+            return it->second;
+        }
+
+        std::optional<int> readGlobal(const std::string& name) const override {
+            return m_globalBackend ? m_globalBackend->readGlobal(name) : std::nullopt;
+        }
+
+        void write(const std::vector<std::pair<std::string, int>>& values) override {
+            for (const auto& value : values) {
+                m_values[value.first] = value.second;
+            }
+            save();
+        }
+
+        void erase(const std::string& name) override {
+            if (m_values.erase(name)) {
+                save();
+            }
+        }
+
+        void eraseAll() override {
+            m_values.clear();
+            save();
+        }
+
+        bool pollChanges() override {
+            const auto now = std::chrono::steady_clock::now();
+            if (now - m_lastPoll < PollInterval) {
+                return false;
+            }
+            m_lastPoll = now;
+
+            // Our own commits are already accounted for in save().
+            if (getFileStamp() == m_fileStamp) {
+                return false;
+            }
+
+            load();
+            return true;
+        }
+
+      private:
+        using FileStamp = std::pair<std::filesystem::file_time_type, uintmax_t>;
+
+        FileStamp getFileStamp() const {
+            std::error_code ec;
+            const auto lastWriteTime = std::filesystem::last_write_time(m_path, ec);
+            if (ec) {
+                return {};
+            }
+            const auto size = std::filesystem::file_size(m_path, ec);
+            return {lastWriteTime, ec ? 0 : size};
+        }
+
+        void load() {
+            m_fileStamp = getFileStamp();
+            m_values.clear();
+
+            std::ifstream file(m_path, std::ios_base::binary);
+            if (!file.is_open()) {
+                return;
+            }
+
+            const std::string content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+            std::istringstream lines(content);
+            std::string line;
+            while (std::getline(lines, line)) {
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+
+                const auto offset = line.find('=');
+                if (line.empty() || offset == std::string::npos || offset == 0) {
+                    continue;
+                }
+
+                try {
+                    size_t end;
+                    const int value = std::stoi(line.substr(offset + 1), &end);
+                    if (offset + 1 + end == line.size()) {
+                        m_values[line.substr(0, offset)] = value;
+                        continue;
+                    }
+                } catch (std::exception&) {
+                }
+                Log("Ignoring malformed setting '%s' in %s\n", line.c_str(), m_path.string().c_str());
+            }
+        }
+
+        void save() {
+            auto temporaryPath = m_path;
+            temporaryPath += ".tmp";
+
+            std::error_code ec;
+            std::filesystem::create_directories(m_path.parent_path(), ec);
+            {
+                std::ofstream file(temporaryPath, std::ios_base::binary | std::ios_base::trunc);
+                if (!file.is_open()) {
+                    Log("Failed to create settings file %s\n", temporaryPath.string().c_str());
+                    return;
+                }
+
+                for (const auto& value : m_values) {
+                    file << value.first << '=' << value.second << '\n';
+                }
+
+                if (!file.flush()) {
+                    file.close();
+                    std::filesystem::remove(temporaryPath, ec);
+                    Log("Failed to write settings file %s\n", temporaryPath.string().c_str());
+                    return;
+                }
+            }
+
+            std::filesystem::rename(temporaryPath, m_path, ec);
+            if (ec) {
+                std::filesystem::remove(temporaryPath, ec);
+                Log("Failed to replace settings file %s\n", m_path.string().c_str());
+                return;
+            }
+
+            m_fileStamp = getFileStamp();
+        }
+
+        const std::filesystem::path m_path;
+
+        // The global values are not per-application, they are kept in the other backend.
+        const std::shared_ptr<const IConfigBackend> m_globalBackend;
+
+        // Sorted so that the file remains easy to read and diff.
+        std::map<std::string, int> m_values;
+
+        FileStamp m_fileStamp;
+        std::chrono::steady_clock::time_point m_lastPoll;
+    };
+
+} // namespace
+
+namespace toolkit::config {
+
+    std::shared_ptr<IConfigBackend> CreateFileConfigBackend(const std::filesystem::path& path,
+                                                            std::shared_ptr<const IConfigBackend> globalBackend) {
+        return std::make_shared<FileConfigBackend>(path, globalBackend);
+    }
+
+} // namespace toolkit::config
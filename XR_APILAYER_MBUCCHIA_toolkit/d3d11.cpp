@@ -24,6 +24,7 @@
 #include "pch.h"
 
 #include "d3dcommon.h"
+#include "d3d11state.h"
 #include "shader_utilities.h"
 #include "factories.h"
 #include "interfaces.h"
@@ -37,6 +38,7 @@ namespace {
     using namespace toolkit;
     using namespace toolkit::graphics;
     using namespace toolkit::graphics::d3dcommon;
+    using namespace toolkit::graphics::d3d11;
     using namespace toolkit::log;
 
     const std::wstring_view FontFamily = L"Segoe UI Symbol";
@@ -63,244 +65,6 @@ void main(uint3 id : SV_DispatchThreadID)
             resource->SetPrivateData(WKPDID_D3DDebugObjectName, static_cast<UINT>(name.size()), name.data());
     }
 
-    struct D3D11ContextState {
-        ComPtr<ID3D11InputLayout> inputLayout;
-        D3D11_PRIMITIVE_TOPOLOGY topology;
-        ComPtr<ID3D11Buffer> vertexBuffers[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
-        UINT vertexBufferStrides[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
-        UINT vertexBufferOffsets[D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
-
-        ComPtr<ID3D11Buffer> indexBuffer;
-        DXGI_FORMAT indexBufferFormat;
-        UINT indexBufferOffset;
-
-        ComPtr<ID3D11RenderTargetView> renderTargets[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT];
-        ComPtr<ID3D11DepthStencilView> depthStencil;
-        ComPtr<ID3D11DepthStencilState> depthStencilState;
-        UINT stencilRef;
-        ComPtr<ID3D11BlendState> blendState;
-        float blendFactor[4];
-        UINT blendMask;
-
-#define SHADER_STAGE_STATE(stage, programType)                                                                         \
-    ComPtr<programType> stage##Program;                                                                                \
-    ComPtr<ID3D11Buffer> stage##ConstantBuffers[D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT];                    \
-    ComPtr<ID3D11SamplerState> stage##Samplers[D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT];                                 \
-    ComPtr<ID3D11ShaderResourceView> stage##ShaderResources[D3D11_COMMONSHADER_INPUT_RESOURCE_SLOT_COUNT];
-
-        SHADER_STAGE_STATE(VS, ID3D11VertexShader);
-        SHADER_STAGE_STATE(PS, ID3D11PixelShader);
-        SHADER_STAGE_STATE(GS, ID3D11GeometryShader);
-        SHADER_STAGE_STATE(DS, ID3D11DomainShader);
-        SHADER_STAGE_STATE(HS, ID3D11HullShader);
-        SHADER_STAGE_STATE(CS, ID3D11ComputeShader);
-
-#undef SHADER_STAGE_STATE
-
-        ComPtr<ID3D11UnorderedAccessView> CSUnorderedResources[D3D11_1_UAV_SLOT_COUNT];
-
-        ComPtr<ID3D11RasterizerState> rasterizerState;
-        D3D11_VIEWPORT viewports[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
-        UINT numViewports;
-        D3D11_RECT scissorRects[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE];
-        UINT numScissorRects;
-
-        void save(ID3D11DeviceContext* context) {
-            TraceLocalActivity(local);
-            TraceLoggingWriteStart(local, "D3D11ContextState_Save");
-
-            context->IAGetInputLayout(set(inputLayout));
-            context->IAGetPrimitiveTopology(&topology);
-            {
-                ID3D11Buffer* vbs[ARRAYSIZE(vertexBuffers)];
-                context->IAGetVertexBuffers(0, ARRAYSIZE(vbs), vbs, vertexBufferStrides, vertexBufferOffsets);
-                for (uint32_t i = 0; i < ARRAYSIZE(vbs); i++) {
-                    attach(vertexBuffers[i], vbs[i]);
-                }
-            }
-            context->IAGetIndexBuffer(set(indexBuffer), &indexBufferFormat, &indexBufferOffset);
-
-            {
-                ID3D11RenderTargetView* rtvs[ARRAYSIZE(renderTargets)];
-                context->OMGetRenderTargets(ARRAYSIZE(rtvs), rtvs, set(depthStencil));
-                for (uint32_t i = 0; i < ARRAYSIZE(rtvs); i++) {
-                    attach(renderTargets[i], rtvs[i]);
-                }
-            }
-
-            context->OMGetDepthStencilState(set(depthStencilState), &stencilRef);
-            context->OMGetBlendState(set(blendState), blendFactor, &blendMask);
-
-#define SHADER_STAGE_SAVE_CONTEXT(stage)                                                                               \
-    context->stage##GetShader(set(stage##Program), nullptr, nullptr);                                                  \
-    {                                                                                                                  \
-        ID3D11Buffer* buffers[ARRAYSIZE(stage##ConstantBuffers)];                                                      \
-        context->stage##GetConstantBuffers(0, ARRAYSIZE(buffers), buffers);                                            \
-        for (uint32_t i = 0; i < ARRAYSIZE(buffers); i++) {                                                            \
-            attach(stage##ConstantBuffers[i], buffers[i]);                                                             \
-        }                                                                                                              \
-    }                                                                                                                  \
-    {                                                                                                                  \
-        ID3D11SamplerState* samp[ARRAYSIZE(stage##Samplers)];                                                          \
-        context->stage##GetSamplers(0, ARRAYSIZE(samp), samp);                                                         \
-        for (uint32_t i = 0; i < ARRAYSIZE(samp); i++) {                                                               \
-            attach(stage##Samplers[i], samp[i]);                                                                       \
-        }                                                                                                              \
-    }                                                                                                                  \
-    {                                                                                                                  \
-        ID3D11ShaderResourceView* srvs[ARRAYSIZE(stage##ShaderResources)];                                             \
-        context->stage##GetShaderResources(0, ARRAYSIZE(srvs), srvs);                                                  \
-        for (uint32_t i = 0; i < ARRAYSIZE(srvs); i++) {                                                               \
-            attach(stage##ShaderResources[i], srvs[i]);                                                                \
-        }                                                                                                              \
-    }
-
-            SHADER_STAGE_SAVE_CONTEXT(VS);
-            SHADER_STAGE_SAVE_CONTEXT(PS);
-            SHADER_STAGE_SAVE_CONTEXT(GS);
-            SHADER_STAGE_SAVE_CONTEXT(DS);
-            SHADER_STAGE_SAVE_CONTEXT(HS);
-            SHADER_STAGE_SAVE_CONTEXT(CS);
-
-#undef SHADER_STAGE_SAVE_CONTEXT
-
-            {
-                ID3D11UnorderedAccessView* uavs[ARRAYSIZE(CSUnorderedResources)];
-                context->CSGetUnorderedAccessViews(0, ARRAYSIZE(uavs), uavs);
-                for (uint32_t i = 0; i < ARRAYSIZE(uavs); i++) {
-                    attach(CSUnorderedResources[i], uavs[i]);
-                }
-            }
-
-            context->RSGetState(set(rasterizerState));
-            numViewports = ARRAYSIZE(viewports);
-            context->RSGetViewports(&numViewports, viewports);
-            numScissorRects = ARRAYSIZE(scissorRects);
-            context->RSGetScissorRects(&numScissorRects, scissorRects);
-
-            m_isValid = true;
-
-            TraceLoggingWriteStop(local, "D3D11ContextState_Save");
-        }
-
-        void restore(ID3D11DeviceContext* context) const {
-            TraceLocalActivity(local);
-            TraceLoggingWriteStart(local, "D3D11ContextState_Restore");
-
-            context->IASetInputLayout(get(inputLayout));
-            context->IASetPrimitiveTopology(topology);
-            {
-                ID3D11Buffer* vbs[ARRAYSIZE(vertexBuffers)];
-                for (uint32_t i = 0; i < ARRAYSIZE(vbs); i++) {
-                    vbs[i] = get(vertexBuffers[i]);
-                }
-                context->IASetVertexBuffers(0, ARRAYSIZE(vbs), vbs, vertexBufferStrides, vertexBufferOffsets);
-            }
-            context->IASetIndexBuffer(get(indexBuffer), indexBufferFormat, indexBufferOffset);
-
-            {
-                ID3D11RenderTargetView* rtvs[ARRAYSIZE(renderTargets)];
-                for (uint32_t i = 0; i < ARRAYSIZE(rtvs); i++) {
-                    rtvs[i] = get(renderTargets[i]);
-                }
-                context->OMSetRenderTargets(ARRAYSIZE(rtvs), rtvs, get(depthStencil));
-            }
-            context->OMSetDepthStencilState(get(depthStencilState), stencilRef);
-            context->OMSetBlendState(get(blendState), blendFactor, blendMask);
-
-#define SHADER_STAGE_RESTORE_CONTEXT(stage)                                                                            \
-    context->stage##SetShader(get(stage##Program), nullptr, 0);                                                        \
-    {                                                                                                                  \
-        ID3D11Buffer* buffers[ARRAYSIZE(stage##ConstantBuffers)];                                                      \
-        for (uint32_t i = 0; i < ARRAYSIZE(buffers); i++) {                                                            \
-            buffers[i] = get(stage##ConstantBuffers[i]);                                                               \
-        }                                                                                                              \
-        context->stage##SetConstantBuffers(0, ARRAYSIZE(buffers), buffers);                                            \
-    }                                                                                                                  \
-    {                                                                                                                  \
-        ID3D11SamplerState* samp[ARRAYSIZE(stage##Samplers)];                                                          \
-        for (uint32_t i = 0; i < ARRAYSIZE(samp); i++) {                                                               \
-            samp[i] = get(stage##Samplers[i]);                                                                         \
-        }                                                                                                              \
-        context->stage##SetSamplers(0, ARRAYSIZE(samp), samp);                                                         \
-    }                                                                                                                  \
-    {                                                                                                                  \
-        ID3D11ShaderResourceView* srvs[ARRAYSIZE(stage##ShaderResources)];                                             \
-        for (uint32_t i = 0; i < ARRAYSIZE(srvs); i++) {                                                               \
-            srvs[i] = get(stage##ShaderResources[i]);                                                                  \
-        }                                                                                                              \
-        context->stage##SetShaderResources(0, ARRAYSIZE(srvs), srvs);                                                  \
-    }
-
-            SHADER_STAGE_RESTORE_CONTEXT(VS);
-            SHADER_STAGE_RESTORE_CONTEXT(PS);
-            SHADER_STAGE_RESTORE_CONTEXT(GS);
-            SHADER_STAGE_RESTORE_CONTEXT(DS);
-            SHADER_STAGE_RESTORE_CONTEXT(HS);
-            SHADER_STAGE_RESTORE_CONTEXT(CS);
-
-#undef SHADER_STAGE_RESTORE_CONTEXT
-
-            {
-                ID3D11UnorderedAccessView* uavs[ARRAYSIZE(CSUnorderedResources)];
-                for (uint32_t i = 0; i < ARRAYSIZE(uavs); i++) {
-                    uavs[i] = get(CSUnorderedResources[i]);
-                }
-                context->CSGetUnorderedAccessViews(0, ARRAYSIZE(uavs), uavs);
-            }
-
-            context->RSSetState(get(rasterizerState));
-            context->RSSetViewports(numViewports, viewports);
-            context->RSSetScissorRects(numScissorRects, scissorRects);
-
-            TraceLoggingWriteStop(local, "D3D11ContextState_Restore");
-        }
-
-        void clear() {
-#define RESET_ARRAY(array)                                                                                             \
-    for (uint32_t i = 0; i < ARRAYSIZE(array); i++) {                                                                  \
-        array[i].Reset();                                                                                              \
-    }
-
-            inputLayout.Reset();
-            RESET_ARRAY(vertexBuffers);
-            indexBuffer.Reset();
-
-            RESET_ARRAY(renderTargets);
-            depthStencil.Reset();
-            depthStencilState.Reset();
-            blendState.Reset();
-
-#define SHADER_STAGE_STATE(stage)                                                                                      \
-    stage##Program.Reset();                                                                                            \
-    RESET_ARRAY(stage##ConstantBuffers);                                                                               \
-    RESET_ARRAY(stage##Samplers);                                                                                      \
-    RESET_ARRAY(stage##ShaderResources);
-
-            SHADER_STAGE_STATE(VS);
-            SHADER_STAGE_STATE(PS);
-            SHADER_STAGE_STATE(GS);
-            SHADER_STAGE_STATE(DS);
-            SHADER_STAGE_STATE(HS);
-            SHADER_STAGE_STATE(CS);
-
-            RESET_ARRAY(CSUnorderedResources);
-
-            rasterizerState.Reset();
-
-#undef RESET_ARRAY
-
-            m_isValid = false;
-        }
-
-        bool isValid() const {
-            return m_isValid;
-        }
-
-      private:
-        bool m_isValid{false};
-    };
-
     // Wrap a pixel shader resource. Obtained from D3D11Device.
     class D3D11QuadShader : public IQuadShader {
       public:
@@ -470,6 +234,29 @@ void main(uint3 id : SV_DispatchThreadID)
             m_depthStencilSubView.resize(info.arraySize);
         }
 
+        // Re-wrap another texture (see EventWrapperPool).
+        void reset(const XrSwapchainCreateInfo& info,
+                   const D3D11_TEXTURE2D_DESC& textureDesc,
+                   ID3D11Texture2D* texture) {
+            m_info = info;
+            m_textureDesc = textureDesc;
+            m_texture = texture;
+            m_shaderResourceView.reset();
+            m_unorderedAccessView.reset();
+            m_renderTargetView.reset();
+            m_depthStencilView.reset();
+            for (auto* subViews : {&m_shaderResourceSubView,
+                                   &m_unorderedAccessSubView,
+                                   &m_renderTargetSubView,
+                                   &m_depthStencilSubView}) {
+                subViews->assign(info.arraySize, nullptr);
+            }
+        }
+
+        void detach() {
+            m_texture = nullptr;
+        }
+
         Api getApi() const override {
             return Api::D3D11;
         }
@@ -676,9 +463,9 @@ void main(uint3 id : SV_DispatchThreadID)
         }
 
         const std::shared_ptr<IDevice> m_device;
-        const XrSwapchainCreateInfo m_info;
-        const D3D11_TEXTURE2D_DESC m_textureDesc;
-        const ComPtr<ID3D11Texture2D> m_texture;
+        XrSwapchainCreateInfo m_info;
+        D3D11_TEXTURE2D_DESC m_textureDesc;
+        ComPtr<ID3D11Texture2D> m_texture;
 
         mutable std::shared_ptr<D3D11ShaderResourceView> m_shaderResourceView;
         mutable std::vector<std::shared_ptr<D3D11ShaderResourceView>> m_shaderResourceSubView;
@@ -836,6 +623,67 @@ void main(uint3 id : SV_DispatchThreadID)
         mutable bool m_valid{false};
     };
 
+    // A staging texture, with an event query to know when the copy has completed.
+    class D3D11ReadbackTexture : public IReadbackTexture {
+      public:
+        D3D11ReadbackTexture(std::shared_ptr<IDevice> device,
+                             const XrSwapchainCreateInfo& info,
+                             ID3D11Texture2D* texture,
+                             ID3D11Query* query)
+            : m_device(device), m_info(info), m_texture(texture), m_query(query) {
+        }
+
+        Api getApi() const override {
+            return Api::D3D11;
+        }
+
+        std::shared_ptr<IDevice> getDevice() const override {
+            return m_device;
+        }
+
+        const XrSwapchainCreateInfo& getInfo() const override {
+            return m_info;
+        }
+
+        void copyFrom(std::shared_ptr<ITexture> source, int32_t srcSlice, uint32_t srcX, uint32_t srcY) override {
+            D3D11_BOX box;
+            box.left = srcX;
+            box.top = srcY;
+            box.right = box.left + m_info.width;
+            box.bottom = box.top + m_info.height;
+            box.front = 0;
+            box.back = 1;
+
+            auto context = m_device->getContextAs<D3D11>();
+            context->CopySubresourceRegion(get(m_texture), 0, 0, 0, 0, source->getAs<D3D11>(), srcSlice, &box);
+            context->End(get(m_query));
+        }
+
+        bool isReady() override {
+            // This is polled every frame: do not force a flush of the command buffer, the copy is submitted with the
+            // rest of the frame.
+            return m_device->getContextAs<D3D11>()->GetData(
+                       get(m_query), nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK;
+        }
+
+        void readback(std::vector<uint8_t>& data, uint32_t& rowPitch) override {
+            auto context = m_device->getContextAs<D3D11>();
+
+            D3D11_MAPPED_SUBRESOURCE mapped;
+            CHECK_HRCMD(context->Map(get(m_texture), 0, D3D11_MAP_READ, 0, &mapped));
+            rowPitch = mapped.RowPitch;
+            const uint8_t* const mappedData = static_cast<const uint8_t*>(mapped.pData);
+            data.assign(mappedData, mappedData + (size_t)rowPitch * m_info.height);
+            context->Unmap(get(m_texture), 0);
+        }
+
+      private:
+        const std::shared_ptr<IDevice> m_device;
+        const XrSwapchainCreateInfo m_info;
+        const ComPtr<ID3D11Texture2D> m_texture;
+        const ComPtr<ID3D11Query> m_query;
+    };
+
     // Wrap a device context.
     class D3D11Context : public graphics::IContext {
       public:
@@ -843,6 +691,15 @@ void main(uint3 id : SV_DispatchThreadID)
             : m_device(device), m_context(context) {
         }
 
+        // Re-wrap another context (see EventWrapperPool).
+        void reset(ID3D11DeviceContext* context) {
+            m_context = context;
+        }
+
+        void detach() {
+            m_context = nullptr;
+        }
+
         Api getApi() const override {
             return Api::D3D11;
         }
@@ -857,7 +714,7 @@ void main(uint3 id : SV_DispatchThreadID)
 
       private:
         const std::shared_ptr<IDevice> m_device;
-        const ComPtr<ID3D11DeviceContext> m_context;
+        ComPtr<ID3D11DeviceContext> m_context;
     };
 
     class D3D11Device : public IDevice, public std::enable_shared_from_this<D3D11Device> {
@@ -871,6 +728,27 @@ void main(uint3 id : SV_DispatchThreadID)
                                  !configManager->getValue(config::SettingDisableInterceptor)),
               m_lateInitCountdown(enableOculusQuirk ? 10 : 0) {
             m_device->GetImmediateContext(set(m_context));
+            {
+                // Prefer swapping the entire pipeline state over saving/restoring each slot (see D3D11ContextSaver).
+                ComPtr<ID3D11Device1> device1;
+                if (SUCCEEDED(m_device->QueryInterface(set(device1))) &&
+                    SUCCEEDED(m_context->QueryInterface(set(m_context1)))) {
+                    const D3D_FEATURE_LEVEL featureLevel = m_device->GetFeatureLevel();
+                    const UINT flags = (m_device->GetCreationFlags() & D3D11_CREATE_DEVICE_SINGLETHREADED)
+                                           ? D3D11_1_CREATE_DEVICE_CONTEXT_STATE_SINGLETHREADED
+                                           : 0;
+                    if (FAILED(device1->CreateDeviceContextState(flags,
+                                                                 &featureLevel,
+                                                                 1,
+                                                                 D3D11_SDK_VERSION,
+                                                                 __uuidof(ID3D11Device1),
+                                                                 nullptr,
+                                                                 set(m_toolkitContextState)))) {
+                        m_toolkitContextState = nullptr;
+                    }
+                }
+                m_contextSaver.initialize(get(m_context), get(m_context1), get(m_toolkitContextState));
+            }
             {
                 ComPtr<IDXGIDevice> dxgiDevice;
                 DXGI_ADAPTER_DESC desc;
@@ -924,6 +802,9 @@ void main(uint3 id : SV_DispatchThreadID)
 
             m_meshModelBuffer.reset();
             m_meshViewProjectionBuffer.reset();
+
+            m_contextWrappers.clear();
+            m_textureWrappers.clear();
         }
 
         Api getApi() const override {
@@ -969,26 +850,16 @@ void main(uint3 id : SV_DispatchThreadID)
         }
 
         void saveContext(bool clear) override {
-            // Ensure we are not dropping an unfinished context.
-            assert(!m_state.isValid());
-
-            m_state.save(get(m_context));
-            if (clear) {
-                m_context->ClearState();
-            }
+            m_contextSaver.save(clear);
         }
 
         void restoreContext() override {
-            // Ensure saveContext() was called.
-            assert(m_state.isValid());
-
-            m_state.restore(get(m_context));
-            m_state.clear();
+            m_contextSaver.restore();
         }
 
         void flushContext(bool blocking, bool isEndOfFrame = false) override {
             // Ensure we are not dropping an unfinished context.
-            assert(!m_state.isValid());
+            assert(!m_contextSaver.isSaved());
 
             if (!blocking) {
                 m_context->Flush();
@@ -1063,6 +934,32 @@ void main(uint3 id : SV_DispatchThreadID)
             return std::make_shared<D3D11Texture>(shared_from_this(), info, desc, get(texture));
         }
 
+        std::shared_ptr<IReadbackTexture> createReadbackTexture(const XrSwapchainCreateInfo& info,
+                                                                std::string_view debugName) override {
+            D3D11_TEXTURE2D_DESC desc;
+            ZeroMemory(&desc, sizeof(desc));
+            desc.Format = (DXGI_FORMAT)info.format;
+            desc.Width = info.width;
+            desc.Height = info.height;
+            desc.ArraySize = 1;
+            desc.MipLevels = 1;
+            desc.SampleDesc.Count = 1;
+            desc.Usage = D3D11_USAGE_STAGING;
+            desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+            ComPtr<ID3D11Texture2D> texture;
+            CHECK_HRCMD(m_device->CreateTexture2D(&desc, nullptr, set(texture)));
+            SetDebugName(get(texture), debugName);
+
+            D3D11_QUERY_DESC queryDesc;
+            ZeroMemory(&queryDesc, sizeof(queryDesc));
+            queryDesc.Query = D3D11_QUERY_EVENT;
+            ComPtr<ID3D11Query> query;
+            CHECK_HRCMD(m_device->CreateQuery(&queryDesc, set(query)));
+
+            return std::make_shared<D3D11ReadbackTexture>(shared_from_this(), info, get(texture), get(query));
+        }
+
         std::shared_ptr<IShaderBuffer>
         createBuffer(size_t size, std::string_view debugName, const void* initialData, bool immutable) override {
             auto desc = CD3D11_BUFFER_DESC(static_cast<UINT>(size),
@@ -1843,7 +1740,9 @@ void main(uint3 id : SV_DispatchThreadID)
                 return;
             }
 
-            auto wrappedContext = std::make_shared<D3D11Context>(shared_from_this(), context);
+            EventWrapperPool<D3D11Context>::Lease contextLease(m_contextWrappers);
+            EventWrapperPool<D3D11Texture>::Lease renderTargetLease(m_textureWrappers);
+            const auto wrappedContext = wrapContext(contextLease, context);
 
             if (!numViews || !renderTargetViews || !renderTargetViews[0]) {
                 INVOKE_EVENT(unsetRenderTargetEvent, wrappedContext);
@@ -1874,8 +1773,7 @@ void main(uint3 id : SV_DispatchThreadID)
             D3D11_TEXTURE2D_DESC textureDesc;
             texture->GetDesc(&textureDesc);
 
-            auto renderTarget = std::make_shared<D3D11Texture>(
-                shared_from_this(), getTextureInfo(textureDesc), textureDesc, get(texture));
+            const auto renderTarget = wrapTexture(renderTargetLease, textureDesc, get(texture));
             INVOKE_EVENT(setRenderTargetEvent, wrappedContext, renderTarget);
         }
 
@@ -1904,27 +1802,48 @@ void main(uint3 id : SV_DispatchThreadID)
                 return;
             }
 
-            auto wrappedContext = std::make_shared<D3D11Context>(shared_from_this(), context);
+            EventWrapperPool<D3D11Context>::Lease contextLease(m_contextWrappers);
+            EventWrapperPool<D3D11Texture>::Lease sourceLease(m_textureWrappers);
+            EventWrapperPool<D3D11Texture>::Lease destinationLease(m_textureWrappers);
+            const auto wrappedContext = wrapContext(contextLease, context);
 
             D3D11_TEXTURE2D_DESC sourceTextureDesc;
             sourceTexture->GetDesc(&sourceTextureDesc);
-
-            auto source = std::make_shared<D3D11Texture>(
-                shared_from_this(), getTextureInfo(sourceTextureDesc), sourceTextureDesc, get(sourceTexture));
+            const auto source = wrapTexture(sourceLease, sourceTextureDesc, get(sourceTexture));
 
             D3D11_TEXTURE2D_DESC destinationTextureDesc;
             destinationTexture->GetDesc(&destinationTextureDesc);
-
-            auto destination = std::make_shared<D3D11Texture>(shared_from_this(),
-                                                              getTextureInfo(destinationTextureDesc),
-                                                              destinationTextureDesc,
-                                                              get(destinationTexture));
+            const auto destination = wrapTexture(destinationLease, destinationTextureDesc, get(destinationTexture));
 
             INVOKE_EVENT(copyTextureEvent, wrappedContext, source, destination, SrcSubresource, DstSubresource);
         }
 
 #undef INVOKE_EVENT
 
+        std::shared_ptr<D3D11Context> wrapContext(EventWrapperPool<D3D11Context>::Lease& lease,
+                                                  ID3D11DeviceContext* context) {
+            auto& wrapper = lease.wrapper();
+            if (!wrapper) {
+                wrapper = std::make_shared<D3D11Context>(shared_from_this(), context);
+            } else {
+                wrapper->reset(context);
+            }
+            return wrapper;
+        }
+
+        std::shared_ptr<D3D11Texture> wrapTexture(EventWrapperPool<D3D11Texture>::Lease& lease,
+                                                  const D3D11_TEXTURE2D_DESC& textureDesc,
+                                                  ID3D11Texture2D* texture) {
+            auto& wrapper = lease.wrapper();
+            if (!wrapper) {
+                wrapper = std::make_shared<D3D11Texture>(
+                    shared_from_this(), getTextureInfo(textureDesc), textureDesc, texture);
+            } else {
+                wrapper->reset(getTextureInfo(textureDesc), textureDesc, texture);
+            }
+            return wrapper;
+        }
+
         void patchSamplers(ID3D11DeviceContext* context, ID3D11SamplerState** samplers, size_t numSamplers) {
             if (m_blockEvents || m_mipMapBiasingType == config::MipMapBias::Off) {
                 return;
@@ -1996,7 +1915,9 @@ void main(uint3 id : SV_DispatchThreadID)
         const std::shared_ptr<config::IConfigManager> m_configManager;
         ComPtr<IDXGIAdapter> m_adapter;
         ComPtr<ID3D11DeviceContext> m_context;
-        D3D11ContextState m_state;
+        ComPtr<ID3D11DeviceContext1> m_context1;
+        ComPtr<ID3DDeviceContextState> m_toolkitContextState;
+        D3D11ContextSaver<ID3D11DeviceContext, ID3D11DeviceContext1, ID3DDeviceContextState> m_contextSaver;
         std::string m_deviceName;
         GpuArchitecture m_gpuArchitecture;
         const bool m_allowInterceptor;
@@ -2032,6 +1953,8 @@ void main(uint3 id : SV_DispatchThreadID)
         SetRenderTargetEvent m_setRenderTargetEvent;
         UnsetRenderTargetEvent m_unsetRenderTargetEvent;
         CopyTextureEvent m_copyTextureEvent;
+        EventWrapperPool<D3D11Context> m_contextWrappers;
+        EventWrapperPool<D3D11Texture> m_textureWrappers;
         std::atomic<bool> m_blockEvents{false};
 
         ComPtr<ID3D11ComputeShader> m_debugWorkloadShader;
@@ -2099,7 +2022,7 @@ void main(uint3 id : SV_DispatchThreadID)
                                 ID3D11RenderTargetView* const* ppRenderTargetViews,
                                 ID3D11DepthStencilView* pDepthStencilView) {
             TraceLocalActivity(local);
-            TraceLoggingWriteStart(local,
+            TraceLoggingLocalStart(local,
                                    "ID3D11DeviceContext_OMSetRenderTargets",
                                    TLPArg(Context, "Context"),
                                    TLArg(NumViews, "NumViews"),
@@ -2118,7 +2041,7 @@ void main(uint3 id : SV_DispatchThreadID)
 
             g_instance->onSetRenderTargets(Context, NumViews, ppRenderTargetViews, pDepthStencilView);
 
-            TraceLoggingWriteStop(local, "ID3D11DeviceContext_OMSetRenderTargets");
+            TraceLoggingLocalStop(local, "ID3D11DeviceContext_OMSetRenderTargets");
         }
 
         DECLARE_DETOUR_FUNCTION(static void,
@@ -2133,7 +2056,7 @@ void main(uint3 id : SV_DispatchThreadID)
                                 ID3D11UnorderedAccessView* const* ppUnorderedAccessViews,
                                 const UINT* pUAVInitialCounts) {
             TraceLocalActivity(local);
-            TraceLoggingWriteStart(local,
+            TraceLoggingLocalStart(local,
                                    "ID3D11DeviceContext_OMSetRenderTargetsAndUnorderedAccessViews",
                                    TLPArg(Context, "Context"),
                                    TLArg(NumRTVs, "NumRTVs"),
@@ -2161,7 +2084,7 @@ void main(uint3 id : SV_DispatchThreadID)
                 g_instance->onSetRenderTargets(Context, NumRTVs, ppRenderTargetViews, pDepthStencilView);
             }
 
-            TraceLoggingWriteStop(local, "ID3D11DeviceContext_OMSetRenderTargetsAndUnorderedAccessViews");
+            TraceLoggingLocalStop(local, "ID3D11DeviceContext_OMSetRenderTargetsAndUnorderedAccessViews");
         }
 
         DECLARE_DETOUR_FUNCTION(static void,
@@ -2171,7 +2094,7 @@ void main(uint3 id : SV_DispatchThreadID)
                                 UINT NumViewports,
                                 const D3D11_VIEWPORT* pViewports) {
             TraceLocalActivity(local);
-            TraceLoggingWriteStart(local,
+            TraceLoggingLocalStart(local,
                                    "ID3D11DeviceContext_RSSetViewports",
                                    TLPArg(Context, "Context"),
                                    TLArg(NumViewports, "NumViewports"));
@@ -2190,7 +2113,7 @@ void main(uint3 id : SV_DispatchThreadID)
             assert(g_original_ID3D11DeviceContext_RSSetViewports);
             g_original_ID3D11DeviceContext_RSSetViewports(Context, NumViewports, pViewports);
 
-            TraceLoggingWriteStop(local, "ID3D11DeviceContext_RSSetViewports");
+            TraceLoggingLocalStop(local, "ID3D11DeviceContext_RSSetViewports");
         }
 
         DECLARE_DETOUR_FUNCTION(static void,
@@ -2200,7 +2123,7 @@ void main(uint3 id : SV_DispatchThreadID)
                                 ID3D11Resource* pDstResource,
                                 ID3D11Resource* pSrcResource) {
             TraceLocalActivity(local);
-            TraceLoggingWriteStart(local,
+            TraceLoggingLocalStart(local,
                                    "ID3D11DeviceContext_CopyResource",
                                    TLPArg(Context, "Context"),
                                    TLPArg(pDstResource, "DstResource"),
@@ -2212,7 +2135,7 @@ void main(uint3 id : SV_DispatchThreadID)
             assert(g_original_ID3D11DeviceContext_CopyResource);
             g_original_ID3D11DeviceContext_CopyResource(Context, pDstResource, pSrcResource);
 
-            TraceLoggingWriteStop(local, "ID3D11DeviceContext_CopyResource");
+            TraceLoggingLocalStop(local, "ID3D11DeviceContext_CopyResource");
         }
 
         DECLARE_DETOUR_FUNCTION(static void,
@@ -2228,7 +2151,7 @@ void main(uint3 id : SV_DispatchThreadID)
                                 UINT SrcSubresource,
                                 const D3D11_BOX* pSrcBox) {
             TraceLocalActivity(local);
-            TraceLoggingWriteStart(local,
+            TraceLoggingLocalStart(local,
                                    "ID3D11DeviceContext_CopySubresourceRegion",
                                    TLPArg(Context, "Context"),
                                    TLPArg(pDstResource, "DstResource"),
@@ -2243,7 +2166,7 @@ void main(uint3 id : SV_DispatchThreadID)
             g_original_ID3D11DeviceContext_CopySubresourceRegion(
                 Context, pDstResource, DstSubresource, DstX, DstY, DstZ, pSrcResource, SrcSubresource, pSrcBox);
 
-            TraceLoggingWriteStop(local, "ID3D11DeviceContext_CopySubresourceRegion");
+            TraceLoggingLocalStop(local, "ID3D11DeviceContext_CopySubresourceRegion");
         }
 
         DECLARE_DETOUR_FUNCTION(static void,
@@ -2254,7 +2177,7 @@ void main(uint3 id : SV_DispatchThreadID)
                                 UINT NumSamplers,
                                 ID3D11SamplerState* const* ppSamplers) {
             TraceLocalActivity(local);
-            TraceLoggingWriteStart(local,
+            TraceLoggingLocalStart(local,
                                    "ID3D11DeviceContext_PSSetSamplers",
                                    TLPArg(Context, "Context"),
                                    TLArg(StartSlot, "StartSlots"),
@@ -2275,7 +2198,7 @@ void main(uint3 id : SV_DispatchThreadID)
             assert(g_original_ID3D11DeviceContext_PSSetSamplers);
             g_original_ID3D11DeviceContext_PSSetSamplers(Context, StartSlot, NumSamplers, updatedSamplers);
 
-            TraceLoggingWriteStop(local, "ID3D11DeviceContext_PSSetSamplers");
+            TraceLoggingLocalStop(local, "ID3D11DeviceContext_PSSetSamplers");
         }
     };
 
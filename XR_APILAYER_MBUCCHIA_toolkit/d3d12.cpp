@@ -60,45 +60,177 @@ namespace {
             resource->SetPrivateData(WKPDID_D3DDebugObjectName, static_cast<UINT>(name.size()), name.data());
     }
 
-    auto descriptorCompare = [](const D3D12_CPU_DESCRIPTOR_HANDLE& left, const D3D12_CPU_DESCRIPTOR_HANDLE& right) {
-        return left.ptr < right.ptr;
+    // The resources bound to render target descriptors.
+    struct RenderTargetDescriptor {
+        ID3D12Resource* resource;
+        D3D12_RESOURCE_DESC desc;
     };
 
-    struct D3D12Heap {
-        void initialize(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT numDescriptors = 32) {
-            D3D12_DESCRIPTOR_HEAP_DESC desc;
-            ZeroMemory(&desc, sizeof(desc));
-            heapSize = desc.NumDescriptors = numDescriptors;
-            desc.Type = type;
-            desc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-            if (type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER || type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV) {
-                desc.Flags |= D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    using RenderTargetDescriptorTable = LockFreeHandleMap<RenderTargetDescriptor>;
+
+    // The fence signaled upon each flush of the device context (see flushContext()), to know when the commands that
+    // were recorded before a given flush have completed on the GPU.
+    class D3D12SubmissionFence {
+      public:
+        void initialize(ID3D12Device* device) {
+            CHECK_HRCMD(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(set(m_fence))));
+            m_submittedValue = 0;
+        }
+
+        UINT64 signal(ID3D12CommandQueue* queue) {
+            CHECK_HRCMD(queue->Signal(get(m_fence), ++m_submittedValue));
+            return m_submittedValue;
+        }
+
+        void wait(UINT64 value) const {
+            if (m_fence->GetCompletedValue() < value) {
+                wil::unique_handle eventHandle;
+                *eventHandle.put() = CreateEventEx(nullptr, L"flushContext Fence", 0, EVENT_ALL_ACCESS);
+                CHECK_HRCMD(m_fence->SetEventOnCompletion(value, eventHandle.get()));
+                WaitForSingleObject(eventHandle.get(), INFINITE);
             }
-            CHECK_HRCMD(device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(set(heap))));
-            heapStartCPU = heap->GetCPUDescriptorHandleForHeapStart();
-            heapStartGPU = heap->GetGPUDescriptorHandleForHeapStart();
-            heapOffset = 0;
-            descSize = device->GetDescriptorHandleIncrementSize(type);
         }
 
-        void allocate(D3D12_CPU_DESCRIPTOR_HANDLE& desc) {
-            assert((UINT)heapOffset < heapSize);
-            desc = CD3DX12_CPU_DESCRIPTOR_HANDLE(heapStartCPU, heapOffset++, descSize);
+        bool isCompleted(UINT64 value) const {
+            return m_fence->GetCompletedValue() >= value;
+        }
+
+        // The value that is signaled once the commands being recorded right now have completed.
+        UINT64 getNextValue() const {
+            return m_submittedValue + 1;
         }
 
-        // TODO: Implement freeing a descriptor
+      private:
+        ComPtr<ID3D12Fence> m_fence;
+        UINT64 m_submittedValue{0};
+    };
+
+    // A descriptor allocated from a D3D12Heap. The generation is used to detect the release of a stale descriptor.
+    struct D3D12Descriptor {
+        D3D12_CPU_DESCRIPTOR_HANDLE handle{0};
+        uint32_t generation{0};
+    };
+
+    // A descriptor heap with reuse of the released descriptors (see DescriptorAllocator).
+    // Released descriptors might still be referenced by in-flight command lists, so they are only recycled after a
+    // given number of flushes (see flushContext()). Heaps that are not shader-visible grow by adding pages.
+    // Shader-visible heaps cannot grow, since only one heap of each type can be bound at a time.
+    class D3D12Heap {
+      public:
+        void initialize(ID3D12Device* device,
+                        D3D12_DESCRIPTOR_HEAP_TYPE type,
+                        UINT numDescriptors = 32,
+                        UINT recycleLatency = 0) {
+            m_device = device;
+            m_type = type;
+            m_isShaderVisible =
+                type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER || type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+            m_descSize = device->GetDescriptorHandleIncrementSize(type);
+            m_pages.clear();
+            m_allocator.initialize(recycleLatency);
+
+            addPage(numDescriptors);
+        }
+
+        D3D12Descriptor allocate() {
+            std::unique_lock lock(m_lock);
+
+            auto location = m_allocator.allocate();
+            if (!location) {
+                if (m_isShaderVisible) {
+                    throw std::runtime_error(fmt::format("Out of descriptors in shader-visible heap ({})",
+                                                         m_pages.back().size));
+                }
+                addPage(m_pages.back().size * 2);
+                location = m_allocator.allocate();
+            }
+
+            return {CD3DX12_CPU_DESCRIPTOR_HANDLE(m_pages[location->page].heapStartCPU, location->index, m_descSize),
+                    location->generation};
+        }
+
+        void free(const D3D12Descriptor& descriptor) {
+            std::unique_lock lock(m_lock);
+
+            const auto location = locate(descriptor.handle);
+            if (!location || !m_allocator.free(location->first, location->second, descriptor.generation)) {
+                assert(false);
+            }
+        }
+
+        // Invoked upon each flush of the device context, to recycle the descriptors that are no longer in use.
+        void recycle() {
+            std::unique_lock lock(m_lock);
+
+            m_allocator.recycle();
+        }
 
         D3D12_GPU_DESCRIPTOR_HANDLE getGPUHandle(D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle) const {
-            INT64 offset = (cpuHandle.ptr - heapStartCPU.ptr) / descSize;
-            return CD3DX12_GPU_DESCRIPTOR_HANDLE(heapStartGPU, (INT)offset, descSize);
+            assert(m_isShaderVisible && m_pages.size() == 1);
+            INT64 offset = (cpuHandle.ptr - m_pages[0].heapStartCPU.ptr) / m_descSize;
+            return CD3DX12_GPU_DESCRIPTOR_HANDLE(m_pages[0].heapStartGPU, (INT)offset, m_descSize);
+        }
+
+        ID3D12DescriptorHeap* getShaderVisibleHeap() const {
+            assert(m_isShaderVisible);
+            return get(m_pages[0].heap);
+        }
+
+        UINT getNumAllocated() const {
+            return m_allocator.getNumAllocated();
+        }
+
+        UINT getCapacity() const {
+            return m_allocator.getCapacity();
+        }
+
+      private:
+        struct Page {
+            ComPtr<ID3D12DescriptorHeap> heap;
+            D3D12_CPU_DESCRIPTOR_HANDLE heapStartCPU;
+            D3D12_GPU_DESCRIPTOR_HANDLE heapStartGPU;
+            UINT size;
+        };
+
+        void addPage(UINT numDescriptors) {
+            D3D12_DESCRIPTOR_HEAP_DESC desc;
+            ZeroMemory(&desc, sizeof(desc));
+            desc.NumDescriptors = numDescriptors;
+            desc.Type = m_type;
+            desc.Flags =
+                m_isShaderVisible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+
+            Page page;
+            CHECK_HRCMD(m_device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(set(page.heap))));
+            page.heapStartCPU = page.heap->GetCPUDescriptorHandleForHeapStart();
+            if (m_isShaderVisible) {
+                page.heapStartGPU = page.heap->GetGPUDescriptorHandleForHeapStart();
+            }
+            page.size = numDescriptors;
+
+            m_pages.push_back(std::move(page));
+            m_allocator.addPage(numDescriptors);
         }
 
-        UINT heapSize{0};
-        ComPtr<ID3D12DescriptorHeap> heap;
-        D3D12_CPU_DESCRIPTOR_HANDLE heapStartCPU;
-        D3D12_GPU_DESCRIPTOR_HANDLE heapStartGPU;
-        INT heapOffset{0};
-        UINT descSize;
+        std::optional<std::pair<size_t, UINT>> locate(D3D12_CPU_DESCRIPTOR_HANDLE handle) const {
+            for (size_t i = 0; i < m_pages.size(); i++) {
+                const auto& page = m_pages[i];
+                if (handle.ptr >= page.heapStartCPU.ptr &&
+                    handle.ptr < page.heapStartCPU.ptr + (SIZE_T)page.size * m_descSize) {
+                    return std::make_pair(i, (UINT)((handle.ptr - page.heapStartCPU.ptr) / m_descSize));
+                }
+            }
+            return std::nullopt;
+        }
+
+        ID3D12Device* m_device{nullptr};
+        D3D12_DESCRIPTOR_HEAP_TYPE m_type;
+        bool m_isShaderVisible{false};
+        UINT m_descSize{0};
+
+        std::vector<Page> m_pages;
+        DescriptorAllocator m_allocator;
+        std::mutex m_lock;
     };
 
     // Wrap shader resources, common code for root signature creation.
@@ -336,8 +468,12 @@ namespace {
                               public IRenderTargetView,
                               public IDepthStencilView {
       public:
-        D3D12ResourceView(std::shared_ptr<IDevice> device, D3D12_CPU_DESCRIPTOR_HANDLE resourceView)
-            : m_device(device), m_resourceView(resourceView) {
+        D3D12ResourceView(std::shared_ptr<IDevice> device, D3D12Heap& heap, const D3D12Descriptor& descriptor)
+            : m_device(device), m_heap(heap), m_descriptor(descriptor), m_resourceView(descriptor.handle) {
+        }
+
+        ~D3D12ResourceView() override {
+            m_heap.free(m_descriptor);
         }
 
         Api getApi() const override {
@@ -354,6 +490,8 @@ namespace {
 
       private:
         const std::shared_ptr<IDevice> m_device;
+        D3D12Heap& m_heap;
+        const D3D12Descriptor m_descriptor;
         const D3D12_CPU_DESCRIPTOR_HANDLE m_resourceView;
     };
 
@@ -367,15 +505,50 @@ namespace {
                      D3D12_RESOURCE_STATES initialState,
                      D3D12Heap& rtvHeap,
                      D3D12Heap& dsvHeap,
-                     D3D12Heap& rvHeap)
+                     D3D12Heap& rvHeap,
+                     D3D12SubmissionFence& submissionFence)
             : m_device(device), m_info(info), m_textureDesc(textureDesc), m_texture(texture),
-              m_currentState(initialState), m_rtvHeap(rtvHeap), m_dsvHeap(dsvHeap), m_rvHeap(rvHeap) {
+              m_currentState(initialState), m_rtvHeap(rtvHeap), m_dsvHeap(dsvHeap), m_rvHeap(rvHeap),
+              m_submissionFence(submissionFence) {
             m_shaderResourceSubView.resize(info.arraySize);
             m_unorderedAccessSubView.resize(info.arraySize);
             m_renderTargetSubView.resize(info.arraySize);
             m_depthStencilSubView.resize(info.arraySize);
         }
 
+        // Re-wrap another texture (see EventWrapperPool).
+        void reset(const XrSwapchainCreateInfo& info,
+                   const D3D12_RESOURCE_DESC& textureDesc,
+                   ID3D12Resource* texture,
+                   D3D12_RESOURCE_STATES initialState) {
+            m_info = info;
+            m_textureDesc = textureDesc;
+            m_texture = texture;
+            m_currentState = initialState;
+            m_stateStack.clear();
+            m_uploadBuffers.clear();
+            m_uploadSize = 0;
+            m_interopTexture.reset();
+            m_interopCopyTexture.reset();
+            m_shaderResourceView.reset();
+            m_unorderedAccessView.reset();
+            m_renderTargetView.reset();
+            m_depthStencilView.reset();
+            for (auto* subViews : {&m_shaderResourceSubView,
+                                   &m_unorderedAccessSubView,
+                                   &m_renderTargetSubView,
+                                   &m_depthStencilSubView}) {
+                subViews->assign(info.arraySize, nullptr);
+            }
+        }
+
+        void detach() {
+            m_texture = nullptr;
+            m_uploadBuffers.clear();
+            m_interopTexture.reset();
+            m_interopCopyTexture.reset();
+        }
+
         Api getApi() const override {
             return Api::D3D12;
         }
@@ -427,26 +600,48 @@ namespace {
         void uploadData(const void* buffer, uint32_t rowPitch, int32_t slice = -1) override {
             assert(!(rowPitch % m_device->getTextureAlignmentConstraint()));
 
-            // Create an upload buffer if we don't have one already
-            if (!m_uploadBuffer) {
+            // The copy from a previous upload might still be in flight, and it would read the new data if we overwrote
+            // its upload buffer. Use an upload buffer whose last copy has completed, or add one to the ring.
+            auto uploadBuffer = std::find_if(m_uploadBuffers.begin(), m_uploadBuffers.end(), [&](const auto& entry) {
+                return m_submissionFence.isCompleted(entry.fenceValue);
+            });
+            if (uploadBuffer == m_uploadBuffers.end() && m_uploadBuffers.size() >= MaxInflightUploads) {
+                // Do not grow the ring indefinitely: wait for the oldest copy, unless it is not even submitted yet.
+                uploadBuffer = std::min_element(
+                    m_uploadBuffers.begin(), m_uploadBuffers.end(), [](const auto& a, const auto& b) {
+                        return a.fenceValue < b.fenceValue;
+                    });
+                if (uploadBuffer->fenceValue < m_submissionFence.getNextValue()) {
+                    m_submissionFence.wait(uploadBuffer->fenceValue);
+                } else {
+                    uploadBuffer = m_uploadBuffers.end();
+                }
+            }
+            if (uploadBuffer == m_uploadBuffers.end()) {
                 m_uploadSize = alignTo((UINT)m_textureDesc.Width, m_device->getTextureAlignmentConstraint()) *
                                m_textureDesc.Height;
                 const auto& heapType = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
                 const auto stagingDesc = CD3DX12_RESOURCE_DESC::Buffer(m_uploadSize);
+                UploadBuffer newBuffer;
                 CHECK_HRCMD(m_device->getAs<D3D12>()->CreateCommittedResource(&heapType,
                                                                               D3D12_HEAP_FLAG_NONE,
                                                                               &stagingDesc,
                                                                               D3D12_RESOURCE_STATE_GENERIC_READ,
                                                                               nullptr,
-                                                                              IID_PPV_ARGS(set(m_uploadBuffer))));
+                                                                              IID_PPV_ARGS(set(newBuffer.buffer))));
+                m_uploadBuffers.push_back(std::move(newBuffer));
+                uploadBuffer = std::prev(m_uploadBuffers.end());
             }
 
+            // The copy below is submitted with the next flushContext().
+            uploadBuffer->fenceValue = m_submissionFence.getNextValue();
+
             // Copy to the upload buffer.
             {
                 void* mappedBuffer = nullptr;
-                m_uploadBuffer->Map(0, nullptr, &mappedBuffer);
+                uploadBuffer->buffer->Map(0, nullptr, &mappedBuffer);
                 memcpy(mappedBuffer, buffer, m_uploadSize);
-                m_uploadBuffer->Unmap(0, nullptr);
+                uploadBuffer->buffer->Unmap(0, nullptr);
             }
 
             // Do the upload now.
@@ -460,7 +655,7 @@ namespace {
                 footprint.Footprint.Depth = 1;
                 footprint.Footprint.RowPitch = rowPitch;
                 footprint.Footprint.Format = m_textureDesc.Format;
-                CD3DX12_TEXTURE_COPY_LOCATION src(get(m_uploadBuffer), footprint);
+                CD3DX12_TEXTURE_COPY_LOCATION src(get(uploadBuffer->buffer), footprint);
                 CD3DX12_TEXTURE_COPY_LOCATION dst(get(m_texture), 0);
                 context->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
 
@@ -606,10 +801,9 @@ namespace {
                 desc.Texture2DArray.MipLevels = m_info.mipCount;
                 desc.Texture2DArray.MostDetailedMip = D3D12CalcSubresource(0, 0, 0, m_info.mipCount, m_info.arraySize);
 
-                D3D12_CPU_DESCRIPTOR_HANDLE handle;
-                m_rvHeap.allocate(handle);
-                device->CreateShaderResourceView(get(m_texture), &desc, handle);
-                return std::make_shared<D3D12ResourceView>(m_device, handle);
+                const auto descriptor = m_rvHeap.allocate();
+                device->CreateShaderResourceView(get(m_texture), &desc, descriptor.handle);
+                return std::make_shared<D3D12ResourceView>(m_device, m_rvHeap, descriptor);
             }
             return nullptr;
         }
@@ -628,10 +822,9 @@ namespace {
                 desc.Texture2DArray.FirstArraySlice = slice;
                 desc.Texture2DArray.MipSlice = D3D12CalcSubresource(0, 0, 0, m_info.mipCount, m_info.arraySize);
 
-                D3D12_CPU_DESCRIPTOR_HANDLE handle;
-                m_rvHeap.allocate(handle);
-                device->CreateUnorderedAccessView(get(m_texture), nullptr, &desc, handle);
-                return std::make_shared<D3D12ResourceView>(m_device, handle);
+                const auto descriptor = m_rvHeap.allocate();
+                device->CreateUnorderedAccessView(get(m_texture), nullptr, &desc, descriptor.handle);
+                return std::make_shared<D3D12ResourceView>(m_device, m_rvHeap, descriptor);
             }
             return nullptr;
         }
@@ -650,10 +843,9 @@ namespace {
                 desc.Texture2DArray.FirstArraySlice = slice;
                 desc.Texture2DArray.MipSlice = D3D12CalcSubresource(0, 0, 0, m_info.mipCount, m_info.arraySize);
 
-                D3D12_CPU_DESCRIPTOR_HANDLE handle;
-                m_rtvHeap.allocate(handle);
-                device->CreateRenderTargetView(get(m_texture), &desc, handle);
-                return std::make_shared<D3D12ResourceView>(m_device, handle);
+                const auto descriptor = m_rtvHeap.allocate();
+                device->CreateRenderTargetView(get(m_texture), &desc, descriptor.handle);
+                return std::make_shared<D3D12ResourceView>(m_device, m_rtvHeap, descriptor);
             }
             return nullptr;
         }
@@ -672,10 +864,9 @@ namespace {
                 desc.Texture2DArray.FirstArraySlice = slice;
                 desc.Texture2DArray.MipSlice = D3D12CalcSubresource(0, 0, 0, m_info.mipCount, m_info.arraySize);
 
-                D3D12_CPU_DESCRIPTOR_HANDLE handle;
-                m_dsvHeap.allocate(handle);
-                device->CreateDepthStencilView(get(m_texture), &desc, handle);
-                return std::make_shared<D3D12ResourceView>(m_device, handle);
+                const auto descriptor = m_dsvHeap.allocate();
+                device->CreateDepthStencilView(get(m_texture), &desc, descriptor.handle);
+                return std::make_shared<D3D12ResourceView>(m_device, m_dsvHeap, descriptor);
             }
             return nullptr;
         }
@@ -694,15 +885,23 @@ namespace {
             return m_interopCopyTexture;
         }
 
+        // An upload buffer, with the fence value signaled once its last copy has completed.
+        struct UploadBuffer {
+            ComPtr<ID3D12Resource> buffer;
+            UINT64 fenceValue{0};
+        };
+
+        static constexpr size_t MaxInflightUploads = 4;
+
         const std::shared_ptr<IDevice> m_device;
-        const XrSwapchainCreateInfo m_info;
-        const D3D12_RESOURCE_DESC m_textureDesc;
-        const ComPtr<ID3D12Resource> m_texture;
+        XrSwapchainCreateInfo m_info;
+        D3D12_RESOURCE_DESC m_textureDesc;
+        ComPtr<ID3D12Resource> m_texture;
 
         D3D12_RESOURCE_STATES m_currentState;
         std::vector<D3D12_RESOURCE_STATES> m_stateStack;
 
-        ComPtr<ID3D12Resource> m_uploadBuffer;
+        std::vector<UploadBuffer> m_uploadBuffers;
         UINT m_uploadSize{0};
         std::shared_ptr<ITexture> m_interopTexture;
         std::shared_ptr<ITexture> m_interopCopyTexture;
@@ -710,6 +909,7 @@ namespace {
         D3D12Heap& m_rtvHeap;
         D3D12Heap& m_dsvHeap;
         D3D12Heap& m_rvHeap;
+        D3D12SubmissionFence& m_submissionFence;
 
         mutable std::shared_ptr<D3D12ResourceView> m_shaderResourceView;
         mutable std::vector<std::shared_ptr<D3D12ResourceView>> m_shaderResourceSubView;
@@ -735,6 +935,12 @@ namespace {
               m_rvHeap(rvHeap), m_uploadBuffer(uploadBuffer) {
         }
 
+        ~D3D12Buffer() override {
+            if (m_constantBufferView) {
+                m_rvHeap.free(m_constantBufferView.value());
+            }
+        }
+
         Api getApi() const override {
             return Api::D3D12;
         }
@@ -765,21 +971,17 @@ namespace {
         // TODO: Consider moving this operation up to IShaderBuffer. Will prevent the need for dynamic_cast below.
         D3D12_CPU_DESCRIPTOR_HANDLE getConstantBufferView() const {
             if (!m_constantBufferView) {
-                {
-                    D3D12_CPU_DESCRIPTOR_HANDLE handle;
-                    m_rvHeap.allocate(handle);
-                    m_constantBufferView = handle;
-                }
+                m_constantBufferView = m_rvHeap.allocate();
 
                 if (auto device = m_device->getAs<D3D12>()) {
                     D3D12_CONSTANT_BUFFER_VIEW_DESC desc;
                     desc.BufferLocation = m_buffer->GetGPUVirtualAddress();
                     desc.SizeInBytes =
                         alignTo(static_cast<UINT>(m_bufferDesc.Width), D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
-                    device->CreateConstantBufferView(&desc, m_constantBufferView.value());
+                    device->CreateConstantBufferView(&desc, m_constantBufferView.value().handle);
                 }
             }
-            return m_constantBufferView.value();
+            return m_constantBufferView.value().handle;
         }
 
         void pushState(D3D12_RESOURCE_STATES newState) override {
@@ -821,7 +1023,7 @@ namespace {
 
         const ComPtr<ID3D12Resource> m_uploadBuffer;
 
-        mutable std::optional<D3D12_CPU_DESCRIPTOR_HANDLE> m_constantBufferView;
+        mutable std::optional<D3D12Descriptor> m_constantBufferView;
     };
 
     // Wrap a vertex+indices buffers. Obtained from D3D12Device.
@@ -866,6 +1068,87 @@ namespace {
         mutable struct D3D12::MeshData m_meshData;
     };
 
+    // A buffer in a readback heap, with a fence to know when the copy has completed.
+    class D3D12ReadbackTexture : public IReadbackTexture {
+      public:
+        D3D12ReadbackTexture(std::shared_ptr<IDevice> device,
+                             const XrSwapchainCreateInfo& info,
+                             ID3D12Resource* buffer,
+                             const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint,
+                             ID3D12CommandQueue* queue,
+                             ID3D12Fence* fence)
+            : m_device(device), m_info(info), m_buffer(buffer), m_footprint(footprint), m_queue(queue),
+              m_fence(fence) {
+        }
+
+        Api getApi() const override {
+            return Api::D3D12;
+        }
+
+        std::shared_ptr<IDevice> getDevice() const override {
+            return m_device;
+        }
+
+        const XrSwapchainCreateInfo& getInfo() const override {
+            return m_info;
+        }
+
+        void copyFrom(std::shared_ptr<ITexture> source, int32_t srcSlice, uint32_t srcX, uint32_t srcY) override {
+            const CD3DX12_TEXTURE_COPY_LOCATION destLoc(get(m_buffer), m_footprint);
+            const CD3DX12_TEXTURE_COPY_LOCATION srcLoc(source->getAs<D3D12>(), (UINT)srcSlice);
+
+            D3D12_BOX box;
+            box.left = srcX;
+            box.top = srcY;
+            box.right = box.left + m_info.width;
+            box.bottom = box.top + m_info.height;
+            box.front = 0;
+            box.back = 1;
+
+            source->pushState(D3D12_RESOURCE_STATE_COPY_SOURCE);
+            m_device->getContextAs<D3D12>()->CopyTextureRegion(&destLoc, 0, 0, 0, &srcLoc, &box);
+            source->popState();
+
+            m_needSignal = true;
+        }
+
+        bool isReady() override {
+            // The copy is only submitted with the next flushContext(), so we can only signal the fence from the first
+            // poll.
+            if (m_needSignal) {
+                CHECK_HRCMD(m_queue->Signal(get(m_fence), ++m_fenceValue));
+                m_needSignal = false;
+            }
+            return m_fence->GetCompletedValue() >= m_fenceValue;
+        }
+
+        void readback(std::vector<uint8_t>& data, uint32_t& rowPitch) override {
+            rowPitch = m_footprint.Footprint.RowPitch;
+
+            // The last row is not padded in the buffer.
+            const size_t size = (size_t)m_buffer->GetDesc().Width;
+            data.resize((size_t)rowPitch * m_info.height);
+
+            void* mappedBuffer = nullptr;
+            const D3D12_RANGE readRange{0, size};
+            CHECK_HRCMD(m_buffer->Map(0, &readRange, &mappedBuffer));
+            memcpy(data.data(), mappedBuffer, std::min(size, data.size()));
+            const D3D12_RANGE writeRange{0, 0};
+            m_buffer->Unmap(0, &writeRange);
+        }
+
+      private:
+        const std::shared_ptr<IDevice> m_device;
+        const XrSwapchainCreateInfo m_info;
+        const ComPtr<ID3D12Resource> m_buffer;
+        const D3D12_PLACED_SUBRESOURCE_FOOTPRINT m_footprint;
+        const ComPtr<ID3D12CommandQueue> m_queue;
+        const ComPtr<ID3D12Fence> m_fence;
+
+        UINT64 m_fenceValue{0};
+        bool m_needSignal{false};
+    };
+
     class D3D12GpuTimer : public IGpuTimer {
       public:
         D3D12GpuTimer(std::shared_ptr<IDevice> device,
@@ -912,6 +1195,15 @@ namespace {
             : m_device(device), m_context(context) {
         }
 
+        // Re-wrap another command list (see EventWrapperPool).
+        void reset(ID3D12GraphicsCommandList* context) {
+            m_context = context;
+        }
+
+        void detach() {
+            m_context = nullptr;
+        }
+
         Api getApi() const override {
             return Api::D3D12;
         }
@@ -926,7 +1218,7 @@ namespace {
 
       private:
         const std::shared_ptr<IDevice> m_device;
-        const ComPtr<ID3D12GraphicsCommandList> m_context;
+        ComPtr<ID3D12GraphicsCommandList> m_context;
     };
 
     class D3D12Device : public IDevice, public std::enable_shared_from_this<D3D12Device> {
@@ -985,10 +1277,11 @@ namespace {
             }
 
             // Initialize the command lists and heaps.
-            m_rtvHeap.initialize(get(m_device), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, 128);
-            m_dsvHeap.initialize(get(m_device), D3D12_DESCRIPTOR_HEAP_TYPE_DSV, 128);
-            m_rvHeap.initialize(get(m_device), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 128 + MaxModelBuffers);
-            m_samplerHeap.initialize(get(m_device), D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+            m_rtvHeap.initialize(get(m_device), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, 128, NumInflightContexts);
+            m_dsvHeap.initialize(get(m_device), D3D12_DESCRIPTOR_HEAP_TYPE_DSV, 128, NumInflightContexts);
+            m_rvHeap.initialize(
+                get(m_device), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 128 + MaxModelBuffers, NumInflightContexts);
+            m_samplerHeap.initialize(get(m_device), D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, 32, NumInflightContexts);
             {
                 D3D12_QUERY_HEAP_DESC desc;
                 ZeroMemory(&desc, sizeof(desc));
@@ -1053,7 +1346,7 @@ namespace {
                 m_textDevice = WrapD3D11TextDevice(get(textDevice), configManager);
             }
 
-            CHECK_HRCMD(m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(set(m_fence))));
+            m_submissionFence.initialize(get(m_device));
 
             initializeInterceptor();
             initializeShadingResources();
@@ -1068,14 +1361,14 @@ namespace {
         void shutdown() override {
             // Log some statistics for sizing.
             DebugLog("heap statistics: samp=%u/%u, rtv=%u/%u, dsv=%u/%u, rv=%u/%u, query=%u/%u\n",
-                     m_samplerHeap.heapOffset,
-                     m_samplerHeap.heapSize,
-                     m_rtvHeap.heapOffset,
-                     m_rtvHeap.heapSize,
-                     m_dsvHeap.heapOffset,
-                     m_dsvHeap.heapSize,
-                     m_rvHeap.heapOffset,
-                     m_rvHeap.heapSize,
+                     m_samplerHeap.getNumAllocated(),
+                     m_samplerHeap.getCapacity(),
+                     m_rtvHeap.getNumAllocated(),
+                     m_rtvHeap.getCapacity(),
+                     m_dsvHeap.getNumAllocated(),
+                     m_dsvHeap.getCapacity(),
+                     m_rvHeap.getNumAllocated(),
+                     m_rvHeap.getCapacity(),
                      m_nextGpuTimestampIndex,
                      ARRAYSIZE(m_queryBuffer));
 
@@ -1093,6 +1386,8 @@ namespace {
             for (uint32_t i = 0; i < ARRAYSIZE(m_meshModelBuffer); i++) {
                 m_meshModelBuffer[i].reset();
             }
+            m_contextWrappers.clear();
+            m_textureWrappers.clear();
 
             m_device->SetPrivateDataInterface(IID_ID3D12CommandQueue, nullptr);
         }
@@ -1167,19 +1462,17 @@ namespace {
             ID3D12CommandList* const lists[] = {get(m_context)};
             m_queue->ExecuteCommandLists(ARRAYSIZE(lists), lists);
 
+            const auto fenceValue = m_submissionFence.signal(get(m_queue));
             if (blocking) {
-                m_queue->Signal(get(m_fence), ++m_fenceValue);
-                if (m_fence->GetCompletedValue() < m_fenceValue) {
-                    wil::unique_handle eventHandle;
-                    *eventHandle.put() = CreateEventEx(nullptr, L"flushContext Fence", 0, EVENT_ALL_ACCESS);
-                    CHECK_HRCMD(m_fence->SetEventOnCompletion(m_fenceValue, eventHandle.get()));
-                    WaitForSingleObject(eventHandle.get(), INFINITE);
-                }
+                m_submissionFence.wait(fenceValue);
             }
 
             if (++m_currentContext == NumInflightContexts) {
                 m_currentContext = 0;
             }
+            for (auto heap : {&m_rtvHeap, &m_dsvHeap, &m_rvHeap, &m_samplerHeap}) {
+                heap->recycle();
+            }
             CHECK_HRCMD(m_commandAllocator[m_currentContext]->Reset());
             CHECK_HRCMD(m_commandList[m_currentContext]->Reset(get(m_commandAllocator[m_currentContext]), nullptr));
             m_context = m_commandList[m_currentContext];
@@ -1271,7 +1564,34 @@ namespace {
             SetDebugName(get(texture), debugName);
 
             return std::make_shared<D3D12Texture>(
-                shared_from_this(), info, desc, get(texture), initialState, m_rtvHeap, m_dsvHeap, m_rvHeap);
+                shared_from_this(), info, desc, get(texture), initialState, m_rtvHeap, m_dsvHeap, m_rvHeap,
+                m_submissionFence);
+        }
+
+        std::shared_ptr<IReadbackTexture> createReadbackTexture(const XrSwapchainCreateInfo& info,
+                                                                std::string_view debugName) override {
+            const auto textureDesc =
+                CD3DX12_RESOURCE_DESC::Tex2D((DXGI_FORMAT)info.format, info.width, info.height, 1, 1);
+            D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint;
+            UINT64 size = 0;
+            m_device->GetCopyableFootprints(&textureDesc, 0, 1, 0, &footprint, nullptr, nullptr, &size);
+
+            ComPtr<ID3D12Resource> buffer;
+            const auto& heapType = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK);
+            const auto desc = CD3DX12_RESOURCE_DESC::Buffer(size);
+            CHECK_HRCMD(m_device->CreateCommittedResource(&heapType,
+                                                          D3D12_HEAP_FLAG_NONE,
+                                                          &desc,
+                                                          D3D12_RESOURCE_STATE_COPY_DEST,
+                                                          nullptr,
+                                                          IID_PPV_ARGS(set(buffer))));
+            SetDebugName(get(buffer), debugName);
+
+            ComPtr<ID3D12Fence> fence;
+            CHECK_HRCMD(m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(set(fence))));
+
+            return std::make_shared<D3D12ReadbackTexture>(
+                shared_from_this(), info, get(buffer), footprint, get(m_queue), get(fence));
         }
 
         std::shared_ptr<IShaderBuffer>
@@ -1408,8 +1728,8 @@ namespace {
             m_currentRootSlot = 0;
 
             ID3D12DescriptorHeap* const heaps[] = {
-                get(m_rvHeap.heap),
-                get(m_samplerHeap.heap),
+                m_rvHeap.getShaderVisibleHeap(),
+                m_samplerHeap.getShaderVisibleHeap(),
             };
             m_context->SetDescriptorHeaps(ARRAYSIZE(heaps), heaps);
 
@@ -1439,8 +1759,8 @@ namespace {
             m_currentRootSlot = 0;
 
             ID3D12DescriptorHeap* const heaps[] = {
-                get(m_rvHeap.heap),
-                get(m_samplerHeap.heap),
+                m_rvHeap.getShaderVisibleHeap(),
+                m_samplerHeap.getShaderVisibleHeap(),
             };
             m_context->SetDescriptorHeaps(ARRAYSIZE(heaps), heaps);
 
@@ -1771,7 +2091,7 @@ namespace {
                 m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
                 ID3D12DescriptorHeap* const heaps[] = {
-                    get(m_rvHeap.heap),
+                    m_rvHeap.getShaderVisibleHeap(),
                 };
                 m_context->SetDescriptorHeaps(ARRAYSIZE(heaps), heaps);
 
@@ -2045,14 +2365,14 @@ namespace {
                 desc.MaxAnisotropy = 1;
                 desc.ComparisonFunc = D3D12_COMPARISON_FUNC_ALWAYS;
                 desc.BorderColor[3] = 1.0f;
-                m_samplerHeap.allocate(m_samplers[to_integral(SamplerType::NearestClamp)]);
+                m_samplers[to_integral(SamplerType::NearestClamp)] = m_samplerHeap.allocate().handle;
                 m_device->CreateSampler(&desc, m_samplers[to_integral(SamplerType::NearestClamp)]);
 
                 desc.Filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
                 desc.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
                 desc.MinLOD = D3D12_MIP_LOD_BIAS_MIN;
                 desc.MaxLOD = D3D12_MIP_LOD_BIAS_MAX;
-                m_samplerHeap.allocate(m_samplers[to_integral(SamplerType::LinearClamp)]);
+                m_samplers[to_integral(SamplerType::LinearClamp)] = m_samplerHeap.allocate().handle;
                 m_device->CreateSampler(&desc, m_samplers[to_integral(SamplerType::LinearClamp)]);
             }
             {
@@ -2175,13 +2495,10 @@ namespace {
 
             D3D12_RESOURCE_DESC resourceDesc = resource->GetDesc();
             if (resourceDesc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE2D) {
-                const size_t sizeBefore = m_renderTargetResourceDescriptors.size();
-                {
-                    std::unique_lock lock(m_renderTargetResourceDescriptorsLock);
-
-                    m_renderTargetResourceDescriptors.insert_or_assign(handle, std::make_pair(resource, resourceDesc));
-                    if (sizeBefore && !(sizeBefore % 100) && m_renderTargetResourceDescriptors.size() != sizeBefore) {
-                        Log("Dictionary of render target resource descriptor now at %zu elements\n", sizeBefore + 1);
+                if (m_renderTargetResourceDescriptors.insertOrAssign(handle.ptr, {resource, resourceDesc})) {
+                    const size_t size = m_renderTargetResourceDescriptors.size();
+                    if (size > 1 && !((size - 1) % 100)) {
+                        Log("Dictionary of render target resource descriptor now at %zu elements\n", size);
                     }
                 }
             }
@@ -2201,42 +2518,34 @@ namespace {
                                 const D3D12_CPU_DESCRIPTOR_HANDLE* renderTargetHandles,
                                 BOOL singleHandleToDescriptorRange,
                                 const D3D12_CPU_DESCRIPTOR_HANDLE* depthStencilHandle) {
+            if (m_blockEvents) {
+                return;
+            }
+
             ComPtr<ID3D12Device> device;
             CHECK_HRCMD(context->GetDevice(IID_PPV_ARGS(set(device))));
             if (device != m_realDevice) {
                 return;
             }
 
-            auto wrappedContext = std::make_shared<D3D12Context>(shared_from_this(), context);
+            EventWrapperPool<D3D12Context>::Lease contextLease(m_contextWrappers);
+            EventWrapperPool<D3D12Texture>::Lease renderTargetLease(m_textureWrappers);
+            const auto wrappedContext = wrapContext(contextLease, context);
 
             if (!numRenderTargetDescriptors) {
                 INVOKE_EVENT(unsetRenderTargetEvent, wrappedContext);
                 return;
             }
 
-            std::shared_ptr<D3D12Texture> renderTarget;
-            {
-                std::unique_lock lock(m_renderTargetResourceDescriptorsLock);
-
-                auto it = m_renderTargetResourceDescriptors.find(renderTargetHandles[0]);
-                if (it == m_renderTargetResourceDescriptors.cend()) {
-                    INVOKE_EVENT(unsetRenderTargetEvent, wrappedContext);
-                    return;
-                }
-
-                ID3D12Resource* const resource = it->second.first;
-                const D3D12_RESOURCE_DESC& resourceDesc = it->second.second;
-
-                renderTarget = std::make_shared<D3D12Texture>(shared_from_this(),
-                                                              getTextureInfo(resourceDesc),
-                                                              resourceDesc,
-                                                              resource,
-                                                              D3D12_RESOURCE_STATE_COMMON, /* Conservative. */
-                                                              m_rtvHeap,
-                                                              m_dsvHeap,
-                                                              m_rvHeap);
+            const auto entry = m_renderTargetResourceDescriptors.find(renderTargetHandles[0].ptr);
+            if (!entry) {
+                INVOKE_EVENT(unsetRenderTargetEvent, wrappedContext);
+                return;
             }
 
+            const auto renderTarget = wrapTexture(
+                renderTargetLease, entry->desc, entry->resource, D3D12_RESOURCE_STATE_COMMON /* Conservative. */);
+
             INVOKE_EVENT(setRenderTargetEvent, wrappedContext, renderTarget);
         }
 
@@ -2245,39 +2554,67 @@ namespace {
                            ID3D12Resource* pDstResource,
                            UINT SrcSubresource = 0,
                            UINT DstSubresource = 0) {
+            if (m_blockEvents) {
+                return;
+            }
+
             ComPtr<ID3D12Device> device;
             CHECK_HRCMD(context->GetDevice(IID_PPV_ARGS(set(device))));
             if (device != m_realDevice) {
                 return;
             }
 
-            auto wrappedContext = std::make_shared<D3D12Context>(shared_from_this(), context);
+            EventWrapperPool<D3D12Context>::Lease contextLease(m_contextWrappers);
+            EventWrapperPool<D3D12Texture>::Lease sourceLease(m_textureWrappers);
+            EventWrapperPool<D3D12Texture>::Lease destinationLease(m_textureWrappers);
+            const auto wrappedContext = wrapContext(contextLease, context);
 
-            const D3D12_RESOURCE_DESC& sourceTextureDesc = pSrcResource->GetDesc();
-            auto source = std::make_shared<D3D12Texture>(shared_from_this(),
-                                                         getTextureInfo(sourceTextureDesc),
-                                                         sourceTextureDesc,
-                                                         pSrcResource,
-                                                         D3D12_RESOURCE_STATE_COPY_SOURCE, /* Conservative. */
-                                                         m_rtvHeap,
-                                                         m_dsvHeap,
-                                                         m_rvHeap);
-
-            const D3D12_RESOURCE_DESC& destinationTextureDesc = pSrcResource->GetDesc();
-            auto destination = std::make_shared<D3D12Texture>(shared_from_this(),
-                                                              getTextureInfo(destinationTextureDesc),
-                                                              destinationTextureDesc,
-                                                              pDstResource,
-                                                              D3D12_RESOURCE_STATE_COPY_DEST, /* Conservative. */
-                                                              m_rtvHeap,
-                                                              m_dsvHeap,
-                                                              m_rvHeap);
+            const auto source = wrapTexture(sourceLease,
+                                            pSrcResource->GetDesc(),
+                                            pSrcResource,
+                                            D3D12_RESOURCE_STATE_COPY_SOURCE /* Conservative. */);
+            const auto destination = wrapTexture(destinationLease,
+                                                 pDstResource->GetDesc(),
+                                                 pDstResource,
+                                                 D3D12_RESOURCE_STATE_COPY_DEST /* Conservative. */);
 
             INVOKE_EVENT(copyTextureEvent, wrappedContext, source, destination, SrcSubresource, DstSubresource);
         }
 
 #undef INVOKE_EVENT
 
+        std::shared_ptr<D3D12Context> wrapContext(EventWrapperPool<D3D12Context>::Lease& lease,
+                                                  ID3D12GraphicsCommandList* context) {
+            auto& wrapper = lease.wrapper();
+            if (!wrapper) {
+                wrapper = std::make_shared<D3D12Context>(shared_from_this(), context);
+            } else {
+                wrapper->reset(context);
+            }
+            return wrapper;
+        }
+
+        std::shared_ptr<D3D12Texture> wrapTexture(EventWrapperPool<D3D12Texture>::Lease& lease,
+                                                  const D3D12_RESOURCE_DESC& textureDesc,
+                                                  ID3D12Resource* texture,
+                                                  D3D12_RESOURCE_STATES initialState) {
+            auto& wrapper = lease.wrapper();
+            if (!wrapper) {
+                wrapper = std::make_shared<D3D12Texture>(shared_from_this(),
+                                                         getTextureInfo(textureDesc),
+                                                         textureDesc,
+                                                         texture,
+                                                         initialState,
+                                                         m_rtvHeap,
+                                                         m_dsvHeap,
+                                                         m_rvHeap,
+                                                         m_submissionFence);
+            } else {
+                wrapper->reset(getTextureInfo(textureDesc), textureDesc, texture, initialState);
+            }
+            return wrapper;
+        }
+
         const ComPtr<ID3D12Device> m_device;
         ComPtr<IDXGIAdapter> m_adapter;
         ComPtr<ID3D12Device> m_realDevice;
@@ -2310,8 +2647,7 @@ namespace {
         ComPtr<ID3D12RootSignature> m_meshRendererRootSignature;
         ComPtr<ID3D12PipelineState> m_meshRendererPipelineState;
         ComPtr<ID3D12PipelineState> m_meshRendererNoCullingPipelineState;
-        ComPtr<ID3D12Fence> m_fence;
-        UINT64 m_fenceValue{0};
+        D3D12SubmissionFence m_submissionFence;
 
         UINT m_nextGpuTimestampIndex{0};
         uint64_t m_queryBuffer[MaxGpuTimers * 2];
@@ -2339,13 +2675,11 @@ namespace {
         SetRenderTargetEvent m_setRenderTargetEvent;
         UnsetRenderTargetEvent m_unsetRenderTargetEvent;
         CopyTextureEvent m_copyTextureEvent;
+        EventWrapperPool<D3D12Context> m_contextWrappers;
+        EventWrapperPool<D3D12Texture> m_textureWrappers;
         std::atomic<bool> m_blockEvents{false};
 
-        std::map<D3D12_CPU_DESCRIPTOR_HANDLE,
-                 std::pair<ID3D12Resource*, D3D12_RESOURCE_DESC>,
-                 decltype(descriptorCompare)>
-            m_renderTargetResourceDescriptors{descriptorCompare};
-        std::mutex m_renderTargetResourceDescriptorsLock;
+        RenderTargetDescriptorTable m_renderTargetResourceDescriptors;
 
         friend std::shared_ptr<ITexture> toolkit::graphics::WrapD3D12Texture(std::shared_ptr<IDevice> device,
                                                                              const XrSwapchainCreateInfo& info,
@@ -2402,7 +2736,7 @@ namespace {
                                 const D3D12_RENDER_TARGET_VIEW_DESC* pDesc,
                                 D3D12_CPU_DESCRIPTOR_HANDLE DestDescriptor) {
             TraceLocalActivity(local);
-            TraceLoggingWriteStart(
+            TraceLoggingLocalStart(
                 local, "ID3D12Device_CreateRenderTargetView", TLPArg(Device, "Device"), TLPArg(pResource, "Resource"));
 
             assert(g_instance);
@@ -2411,7 +2745,7 @@ namespace {
             assert(g_original_ID3D12Device_CreateRenderTargetView);
             g_original_ID3D12Device_CreateRenderTargetView(Device, pResource, pDesc, DestDescriptor);
 
-            TraceLoggingWriteStop(
+            TraceLoggingLocalStop(
                 local, "ID3D12Device_CreateRenderTargetView", TLPArg(DestDescriptor.ptr, "Descriptor"));
         }
 
@@ -2424,7 +2758,7 @@ namespace {
                                 BOOL RTsSingleHandleToDescriptorRange,
                                 const D3D12_CPU_DESCRIPTOR_HANDLE* pDepthStencilDescriptor) {
             TraceLocalActivity(local);
-            TraceLoggingWriteStart(local,
+            TraceLoggingLocalStart(local,
                                    "ID3D12GraphicsCommandList_OMSetRenderTargets",
                                    TLPArg(Context, "Context"),
                                    TLArg(NumRenderTargetDescriptors, "NumRenderTargetDescriptors"),
@@ -2452,7 +2786,7 @@ namespace {
                                            RTsSingleHandleToDescriptorRange,
                                            pDepthStencilDescriptor);
 
-            TraceLoggingWriteStop(local, "ID3D12GraphicsCommandList_OMSetRenderTargets");
+            TraceLoggingLocalStop(local, "ID3D12GraphicsCommandList_OMSetRenderTargets");
         }
 
         DECLARE_DETOUR_FUNCTION(static void,
@@ -2466,7 +2800,7 @@ namespace {
                                 const D3D12_TEXTURE_COPY_LOCATION* pSrc,
                                 const D3D12_BOX* pSrcBox) {
             TraceLocalActivity(local);
-            TraceLoggingWriteStart(local,
+            TraceLoggingLocalStart(local,
                                    "ID3D12GraphicsCommandList_CopyTextureRegion",
                                    TLPArg(Context, "Context"),
                                    TLPArg(pDst->pResource, "Destination"),
@@ -2481,7 +2815,7 @@ namespace {
             assert(g_original_ID3D12GraphicsCommandList_CopyTextureRegion);
             g_original_ID3D12GraphicsCommandList_CopyTextureRegion(Context, pDst, DstX, DstY, DstZ, pSrc, pSrcBox);
 
-            TraceLoggingWriteStop(local, "ID3D12GraphicsCommandList_CopyTextureRegion");
+            TraceLoggingLocalStop(local, "ID3D12GraphicsCommandList_CopyTextureRegion");
         }
     };
 
@@ -2512,7 +2846,8 @@ namespace toolkit::graphics {
                                                   initialState,
                                                   d3d12Device->m_rtvHeap,
                                                   d3d12Device->m_dsvHeap,
-                                                  d3d12Device->m_rvHeap);
+                                                  d3d12Device->m_rvHeap,
+                                                  d3d12Device->m_submissionFence);
         }
         throw std::runtime_error("Not a D3D12 device");
     }
@@ -11,6 +11,452 @@ namespace toolkit::graphics::d3dcommon {
         DirectX::XMFLOAT4X4 ViewProjection;
     };
 
+    // A small pool of the wrappers passed to the intercepted events (set render target, copy texture), so that the
+    // hooks do not need to allocate on every call. A wrapper is only reused once no event handler holds on to it.
+    template <typename T, size_t Size = 8>
+    class EventWrapperPool {
+        struct Slot {
+            std::atomic<bool> busy{false};
+            std::shared_ptr<T> wrapper;
+        };
+
+      public:
+        // Reserve a wrapper for the duration of a hook. Wrappers must be declared after the lease that owns them.
+        class Lease {
+          public:
+            Lease(EventWrapperPool& pool) : m_slot(pool.reserve()) {
+            }
+
+            ~Lease() {
+                if (m_slot) {
+                    // Do not keep the native object alive past the hook.
+                    if (m_slot->wrapper && m_slot->wrapper.use_count() == 1) {
+                        m_slot->wrapper->detach();
+                    }
+                    m_slot->busy.store(false, std::memory_order_release);
+                }
+            }
+
+            // Empty if the wrapper must be created, otherwise it must be reset.
+            std::shared_ptr<T>& wrapper() {
+                return m_slot ? m_slot->wrapper : m_fallback;
+            }
+
+          private:
+            Slot* const m_slot;
+            std::shared_ptr<T> m_fallback;
+        };
+
+        // The wrappers hold a reference to the device: this must be called upon shutdown.
+        void clear() {
+            for (auto& slot : m_slots) {
+                bool expected = false;
+                while (!slot.busy.compare_exchange_weak(expected, true, std::memory_order_acquire)) {
+                    expected = false;
+                    std::this_thread::yield();
+                }
+                slot.wrapper.reset();
+                slot.busy.store(false, std::memory_order_release);
+            }
+        }
+
+      private:
+        Slot* reserve() {
+            for (auto& slot : m_slots) {
+                bool expected = false;
+                if (!slot.busy.load(std::memory_order_relaxed) &&
+                    slot.busy.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                    if (!slot.wrapper || slot.wrapper.use_count() == 1) {
+                        return &slot;
+                    }
+                    slot.busy.store(false, std::memory_order_release);
+                }
+            }
+
+            // All wrappers are in use (many threads, or held by an event handler).
+            return nullptr;
+        }
+
+        Slot m_slots[Size];
+    };
+
+    // A map from handles (descriptors, native pointers) to values. Look-ups are lock-free since they happen from the
+    // hooks on any command list recording thread. Updates are serialized, and the values (or tables) that they replace
+    // are reclaimed once all the look-ups that might still see them have completed (epoch-based reclamation).
+    // Reclaimed values are recycled by the next updates. The handle 0 is reserved.
+    template <typename T>
+    class LockFreeHandleMap {
+      public:
+        LockFreeHandleMap() {
+            m_table.store(new Table(InitialCapacity));
+        }
+
+        ~LockFreeHandleMap() {
+            delete m_table.load();
+            for (auto& retired : m_retired) {
+                for (auto table : retired.tables) {
+                    delete table;
+                }
+            }
+        }
+
+        // Returns true if the handle was not in the map.
+        bool insertOrAssign(uintptr_t handle, const T& value) {
+            std::unique_lock lock(m_writerLock);
+
+            Table* table = m_table.load(std::memory_order_relaxed);
+            if ((m_size.load(std::memory_order_relaxed) + 1) * 2 > table->capacity) {
+                table = grow(table);
+            }
+
+            T* const entry = allocateEntry(value);
+            Slot& slot = findSlot(*table, handle);
+            T* const previous = slot.entry.exchange(entry, std::memory_order_acq_rel);
+            if (!previous) {
+                // New key: publish it only once its entry is visible.
+                slot.key.store(handle, std::memory_order_release);
+                m_size++;
+            } else {
+                retire(previous, nullptr);
+            }
+
+            tryReclaim();
+
+            return !previous;
+        }
+
+        size_t size() const {
+            return m_size;
+        }
+
+        std::optional<T> find(uintptr_t handle) const {
+            const uint32_t epoch = enterRead();
+
+            std::optional<T> result;
+            const Table* const table = m_table.load(std::memory_order_acquire);
+            for (size_t i = hash(handle) & (table->capacity - 1);; i = (i + 1) & (table->capacity - 1)) {
+                const uintptr_t key = table->slots[i].key.load(std::memory_order_acquire);
+                if (key == handle) {
+                    result = *table->slots[i].entry.load(std::memory_order_acquire);
+                    break;
+                } else if (!key) {
+                    break;
+                }
+            }
+
+            m_readers[epoch & 1].fetch_sub(1, std::memory_order_release);
+
+            return result;
+        }
+
+        // The number of entries that were allocated, including the ones waiting to be recycled.
+        size_t getNumAllocatedEntries() const {
+            std::unique_lock lock(m_writerLock);
+            return m_entryPool.size();
+        }
+
+      private:
+        static constexpr size_t InitialCapacity = 256;
+
+        struct Slot {
+            std::atomic<uintptr_t> key{0};
+            std::atomic<T*> entry{nullptr};
+        };
+
+        struct Table {
+            Table(size_t capacity) : capacity(capacity), slots(std::make_unique<Slot[]>(capacity)) {
+            }
+
+            const size_t capacity;
+            std::unique_ptr<Slot[]> slots;
+        };
+
+        struct Retired {
+            std::vector<T*> entries;
+            std::vector<Table*> tables;
+        };
+
+        static size_t hash(uintptr_t key) {
+            // Handles are small increments from one another: mix the bits to avoid clustering.
+            return (size_t)(((uint64_t)key * 0x9e3779b97f4a7c15ull) >> 32);
+        }
+
+        // Must be called with the writer lock held.
+        T* allocateEntry(const T& value) {
+            if (m_freeEntries.empty()) {
+                // The entries never move, since a deque does not relocate its elements when growing at the end.
+                return &m_entryPool.emplace_back(value);
+            }
+            T* const entry = m_freeEntries.back();
+            m_freeEntries.pop_back();
+            *entry = value;
+            return entry;
+        }
+
+        // Must be called with the writer lock held.
+        Slot& findSlot(Table& table, uintptr_t key) {
+            for (size_t i = hash(key) & (table.capacity - 1);; i = (i + 1) & (table.capacity - 1)) {
+                const uintptr_t slotKey = table.slots[i].key.load(std::memory_order_relaxed);
+                if (slotKey == key || !slotKey) {
+                    return table.slots[i];
+                }
+            }
+        }
+
+        // Must be called with the writer lock held.
+        Table* grow(Table* table) {
+            // Readers may still use the old table, so we only move the entries (which remain shared) to a new table.
+            Table* const newTable = new Table(table->capacity * 2);
+            for (size_t i = 0; i < table->capacity; i++) {
+                const uintptr_t key = table->slots[i].key.load(std::memory_order_relaxed);
+                if (key) {
+                    Slot& slot = findSlot(*newTable, key);
+                    slot.entry.store(table->slots[i].entry.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    slot.key.store(key, std::memory_order_relaxed);
+                }
+            }
+            m_table.store(newTable, std::memory_order_release);
+            retire(nullptr, table);
+
+            return newTable;
+        }
+
+        uint32_t enterRead() const {
+            // Register with the current epoch. If the epoch moves while we register, we might be counted too late.
+            while (true) {
+                const uint32_t epoch = m_epoch.load();
+                m_readers[epoch & 1].fetch_add(1);
+                if (m_epoch.load() == epoch) {
+                    return epoch;
+                }
+                m_readers[epoch & 1].fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        // Must be called with the writer lock held.
+        void retire(T* entry, Table* table) {
+            Retired& retired = m_retired[m_epoch.load(std::memory_order_relaxed) & 1];
+            if (entry) {
+                retired.entries.push_back(entry);
+            }
+            if (table) {
+                retired.tables.push_back(table);
+            }
+        }
+
+        // Must be called with the writer lock held.
+        void tryReclaim() {
+            // The objects retired in the previous epoch may only be seen by readers registered in that epoch. Once they
+            // are all gone, we can recycle these objects and start a new epoch.
+            const uint32_t epoch = m_epoch.load(std::memory_order_relaxed);
+            if (m_readers[(epoch + 1) & 1].load() == 0) {
+                Retired& retired = m_retired[(epoch + 1) & 1];
+                m_freeEntries.insert(m_freeEntries.end(), retired.entries.begin(), retired.entries.end());
+                for (auto table : retired.tables) {
+                    delete table;
+                }
+                retired.entries.clear();
+                retired.tables.clear();
+                m_epoch.store(epoch + 1);
+            }
+        }
+
+        std::atomic<Table*> m_table;
+        std::atomic<size_t> m_size{0};
+
+        std::atomic<uint32_t> m_epoch{0};
+        mutable std::atomic<uint32_t> m_readers[2]{};
+        Retired m_retired[2];
+        std::deque<T> m_entryPool;
+        std::vector<T*> m_freeEntries;
+        mutable std::mutex m_writerLock;
+    };
+
+    // Open-addressing table (linear probing) keyed by a native pointer or handle, for a single thread. Entries are
+    // never removed, so there is no need for tombstones. The key 0 marks an empty slot.
+    template <typename Value>
+    class FlatHandleMap {
+      public:
+        FlatHandleMap() : m_slots(MinCapacity) {
+        }
+
+        // Returns the existing entry when the key was already present.
+        Value& insert(uint64_t key) {
+            assert(key != 0);
+            if ((m_size + 1) * 2 > m_slots.size()) {
+                rehash(m_slots.size() * 2);
+            }
+
+            Slot* slot = probe(key);
+            if (!slot->key) {
+                slot->key = key;
+                slot->value = {};
+                m_size++;
+            }
+            return slot->value;
+        }
+
+        const Value* find(uint64_t key) const {
+            if (!m_size || !key) {
+                return nullptr;
+            }
+
+            const Slot* slot = probe(key);
+            return slot->key ? &slot->value : nullptr;
+        }
+
+      private:
+        static constexpr size_t MinCapacity = 16;
+
+        struct Slot {
+            uint64_t key{0};
+            Value value{};
+        };
+
+        size_t hash(uint64_t key) const {
+            // Fibonacci hashing. Pointers are aligned, so the low bits carry little information.
+            return (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (m_slots.size() - 1);
+        }
+
+        Slot* probe(uint64_t key) {
+            return const_cast<Slot*>(std::as_const(*this).probe(key));
+        }
+
+        const Slot* probe(uint64_t key) const {
+            // The load factor is kept under 1/2, so there is always an empty slot to end the search.
+            const size_t mask = m_slots.size() - 1;
+            size_t index = hash(key);
+            while (m_slots[index].key && m_slots[index].key != key) {
+                index = (index + 1) & mask;
+            }
+            return &m_slots[index];
+        }
+
+        void rehash(size_t capacity) {
+            std::vector<Slot> slots(capacity);
+            std::swap(m_slots, slots);
+            for (const auto& slot : slots) {
+                if (slot.key) {
+                    *probe(slot.key) = slot;
+                }
+            }
+        }
+
+        std::vector<Slot> m_slots;
+        size_t m_size{0};
+    };
+
+    // The bookkeeping of a descriptor heap made of pages: allocation from a free list, deferred recycling of the
+    // released descriptors, and generations to detect the release of a stale descriptor. The caller owns the actual
+    // heaps and serializes the calls.
+    class DescriptorAllocator {
+      public:
+        struct Location {
+            size_t page;
+            uint32_t index;
+            uint32_t generation;
+        };
+
+        // The released descriptors are recycled after recycleLatency + 1 calls to recycle().
+        void initialize(uint32_t recycleLatency) {
+            m_recycleLatency = recycleLatency;
+            m_pages.clear();
+            m_freeList.clear();
+            m_pending.clear();
+            m_flushCount = 0;
+            m_numAllocated = 0;
+        }
+
+        void addPage(uint32_t numDescriptors) {
+            Page page;
+            page.size = numDescriptors;
+            page.offset = 0;
+            page.generations.resize(numDescriptors);
+            m_pages.push_back(std::move(page));
+        }
+
+        // Returns an empty location when all the pages are full.
+        std::optional<Location> allocate() {
+            size_t page;
+            uint32_t index;
+            if (!m_freeList.empty()) {
+                page = m_freeList.back().first;
+                index = m_freeList.back().second;
+                m_freeList.pop_back();
+            } else {
+                if (m_pages.empty() || m_pages.back().offset == m_pages.back().size) {
+                    return std::nullopt;
+                }
+                page = m_pages.size() - 1;
+                index = m_pages.back().offset++;
+            }
+            m_numAllocated++;
+
+            return Location{page, index, m_pages[page].generations[index]};
+        }
+
+        // Returns false if the descriptor is not allocated (or was already released).
+        bool free(size_t page, uint32_t index, uint32_t generation) {
+            if (page >= m_pages.size() || index >= m_pages[page].offset) {
+                return false;
+            }
+
+            // Bumping the generation catches a second release of the same descriptor.
+            uint32_t& currentGeneration = m_pages[page].generations[index];
+            if (currentGeneration != generation) {
+                return false;
+            }
+            currentGeneration++;
+
+            m_pending.push_back({m_flushCount, page, index});
+            m_numAllocated--;
+
+            return true;
+        }
+
+        // Invoked upon each flush of the device context, to recycle the descriptors that are no longer in use.
+        void recycle() {
+            m_flushCount++;
+            while (!m_pending.empty() && m_pending.front().flushCount + m_recycleLatency < m_flushCount) {
+                m_freeList.push_back({m_pending.front().page, m_pending.front().index});
+                m_pending.pop_front();
+            }
+        }
+
+        uint32_t getNumAllocated() const {
+            return m_numAllocated;
+        }
+
+        uint32_t getCapacity() const {
+            uint32_t capacity = 0;
+            for (const auto& page : m_pages) {
+                capacity += page.size;
+            }
+            return capacity;
+        }
+
+      private:
+        struct Page {
+            uint32_t size;
+            uint32_t offset;
+            std::vector<uint32_t> generations;
+        };
+
+        struct PendingDescriptor {
+            uint64_t flushCount;
+            size_t page;
+            uint32_t index;
+        };
+
+        uint32_t m_recycleLatency{0};
+
+        std::vector<Page> m_pages;
+        std::vector<std::pair<size_t, uint32_t>> m_freeList;
+        std::deque<PendingDescriptor> m_pending;
+        uint64_t m_flushCount{0};
+        uint32_t m_numAllocated{0};
+    };
+
     const std::string_view MeshShaders = R"_(
 struct VSOutput {
     float4 Pos : SV_POSITION;
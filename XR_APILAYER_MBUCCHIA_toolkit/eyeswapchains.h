@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "pch.h"
+
+#include "d3dcommon.h"
+#include "interfaces.h"
+
+namespace toolkit::graphics {
+
+    // The swapchain images of the eyes, to recognize them among the render targets and the copy destinations of the
+    // application. This look-up runs on every render target change of every frame.
+    class EyeSwapchainImages {
+      public:
+        struct Image {
+            std::optional<utilities::Eye> eye;
+            XrSwapchain swapchain{XR_NULL_HANDLE};
+            uint32_t imageIndex{0};
+        };
+
+        void registerImage(XrSwapchain swapchain,
+                           const std::shared_ptr<ITexture>& texture,
+                           uint32_t imageIndex,
+                           utilities::Eye eye) {
+            // An image used for both eyes was always reported as the left eye.
+            auto& image = m_images.insert((uint64_t)texture->getNativePtr());
+            if (!image.eye || eye == utilities::Eye::Left) {
+                image.eye = eye;
+                image.swapchain = swapchain;
+                image.imageIndex = imageIndex;
+            }
+
+            const auto& info = texture->getInfo();
+            const auto dimensions = std::make_pair(info.width, info.height);
+            if (std::find(m_dimensions.cbegin(), m_dimensions.cend(), dimensions) == m_dimensions.cend()) {
+                m_dimensions.push_back(dimensions);
+            }
+        }
+
+        const Image* find(const std::shared_ptr<ITexture>& texture) const {
+            // Most render targets of a frame (shadow maps, G-buffers, post-processing chain...) do not have the same
+            // size as the swapchains, and are dismissed here without hashing.
+            const auto& info = texture->getInfo();
+            if (info.arraySize != 1) {
+                return nullptr;
+            }
+            bool isEyeSize = false;
+            for (const auto& dimensions : m_dimensions) {
+                isEyeSize |= dimensions.first == info.width && dimensions.second == info.height;
+            }
+            if (!isEyeSize) {
+                return nullptr;
+            }
+
+            return m_images.find((uint64_t)texture->getNativePtr());
+        }
+
+      private:
+        d3dcommon::FlatHandleMap<Image> m_images;
+        std::vector<std::pair<uint32_t, uint32_t>> m_dimensions;
+    };
+
+} // namespace toolkit::graphics
@@ -42,7 +42,7 @@ namespace {
     class EyeTrackerBase : public IEyeTracker {
       public:
         EyeTrackerBase(OpenXrApi& openXR, std::shared_ptr<IConfigManager> configManager)
-            : m_openXR(openXR), m_configManager(configManager) {
+            : m_openXR(openXR), m_configManager(configManager), m_gazeFilter(CreateGazeFilter({})) {
         }
 
         ~EyeTrackerBase() override {
@@ -51,6 +51,7 @@ namespace {
 
         void beginSession(XrSession session) override {
             m_session = session;
+            m_gazeFilter->reset();
 
             // Create a reference space.
             {
@@ -83,7 +84,22 @@ namespace {
         }
 
         void update() {
+            // Nothing to do unless a setting changed.
+            const auto changeGeneration = m_configManager->getChangeGeneration();
+            if (changeGeneration == m_lastChangeGeneration) {
+                return;
+            }
+            m_lastChangeGeneration = changeGeneration;
+
             m_projectionDistance = m_configManager->getValue(SettingEyeProjectionDistance) / 100.f;
+
+            GazeFilterParameters parameters;
+            parameters.enabled = m_configManager->getValue(SettingEyeFilter);
+            parameters.minCutoff = m_configManager->getValue(SettingEyeFilterMinCutoff) / 100.f;
+            parameters.beta = m_configManager->getValue(SettingEyeFilterBeta) / 100.f;
+            parameters.saccadeVelocity = m_configManager->getValue(SettingEyeSaccadeThreshold) / 100.f;
+            m_gazeFilter->setParameters(parameters);
+            m_gazeLatency = m_configManager->getValue(SettingEyeLatency) * 1'000'000ll;
         }
 
         XrActionSet getActionSet() const override {
@@ -129,6 +145,9 @@ namespace {
                 m_valid = GetProjectedGaze(eyeInViewSpace, projectedPoint, m_gaze);
 
                 if (m_valid) {
+                    m_gazeFilter->addSample(m_frameTime - m_gazeLatency, m_gaze);
+                    m_gazeFilter->getGaze(m_frameTime, m_gaze);
+
                     m_eyeGazeState.leftPoint.x = m_gaze[0].x;
                     m_eyeGazeState.leftPoint.y = m_gaze[0].y;
                     m_eyeGazeState.rightPoint.x = m_gaze[1].x;
@@ -143,6 +162,10 @@ namespace {
             return true;
         }
 
+        GazeMovement getGazeMovement() const override {
+            return m_gazeFilter->getMovement();
+        }
+
         const EyeGazeState& getEyeGazeState() const override {
             return m_eyeGazeState;
         }
@@ -151,6 +174,9 @@ namespace {
         OpenXrApi& m_openXR;
         const std::shared_ptr<IConfigManager> m_configManager;
         float m_projectionDistance{2.f};
+        const std::shared_ptr<IGazeFilter> m_gazeFilter;
+        XrDuration m_gazeLatency{0};
+        uint64_t m_lastChangeGeneration{UINT64_MAX};
 
         XrSession m_session{XR_NULL_HANDLE};
         XrSpace m_viewSpace{XR_NULL_HANDLE};
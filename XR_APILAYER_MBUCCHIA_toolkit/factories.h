@@ -40,6 +40,18 @@ namespace toolkit {
 
         std::shared_ptr<ICpuTimer> CreateCpuTimer();
 
+        std::shared_ptr<IFrameStatisticsHistory> CreateFrameStatisticsHistory(size_t capacity);
+        std::shared_ptr<IQuantileEstimator> CreateQuantileEstimator(double quantile);
+        std::shared_ptr<IFrameStatisticsRecorder>
+        CreateFrameStatisticsRecorder(std::shared_ptr<IFrameStatisticsHistory> history,
+                                      const std::filesystem::path& path);
+
+        std::shared_ptr<IClock> CreateSystemClock();
+        std::shared_ptr<IFrameThrottler> CreateFrameThrottler(std::shared_ptr<IClock> clock);
+
+        std::shared_ptr<IAsyncFrameWaiter>
+        CreateAsyncFrameWaiter(std::function<XrResult(XrFrameState& frameState)> waitFrame);
+
         uint32_t GetScaledInputSize(uint32_t outputSize, int scalePercent, uint32_t blockSize);
 
         bool UpdateKeyState(bool& keyState, const std::vector<int>& vkModifiers, int vkKey, bool isRepeat);
@@ -61,6 +73,11 @@ namespace toolkit {
     namespace config {
 
         std::shared_ptr<IConfigManager> CreateConfigManager(const std::string& appName);
+        std::shared_ptr<IConfigManager> CreateConfigManager(std::shared_ptr<IConfigBackend> backend);
+
+        std::shared_ptr<IConfigBackend> CreateRegistryConfigBackend(const std::string& appName);
+        std::shared_ptr<IConfigBackend> CreateFileConfigBackend(const std::filesystem::path& path,
+                                                                std::shared_ptr<const IConfigBackend> globalBackend);
 
         std::pair<uint32_t, uint32_t> GetScaledDimensions(
             int settingScaling, int settingAnamophic, uint32_t outputWidth, uint32_t outputHeight, uint32_t blockSize);
@@ -96,6 +113,27 @@ namespace toolkit {
         std::shared_ptr<IImageProcessor> CreateImageProcessor(
             std::shared_ptr<toolkit::config::IConfigManager> configManager, std::shared_ptr<IDevice> graphicsDevice);
 
+        // Generate a VRS mask on the CPU. Each tile of the mask receives the minimum of its current value and the rate
+        // of the innermost ring containing it.
+        void GenerateShadingRateMask(const ShadingRateMaskConstants& constants,
+                                     uint32_t numRings,
+                                     uint8_t defaultRate,
+                                     uint32_t widthInTiles,
+                                     uint32_t heightInTiles,
+                                     uint8_t* mask,
+                                     size_t rowPitch,
+                                     bool allowSimd = true);
+
+        // Mark the tiles whose center is covered by a triangle mesh (with vertices in NDC).
+        void RasterizeTileCoverage(const std::vector<XrVector2f>& vertices,
+                                   const std::vector<uint32_t>& indices,
+                                   uint32_t widthInTiles,
+                                   uint32_t heightInTiles,
+                                   uint8_t* coverage,
+                                   size_t rowPitch);
+
+        std::shared_ptr<IRenderPassLearner> CreateRenderPassLearner();
+
         std::shared_ptr<IFrameAnalyzer>
         CreateFrameAnalyzer(std::shared_ptr<toolkit::config::IConfigManager> configManager,
                             std::shared_ptr<IDevice> graphicsDevice,
@@ -133,6 +171,9 @@ namespace toolkit {
                                  bool hasVisibilityMask,
                                  bool needMirroredPattern);
 
+        std::shared_ptr<IScreenshotService> CreateScreenshotService(std::shared_ptr<IDevice> graphicsDevice,
+                                                                    const ScreenshotServiceParameters& parameters = {});
+
         bool IsDeviceSupportingFP16(std::shared_ptr<IDevice> device);
 
         GpuArchitecture GetGpuArchitecture(UINT VendorId);
@@ -156,6 +197,12 @@ namespace toolkit {
         std::shared_ptr<input::IEyeTracker> CreatePimaxEyeTracker(
             toolkit::OpenXrApi& openXR, std::shared_ptr<toolkit::config::IConfigManager> configManager);
 
+        std::shared_ptr<input::IGazeFilter> CreateGazeFilter(const input::GazeFilterParameters& parameters);
+
+        std::shared_ptr<input::IGestureEngine> CreateGestureEngine(bool allowSimd = true);
+        std::shared_ptr<input::IHandPosePredictor>
+        CreateHandPosePredictor(const input::HandPredictionParameters& parameters);
+
     } // namespace input
 
     namespace menu {
@@ -22,6 +22,8 @@
 
 #include "pch.h"
 
+#include "d3dcommon.h"
+#include "eyeswapchains.h"
 #include "factories.h"
 #include "interfaces.h"
 #include "log.h"
@@ -32,8 +34,16 @@ namespace {
     using namespace toolkit::config;
     using namespace toolkit::log;
     using namespace toolkit::graphics;
+    using namespace toolkit::graphics::d3dcommon;
     using namespace toolkit::utilities;
 
+    // How long to look for a better heuristic before falling back to the swapchain acquisition order.
+    constexpr uint32_t FallbackDelay = 100;
+
+    // A render pass signature (learned or persisted) that does not match this many consecutive frames is dropped, so
+    // that the other heuristics get a chance. This is also how long a persisted signature has to prove itself.
+    constexpr uint32_t MaxSignatureMissedFrames = 100;
+
     class FrameAnalyzer : public IFrameAnalyzer {
       public:
         FrameAnalyzer(std::shared_ptr<IConfigManager> configManager,
@@ -42,12 +52,37 @@ namespace {
                       uint32_t displayHeight,
                       FrameAnalyzerHeuristic heuristic)
             : m_configManager(configManager), m_device(graphicsDevice), m_displayWidth(displayWidth),
-              m_displayHeight(displayHeight), m_forceHeuristic(heuristic) {
+              m_displayHeight(displayHeight), m_forceHeuristic(heuristic), m_passLearner(CreateRenderPassLearner()) {
+            // Use the signature learned during a previous session to predict the eyes from the first frame.
+            if (m_forceHeuristic == FrameAnalyzerHeuristic::LearnedSignature ||
+                m_forceHeuristic == FrameAnalyzerHeuristic::Unknown) {
+                RenderPassSignature signature;
+                signature.switchPass = (uint32_t)m_configManager->getValue(SettingFrameAnalyzerSwitchPass);
+                signature.switchOccurrence =
+                    (uint32_t)std::max(0, m_configManager->getValue(SettingFrameAnalyzerSwitchOccurrence));
+                if (signature.isValid()) {
+                    Log("Using learned render pass signature %08x/%u\n",
+                        signature.switchPass,
+                        signature.switchOccurrence);
+                    m_passLearner->setSignature(signature);
+                    m_persistedSignature = signature;
+                    m_heuristic = FrameAnalyzerHeuristic::LearnedSignature;
+                    m_shouldPredictEye = true;
+                }
+            }
         }
 
-        void registerColorSwapchainImage(XrSwapchain swapchain, std::shared_ptr<ITexture> source, Eye eye) override {
-            m_eyeSwapchain[(int)eye].insert(swapchain);
-            m_eyeSwapchainImages[(int)eye].insert(source->getNativePtr());
+        void registerColorSwapchainImage(XrSwapchain swapchain,
+                                         std::shared_ptr<ITexture> source,
+                                         uint32_t imageIndex,
+                                         Eye eye) override {
+            // A swapchain used for both eyes was always reported as the left eye.
+            auto& swapchainEye = m_eyeSwapchains.insert((uint64_t)swapchain);
+            if (!swapchainEye || eye == Eye::Left) {
+                swapchainEye = eye;
+            }
+
+            m_eyeSwapchainImages.registerImage(swapchain, source, imageIndex, eye);
         }
 
         void resetForFrame() override {
@@ -57,12 +92,33 @@ namespace {
             m_eyePrediction = m_firstEye;
             m_isPredictionValid = m_shouldPredictEye;
 
+            if (isLearningPasses()) {
+                m_passLearner->resetForFrame();
+                if (m_heuristic == FrameAnalyzerHeuristic::LearnedSignature && !m_passLearner->getEyeHint()) {
+                    m_isPredictionValid = false;
+                }
+            }
+
             if (m_fallbackDelay) {
                 m_fallbackDelay--;
             }
         }
 
         void prepareForEndFrame() override {
+            if (isLearningPasses()) {
+                m_passLearner->endFrame();
+            }
+
+            if (m_heuristic == FrameAnalyzerHeuristic::LearnedSignature) {
+                m_signatureMissedFrames = m_passLearner->getEyeHint() ? 0 : m_signatureMissedFrames + 1;
+                if (m_signatureMissedFrames >= MaxSignatureMissedFrames) {
+                    Log("Render pass signature %08x/%u does not match the frames anymore\n",
+                        m_passLearner->getSignature().switchPass,
+                        m_passLearner->getSignature().switchOccurrence);
+                    forgetSignature();
+                }
+            }
+
             if (m_heuristic == FrameAnalyzerHeuristic::Unknown) {
                 if (m_hasSeenLeftEye && m_hasSeenRightEye &&
                     (m_forceHeuristic == FrameAnalyzerHeuristic::ForwardRender ||
@@ -76,6 +132,12 @@ namespace {
                     Log("Detected deferred rendering with copy\n");
                     m_heuristic = FrameAnalyzerHeuristic::DeferredCopy;
                     m_firstEye = m_firstEyeCopy;
+                } else if (m_passLearner->getSignature().isValid() &&
+                           (m_forceHeuristic == FrameAnalyzerHeuristic::LearnedSignature ||
+                            m_forceHeuristic == FrameAnalyzerHeuristic::Unknown)) {
+                    Log("Detected render pass signature\n");
+                    m_heuristic = FrameAnalyzerHeuristic::LearnedSignature;
+                    m_firstEye = Eye::Left;
                 } else if (!m_fallbackDelay && (m_forceHeuristic == FrameAnalyzerHeuristic::Fallback ||
                                                 m_forceHeuristic == FrameAnalyzerHeuristic::Unknown)) {
                     Log("Fallback to swapchain acquisition\n");
@@ -88,23 +150,41 @@ namespace {
 
                 m_shouldPredictEye = m_heuristic != FrameAnalyzerHeuristic::Unknown;
             }
+
+            // Remember the signature for the next session. It may also have been re-learned (eg: after a change of
+            // resolution).
+            if (m_heuristic == FrameAnalyzerHeuristic::LearnedSignature) {
+                const auto& signature = m_passLearner->getSignature();
+                if (signature != m_persistedSignature) {
+                    Log("Learned render pass signature %08x/%u\n", signature.switchPass, signature.switchOccurrence);
+                    m_configManager->setValue(SettingFrameAnalyzerSwitchPass, (int)signature.switchPass);
+                    m_configManager->setValue(SettingFrameAnalyzerSwitchOccurrence, (int)signature.switchOccurrence);
+                    m_persistedSignature = signature;
+                }
+            }
         }
 
         void onSetRenderTarget(std::shared_ptr<graphics::IContext> context,
                                std::shared_ptr<ITexture> renderTarget) override {
-            const auto& info = renderTarget->getInfo();
-            if (info.arraySize != 1) {
-                return;
+            if (isLearningPasses()) {
+                const auto& info = renderTarget->getInfo();
+                m_passLearner->recordPass(RenderPassEvent::SetRenderTarget, info.width, info.height, info.format);
+                if (m_heuristic == FrameAnalyzerHeuristic::LearnedSignature) {
+                    m_eyePrediction = m_passLearner->getEyeHint().value_or(m_eyePrediction);
+                }
             }
 
-            const void* const nativePtr = renderTarget->getNativePtr();
+            const auto image = m_eyeSwapchainImages.find(renderTarget);
+            if (!image) {
+                return;
+            }
 
             // Handle when the application uses the swapchain image directly.
-            if (m_eyeSwapchainImages[0].find(nativePtr) != m_eyeSwapchainImages[0].cend()) {
+            if (image->eye == Eye::Left) {
                 TraceLoggingWrite(g_traceProvider, "FrameAnalyzer_DetectedLeftEyeForwardRender");
                 m_eyePrediction = Eye::Left;
                 m_hasSeenLeftEye = true;
-            } else if (m_eyeSwapchainImages[1].find(nativePtr) != m_eyeSwapchainImages[1].cend()) {
+            } else {
                 TraceLoggingWrite(g_traceProvider, "FrameAnalyzer_DetectedRightEyeForwardRender");
                 m_eyePrediction = Eye::Right;
                 m_hasSeenRightEye = true;
@@ -118,14 +198,21 @@ namespace {
                            std::shared_ptr<ITexture> destination,
                            int sourceSlice = -1,
                            int destinationSlice = -1) override {
-            if (destination->getInfo().arraySize != 1) {
-                return;
+            if (isLearningPasses()) {
+                const auto& info = destination->getInfo();
+                m_passLearner->recordPass(RenderPassEvent::CopyTexture, info.width, info.height, info.format);
+                if (m_heuristic == FrameAnalyzerHeuristic::LearnedSignature) {
+                    m_eyePrediction = m_passLearner->getEyeHint().value_or(m_eyePrediction);
+                }
             }
 
-            const void* const nativePtr = destination->getNativePtr();
+            const auto image = m_eyeSwapchainImages.find(destination);
+            if (!image) {
+                return;
+            }
 
             // Handle when the application copies the texture to the swapchain image mid-pass. This is what FS2020 does.
-            if (m_eyeSwapchainImages[0].find(nativePtr) != m_eyeSwapchainImages[0].cend()) {
+            if (image->eye == Eye::Left) {
                 TraceLoggingWrite(g_traceProvider, "FrameAnalyzer_DetectedLeftEyeCopyOut");
 
                 if (!m_hasCopiedLeftEye && !m_hasCopiedRightEye) {
@@ -135,7 +222,7 @@ namespace {
                 // Switch to right eye now.
                 m_eyePrediction = Eye::Right;
                 m_hasCopiedLeftEye = true;
-            } else if (m_eyeSwapchainImages[1].find(nativePtr) != m_eyeSwapchainImages[1].cend()) {
+            } else {
                 TraceLoggingWrite(g_traceProvider, "FrameAnalyzer_DetectedRightEyeCopyOut");
 
                 if (!m_hasCopiedLeftEye && !m_hasCopiedRightEye) {
@@ -149,13 +236,18 @@ namespace {
         }
 
         void onAcquireSwapchain(XrSwapchain swapchain) override {
+            const auto eye = m_eyeSwapchains.find((uint64_t)swapchain);
+            if (!eye) {
+                return;
+            }
+
             // If we don't have a better heuristic, just use the swapchain acquisition order.
-            if (m_eyeSwapchain[0].find(swapchain) != m_eyeSwapchain[0].cend()) {
+            if (*eye == Eye::Left) {
                 TraceLoggingWrite(g_traceProvider, "FrameAnalyzer_DetectedLeftEyeSwapchainAcquisition");
                 if (m_heuristic == FrameAnalyzerHeuristic::Fallback) {
                     m_eyePrediction = Eye::Left;
                 }
-            } else if (m_eyeSwapchain[1].find(swapchain) != m_eyeSwapchain[1].cend()) {
+            } else {
                 TraceLoggingWrite(g_traceProvider, "FrameAnalyzer_DetectedRightEyeSwapchainAcquisition");
                 if (m_heuristic == FrameAnalyzerHeuristic::Fallback) {
                     m_eyePrediction = Eye::Right;
@@ -164,14 +256,19 @@ namespace {
         }
 
         void onReleaseSwapchain(XrSwapchain swapchain) override {
+            const auto eye = m_eyeSwapchains.find((uint64_t)swapchain);
+            if (!eye) {
+                return;
+            }
+
             // If we don't have a better heuristic, just use the swapchain acquisition order.
             // Switch eye once a swapchain is released.
-            if (m_eyeSwapchain[0].find(swapchain) != m_eyeSwapchain[0].cend()) {
+            if (*eye == Eye::Left) {
                 TraceLoggingWrite(g_traceProvider, "FrameAnalyzer_DetectedLeftEyeSwapchainRelease");
                 if (m_heuristic == FrameAnalyzerHeuristic::Fallback) {
                     m_eyePrediction = Eye::Right;
                 }
-            } else if (m_eyeSwapchain[1].find(swapchain) != m_eyeSwapchain[1].cend()) {
+            } else {
                 TraceLoggingWrite(g_traceProvider, "FrameAnalyzer_DetectedRightEyeSwapchainRelease");
                 if (m_heuristic == FrameAnalyzerHeuristic::Fallback) {
                     m_eyePrediction = Eye::Left;
@@ -191,14 +288,36 @@ namespace {
         }
 
       private:
+        void forgetSignature() {
+            m_passLearner->setSignature({});
+            m_heuristic = FrameAnalyzerHeuristic::Unknown;
+            m_signatureMissedFrames = 0;
+
+            // Give the signature the same chance to be learned again as at the start of the session.
+            m_fallbackDelay = FallbackDelay;
+
+            if (m_persistedSignature.isValid()) {
+                m_configManager->deleteValue(SettingFrameAnalyzerSwitchPass);
+                m_configManager->deleteValue(SettingFrameAnalyzerSwitchOccurrence);
+                m_persistedSignature = {};
+            }
+        }
+
+        // The render passes are only analyzed until a better heuristic is found.
+        bool isLearningPasses() const {
+            return m_heuristic == FrameAnalyzerHeuristic::Unknown ||
+                   m_heuristic == FrameAnalyzerHeuristic::LearnedSignature;
+        }
+
         const std::shared_ptr<IConfigManager> m_configManager;
         const std::shared_ptr<IDevice> m_device;
         const uint32_t m_displayWidth;
         const uint32_t m_displayHeight;
         const FrameAnalyzerHeuristic m_forceHeuristic;
+        const std::shared_ptr<IRenderPassLearner> m_passLearner;
 
-        std::set<const void*> m_eyeSwapchainImages[ViewCount];
-        std::set<XrSwapchain> m_eyeSwapchain[ViewCount];
+        EyeSwapchainImages m_eyeSwapchainImages;
+        FlatHandleMap<std::optional<Eye>> m_eyeSwapchains;
 
         bool m_hasSeenLeftEye{false};
         bool m_hasSeenRightEye{false};
@@ -212,7 +331,10 @@ namespace {
         Eye m_eyePrediction;
         Eye m_firstEye{Eye::Left};
 
-        uint32_t m_fallbackDelay{100};
+        uint32_t m_fallbackDelay{FallbackDelay};
+
+        RenderPassSignature m_persistedSignature;
+        uint32_t m_signatureMissedFrames{0};
     };
 
 } // namespace
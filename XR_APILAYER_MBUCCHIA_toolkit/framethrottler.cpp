@@ -0,0 +1,226 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+#include "log.h"
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace {
+
+    using namespace toolkit;
+    using namespace toolkit::log;
+    using namespace toolkit::utilities;
+
+    using namespace std::chrono_literals;
+
+    // Head start given to the application before the deadline, to absorb the cost of xrWaitFrame() itself.
+    constexpr int64_t RunningStart = std::chrono::nanoseconds(500us).count();
+
+    // Bounds for the portion of the wait that is busy-waited rather than slept.
+    constexpr int64_t MinSpinThreshold = std::chrono::nanoseconds(100us).count();
+    constexpr int64_t MaxSpinThreshold = std::chrono::nanoseconds(2ms).count();
+
+    // Smoothing of the sleep overshoot estimates (exponentially weighted moving average).
+    constexpr double OvershootSmoothing = 0.1;
+
+    // How close to a multiple of the display period the throttling period must be to snap to it.
+    constexpr double DisplayPeriodSnapTolerance = 0.1;
+
+    class SystemClock : public IClock {
+      public:
+        SystemClock() {
+            // Prefer a high-resolution timer (Windows 10 1803+), which gives a much tighter wake-up than Sleep().
+            m_timer.reset(CreateWaitableTimerExW(
+                nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_MODIFY_STATE | SYNCHRONIZE));
+        }
+
+        int64_t now() const override {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        void sleepUntil(int64_t time) override {
+            const int64_t duration = time - now();
+            if (duration <= 0) {
+                return;
+            }
+
+            if (m_timer) {
+                // Relative due time, in 100ns units.
+                LARGE_INTEGER dueTime;
+                dueTime.QuadPart = -(duration / 100);
+                if (SetWaitableTimer(m_timer.get(), &dueTime, 0, nullptr, nullptr, FALSE)) {
+                    WaitForSingleObject(m_timer.get(), INFINITE);
+                    return;
+                }
+            }
+
+            std::this_thread::sleep_for(std::chrono::nanoseconds(duration));
+        }
+
+        void spin() override {
+            YieldProcessor();
+        }
+
+      private:
+        wil::unique_handle m_timer;
+    };
+
+    // Paces frames with a hybrid sleep-then-spin wait. The portion that is slept is adjusted based on the measured
+    // scheduler overshoot, and the deadlines are derived from the previous deadline (rather than the wake-up time) so
+    // that errors do not accumulate. When the runtime reports its display period, the deadlines are phase-aligned to
+    // the refresh so that the application does not wait at a random point in the V-sync interval.
+    class FrameThrottler : public IFrameThrottler {
+      public:
+        FrameThrottler(std::shared_ptr<IClock> clock) : m_clock(clock) {
+            reset();
+        }
+
+        void throttle(uint32_t targetFrameRate) override {
+            if (!targetFrameRate) {
+                return;
+            }
+
+            const int64_t period = getThrottlingPeriod(targetFrameRate);
+            const int64_t now = m_clock->now();
+
+            int64_t deadline;
+            if (m_lastRuntimeWakeUp && now - m_lastRuntimeWakeUp < 2 * period) {
+                // Anchor to the last V-sync-aligned wake-up from the runtime.
+                deadline = m_lastRuntimeWakeUp + period - RunningStart;
+            } else if (m_lastDeadline) {
+                deadline = m_lastDeadline + period;
+            } else {
+                deadline = now + period;
+            }
+
+            if (deadline < now - period) {
+                // We fell behind (eg: loading screen). Do not try to catch up with several short frames.
+                deadline = now;
+            }
+            m_lastDeadline = deadline;
+
+            if (deadline - now > m_spinThreshold) {
+                const int64_t sleepTarget = deadline - m_spinThreshold;
+                m_clock->sleepUntil(sleepTarget);
+                updateSpinThreshold(m_clock->now() - sleepTarget);
+            }
+
+            int64_t wakeUp = m_clock->now();
+            while (wakeUp < deadline) {
+                m_clock->spin();
+                wakeUp = m_clock->now();
+            }
+
+            m_lastWakeUpError = wakeUp - deadline;
+
+            TraceLoggingWrite(g_traceProvider,
+                              "FrameThrottler",
+                              TLArg(period, "Period"),
+                              TLArg(m_lastWakeUpError, "WakeUpError"),
+                              TLArg(m_spinThreshold, "SpinThreshold"));
+        }
+
+        void onFrameWaited(XrDuration predictedDisplayPeriod) override {
+            m_lastRuntimeWakeUp = m_clock->now();
+            m_displayPeriod = predictedDisplayPeriod;
+        }
+
+        void reset() override {
+            m_lastDeadline = 0;
+            m_lastRuntimeWakeUp = 0;
+            m_displayPeriod = 0;
+            m_lastWakeUpError = 0;
+            m_overshootMean = 0;
+            m_overshootDeviation = 0;
+            m_spinThreshold = MaxSpinThreshold;
+        }
+
+        int64_t getLastWakeUpError() const override {
+            return m_lastWakeUpError;
+        }
+
+        int64_t getSpinThreshold() const override {
+            return m_spinThreshold;
+        }
+
+      private:
+        int64_t getThrottlingPeriod(uint32_t targetFrameRate) const {
+            const int64_t period = 1'000'000'000ll / targetFrameRate;
+            if (m_displayPeriod <= 0) {
+                return period;
+            }
+
+            // Snap to a multiple of the display period when close enough, to avoid beating against the refresh.
+            const int64_t multiple = std::max<int64_t>((period + m_displayPeriod / 2) / m_displayPeriod, 1);
+            const int64_t snapped = multiple * m_displayPeriod;
+            if (std::abs(snapped - period) <= DisplayPeriodSnapTolerance * m_displayPeriod) {
+                return snapped;
+            }
+
+            return period;
+        }
+
+        void updateSpinThreshold(int64_t overshoot) {
+            overshoot = std::max<int64_t>(overshoot, 0);
+
+            const double error = overshoot - m_overshootMean;
+            m_overshootMean += OvershootSmoothing * error;
+            m_overshootDeviation += OvershootSmoothing * (std::abs(error) - m_overshootDeviation);
+
+            m_spinThreshold = std::clamp(static_cast<int64_t>(m_overshootMean + 4 * m_overshootDeviation),
+                                         MinSpinThreshold,
+                                         MaxSpinThreshold);
+        }
+
+        const std::shared_ptr<IClock> m_clock;
+
+        int64_t m_lastDeadline;
+        int64_t m_lastRuntimeWakeUp;
+        XrDuration m_displayPeriod;
+        int64_t m_lastWakeUpError;
+
+        double m_overshootMean;
+        double m_overshootDeviation;
+        int64_t m_spinThreshold;
+    };
+
+} // namespace
+
+namespace toolkit::utilities {
+
+    std::shared_ptr<IClock> CreateSystemClock() {
+        return std::make_shared<SystemClock>();
+    }
+
+    std::shared_ptr<IFrameThrottler> CreateFrameThrottler(std::shared_ptr<IClock> clock) {
+        return std::make_shared<FrameThrottler>(clock);
+    }
+
+} // namespace toolkit::utilities
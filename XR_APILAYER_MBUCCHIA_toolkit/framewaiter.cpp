@@ -0,0 +1,181 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+#include "log.h"
+
+namespace {
+
+    using namespace toolkit;
+    using namespace toolkit::log;
+    using namespace toolkit::utilities;
+
+    // The runtime only lets us have one waited frame outstanding (a second xrWaitFrame() blocks until the first frame
+    // is begun), so the wait thread is never more than one runtime frame ahead. The pipeline depth instead bounds how
+    // many frames we let the application start before that runtime frame is ready.
+    class AsyncFrameWaiter : public IAsyncFrameWaiter {
+      public:
+        AsyncFrameWaiter(std::function<XrResult(XrFrameState& frameState)> waitFrame) : m_waitFrame(waitFrame) {
+            m_thread = std::thread([&] { waiterThread(); });
+        }
+
+        ~AsyncFrameWaiter() override {
+            {
+                std::unique_lock lock(m_lock);
+                m_stop = true;
+            }
+            m_wakeUp.notify_all();
+            m_thread.join();
+        }
+
+        void start(XrTime lastPredictedDisplayTime, XrDuration lastPredictedDisplayPeriod) override {
+            std::unique_lock lock(m_lock);
+            if (m_pending) {
+                return;
+            }
+
+            TraceLoggingWrite(g_traceProvider, "AsyncWaitStart");
+
+            m_lastPredictedDisplayTime = lastPredictedDisplayTime;
+            m_lastPredictedDisplayPeriod = lastPredictedDisplayPeriod;
+            m_numFramesPolled = 0;
+            m_completed = false;
+            m_pending = true;
+            m_wakeUp.notify_all();
+        }
+
+        bool isPending() const override {
+            std::unique_lock lock(m_lock);
+            return m_pending;
+        }
+
+        void pollFrame(XrFrameState& frameState) override {
+            std::unique_lock lock(m_lock);
+
+            if (m_numFramesPolled >= m_pipelineDepth && !m_completed) {
+                TraceLocalActivity(local);
+
+                TraceLoggingLocalStart(local, "AsyncWaitNow");
+                m_completion.wait(lock, [&] { return m_completed; });
+                TraceLoggingLocalStop(local, "AsyncWaitNow");
+            }
+
+            // Extrapolate from the last frame known to the runtime. When the runtime frame is not ready yet, the
+            // application is at least one frame ahead of it.
+            const uint32_t framesAhead = m_numFramesPolled + (m_completed ? 0 : 1);
+            frameState.predictedDisplayTime = m_lastPredictedDisplayTime + framesAhead * m_lastPredictedDisplayPeriod;
+            frameState.predictedDisplayPeriod = m_lastPredictedDisplayPeriod;
+            frameState.shouldRender = XR_TRUE;
+            m_numFramesPolled++;
+        }
+
+        void waitForFrame() override {
+            std::unique_lock lock(m_lock);
+            m_completion.wait(lock, [&] { return !m_pending || m_completed; });
+        }
+
+        bool waitForFrame(std::chrono::milliseconds timeout) override {
+            std::unique_lock lock(m_lock);
+            return m_completion.wait_for(lock, timeout, [&] { return !m_pending || m_completed; });
+        }
+
+        XrFrameState consumeFrame() override {
+            std::unique_lock lock(m_lock);
+            m_pending = false;
+            return m_frameState;
+        }
+
+        void setPipelineDepth(uint32_t depth) override {
+            std::unique_lock lock(m_lock);
+            m_pipelineDepth = std::max(depth, 1u);
+        }
+
+      private:
+        void waiterThread() {
+            std::unique_lock lock(m_lock);
+            while (true) {
+                m_wakeUp.wait(lock, [&] { return m_stop || (m_pending && !m_completed); });
+                if (m_stop) {
+                    break;
+                }
+
+                lock.unlock();
+
+                TraceLocalActivity(local);
+
+                XrFrameState frameState{XR_TYPE_FRAME_STATE};
+                TraceLoggingLocalStart(local, "AsyncWaitFrame");
+                const XrResult result = m_waitFrame(frameState);
+                TraceLoggingLocalStop(local,
+                                      "AsyncWaitFrame",
+                                      TLArg(xr::ToCString(result), "Result"),
+                                      TLArg(frameState.predictedDisplayTime, "PredictedDisplayTime"),
+                                      TLArg(frameState.predictedDisplayPeriod, "PredictedDisplayPeriod"));
+
+                lock.lock();
+
+                if (XR_SUCCEEDED(result)) {
+                    m_frameState = frameState;
+                    m_lastPredictedDisplayTime = frameState.predictedDisplayTime;
+                    m_lastPredictedDisplayPeriod = frameState.predictedDisplayPeriod;
+                } else {
+                    // Do not leave the application hanging. The next xrBeginFrame() will surface the error.
+                    Log("xrWaitFrame failed in Turbo Mode: %s\n", xr::ToCString(result));
+                    m_frameState = {XR_TYPE_FRAME_STATE};
+                    m_frameState.predictedDisplayTime = m_lastPredictedDisplayTime + m_lastPredictedDisplayPeriod;
+                    m_frameState.predictedDisplayPeriod = m_lastPredictedDisplayPeriod;
+                }
+                m_completed = true;
+                m_completion.notify_all();
+            }
+        }
+
+        const std::function<XrResult(XrFrameState& frameState)> m_waitFrame;
+
+        std::thread m_thread;
+        mutable std::mutex m_lock;
+        std::condition_variable m_wakeUp;
+        std::condition_variable m_completion;
+        bool m_stop{false};
+
+        bool m_pending{false};
+        bool m_completed{false};
+        uint32_t m_numFramesPolled{0};
+        uint32_t m_pipelineDepth{1};
+        XrFrameState m_frameState{XR_TYPE_FRAME_STATE};
+        XrTime m_lastPredictedDisplayTime{0};
+        XrDuration m_lastPredictedDisplayPeriod{0};
+    };
+
+} // namespace
+
+namespace toolkit::utilities {
+
+    std::shared_ptr<IAsyncFrameWaiter>
+    CreateAsyncFrameWaiter(std::function<XrResult(XrFrameState& frameState)> waitFrame) {
+        return std::make_shared<AsyncFrameWaiter>(waitFrame);
+    }
+
+} // namespace toolkit::utilities
@@ -43,7 +43,7 @@ namespace LAYER_NAMESPACE {
                                       const struct XrApiLayerCreateInfo* const apiLayerInfo,
                                       XrInstance* const instance) {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local, "xrCreateApiLayerInstance");
+        TraceLoggingLocalStart(local, "xrCreateApiLayerInstance");
 
         if (!apiLayerInfo || apiLayerInfo->structType != XR_LOADER_INTERFACE_STRUCT_API_LAYER_CREATE_INFO ||
             apiLayerInfo->structVersion != XR_API_LAYER_CREATE_INFO_STRUCT_VERSION ||
@@ -289,7 +289,7 @@ namespace LAYER_NAMESPACE {
             }
         }
 
-        TraceLoggingWriteStop(local, "xrCreateApiLayerInstance", TLArg((int)result, "Result"));
+        TraceLoggingLocalStop(local, "xrCreateApiLayerInstance", TLArg((int)result, "Result"));
 
         return result;
     }
@@ -297,7 +297,7 @@ namespace LAYER_NAMESPACE {
     // Handle cleanup of the layer's singleton.
     XrResult xrDestroyInstance(XrInstance instance) {
         TraceLocalActivity(local);
-        TraceLoggingWriteStart(local, "xrDestroyInstance");
+        TraceLoggingLocalStart(local, "xrDestroyInstance");
 
         XrResult result;
         try {
@@ -310,7 +310,7 @@ namespace LAYER_NAMESPACE {
             result = XR_ERROR_RUNTIME_FAILURE;
         }
 
-        TraceLoggingWriteStop(local, "xrDestroyInstance", TLArg((int)result, "Result"));
+        TraceLoggingLocalStop(local, "xrDestroyInstance", TLArg((int)result, "Result"));
 
         return result;
     }
@@ -42,7 +42,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrPollEvent(XrInstance instance, XrEventDataBuffer* eventData)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrPollEvent");
+		TraceLoggingLocalStart(local, "xrPollEvent");
 
 		XrResult result;
 		try
@@ -56,7 +56,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrPollEvent", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrPollEvent", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -64,7 +64,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrGetSystem(XrInstance instance, const XrSystemGetInfo* getInfo, XrSystemId* systemId)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrGetSystem");
+		TraceLoggingLocalStart(local, "xrGetSystem");
 
 		XrResult result;
 		try
@@ -78,7 +78,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrGetSystem", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrGetSystem", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -86,7 +86,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrCreateSession(XrInstance instance, const XrSessionCreateInfo* createInfo, XrSession* session)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrCreateSession");
+		TraceLoggingLocalStart(local, "xrCreateSession");
 
 		XrResult result;
 		try
@@ -100,7 +100,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrCreateSession", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrCreateSession", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -108,7 +108,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrDestroySession(XrSession session)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrDestroySession");
+		TraceLoggingLocalStart(local, "xrDestroySession");
 
 		XrResult result;
 		try
@@ -122,7 +122,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrDestroySession", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrDestroySession", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -130,7 +130,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo* createInfo, XrSpace* space)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrCreateActionSpace");
+		TraceLoggingLocalStart(local, "xrCreateActionSpace");
 
 		XrResult result;
 		try
@@ -144,7 +144,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrCreateActionSpace", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrCreateActionSpace", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -152,7 +152,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrLocateSpace");
+		TraceLoggingLocalStart(local, "xrLocateSpace");
 
 		XrResult result;
 		try
@@ -166,7 +166,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrLocateSpace", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrLocateSpace", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -174,7 +174,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrDestroySpace(XrSpace space)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrDestroySpace");
+		TraceLoggingLocalStart(local, "xrDestroySpace");
 
 		XrResult result;
 		try
@@ -188,7 +188,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrDestroySpace", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrDestroySpace", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -196,7 +196,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrEnumerateViewConfigurationViews(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrViewConfigurationView* views)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrEnumerateViewConfigurationViews");
+		TraceLoggingLocalStart(local, "xrEnumerateViewConfigurationViews");
 
 		XrResult result;
 		try
@@ -210,7 +210,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrEnumerateViewConfigurationViews", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrEnumerateViewConfigurationViews", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -218,7 +218,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrCreateSwapchain(XrSession session, const XrSwapchainCreateInfo* createInfo, XrSwapchain* swapchain)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrCreateSwapchain");
+		TraceLoggingLocalStart(local, "xrCreateSwapchain");
 
 		XrResult result;
 		try
@@ -232,7 +232,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrCreateSwapchain", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrCreateSwapchain", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -240,7 +240,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrDestroySwapchain(XrSwapchain swapchain)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrDestroySwapchain");
+		TraceLoggingLocalStart(local, "xrDestroySwapchain");
 
 		XrResult result;
 		try
@@ -254,7 +254,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrDestroySwapchain", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrDestroySwapchain", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -262,7 +262,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t imageCapacityInput, uint32_t* imageCountOutput, XrSwapchainImageBaseHeader* images)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrEnumerateSwapchainImages");
+		TraceLoggingLocalStart(local, "xrEnumerateSwapchainImages");
 
 		XrResult result;
 		try
@@ -276,7 +276,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrEnumerateSwapchainImages", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrEnumerateSwapchainImages", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -284,7 +284,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo* acquireInfo, uint32_t* index)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrAcquireSwapchainImage");
+		TraceLoggingLocalStart(local, "xrAcquireSwapchainImage");
 
 		XrResult result;
 		try
@@ -298,7 +298,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrAcquireSwapchainImage", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrAcquireSwapchainImage", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -306,7 +306,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo* waitInfo)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrWaitSwapchainImage");
+		TraceLoggingLocalStart(local, "xrWaitSwapchainImage");
 
 		XrResult result;
 		try
@@ -320,7 +320,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrWaitSwapchainImage", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrWaitSwapchainImage", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -328,7 +328,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo* releaseInfo)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrReleaseSwapchainImage");
+		TraceLoggingLocalStart(local, "xrReleaseSwapchainImage");
 
 		XrResult result;
 		try
@@ -342,7 +342,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrReleaseSwapchainImage", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrReleaseSwapchainImage", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -350,7 +350,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrBeginSession(XrSession session, const XrSessionBeginInfo* beginInfo)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrBeginSession");
+		TraceLoggingLocalStart(local, "xrBeginSession");
 
 		XrResult result;
 		try
@@ -364,7 +364,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrBeginSession", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrBeginSession", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -372,7 +372,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrEndSession(XrSession session)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrEndSession");
+		TraceLoggingLocalStart(local, "xrEndSession");
 
 		XrResult result;
 		try
@@ -386,7 +386,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrEndSession", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrEndSession", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -394,7 +394,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrWaitFrame(XrSession session, const XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrWaitFrame");
+		TraceLoggingLocalStart(local, "xrWaitFrame");
 
 		XrResult result;
 		try
@@ -408,7 +408,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrWaitFrame", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrWaitFrame", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -416,7 +416,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrBeginFrame(XrSession session, const XrFrameBeginInfo* frameBeginInfo)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrBeginFrame");
+		TraceLoggingLocalStart(local, "xrBeginFrame");
 
 		XrResult result;
 		try
@@ -430,7 +430,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrBeginFrame", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrBeginFrame", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -438,7 +438,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrEndFrame(XrSession session, const XrFrameEndInfo* frameEndInfo)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrEndFrame");
+		TraceLoggingLocalStart(local, "xrEndFrame");
 
 		XrResult result;
 		try
@@ -452,7 +452,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrEndFrame", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrEndFrame", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -460,7 +460,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrLocateViews(XrSession session, const XrViewLocateInfo* viewLocateInfo, XrViewState* viewState, uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrView* views)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrLocateViews");
+		TraceLoggingLocalStart(local, "xrLocateViews");
 
 		XrResult result;
 		try
@@ -474,7 +474,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrLocateViews", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrLocateViews", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -482,7 +482,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrCreateAction(XrActionSet actionSet, const XrActionCreateInfo* createInfo, XrAction* action)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrCreateAction");
+		TraceLoggingLocalStart(local, "xrCreateAction");
 
 		XrResult result;
 		try
@@ -496,7 +496,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrCreateAction", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrCreateAction", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -504,7 +504,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrDestroyAction(XrAction action)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrDestroyAction");
+		TraceLoggingLocalStart(local, "xrDestroyAction");
 
 		XrResult result;
 		try
@@ -518,7 +518,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrDestroyAction", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrDestroyAction", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -526,7 +526,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrSuggestInteractionProfileBindings(XrInstance instance, const XrInteractionProfileSuggestedBinding* suggestedBindings)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrSuggestInteractionProfileBindings");
+		TraceLoggingLocalStart(local, "xrSuggestInteractionProfileBindings");
 
 		XrResult result;
 		try
@@ -540,7 +540,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrSuggestInteractionProfileBindings", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrSuggestInteractionProfileBindings", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -548,7 +548,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrAttachSessionActionSets(XrSession session, const XrSessionActionSetsAttachInfo* attachInfo)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrAttachSessionActionSets");
+		TraceLoggingLocalStart(local, "xrAttachSessionActionSets");
 
 		XrResult result;
 		try
@@ -562,7 +562,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrAttachSessionActionSets", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrAttachSessionActionSets", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -570,7 +570,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrGetCurrentInteractionProfile(XrSession session, XrPath topLevelUserPath, XrInteractionProfileState* interactionProfile)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrGetCurrentInteractionProfile");
+		TraceLoggingLocalStart(local, "xrGetCurrentInteractionProfile");
 
 		XrResult result;
 		try
@@ -584,7 +584,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrGetCurrentInteractionProfile", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrGetCurrentInteractionProfile", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -592,7 +592,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrGetActionStateBoolean(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* state)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrGetActionStateBoolean");
+		TraceLoggingLocalStart(local, "xrGetActionStateBoolean");
 
 		XrResult result;
 		try
@@ -606,7 +606,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrGetActionStateBoolean", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrGetActionStateBoolean", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -614,7 +614,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrGetActionStateFloat(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateFloat* state)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrGetActionStateFloat");
+		TraceLoggingLocalStart(local, "xrGetActionStateFloat");
 
 		XrResult result;
 		try
@@ -628,7 +628,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrGetActionStateFloat", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrGetActionStateFloat", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -636,7 +636,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrGetActionStatePose(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStatePose* state)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrGetActionStatePose");
+		TraceLoggingLocalStart(local, "xrGetActionStatePose");
 
 		XrResult result;
 		try
@@ -650,7 +650,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrGetActionStatePose", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrGetActionStatePose", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -658,7 +658,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrSyncActions(XrSession session, const XrActionsSyncInfo* syncInfo)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrSyncActions");
+		TraceLoggingLocalStart(local, "xrSyncActions");
 
 		XrResult result;
 		try
@@ -672,7 +672,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrSyncActions", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrSyncActions", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -680,7 +680,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrApplyHapticFeedback(XrSession session, const XrHapticActionInfo* hapticActionInfo, const XrHapticBaseHeader* hapticFeedback)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrApplyHapticFeedback");
+		TraceLoggingLocalStart(local, "xrApplyHapticFeedback");
 
 		XrResult result;
 		try
@@ -694,7 +694,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrApplyHapticFeedback", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrApplyHapticFeedback", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -702,7 +702,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrStopHapticFeedback(XrSession session, const XrHapticActionInfo* hapticActionInfo)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrStopHapticFeedback");
+		TraceLoggingLocalStart(local, "xrStopHapticFeedback");
 
 		XrResult result;
 		try
@@ -716,7 +716,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrStopHapticFeedback", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrStopHapticFeedback", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -724,7 +724,7 @@ namespace LAYER_NAMESPACE
 	XrResult xrGetVisibilityMaskKHR(XrSession session, XrViewConfigurationType viewConfigurationType, uint32_t viewIndex, XrVisibilityMaskTypeKHR visibilityMaskType, XrVisibilityMaskKHR* visibilityMask)
 	{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "xrGetVisibilityMaskKHR");
+		TraceLoggingLocalStart(local, "xrGetVisibilityMaskKHR");
 
 		XrResult result;
 		try
@@ -738,7 +738,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}
 
-		TraceLoggingWriteStop(local, "xrGetVisibilityMaskKHR", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "xrGetVisibilityMaskKHR", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}
@@ -751,174 +751,141 @@ namespace LAYER_NAMESPACE
 
 		if (XR_SUCCEEDED(result))
 		{
-			const std::string apiName(name);
-
-			if (apiName == "xrDestroyInstance")
-			{
-				m_xrDestroyInstance = reinterpret_cast<PFN_xrDestroyInstance>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrDestroyInstance);
-			}
-			else if (apiName == "xrPollEvent")
-			{
-				m_xrPollEvent = reinterpret_cast<PFN_xrPollEvent>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrPollEvent);
-			}
-			else if (apiName == "xrGetSystem")
-			{
-				m_xrGetSystem = reinterpret_cast<PFN_xrGetSystem>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetSystem);
-			}
-			else if (apiName == "xrCreateSession")
-			{
-				m_xrCreateSession = reinterpret_cast<PFN_xrCreateSession>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrCreateSession);
-			}
-			else if (apiName == "xrDestroySession")
-			{
-				m_xrDestroySession = reinterpret_cast<PFN_xrDestroySession>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrDestroySession);
-			}
-			else if (apiName == "xrCreateActionSpace")
-			{
-				m_xrCreateActionSpace = reinterpret_cast<PFN_xrCreateActionSpace>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrCreateActionSpace);
-			}
-			else if (apiName == "xrLocateSpace")
-			{
-				m_xrLocateSpace = reinterpret_cast<PFN_xrLocateSpace>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrLocateSpace);
-			}
-			else if (apiName == "xrDestroySpace")
-			{
-				m_xrDestroySpace = reinterpret_cast<PFN_xrDestroySpace>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrDestroySpace);
-			}
-			else if (apiName == "xrEnumerateViewConfigurationViews")
-			{
-				m_xrEnumerateViewConfigurationViews = reinterpret_cast<PFN_xrEnumerateViewConfigurationViews>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrEnumerateViewConfigurationViews);
-			}
-			else if (apiName == "xrCreateSwapchain")
-			{
-				m_xrCreateSwapchain = reinterpret_cast<PFN_xrCreateSwapchain>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrCreateSwapchain);
-			}
-			else if (apiName == "xrDestroySwapchain")
-			{
-				m_xrDestroySwapchain = reinterpret_cast<PFN_xrDestroySwapchain>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrDestroySwapchain);
-			}
-			else if (apiName == "xrEnumerateSwapchainImages")
-			{
-				m_xrEnumerateSwapchainImages = reinterpret_cast<PFN_xrEnumerateSwapchainImages>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrEnumerateSwapchainImages);
-			}
-			else if (apiName == "xrAcquireSwapchainImage")
-			{
-				m_xrAcquireSwapchainImage = reinterpret_cast<PFN_xrAcquireSwapchainImage>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrAcquireSwapchainImage);
-			}
-			else if (apiName == "xrWaitSwapchainImage")
-			{
-				m_xrWaitSwapchainImage = reinterpret_cast<PFN_xrWaitSwapchainImage>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrWaitSwapchainImage);
-			}
-			else if (apiName == "xrReleaseSwapchainImage")
-			{
-				m_xrReleaseSwapchainImage = reinterpret_cast<PFN_xrReleaseSwapchainImage>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrReleaseSwapchainImage);
-			}
-			else if (apiName == "xrBeginSession")
-			{
-				m_xrBeginSession = reinterpret_cast<PFN_xrBeginSession>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrBeginSession);
-			}
-			else if (apiName == "xrEndSession")
-			{
-				m_xrEndSession = reinterpret_cast<PFN_xrEndSession>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrEndSession);
+			switch (dispatch::FindDispatchSlot(name))
+			{
+				case 0:
+					m_xrEnumerateViewConfigurationViews = reinterpret_cast<PFN_xrEnumerateViewConfigurationViews>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrEnumerateViewConfigurationViews);
+					break;
+				case 3:
+					m_xrCreateActionSpace = reinterpret_cast<PFN_xrCreateActionSpace>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrCreateActionSpace);
+					break;
+				case 4:
+					m_xrGetActionStateFloat = reinterpret_cast<PFN_xrGetActionStateFloat>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetActionStateFloat);
+					break;
+				case 7:
+					m_xrCreateAction = reinterpret_cast<PFN_xrCreateAction>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrCreateAction);
+					break;
+				case 18:
+					m_xrAcquireSwapchainImage = reinterpret_cast<PFN_xrAcquireSwapchainImage>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrAcquireSwapchainImage);
+					break;
+				case 21:
+					m_xrWaitSwapchainImage = reinterpret_cast<PFN_xrWaitSwapchainImage>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrWaitSwapchainImage);
+					break;
+				case 27:
+					m_xrLocateViews = reinterpret_cast<PFN_xrLocateViews>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrLocateViews);
+					break;
+				case 32:
+					m_xrPollEvent = reinterpret_cast<PFN_xrPollEvent>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrPollEvent);
+					break;
+				case 35:
+					m_xrGetActionStatePose = reinterpret_cast<PFN_xrGetActionStatePose>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetActionStatePose);
+					break;
+				case 43:
+					m_xrLocateSpace = reinterpret_cast<PFN_xrLocateSpace>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrLocateSpace);
+					break;
+				case 45:
+					m_xrWaitFrame = reinterpret_cast<PFN_xrWaitFrame>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrWaitFrame);
+					break;
+				case 50:
+					m_xrBeginSession = reinterpret_cast<PFN_xrBeginSession>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrBeginSession);
+					break;
+				case 51:
+					m_xrCreateSwapchain = reinterpret_cast<PFN_xrCreateSwapchain>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrCreateSwapchain);
+					break;
+				case 54:
+					m_xrGetSystem = reinterpret_cast<PFN_xrGetSystem>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetSystem);
+					break;
+				case 59:
+					m_xrEndFrame = reinterpret_cast<PFN_xrEndFrame>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrEndFrame);
+					break;
+				case 65:
+					m_xrStopHapticFeedback = reinterpret_cast<PFN_xrStopHapticFeedback>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrStopHapticFeedback);
+					break;
+				case 66:
+					m_xrGetVisibilityMaskKHR = reinterpret_cast<PFN_xrGetVisibilityMaskKHR>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetVisibilityMaskKHR);
+					break;
+				case 75:
+					m_xrAttachSessionActionSets = reinterpret_cast<PFN_xrAttachSessionActionSets>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrAttachSessionActionSets);
+					break;
+				case 78:
+					m_xrEndSession = reinterpret_cast<PFN_xrEndSession>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrEndSession);
+					break;
+				case 79:
+					m_xrCreateSession = reinterpret_cast<PFN_xrCreateSession>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrCreateSession);
+					break;
+				case 81:
+					m_xrSyncActions = reinterpret_cast<PFN_xrSyncActions>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrSyncActions);
+					break;
+				case 83:
+					m_xrApplyHapticFeedback = reinterpret_cast<PFN_xrApplyHapticFeedback>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrApplyHapticFeedback);
+					break;
+				case 87:
+					m_xrDestroySession = reinterpret_cast<PFN_xrDestroySession>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrDestroySession);
+					break;
+				case 90:
+					m_xrSuggestInteractionProfileBindings = reinterpret_cast<PFN_xrSuggestInteractionProfileBindings>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrSuggestInteractionProfileBindings);
+					break;
+				case 95:
+					m_xrDestroyAction = reinterpret_cast<PFN_xrDestroyAction>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrDestroyAction);
+					break;
+				case 101:
+					m_xrDestroySpace = reinterpret_cast<PFN_xrDestroySpace>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrDestroySpace);
+					break;
+				case 102:
+					m_xrGetActionStateBoolean = reinterpret_cast<PFN_xrGetActionStateBoolean>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetActionStateBoolean);
+					break;
+				case 105:
+					m_xrEnumerateSwapchainImages = reinterpret_cast<PFN_xrEnumerateSwapchainImages>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrEnumerateSwapchainImages);
+					break;
+				case 111:
+					m_xrBeginFrame = reinterpret_cast<PFN_xrBeginFrame>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrBeginFrame);
+					break;
+				case 114:
+					m_xrDestroyInstance = reinterpret_cast<PFN_xrDestroyInstance>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrDestroyInstance);
+					break;
+				case 117:
+					m_xrGetCurrentInteractionProfile = reinterpret_cast<PFN_xrGetCurrentInteractionProfile>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetCurrentInteractionProfile);
+					break;
+				case 123:
+					m_xrDestroySwapchain = reinterpret_cast<PFN_xrDestroySwapchain>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrDestroySwapchain);
+					break;
+				case 127:
+					m_xrReleaseSwapchainImage = reinterpret_cast<PFN_xrReleaseSwapchainImage>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrReleaseSwapchainImage);
+					break;
 			}
-			else if (apiName == "xrWaitFrame")
-			{
-				m_xrWaitFrame = reinterpret_cast<PFN_xrWaitFrame>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrWaitFrame);
-			}
-			else if (apiName == "xrBeginFrame")
-			{
-				m_xrBeginFrame = reinterpret_cast<PFN_xrBeginFrame>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrBeginFrame);
-			}
-			else if (apiName == "xrEndFrame")
-			{
-				m_xrEndFrame = reinterpret_cast<PFN_xrEndFrame>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrEndFrame);
-			}
-			else if (apiName == "xrLocateViews")
-			{
-				m_xrLocateViews = reinterpret_cast<PFN_xrLocateViews>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrLocateViews);
-			}
-			else if (apiName == "xrCreateAction")
-			{
-				m_xrCreateAction = reinterpret_cast<PFN_xrCreateAction>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrCreateAction);
-			}
-			else if (apiName == "xrDestroyAction")
-			{
-				m_xrDestroyAction = reinterpret_cast<PFN_xrDestroyAction>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrDestroyAction);
-			}
-			else if (apiName == "xrSuggestInteractionProfileBindings")
-			{
-				m_xrSuggestInteractionProfileBindings = reinterpret_cast<PFN_xrSuggestInteractionProfileBindings>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrSuggestInteractionProfileBindings);
-			}
-			else if (apiName == "xrAttachSessionActionSets")
-			{
-				m_xrAttachSessionActionSets = reinterpret_cast<PFN_xrAttachSessionActionSets>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrAttachSessionActionSets);
-			}
-			else if (apiName == "xrGetCurrentInteractionProfile")
-			{
-				m_xrGetCurrentInteractionProfile = reinterpret_cast<PFN_xrGetCurrentInteractionProfile>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetCurrentInteractionProfile);
-			}
-			else if (apiName == "xrGetActionStateBoolean")
-			{
-				m_xrGetActionStateBoolean = reinterpret_cast<PFN_xrGetActionStateBoolean>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetActionStateBoolean);
-			}
-			else if (apiName == "xrGetActionStateFloat")
-			{
-				m_xrGetActionStateFloat = reinterpret_cast<PFN_xrGetActionStateFloat>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetActionStateFloat);
-			}
-			else if (apiName == "xrGetActionStatePose")
-			{
-				m_xrGetActionStatePose = reinterpret_cast<PFN_xrGetActionStatePose>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetActionStatePose);
-			}
-			else if (apiName == "xrSyncActions")
-			{
-				m_xrSyncActions = reinterpret_cast<PFN_xrSyncActions>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrSyncActions);
-			}
-			else if (apiName == "xrApplyHapticFeedback")
-			{
-				m_xrApplyHapticFeedback = reinterpret_cast<PFN_xrApplyHapticFeedback>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrApplyHapticFeedback);
-			}
-			else if (apiName == "xrStopHapticFeedback")
-			{
-				m_xrStopHapticFeedback = reinterpret_cast<PFN_xrStopHapticFeedback>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrStopHapticFeedback);
-			}
-			else if (apiName == "xrGetVisibilityMaskKHR")
-			{
-				m_xrGetVisibilityMaskKHR = reinterpret_cast<PFN_xrGetVisibilityMaskKHR>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrGetVisibilityMaskKHR);
-			}
-
 		}
 
 		return result;
@@ -442,5 +442,196 @@ namespace LAYER_NAMESPACE
 
 	};
 
+	// Auto-generated dispatcher table.
+	namespace dispatch
+	{
+		// Perfect hash of the names of the functions we intercept (FNV-1a with a seed chosen by the generator).
+		constexpr uint32_t DispatchHashSeed = 0x811c9dcf;
+		constexpr uint32_t DispatchTableSize = 128;
+		constexpr uint32_t NoDispatchSlot = DispatchTableSize;
+
+		inline constexpr const char* DispatchTable[DispatchTableSize] = {
+			"xrEnumerateViewConfigurationViews",
+			nullptr,
+			nullptr,
+			"xrCreateActionSpace",
+			"xrGetActionStateFloat",
+			nullptr,
+			nullptr,
+			"xrCreateAction",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrAcquireSwapchainImage",
+			nullptr,
+			nullptr,
+			"xrWaitSwapchainImage",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrLocateViews",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrPollEvent",
+			nullptr,
+			nullptr,
+			"xrGetActionStatePose",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrLocateSpace",
+			nullptr,
+			"xrWaitFrame",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrBeginSession",
+			"xrCreateSwapchain",
+			nullptr,
+			nullptr,
+			"xrGetSystem",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrEndFrame",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrStopHapticFeedback",
+			"xrGetVisibilityMaskKHR",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrAttachSessionActionSets",
+			nullptr,
+			nullptr,
+			"xrEndSession",
+			"xrCreateSession",
+			nullptr,
+			"xrSyncActions",
+			nullptr,
+			"xrApplyHapticFeedback",
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrDestroySession",
+			nullptr,
+			nullptr,
+			"xrSuggestInteractionProfileBindings",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrDestroyAction",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrDestroySpace",
+			"xrGetActionStateBoolean",
+			nullptr,
+			nullptr,
+			"xrEnumerateSwapchainImages",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrBeginFrame",
+			nullptr,
+			nullptr,
+			"xrDestroyInstance",
+			nullptr,
+			nullptr,
+			"xrGetCurrentInteractionProfile",
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrDestroySwapchain",
+			nullptr,
+			nullptr,
+			nullptr,
+			"xrReleaseSwapchainImage",
+		};
+
+		constexpr uint32_t GetDispatchSlot(const char* name)
+		{
+			uint32_t hash = DispatchHashSeed;
+			while (*name)
+			{
+				hash = (hash ^ static_cast<uint8_t>(*name++)) * 16777619u;
+			}
+			return hash & (DispatchTableSize - 1);
+		}
+
+		static_assert(GetDispatchSlot("xrEnumerateViewConfigurationViews") == 0);
+		static_assert(GetDispatchSlot("xrCreateActionSpace") == 3);
+		static_assert(GetDispatchSlot("xrGetActionStateFloat") == 4);
+		static_assert(GetDispatchSlot("xrCreateAction") == 7);
+		static_assert(GetDispatchSlot("xrAcquireSwapchainImage") == 18);
+		static_assert(GetDispatchSlot("xrWaitSwapchainImage") == 21);
+		static_assert(GetDispatchSlot("xrLocateViews") == 27);
+		static_assert(GetDispatchSlot("xrPollEvent") == 32);
+		static_assert(GetDispatchSlot("xrGetActionStatePose") == 35);
+		static_assert(GetDispatchSlot("xrLocateSpace") == 43);
+		static_assert(GetDispatchSlot("xrWaitFrame") == 45);
+		static_assert(GetDispatchSlot("xrBeginSession") == 50);
+		static_assert(GetDispatchSlot("xrCreateSwapchain") == 51);
+		static_assert(GetDispatchSlot("xrGetSystem") == 54);
+		static_assert(GetDispatchSlot("xrEndFrame") == 59);
+		static_assert(GetDispatchSlot("xrStopHapticFeedback") == 65);
+		static_assert(GetDispatchSlot("xrGetVisibilityMaskKHR") == 66);
+		static_assert(GetDispatchSlot("xrAttachSessionActionSets") == 75);
+		static_assert(GetDispatchSlot("xrEndSession") == 78);
+		static_assert(GetDispatchSlot("xrCreateSession") == 79);
+		static_assert(GetDispatchSlot("xrSyncActions") == 81);
+		static_assert(GetDispatchSlot("xrApplyHapticFeedback") == 83);
+		static_assert(GetDispatchSlot("xrDestroySession") == 87);
+		static_assert(GetDispatchSlot("xrSuggestInteractionProfileBindings") == 90);
+		static_assert(GetDispatchSlot("xrDestroyAction") == 95);
+		static_assert(GetDispatchSlot("xrDestroySpace") == 101);
+		static_assert(GetDispatchSlot("xrGetActionStateBoolean") == 102);
+		static_assert(GetDispatchSlot("xrEnumerateSwapchainImages") == 105);
+		static_assert(GetDispatchSlot("xrBeginFrame") == 111);
+		static_assert(GetDispatchSlot("xrDestroyInstance") == 114);
+		static_assert(GetDispatchSlot("xrGetCurrentInteractionProfile") == 117);
+		static_assert(GetDispatchSlot("xrDestroySwapchain") == 123);
+		static_assert(GetDispatchSlot("xrReleaseSwapchainImage") == 127);
+
+		// Returns the slot of an intercepted function, or NoDispatchSlot.
+		inline uint32_t FindDispatchSlot(const char* name)
+		{
+			const uint32_t slot = GetDispatchSlot(name);
+			return DispatchTable[slot] && !strcmp(name, DispatchTable[slot]) ? slot : NoDispatchSlot;
+		}
+	} // namespace dispatch
+
 } // namespace LAYER_NAMESPACE
 
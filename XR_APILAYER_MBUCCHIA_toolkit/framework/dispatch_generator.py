@@ -108,6 +108,14 @@ class DispatchGenOutputGenerator(AutomaticSourceOutputGenerator):
 
         return arguments_list
 
+    def getDispatchedFunctions(self):
+        dispatched_functions = ['xrDestroyInstance']
+        for cur_cmd in self.core_commands + self.ext_commands:
+            if cur_cmd.name in layer_apis.override_functions:
+                dispatched_functions.append(cur_cmd.name)
+
+        return dispatched_functions
+
 class DispatchGenCppOutputGenerator(DispatchGenOutputGenerator):
     '''Generator for dispatch.gen.cpp.'''
     def beginFile(self, genOpts):
@@ -165,7 +173,7 @@ namespace LAYER_NAMESPACE
 	XrResult {cur_cmd.name}({parameters_list})
 	{{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "{cur_cmd.name}");
+		TraceLoggingLocalStart(local, "{cur_cmd.name}");
 
 		XrResult result;
 		try
@@ -179,7 +187,7 @@ namespace LAYER_NAMESPACE
 			result = XR_ERROR_RUNTIME_FAILURE;
 		}}
 
-		TraceLoggingWriteStop(local, "{cur_cmd.name}", TLArg(xr::ToCString(result), "Result"));
+		TraceLoggingLocalStop(local, "{cur_cmd.name}", TLArg(xr::ToCString(result), "Result"));
 
 		return result;
 	}}
@@ -189,7 +197,7 @@ namespace LAYER_NAMESPACE
 	void {cur_cmd.name}({parameters_list})
 	{{
 		TraceLocalActivity(local);
-		TraceLoggingWriteStart(local, "{cur_cmd.name}");
+		TraceLoggingLocalStart(local, "{cur_cmd.name}");
 
 		try
 		{{
@@ -201,7 +209,7 @@ namespace LAYER_NAMESPACE
 			Log("{cur_cmd.name}: %s\\n", exc.what());
 		}}
 
-		TraceLoggingWriteStop(local, "{cur_cmd.name}");
+		TraceLoggingLocalStop(local, "{cur_cmd.name}");
 	}}
 '''
                 
@@ -235,35 +243,29 @@ namespace LAYER_NAMESPACE
         return generated;
 
     def genGetInstanceProcAddr(self):
-        generated = '''	XrResult OpenXrApi::xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function)
-	{
+        _, _, slots = makePerfectHash(self.getDispatchedFunctions())
+
+        cases = ''
+        for slot, name in sorted(slots.items()):
+            cases += f'''				case {slot}:
+					m_{name} = reinterpret_cast<PFN_{name}>(*function);
+					*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::{name});
+					break;
+'''
+
+        generated = f'''	XrResult OpenXrApi::xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function)
+	{{
 		XrResult result = m_xrGetInstanceProcAddr(instance, name, function);
 
 		if (XR_SUCCEEDED(result))
-		{
-			const std::string apiName(name);
-
-			if (apiName == "xrDestroyInstance")
-			{
-				m_xrDestroyInstance = reinterpret_cast<PFN_xrDestroyInstance>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::xrDestroyInstance);
-			}
-'''
-
-        for cur_cmd in self.core_commands + self.ext_commands:
-            if cur_cmd.name in layer_apis.override_functions:
-                generated += f'''			else if (apiName == "{cur_cmd.name}")
+		{{
+			switch (dispatch::FindDispatchSlot(name))
 			{{
-				m_{cur_cmd.name} = reinterpret_cast<PFN_{cur_cmd.name}>(*function);
-				*function = reinterpret_cast<PFN_xrVoidFunction>(LAYER_NAMESPACE::{cur_cmd.name});
-			}}
-'''
-
-        generated += '''
-		}
+{cases}			}}
+		}}
 
 		return result;
-	}'''
+	}}'''
 
         return generated
 
@@ -330,11 +332,15 @@ namespace LAYER_NAMESPACE
 
     def endFile(self):
         generated_virtual_methods = self.genVirtualMethods()
+        generated_dispatch_table = self.genDispatchTable()
+
+        postamble = f'''
+	}};
 
-        postamble = '''
-	};
+	// Auto-generated dispatcher table.
+{generated_dispatch_table}
 
-} // namespace LAYER_NAMESPACE
+}} // namespace LAYER_NAMESPACE
 '''
 
         contents = f'''
@@ -380,6 +386,70 @@ namespace LAYER_NAMESPACE
                 
         return generated
 
+    def genDispatchTable(self):
+        seed, table_size, slots = makePerfectHash(self.getDispatchedFunctions())
+
+        table = ''
+        for slot in range(table_size):
+            table += '\t\t\t{},\n'.format(f'"{slots[slot]}"' if slot in slots else 'nullptr')
+
+        checks = ''
+        for slot, name in sorted(slots.items()):
+            checks += f'''		static_assert(GetDispatchSlot("{name}") == {slot});
+'''
+
+        generated = f'''	namespace dispatch
+	{{
+		// Perfect hash of the names of the functions we intercept (FNV-1a with a seed chosen by the generator).
+		constexpr uint32_t DispatchHashSeed = {seed:#010x};
+		constexpr uint32_t DispatchTableSize = {table_size};
+		constexpr uint32_t NoDispatchSlot = DispatchTableSize;
+
+		inline constexpr const char* DispatchTable[DispatchTableSize] = {{
+{table}		}};
+
+		constexpr uint32_t GetDispatchSlot(const char* name)
+		{{
+			uint32_t hash = DispatchHashSeed;
+			while (*name)
+			{{
+				hash = (hash ^ static_cast<uint8_t>(*name++)) * 16777619u;
+			}}
+			return hash & (DispatchTableSize - 1);
+		}}
+
+{checks}
+		// Returns the slot of an intercepted function, or NoDispatchSlot.
+		inline uint32_t FindDispatchSlot(const char* name)
+		{{
+			const uint32_t slot = GetDispatchSlot(name);
+			return DispatchTable[slot] && !strcmp(name, DispatchTable[slot]) ? slot : NoDispatchSlot;
+		}}
+	}} // namespace dispatch'''
+
+        return generated
+
+def makePerfectHash(names):
+    """Find a seed for which FNV-1a maps each name to its own slot. Returns (seed, table_size, slots)."""
+    table_size = 1
+    while table_size < 2 * len(names):
+        table_size *= 2
+
+    while True:
+        for seed in range(0x811c9dc5, 0x811c9dc5 + 100000):
+            slots = {}
+            for name in names:
+                hash = seed
+                for c in name.encode():
+                    hash = ((hash ^ c) * 16777619) & 0xffffffff
+                slot = hash & (table_size - 1)
+                if slot in slots:
+                    break
+                slots[slot] = name
+            else:
+                return seed, table_size, slots
+        table_size *= 2
+
 def makeREstring(strings, default=None):
     """Turn a list of strings into a regexp string matching exactly those strings."""
     if strings or default is None:
@@ -55,7 +55,7 @@ XrResult __declspec(dllexport) XRAPI_CALL
                                        const char* const apiLayerName,
                                        XrNegotiateApiLayerRequest* const apiLayerRequest) {
     TraceLocalActivity(local);
-    TraceLoggingWriteStart(local, "xrNegotiateLoaderApiLayerInterface");
+    TraceLoggingLocalStart(local, "xrNegotiateLoaderApiLayerInterface");
 
     // Retrieve the path of the DLL.
     if (dllHome.empty()) {
@@ -119,7 +119,7 @@ XrResult __declspec(dllexport) XRAPI_CALL
 
     Log("%s layer is active\n", LayerPrettyName.c_str());
 
-    TraceLoggingWriteStop(local, "xrNegotiateLoaderApiLayerInterface");
+    TraceLoggingLocalStop(local, "xrNegotiateLoaderApiLayerInterface");
 
     return XR_SUCCESS;
 }
@@ -0,0 +1,164 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+#include "oneeuro.h"
+
+namespace {
+
+    using namespace toolkit;
+    using namespace toolkit::input;
+    using namespace toolkit::math;
+    using namespace toolkit::utilities;
+
+    // Beyond this gap between two samples (eg: loss of tracking), the filter starts over.
+    constexpr XrDuration MaxSampleInterval = 100'000'000; // 100ms
+
+    // The cutoff frequency (Hz) for the speed estimate of the One-Euro filter.
+    constexpr float DerivativeCutoff = 1.f;
+
+    // Never extrapolate the gaze further than this.
+    constexpr XrDuration MaxPrediction = 50'000'000; // 50ms
+
+    // The cutoff frequency (Hz) for the speed estimate used to detect saccades. Saccades last a few tens of ms.
+    constexpr float ClassificationCutoff = 20.f;
+
+    // The saccade ends when the speed of the gaze falls below this fraction of the threshold.
+    constexpr float SaccadeHysteresis = 0.5f;
+
+    float Length(const XrVector2f& v) {
+        return std::sqrt(v.x * v.x + v.y * v.y);
+    }
+
+    class GazeFilter : public IGazeFilter {
+      public:
+        GazeFilter(const GazeFilterParameters& parameters) : m_parameters(parameters) {
+        }
+
+        void setParameters(const GazeFilterParameters& parameters) override {
+            m_parameters = parameters;
+        }
+
+        void addSample(XrTime time, const XrVector2f gaze[ViewCount]) override {
+            if (m_hasSamples && time <= m_lastTime) {
+                return;
+            }
+
+            if (!m_hasSamples || time - m_lastTime > MaxSampleInterval) {
+                for (uint32_t eye = 0; eye < ViewCount; eye++) {
+                    m_filtered[eye] = m_raw[eye] = gaze[eye];
+                    m_speed[eye] = m_velocity[eye] = {0.f, 0.f};
+                }
+                m_binocularVelocity = {0.f, 0.f};
+                m_lastTime = time;
+                m_hasSamples = true;
+                m_movement = m_parameters.enabled ? GazeMovement::Fixation : GazeMovement::Saccade;
+                return;
+            }
+
+            const float dt = (time - m_lastTime) / 1e9f;
+            m_lastTime = time;
+
+            XrVector2f binocularVelocity{0.f, 0.f};
+            for (uint32_t eye = 0; eye < ViewCount; eye++) {
+                // The instantaneous velocity is used for classification and prediction.
+                m_velocity[eye] = {(gaze[eye].x - m_raw[eye].x) / dt, (gaze[eye].y - m_raw[eye].y) / dt};
+                m_raw[eye] = gaze[eye];
+                binocularVelocity.x += m_velocity[eye].x / ViewCount;
+                binocularVelocity.y += m_velocity[eye].y / ViewCount;
+
+                if (!m_parameters.enabled) {
+                    m_filtered[eye] = gaze[eye];
+                    continue;
+                }
+
+                // The smoothed speed drives the cutoff frequency: the faster the eyes move, the less lag we tolerate.
+                const XrVector2f velocity{(gaze[eye].x - m_filtered[eye].x) / dt,
+                                          (gaze[eye].y - m_filtered[eye].y) / dt};
+                m_speed[eye] = Lerp(m_speed[eye], velocity, SmoothingFactor(DerivativeCutoff, dt));
+                const float cutoff = m_parameters.minCutoff + m_parameters.beta * Length(m_speed[eye]);
+                m_filtered[eye] = Lerp(m_filtered[eye], gaze[eye], SmoothingFactor(cutoff, dt));
+            }
+
+            // Velocity-threshold identification (I-VT), with hysteresis to avoid flickering around the threshold. Both
+            // eyes move together during a saccade, so averaging them cancels out some of the noise.
+            m_binocularVelocity =
+                Lerp(m_binocularVelocity, binocularVelocity, SmoothingFactor(ClassificationCutoff, dt));
+            const float speed = Length(m_binocularVelocity);
+            if (!m_parameters.enabled) {
+                m_movement = GazeMovement::Saccade;
+            } else if (m_movement == GazeMovement::Fixation && speed > m_parameters.saccadeVelocity) {
+                m_movement = GazeMovement::Saccade;
+            } else if (m_movement == GazeMovement::Saccade &&
+                       speed < m_parameters.saccadeVelocity * SaccadeHysteresis) {
+                m_movement = GazeMovement::Fixation;
+            }
+        }
+
+        void getGaze(XrTime displayTime, XrVector2f gaze[ViewCount]) const override {
+            // Only extrapolate during saccades, where the filter lags behind. During fixations, the velocity is mostly
+            // noise.
+            const bool predict = m_parameters.enabled && m_movement == GazeMovement::Saccade;
+            const float horizon = std::clamp(displayTime - m_lastTime, (XrDuration)0, MaxPrediction) / 1e9f;
+            for (uint32_t eye = 0; eye < ViewCount; eye++) {
+                gaze[eye] = m_filtered[eye];
+                if (predict) {
+                    gaze[eye].x += m_velocity[eye].x * horizon;
+                    gaze[eye].y += m_velocity[eye].y * horizon;
+                }
+            }
+        }
+
+        GazeMovement getMovement() const override {
+            return m_movement;
+        }
+
+        void reset() override {
+            m_hasSamples = false;
+            m_movement = GazeMovement::Fixation;
+        }
+
+      private:
+        GazeFilterParameters m_parameters;
+
+        bool m_hasSamples{false};
+        XrTime m_lastTime{0};
+        XrVector2f m_raw[ViewCount]{};
+        XrVector2f m_filtered[ViewCount]{};
+        XrVector2f m_speed[ViewCount]{};
+        XrVector2f m_velocity[ViewCount]{};
+        XrVector2f m_binocularVelocity{};
+        GazeMovement m_movement{GazeMovement::Fixation};
+    };
+
+} // namespace
+
+namespace toolkit::input {
+
+    std::shared_ptr<IGazeFilter> CreateGazeFilter(const GazeFilterParameters& parameters) {
+        return std::make_shared<GazeFilter>(parameters);
+    }
+
+} // namespace toolkit::input
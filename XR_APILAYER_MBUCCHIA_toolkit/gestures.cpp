@@ -0,0 +1,241 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+#include "log.h"
+
+#include <immintrin.h>
+
+namespace {
+
+    using namespace toolkit;
+    using namespace toolkit::input;
+
+    using namespace xr::math;
+
+    constexpr uint32_t HandCount = 2;
+    constexpr uint32_t JointCount = XR_HAND_JOINT_COUNT_EXT;
+
+    // The number of joint pairs evaluated at once.
+    constexpr uint32_t BatchSize = 4;
+
+    inline float ComputeJointPairValue(float distanceSquared, float nearDistance, float farDistance) {
+        // We ignore joints radius and assume the near/far distance are configured to account for them.
+        const float distance = std::sqrt(distanceSquared);
+        return 1.f - (std::clamp(distance, nearDistance, farDistance) - nearDistance) / (farDistance - nearDistance);
+    }
+
+    // The joints of both hands are converted to a structure-of-arrays layout, and every gesture is flattened into
+    // pairs of indices in these arrays, so that all the joint distances are computed in a single pass.
+    class GestureEngine : public IGestureEngine {
+      public:
+        GestureEngine(bool allowSimd) : m_allowSimd(allowSimd) {
+        }
+
+        void setGestures(const std::vector<GestureDefinition>& gestures) override {
+            m_gestures.clear();
+            m_joint1.clear();
+            m_joint2.clear();
+            m_nearDistance.clear();
+            m_farDistance.clear();
+
+            for (uint32_t side = 0; side < HandCount; side++) {
+                const uint32_t otherSide = HandCount - 1 - side;
+
+                for (const auto& gesture : gestures) {
+                    m_gestures.push_back({(uint32_t)m_joint1.size(), (uint32_t)gesture.joints.size()});
+
+                    for (const auto& joints : gesture.joints) {
+                        m_joint1.push_back(side * JointCount + std::min(joints.first, JointCount - 1));
+                        m_joint2.push_back((gesture.twoHanded ? otherSide : side) * JointCount +
+                                           std::min(joints.second, JointCount - 1));
+                        m_nearDistance.push_back(gesture.nearDistance);
+                        m_farDistance.push_back(gesture.farDistance);
+                    }
+                }
+            }
+            m_gestureCount = (uint32_t)gestures.size();
+
+            // Pad to a whole batch.
+            while (m_joint1.size() % BatchSize) {
+                m_joint1.push_back(0);
+                m_joint2.push_back(0);
+                m_nearDistance.push_back(0.f);
+                m_farDistance.push_back(1.f);
+            }
+            m_pairValues.assign(m_joint1.size(), NAN);
+            m_gestureValues.assign(m_gestures.size(), NAN);
+
+            // Only convert the joints that are needed.
+            std::fill(std::begin(m_x), std::end(m_x), NAN);
+            std::fill(std::begin(m_y), std::end(m_y), NAN);
+            std::fill(std::begin(m_z), std::end(m_z), NAN);
+            m_usedJoints.clear();
+            for (uint32_t i = 0; i < m_gestures.size(); i++) {
+                for (uint32_t j = 0; j < m_gestures[i].pairCount; j++) {
+                    m_usedJoints.push_back(m_joint1[m_gestures[i].firstPair + j]);
+                    m_usedJoints.push_back(m_joint2[m_gestures[i].firstPair + j]);
+                }
+            }
+            std::sort(m_usedJoints.begin(), m_usedJoints.end());
+            m_usedJoints.erase(std::unique(m_usedJoints.begin(), m_usedJoints.end()), m_usedJoints.end());
+        }
+
+        uint32_t getGestureCount() const override {
+            return m_gestureCount;
+        }
+
+        void evaluate(const XrHandJointLocationEXT* leftHandJointsPoses,
+                      const XrHandJointLocationEXT* rightHandJointsPoses) override {
+            // Joints that could not be located are stored as NAN, which propagates to the distances.
+            const XrHandJointLocationEXT* jointsPoses[HandCount] = {leftHandJointsPoses, rightHandJointsPoses};
+            for (const uint32_t index : m_usedJoints) {
+                const XrHandJointLocationEXT* joints = jointsPoses[index / JointCount];
+                const XrHandJointLocationEXT* joint = joints ? &joints[index % JointCount] : nullptr;
+                if (joint && Pose::IsPoseValid(joint->locationFlags)) {
+                    m_x[index] = joint->pose.position.x;
+                    m_y[index] = joint->pose.position.y;
+                    m_z[index] = joint->pose.position.z;
+                } else {
+                    m_x[index] = m_y[index] = m_z[index] = NAN;
+                }
+            }
+
+            const uint32_t start = m_allowSimd ? evaluatePairsSse() : 0;
+            evaluatePairsScalar(start);
+
+            for (uint32_t i = 0; i < m_gestures.size(); i++) {
+                const float* values = m_pairValues.data() + m_gestures[i].firstPair;
+                const uint32_t count = m_gestures[i].pairCount;
+
+                if (count <= 1) {
+                    m_gestureValues[i] = count ? values[0] : NAN;
+                    continue;
+                }
+
+                // Ignore the lowest value, average the other ones.
+                float sum = 0.f;
+                float lowest = values[0];
+                for (uint32_t j = 0; j < count; j++) {
+                    sum += values[j];
+                    lowest = std::min(lowest, values[j]);
+                }
+                m_gestureValues[i] = (sum - lowest) / (count - 1);
+            }
+        }
+
+        float getValue(uint32_t gesture, Hand hand) const override {
+            if (gesture >= m_gestureCount) {
+                return NAN;
+            }
+            return m_gestureValues[(uint32_t)hand * m_gestureCount + gesture];
+        }
+
+      private:
+        void evaluatePairsScalar(uint32_t start) {
+            for (uint32_t i = start; i < m_joint1.size(); i++) {
+                const uint32_t j1 = m_joint1[i];
+                const uint32_t j2 = m_joint2[i];
+                const float dx = m_x[j1] - m_x[j2];
+                const float dy = m_y[j1] - m_y[j2];
+                const float dz = m_z[j1] - m_z[j2];
+                const float distanceSquared = dx * dx + dy * dy + dz * dz;
+                m_pairValues[i] = !isnan(distanceSquared)
+                                      ? ComputeJointPairValue(distanceSquared, m_nearDistance[i], m_farDistance[i])
+                                      : NAN;
+            }
+        }
+
+        // Returns the number of pairs processed.
+        uint32_t evaluatePairsSse() {
+            const __m128 one = _mm_set1_ps(1.f);
+            const __m128 nan = _mm_set1_ps(NAN);
+
+            const auto gather = [](const float* values, const uint32_t* indices) {
+                return _mm_setr_ps(values[indices[0]], values[indices[1]], values[indices[2]], values[indices[3]]);
+            };
+
+            uint32_t i = 0;
+            for (; i + BatchSize <= m_joint1.size(); i += BatchSize) {
+                const uint32_t* j1 = m_joint1.data() + i;
+                const uint32_t* j2 = m_joint2.data() + i;
+                const __m128 dx = _mm_sub_ps(gather(m_x, j1), gather(m_x, j2));
+                const __m128 dy = _mm_sub_ps(gather(m_y, j1), gather(m_y, j2));
+                const __m128 dz = _mm_sub_ps(gather(m_z, j1), gather(m_z, j2));
+                const __m128 distanceSquared =
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+                const __m128 nearDistance = _mm_loadu_ps(m_nearDistance.data() + i);
+                const __m128 farDistance = _mm_loadu_ps(m_farDistance.data() + i);
+                const __m128 distance =
+                    _mm_min_ps(_mm_max_ps(_mm_sqrt_ps(distanceSquared), nearDistance), farDistance);
+                const __m128 value = _mm_sub_ps(
+                    one, _mm_div_ps(_mm_sub_ps(distance, nearDistance), _mm_sub_ps(farDistance, nearDistance)));
+
+                // The min/max above do not propagate NAN.
+                const __m128 isInvalid = _mm_cmpunord_ps(distanceSquared, distanceSquared);
+                _mm_storeu_ps(m_pairValues.data() + i,
+                              _mm_or_ps(_mm_and_ps(isInvalid, nan), _mm_andnot_ps(isInvalid, value)));
+            }
+
+            return i;
+        }
+
+        const bool m_allowSimd;
+
+        struct Gesture {
+            uint32_t firstPair;
+            uint32_t pairCount;
+        };
+
+        // The gestures for the left hand, then the gestures for the right hand.
+        uint32_t m_gestureCount{0};
+        std::vector<Gesture> m_gestures;
+        std::vector<float> m_gestureValues;
+
+        // The joint pairs, indexing the joints arrays below.
+        std::vector<uint32_t> m_joint1;
+        std::vector<uint32_t> m_joint2;
+        std::vector<float> m_nearDistance;
+        std::vector<float> m_farDistance;
+        std::vector<float> m_pairValues;
+
+        // The positions of the joints of the left hand, then of the right hand. Only the joints referenced by the
+        // gestures are updated.
+        std::vector<uint32_t> m_usedJoints;
+        float m_x[HandCount * JointCount];
+        float m_y[HandCount * JointCount];
+        float m_z[HandCount * JointCount];
+    };
+
+} // namespace
+
+namespace toolkit::input {
+
+    std::shared_ptr<IGestureEngine> CreateGestureEngine(bool allowSimd) {
+        return std::make_shared<GestureEngine>(allowSimd);
+    }
+
+} // namespace toolkit::input
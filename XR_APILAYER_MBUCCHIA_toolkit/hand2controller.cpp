@@ -22,7 +22,9 @@
 
 #include "pch.h"
 
+#include "actionrouter.h"
 #include "factories.h"
+#include "handjoints.h"
 #include "interfaces.h"
 #include "layer.h"
 #include "log.h"
@@ -84,8 +86,6 @@ namespace {
         targetVector.assign(sourceArray, sourceArray + N);
     }
 
-    static constexpr uint32_t HandCount = 2;
-
     static constexpr XrTime GracePeriod = 2000000; // 2ms
 
     enum class PoseType { Grip, Aim };
@@ -98,27 +98,6 @@ namespace {
         XrPosef poseInActionSpace;
     };
 
-    struct SubAction {
-        Hand hand;
-        std::string path;
-
-        bool synced{false};
-
-        float floatValue{0.0f};
-        XrTime timeFloatValueChanged{0};
-        bool floatValueChanged{false};
-
-        bool boolValue{false};
-        XrTime timeBoolValueChanged{0};
-        bool boolValueChanged{false};
-    };
-
-    struct Action {
-        XrActionSet actionSet;
-
-        std::map<XrPath, SubAction> subActions;
-    };
-
     struct Config {
         Config();
 
@@ -158,11 +137,12 @@ namespace {
         // The target XrAction path to simulate keepalive.
         std::string keepaliveAction;
 
-        // The index of the 1st joint (see enum XrHandJointEXT) to use for 1st custom gesture.
-        int custom1Joint1Index;
+        // Whether to interpolate between cached poses rather than querying the runtime.
+        bool interpolateCachedPoses;
 
-        // The index of the 2nd joint (see enum XrHandJointEXT) to use for 1st custom gesture.
-        int custom1Joint2Index;
+        // How far the poses may be extrapolated from the latest poses located by the runtime (0 to always query the
+        // runtime at the requested time). This is opt-in, with extrapolation_horizon in the configuration file.
+        XrDuration extrapolationHorizon;
 
         // The target XrAction path for a given gesture, and the near/far threshold to map the float action too
         // (near maps to 1, far maps to 0).
@@ -179,9 +159,33 @@ namespace {
         DEFINE_ACTION(palmTap);
         DEFINE_ACTION(wristTap);
         DEFINE_ACTION(indexTipTap);
-        DEFINE_ACTION(custom1);
 
 #undef DEFINE_ACTION
+
+        // A user-defined gesture, and the target XrAction path for each hand.
+        struct CustomGesture {
+            std::string name;
+
+            // The indices of the joints (see enum XrHandJointEXT), by pairs. -1 when unset.
+            std::vector<int> joints;
+
+            bool twoHanded{false};
+            float nearDistance{0.0f};
+            float farDistance{0.1f};
+            std::string action[HandCount];
+
+            bool isValid() const {
+                return !joints.empty() && joints.size() % 2 == 0 &&
+                       std::all_of(joints.cbegin(), joints.cend(), [](int joint) {
+                           return joint >= 0 && joint < XR_HAND_JOINT_COUNT_EXT;
+                       });
+            }
+        };
+
+        // In order of declaration. The 1st custom gesture ("custom1") can also be used for haptics.
+        std::vector<CustomGesture> customGestures;
+
+        CustomGesture& getCustomGesture(const std::string& name);
     };
 
     class HandTracker : public IHandTracker {
@@ -214,6 +218,8 @@ namespace {
             m_config.LoadConfiguration(openXR.GetApplicationName());
             m_config.Dump();
 
+            m_gestureEngine = CreateGestureEngine();
+
             CHECK_HRCMD(openXR.xrStringToPath(
                 openXR.GetXrInstance(), m_config.interactionProfile.c_str(), &m_interactionProfile));
 
@@ -279,95 +285,31 @@ namespace {
             if (bindings.interactionProfile == m_interactionProfile) {
                 Log("Binding to interaction profile: %s\n", getPath(m_interactionProfile).c_str());
 
-                // Clear any previous mappings.
-                m_actions.clear();
-
-                bool hasSystemClick = false;
+                m_actionRouter.clearBindings();
                 for (uint32_t i = 0; i < bindings.countSuggestedBindings; i++) {
                     const std::string fullPath = getPath(bindings.suggestedBindings[i].binding);
-
-                    XrPath subActionPath;
-                    Hand hand;
-                    if (fullPath.find("/user/hand/left") == 0) {
-                        hand = Hand::Left;
-                        subActionPath = m_leftHandSubaction;
-                    } else if (fullPath.find("/user/hand/right") == 0) {
-                        hand = Hand::Right;
-                        subActionPath = m_rightHandSubaction;
-                    } else {
-                        // We ignore non-hand actions.
-                        continue;
-                    }
-
-                    static std::string_view systemClickPath = "/input/system/click";
-                    // Keep track of the /input/system/click
-                    // path.endswith("/input/system/click")
-                    if (fullPath.rfind(systemClickPath) == fullPath.length() - systemClickPath.length()) {
-                        hasSystemClick = true;
-                    }
-
                     const XrAction action = bindings.suggestedBindings[i].action;
-                    auto actionIt = m_actions.find(action);
-                    if (actionIt == m_actions.end()) {
-                        Action entry;
-
-                        for (auto& actionSet : m_actionSets) {
-                            if (actionSet.second.find(action) != actionSet.second.cend()) {
-                                entry.actionSet = actionSet.first;
-                                break;
-                            }
-                        }
 
-                        actionIt = m_actions.insert_or_assign(bindings.suggestedBindings[i].action, entry).first;
+                    XrActionSet actionSet = XR_NULL_HANDLE;
+                    for (const auto& entry : m_actionSets) {
+                        if (entry.second.find(action) != entry.second.cend()) {
+                            actionSet = entry.first;
+                            break;
+                        }
                     }
-                    Action& entry = actionIt->second;
-
-                    SubAction subAction;
-                    subAction.hand = hand;
-                    subAction.path = fullPath;
-                    DebugLog("Simulating action path %s\n", fullPath.c_str());
-                    entry.subActions.insert_or_assign(subActionPath, subAction);
-                }
 
-                // Dummy action to keep track of /input/system/click in case the application does not register it (which
-                // is likely in fact).
-                if (!hasSystemClick) {
-                    Action systemClick;
-
-                    systemClick.actionSet = XR_NULL_HANDLE;
-                    {
-                        SubAction subAction;
-                        subAction.hand = Hand::Left;
-                        subAction.path = "/user/hand/left/input/system/click";
-                        systemClick.subActions.insert_or_assign(m_leftHandSubaction, subAction);
-                    }
-                    {
-                        SubAction subAction;
-                        subAction.hand = Hand::Left;
-                        subAction.path = "/user/hand/right/input/system/click";
-                        systemClick.subActions.insert_or_assign(m_rightHandSubaction, subAction);
+                    // We ignore non-hand actions.
+                    if (m_actionRouter.bind(action, actionSet, fullPath)) {
+                        DebugLog("Simulating action path %s\n", fullPath.c_str());
                     }
-
-                    m_actions.insert_or_assign(XR_NULL_HANDLE, systemClick);
                 }
+                m_actionRouter.bindSystemClick();
             }
         }
 
         const std::string getFullPath(XrAction action, XrPath subActionPath) override {
-            const auto& actionIt = m_actions.find(action);
-            if (actionIt == m_actions.cend()) {
-                return {};
-            }
-
-            auto subActionIt = actionIt->second.subActions.find(subActionPath);
-            if (subActionIt == actionIt->second.subActions.cend()) {
-                if (actionIt->second.subActions.empty()) {
-                    return {};
-                }
-                subActionIt = actionIt->second.subActions.begin();
-            }
-
-            return subActionIt->second.path;
+            const SubAction* subAction = findSubAction(action, subActionPath);
+            return subAction ? subAction->path : std::string();
         }
 
         void beginSession(XrSession session, std::shared_ptr<toolkit::graphics::IDevice> graphicsDevice) override {
@@ -433,6 +375,16 @@ namespace {
 
                     std::string line(buffer);
                     m_config.ParseConfigurationStatement(line);
+                    m_needUpdateGestures = true;
+
+                    std::unique_lock lock(m_cacheLock);
+                    for (auto& spacePredictors : m_handPosePredictors) {
+                        for (auto& predictor : spacePredictors.second) {
+                            if (predictor) {
+                                predictor->setParameters({m_config.extrapolationHorizon});
+                            }
+                        }
+                    }
                 }
             }
 
@@ -442,9 +394,7 @@ namespace {
                 for (auto& spaceCache : m_cachedHandJointsPoses) {
                     auto& cache = spaceCache.second;
                     for (uint32_t side = 0; side < HandCount; side++) {
-                        while (cache[side].size() > 0 && cache[side].front().first + GracePeriod < now) {
-                            cache[side].pop_front();
-                        }
+                        cache[side].evictOlderThan(now - GracePeriod);
 
                         // Update statistics.
                         if (spaceCache.first == m_preferredBaseSpace.value_or(m_referenceSpace)) {
@@ -452,6 +402,17 @@ namespace {
                         }
                     }
                 }
+                for (uint32_t side = 0; side < HandCount; side++) {
+                    m_gesturesState.numJointsQueries[side] = m_numJointsQueries[side];
+                    m_numJointsQueries[side] = 0;
+                }
+                const auto predictorsIt = m_handPosePredictors.find(m_preferredBaseSpace.value_or(m_referenceSpace));
+                if (predictorsIt != m_handPosePredictors.cend()) {
+                    for (uint32_t side = 0; side < HandCount; side++) {
+                        const auto& predictor = predictorsIt->second[side];
+                        m_gesturesState.predictionConfidence[side] = predictor ? predictor->getConfidence() : NAN;
+                    }
+                }
             }
 
             // Inhibit one and or the other if request. The config file acts as a global override.
@@ -463,52 +424,30 @@ namespace {
                                                                handTrackingEnabled == HandTrackingEnabled::Right);
 
             // Get joints poses.
+            HandJointsPoses jointsPoses[HandCount];
             const XrHandJointLocationEXT* leftHandJointsPoses = nullptr;
             if (m_leftHandEnabled) {
-                leftHandJointsPoses = getCachedHandJointsPoses(
-                    Hand::Left, m_thisFrameTime, now, m_preferredBaseSpace.value_or(m_referenceSpace));
+                getCachedHandJointsPoses(
+                    Hand::Left, m_thisFrameTime, now, m_preferredBaseSpace.value_or(m_referenceSpace), jointsPoses[0]);
+                leftHandJointsPoses = jointsPoses[0].data();
             }
             const XrHandJointLocationEXT* rightHandJointsPoses = nullptr;
             if (m_rightHandEnabled) {
-                rightHandJointsPoses = getCachedHandJointsPoses(
-                    Hand::Right, m_thisFrameTime, now, m_preferredBaseSpace.value_or(m_referenceSpace));
+                getCachedHandJointsPoses(
+                    Hand::Right, m_thisFrameTime, now, m_preferredBaseSpace.value_or(m_referenceSpace), jointsPoses[1]);
+                rightHandJointsPoses = jointsPoses[1].data();
             }
 
-            // Only sync actions for the specified action sets.
-            std::set<XrAction> ignore;
-            const Action* systemClick = nullptr;
-            for (auto& action : m_actions) {
-                bool foundActionSet = false;
-                for (uint32_t i = 0; i < syncInfo.countActiveActionSets; i++) {
-                    if (action.second.actionSet == XR_NULL_HANDLE ||
-                        action.second.actionSet == syncInfo.activeActionSets[i].actionSet) {
-                        // TODO: We ignore the subActionPath at this time. This is largely OK and mean we might be
-                        // non-compliant to some edge cases.
-                        foundActionSet = true;
-                        break;
-                    }
-                }
-
-                if (!foundActionSet) {
-                    ignore.insert(action.first);
-                }
-
-                const auto& subAction = *action.second.subActions.cbegin();
-                const auto& path = subAction.second.path;
-                static std::string_view systemClickPath = "/input/system/click";
-                // Keep track of the /input/system/click
-                // path.endswith("/input/system/click")
-                if (path.rfind(systemClickPath) == path.length() - systemClickPath.length()) {
-                    systemClick = &action.second;
-                }
-
-                for (auto& subAction : action.second.subActions) {
-                    subAction.second.synced = false;
-                }
+            if (m_needUpdateGestures) {
+                updateGestures();
+                m_needUpdateGestures = false;
             }
 
+            // Only sync actions for the specified action sets.
+            m_actionRouter.beginSync(syncInfo);
+
             // For each gesture, update the action value.
-            performGesturesDetection(leftHandJointsPoses, rightHandJointsPoses, ignore, now);
+            performGesturesDetection(leftHandJointsPoses, rightHandJointsPoses, now);
 
             // Check for keepalive.
             if (!m_config.keepaliveAction.empty() && m_config.keepaliveInterval) {
@@ -516,7 +455,8 @@ namespace {
                     if (m_lastKeepalive) {
                         for (uint32_t side = 0; side < HandCount; side++) {
                             const Hand hand = (Hand)side;
-                            recordActionValue(hand, m_config.keepaliveAction, ignore, 1.f, now);
+                            m_actionRouter.record(
+                                hand, m_actionRouter.getKeepaliveSource(), 1.f, m_config.clickThreshold, now);
                         }
                     }
 
@@ -525,25 +465,15 @@ namespace {
             }
 
             // Special handling for Windows key.
-            if (systemClick) {
-                bool didChange = false;
-                bool value = false;
-
-                for (auto& subAction : systemClick->subActions) {
-                    didChange = didChange || subAction.second.boolValueChanged;
-                    value = value || subAction.second.boolValue;
-                }
-
-                if (didChange && value) {
-                    INPUT input[2];
-                    ZeroMemory(input, sizeof(input));
-                    input[0].type = INPUT_KEYBOARD;
-                    input[0].ki.wVk = VK_LWIN;
-                    input[1].type = INPUT_KEYBOARD;
-                    input[1].ki.wVk = VK_LWIN;
-                    input[1].ki.dwFlags = KEYEVENTF_KEYUP;
-                    SendInput(2, input, sizeof(INPUT));
-                }
+            if (m_actionRouter.isSystemClickPressed()) {
+                INPUT input[2];
+                ZeroMemory(input, sizeof(input));
+                input[0].type = INPUT_KEYBOARD;
+                input[0].ki.wVk = VK_LWIN;
+                input[1].type = INPUT_KEYBOARD;
+                input[1].ki.wVk = VK_LWIN;
+                input[1].ki.dwFlags = KEYEVENTF_KEYUP;
+                SendInput(2, input, sizeof(INPUT));
             }
 
             const int64_t timeout = m_configManager->getValue(SettingHandTimeout);
@@ -559,34 +489,8 @@ namespace {
                 // see the zero'ed action. If any action was not 0, we set the tracked bit again to give the app one
                 // more chance to see the changes.
                 if (m_trackedRecently[side] && !tracked) {
-                    const XrPath subactionPath = side == 0 ? m_leftHandSubaction : m_rightHandSubaction;
-                    for (auto& action : m_actions) {
-                        auto subActionIt = action.second.subActions.find(subactionPath);
-                        if (subActionIt == action.second.subActions.cend()) {
-                            if (action.second.subActions.empty()) {
-                                continue;
-                            }
-                            const auto& fullPath = action.second.subActions.begin()->second.path;
-                            if ((side == 0 && fullPath.find("/user/hand/left") != 0) ||
-                                (side == 1 && fullPath.find("/user/hand/right") != 0)) {
-                                continue;
-                            }
-                        }
-                        auto& subAction = subActionIt->second;
-                        // We must only set changed if the value is actually different.
-                        subAction.floatValueChanged = std::abs(subAction.floatValue) > FLT_EPSILON;
-                        subAction.floatValue = 0.f;
-                        if (subAction.floatValueChanged) {
-                            subAction.timeFloatValueChanged = now;
-                            tracked = true;
-                        }
-
-                        subAction.boolValueChanged = subAction.boolValue;
-                        subAction.boolValue = false;
-                        if (subAction.boolValueChanged) {
-                            subAction.timeBoolValueChanged = now;
-                            tracked = true;
-                        }
+                    if (m_actionRouter.zero((Hand)side, now)) {
+                        tracked = true;
                     }
 
                     // Clear statistics.
@@ -612,7 +516,8 @@ namespace {
                 return false;
             }
 
-            const auto& jointsPoses = getCachedHandJointsPoses(actionSpace.hand, time, now, baseSpace);
+            HandJointsPoses jointsPoses;
+            getCachedHandJointsPoses(actionSpace.hand, time, now, baseSpace, jointsPoses);
 
             const uint32_t side = actionSpace.hand == Hand::Left ? 0 : 1;
             const uint32_t joint =
@@ -647,8 +552,8 @@ namespace {
                     continue;
                 }
 
-                const auto& jointsPoses =
-                    getCachedHandJointsPoses(hand ? Hand::Right : Hand::Left, m_thisFrameTime, now, baseSpace);
+                HandJointsPoses jointsPoses;
+                getCachedHandJointsPoses(hand ? Hand::Right : Hand::Left, m_thisFrameTime, now, baseSpace, jointsPoses);
 
                 for (uint32_t joint = 0; joint < XR_HAND_JOINT_COUNT_EXT; joint++) {
                     if (!xr::math::Pose::IsPoseValid(jointsPoses[joint].locationFlags)) {
@@ -668,59 +573,29 @@ namespace {
         }
 
         bool getActionState(const XrActionStateGetInfo& getInfo, XrActionStateBoolean& state) const override {
-            const auto& actionIt = m_actions.find(getInfo.action);
-            if (actionIt == m_actions.cend()) {
-                return false;
-            }
-            const auto& action = actionIt->second;
-
-            auto subActionIt = action.subActions.find(getInfo.subactionPath);
-            if (subActionIt == actionIt->second.subActions.cend()) {
-                if (actionIt->second.subActions.empty()) {
-                    return false;
-                }
-                subActionIt = actionIt->second.subActions.begin();
-            }
-            const auto& subAction = subActionIt->second;
-
-            if ((subAction.hand == Hand::Left && !m_leftHandEnabled) ||
-                (subAction.hand == Hand::Right && !m_rightHandEnabled)) {
+            const SubAction* subAction = findSubAction(getInfo.action, getInfo.subactionPath);
+            if (!subAction || !isHandEnabled(subAction->hand)) {
                 return false;
             }
 
             state.isActive = XR_TRUE;
-            state.currentState = subAction.boolValue;
-            state.changedSinceLastSync = subAction.boolValueChanged;
-            state.lastChangeTime = subAction.timeBoolValueChanged;
+            state.currentState = subAction->boolValue;
+            state.changedSinceLastSync = subAction->boolValueChanged;
+            state.lastChangeTime = subAction->timeBoolValueChanged;
 
             return true;
         }
 
         bool getActionState(const XrActionStateGetInfo& getInfo, XrActionStateFloat& state) const override {
-            const auto& actionIt = m_actions.find(getInfo.action);
-            if (actionIt == m_actions.cend()) {
-                return false;
-            }
-            const auto& action = actionIt->second;
-
-            auto subActionIt = action.subActions.find(getInfo.subactionPath);
-            if (subActionIt == actionIt->second.subActions.cend()) {
-                if (actionIt->second.subActions.empty()) {
-                    return false;
-                }
-                subActionIt = actionIt->second.subActions.begin();
-            }
-            const auto& subAction = subActionIt->second;
-
-            if ((subAction.hand == Hand::Left && !m_leftHandEnabled) ||
-                (subAction.hand == Hand::Right && !m_rightHandEnabled)) {
+            const SubAction* subAction = findSubAction(getInfo.action, getInfo.subactionPath);
+            if (!subAction || !isHandEnabled(subAction->hand)) {
                 return false;
             }
 
             state.isActive = XR_TRUE;
-            state.currentState = subAction.floatValue;
-            state.changedSinceLastSync = subAction.floatValueChanged;
-            state.lastChangeTime = subAction.timeFloatValueChanged;
+            state.currentState = subAction->floatValue;
+            state.changedSinceLastSync = subAction->floatValueChanged;
+            state.lastChangeTime = subAction->timeFloatValueChanged;
 
             return true;
         }
@@ -774,67 +649,161 @@ namespace {
             return str;
         }
 
-        const XrHandJointLocationEXT*
-        getCachedHandJointsPoses(Hand hand, XrTime time, XrTime now, std::optional<XrSpace> baseSpace) const {
+        void getCachedHandJointsPoses(Hand hand,
+                                      XrTime time,
+                                      XrTime now,
+                                      std::optional<XrSpace> baseSpace,
+                                      HandJointsPoses& jointsPoses) const {
             const uint32_t side = hand == Hand::Left ? 0 : 1;
 
             std::unique_lock lock(m_cacheLock);
 
-            std::deque<CacheEntry> cache = m_cachedHandJointsPoses[baseSpace.value_or(m_referenceSpace)][side];
-
-            // Search for a entry in the cache.
-            int32_t closestIndex = -1;
-            std::deque<CacheEntry>::iterator insertIt = cache.begin();
-            XrTime closestTimeDelta = INT64_MAX;
-            for (uint32_t i = 0; i < cache.size(); i++) {
-                const auto t = cache[i].first;
-                const XrTime delta = std::abs(t - time);
-                if (t < time) {
-                    insertIt++;
-                }
+            auto& cache = m_cachedHandJointsPoses[baseSpace.value_or(m_referenceSpace)][side];
 
-                if (delta < closestTimeDelta) {
-                    closestTimeDelta = delta;
-                    closestIndex = i;
-                } else {
-                    break;
-                }
+            if (cache.find(time, GracePeriod, m_config.interpolateCachedPoses, jointsPoses)) {
+                return;
             }
 
-            if (closestIndex != -1 && closestTimeDelta < GracePeriod) {
-                return cache[closestIndex].second.data();
+            auto& predictor = m_handPosePredictors[baseSpace.value_or(m_referenceSpace)][side];
+            if (!predictor) {
+                predictor = CreateHandPosePredictor({m_config.extrapolationHorizon});
+            }
+
+            // Extrapolate the future poses from the current ones, rather than relying on the runtime to predict them.
+            if (m_config.extrapolationHorizon > 0 && time > now) {
+                if (predictor->getLatestSampleTime() < now - GracePeriod) {
+                    locateHandJoints(side, baseSpace.value_or(m_referenceSpace), time, now, jointsPoses);
+                    predictor->addSample(now, jointsPoses.data());
+                }
+                predictor->predict(time, jointsPoses.data());
+                cache.insert(time, jointsPoses);
+                return;
             }
 
             // Create a new entry.
-            {
-                XrHandJointsLocateInfoEXT locateInfo{XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT};
-                locateInfo.baseSpace = baseSpace.value_or(m_referenceSpace);
-                // Workaround to loss of virtual controller: do not query a time in the past!
-                locateInfo.time = std::max(time, now);
-
-                CacheEntry entry;
-                XrHandJointLocationsEXT locations{XR_TYPE_HAND_JOINT_LOCATIONS_EXT, nullptr};
-                locations.jointCount = XR_HAND_JOINT_COUNT_EXT;
-                locations.jointLocations = (entry.second).data();
-                entry.first = time;
-
-                CHECK_HRCMD(m_openXR.xrLocateHandJointsEXT(m_handTracker[side], &locateInfo, &locations));
-                if (Pose::IsPoseTracked(locations.jointLocations[XR_HAND_JOINT_PALM_EXT].locationFlags)) {
-                    m_lastTimestampWithPoseTracked[side] = std::max(time, m_lastTimestampWithPoseTracked[side]);
-                } else {
-                    m_gesturesState.numTrackingLosses[side]++;
+            // Workaround to loss of virtual controller: do not query a time in the past!
+            const XrTime locateTime = std::max(time, now);
+            locateHandJoints(side, baseSpace.value_or(m_referenceSpace), time, locateTime, jointsPoses);
+            predictor->addSample(locateTime, jointsPoses.data());
+
+            cache.insert(time, jointsPoses);
+        }
+
+        // Query the runtime. The tracking statistics are accounted at the requested time.
+        void locateHandJoints(
+            uint32_t side, XrSpace baseSpace, XrTime time, XrTime locateTime, HandJointsPoses& jointsPoses) const {
+            XrHandJointsLocateInfoEXT locateInfo{XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT};
+            locateInfo.baseSpace = baseSpace;
+            locateInfo.time = locateTime;
+
+            XrHandJointLocationsEXT locations{XR_TYPE_HAND_JOINT_LOCATIONS_EXT, nullptr};
+            locations.jointCount = XR_HAND_JOINT_COUNT_EXT;
+            locations.jointLocations = jointsPoses.data();
+
+            CHECK_HRCMD(m_openXR.xrLocateHandJointsEXT(m_handTracker[side], &locateInfo, &locations));
+            m_numJointsQueries[side]++;
+            if (Pose::IsPoseTracked(locations.jointLocations[XR_HAND_JOINT_PALM_EXT].locationFlags)) {
+                m_lastTimestampWithPoseTracked[side] = std::max(time, m_lastTimestampWithPoseTracked[side]);
+            } else {
+                m_gesturesState.numTrackingLosses[side]++;
+            }
+        }
+
+        // Flatten the built-in and custom gestures that are bound to an action for the gesture engine.
+        void updateGestures() {
+            const Gesture hapticsGesture =
+                !m_config.hapticsAction.empty() ? m_config.hapticsResponseGesture : Gesture::MaxValue;
+
+            std::vector<GestureDefinition> definitions;
+            m_boundGestures.clear();
+            const auto addGesture = [&](Gesture gesture,
+                                        GestureDefinition definition,
+                                        const std::string (&action)[HandCount],
+                                        float* stateValue) {
+                const bool isHapticsGesture = gesture != Gesture::MaxValue && gesture == hapticsGesture;
+                if (action[0].empty() && action[1].empty() && !isHapticsGesture) {
+                    return;
+                }
+
+                m_boundGestures.push_back(
+                    {{action[0], action[1]}, definition.twoHanded, isHapticsGesture, stateValue});
+                definitions.push_back(std::move(definition));
+            };
+
+#define BUILTIN_GESTURE(configName, gesture, twoHanded, ...)                                                           \
+    addGesture(gesture,                                                                                                \
+               {#configName, {__VA_ARGS__}, twoHanded, m_config.configName##Near, m_config.configName##Far},           \
+               m_config.configName##Action,                                                                            \
+               m_gesturesState.configName##Value);
+
+            // Handle gestures made up from one hand.
+            BUILTIN_GESTURE(pinch, Gesture::Pinch, false, {XR_HAND_JOINT_THUMB_TIP_EXT, XR_HAND_JOINT_INDEX_TIP_EXT});
+            BUILTIN_GESTURE(thumbPress,
+                            Gesture::ThumbPress,
+                            false,
+                            {XR_HAND_JOINT_INDEX_INTERMEDIATE_EXT, XR_HAND_JOINT_THUMB_TIP_EXT});
+            BUILTIN_GESTURE(indexBend,
+                            Gesture::IndexBend,
+                            false,
+                            {XR_HAND_JOINT_INDEX_PROXIMAL_EXT, XR_HAND_JOINT_INDEX_TIP_EXT});
+            BUILTIN_GESTURE(fingerGun,
+                            Gesture::FingerGun,
+                            false,
+                            {XR_HAND_JOINT_THUMB_TIP_EXT, XR_HAND_JOINT_MIDDLE_INTERMEDIATE_EXT});
+
+            // Squeeze requires to look at 3 fingers.
+            BUILTIN_GESTURE(squeeze,
+                            Gesture::Squeeze,
+                            false,
+                            {XR_HAND_JOINT_MIDDLE_TIP_EXT, XR_HAND_JOINT_MIDDLE_METACARPAL_EXT},
+                            {XR_HAND_JOINT_RING_TIP_EXT, XR_HAND_JOINT_RING_METACARPAL_EXT},
+                            {XR_HAND_JOINT_LITTLE_TIP_EXT, XR_HAND_JOINT_LITTLE_METACARPAL_EXT});
+
+            // Handle gestures made up using both hands.
+            BUILTIN_GESTURE(palmTap, Gesture::MaxValue, true, {XR_HAND_JOINT_PALM_EXT, XR_HAND_JOINT_INDEX_TIP_EXT});
+            BUILTIN_GESTURE(wristTap, Gesture::MaxValue, true, {XR_HAND_JOINT_WRIST_EXT, XR_HAND_JOINT_INDEX_TIP_EXT});
+            BUILTIN_GESTURE(
+                indexTipTap, Gesture::MaxValue, true, {XR_HAND_JOINT_INDEX_TIP_EXT, XR_HAND_JOINT_INDEX_TIP_EXT});
+
+#undef BUILTIN_GESTURE
+
+            for (const auto& customGesture : m_config.customGestures) {
+                if (!customGesture.isValid()) {
+                    continue;
                 }
-                
-                std::deque<CacheEntry>::iterator ret = cache.emplace(insertIt, entry);
-                return ret->second.data();
+
+                GestureDefinition definition{customGesture.name,
+                                             {},
+                                             customGesture.twoHanded,
+                                             customGesture.nearDistance,
+                                             customGesture.farDistance};
+                for (size_t i = 0; i < customGesture.joints.size(); i += 2) {
+                    definition.joints.push_back(
+                        {(uint32_t)customGesture.joints[i], (uint32_t)customGesture.joints[i + 1]});
+                }
+
+                const bool isCustom1 = customGesture.name == "custom1";
+                addGesture(isCustom1 ? Gesture::Custom1 : Gesture::MaxValue,
+                           std::move(definition),
+                           customGesture.action,
+                           isCustom1 ? m_gesturesState.custom1Value : nullptr);
+            }
+
+            m_gestureEngine->setGestures(definitions);
+
+            // The sources of action values are indexed like the gestures.
+            std::vector<std::array<std::string, HandCount>> gestureActions;
+            for (const auto& gesture : m_boundGestures) {
+                gestureActions.push_back({gesture.action[0], gesture.action[1]});
             }
+            m_actionRouter.setSources(std::move(gestureActions), m_config.hapticsAction, m_config.keepaliveAction);
         }
 
         void performGesturesDetection(const XrHandJointLocationEXT* leftHandJointsPoses,
                                       const XrHandJointLocationEXT* rightHandJointsPoses,
-                                      const std::set<XrAction>& ignore,
                                       XrTime now) {
-#define ACTION_PARAMS(configName) m_config.configName##Action[side],
+            // Evaluate all the gestures for both hands at once.
+            m_gestureEngine->evaluate(leftHandJointsPoses, rightHandJointsPoses);
 
             for (uint32_t side = 0; side < HandCount; side++) {
                 const Hand hand = (Hand)side;
@@ -847,175 +816,41 @@ namespace {
                     continue;
                 }
 
-                const Gesture hapticsGesture =
-                    !m_config.hapticsAction.empty() ? m_config.hapticsResponseGesture : Gesture::MaxValue;
                 bool hapticsGestureState = false;
-
-#define ONE_HANDED_GESTURE(configName, gesture, joint1, joint2)                                                        \
-    do {                                                                                                               \
-        if (!m_config.configName##Action[side].empty() || hapticsGesture == gesture) {                                 \
-            const auto value = computeJointActionValue(                                                                \
-                jointsPoses, (joint1), jointsPoses, (joint2), m_config.configName##Near, m_config.configName##Far);    \
-            m_gesturesState.configName##Value[side] = value;                                                           \
-            if (!m_config.configName##Action[side].empty()) {                                                          \
-                recordActionValue(hand, m_config.configName##Action[side], ignore, value, now);                        \
-            }                                                                                                          \
-            if (hapticsGesture == gesture) {                                                                           \
-                hapticsGestureState = value >= m_config.clickThreshold;                                                \
-            }                                                                                                          \
-        }                                                                                                              \
-    } while (false);
-
-                // Handle gestures made up from one hand.
-                ONE_HANDED_GESTURE(pinch, Gesture::Squeeze, XR_HAND_JOINT_THUMB_TIP_EXT, XR_HAND_JOINT_INDEX_TIP_EXT);
-                ONE_HANDED_GESTURE(
-                    thumbPress, Gesture::ThumbPress, XR_HAND_JOINT_INDEX_INTERMEDIATE_EXT, XR_HAND_JOINT_THUMB_TIP_EXT);
-                ONE_HANDED_GESTURE(
-                    indexBend, Gesture::IndexBend, XR_HAND_JOINT_INDEX_PROXIMAL_EXT, XR_HAND_JOINT_INDEX_TIP_EXT);
-                ONE_HANDED_GESTURE(
-                    fingerGun, Gesture::FingerGun, XR_HAND_JOINT_THUMB_TIP_EXT, XR_HAND_JOINT_MIDDLE_INTERMEDIATE_EXT);
-
-                if (m_config.custom1Joint1Index >= 0 && m_config.custom1Joint2Index >= 0) {
-                    ONE_HANDED_GESTURE(
-                        custom1, Gesture::Custom1, m_config.custom1Joint1Index, m_config.custom1Joint2Index);
-                }
-
-#undef ONE_HANDED_GESTURE
-
-                // Squeeze requires to look at 3 fingers.
-                if (!m_config.squeezeAction[side].empty() || hapticsGesture == Gesture::Squeeze) {
-                    float squeeze[3] = {computeJointActionValue(jointsPoses,
-                                                                XR_HAND_JOINT_MIDDLE_TIP_EXT,
-                                                                jointsPoses,
-                                                                XR_HAND_JOINT_MIDDLE_METACARPAL_EXT,
-                                                                m_config.squeezeNear,
-                                                                m_config.squeezeFar),
-                                        computeJointActionValue(jointsPoses,
-                                                                XR_HAND_JOINT_RING_TIP_EXT,
-                                                                jointsPoses,
-                                                                XR_HAND_JOINT_RING_METACARPAL_EXT,
-                                                                m_config.squeezeNear,
-                                                                m_config.squeezeFar),
-                                        computeJointActionValue(jointsPoses,
-                                                                XR_HAND_JOINT_LITTLE_TIP_EXT,
-                                                                jointsPoses,
-                                                                XR_HAND_JOINT_LITTLE_METACARPAL_EXT,
-                                                                m_config.squeezeNear,
-                                                                m_config.squeezeFar)};
-
-                    // Quickly bubble sort.
-                    if (squeeze[0] > squeeze[1]) {
-                        std::swap(squeeze[0], squeeze[1]);
-                    }
-                    if (squeeze[0] > squeeze[2]) {
-                        std::swap(squeeze[0], squeeze[2]);
-                    }
-                    if (squeeze[1] > squeeze[2]) {
-                        std::swap(squeeze[1], squeeze[2]);
+                for (uint32_t i = 0; i < m_boundGestures.size(); i++) {
+                    const auto& gesture = m_boundGestures[i];
+                    if ((gesture.action[side].empty() && !gesture.isHapticsGesture) ||
+                        (gesture.twoHanded && !jointsPosesOtherHand)) {
+                        continue;
                     }
 
-                    // Ignore the lowest value, average the other ones.
-                    const float value = (squeeze[1] + squeeze[2]) / 2.f;
-                    m_gesturesState.squeezeValue[side] = value;
-                    if (!m_config.squeezeAction[side].empty()) {
-                        recordActionValue(hand, m_config.squeezeAction[side], ignore, value, now);
+                    const float value = m_gestureEngine->getValue(i, hand);
+                    if (gesture.stateValue) {
+                        gesture.stateValue[side] = value;
+                    }
+                    if (!gesture.action[side].empty()) {
+                        m_actionRouter.record(hand, i, value, m_config.clickThreshold, now);
                     }
-                    if (hapticsGesture == Gesture::Squeeze) {
+                    if (gesture.isHapticsGesture) {
                         hapticsGestureState = value >= m_config.clickThreshold;
                     }
                 }
 
                 // Check for haptics trigger.
                 if (m_evaluateHapticsGesture && !m_config.hapticsAction.empty() && hapticsGestureState) {
-                    recordActionValue(hand, m_config.hapticsAction, ignore, 1.f, now);
+                    m_actionRouter.record(
+                        hand, m_actionRouter.getHapticsSource(), 1.f, m_config.clickThreshold, now);
                 }
-
-#define TWO_HANDED_GESTURE(configName, joint1, joint2)                                                                 \
-    do {                                                                                                               \
-        if (!m_config.configName##Action[side].empty()) {                                                              \
-            const auto value = computeJointActionValue(jointsPoses,                                                    \
-                                                       (joint1),                                                       \
-                                                       jointsPosesOtherHand,                                           \
-                                                       (joint2),                                                       \
-                                                       m_config.configName##Near,                                      \
-                                                       m_config.configName##Far);                                      \
-            m_gesturesState.configName##Value[side] = value;                                                           \
-            recordActionValue(hand, m_config.configName##Action[side], ignore, value, now);                            \
-        }                                                                                                              \
-    } while (false);
-
-                if (!jointsPosesOtherHand) {
-                    continue;
-                }
-
-                // Handle gestures made up using both hands.
-
-                TWO_HANDED_GESTURE(palmTap, XR_HAND_JOINT_PALM_EXT, XR_HAND_JOINT_INDEX_TIP_EXT);
-                TWO_HANDED_GESTURE(wristTap, XR_HAND_JOINT_WRIST_EXT, XR_HAND_JOINT_INDEX_TIP_EXT);
-                TWO_HANDED_GESTURE(indexTipTap, XR_HAND_JOINT_INDEX_TIP_EXT, XR_HAND_JOINT_INDEX_TIP_EXT);
-
-#undef TWO_HANDED_GESTURE
             }
 
             m_evaluateHapticsGesture = false;
         }
 
-        // Compute the scaled action value based on the distance between 2 joints.
-        float computeJointActionValue(const XrHandJointLocationEXT* joints1Poses,
-                                      uint32_t joint1,
-                                      const XrHandJointLocationEXT* joints2Poses,
-                                      uint32_t joint2,
-                                      float nearDistance,
-                                      float farDistance) {
-            if (Pose::IsPoseValid(joints1Poses[joint1].locationFlags) &&
-                Pose::IsPoseValid(joints2Poses[joint2].locationFlags)) {
-                // We ignore joints radius and assume the near/far distance are configured to account for them.
-                const float distance =
-                    std::max(Length(joints1Poses[joint1].pose.position - joints2Poses[joint2].pose.position), 0.f);
-
-                return 1.f -
-                       (std::clamp(distance, nearDistance, farDistance) - nearDistance) / (farDistance - nearDistance);
-            }
-            return NAN;
-        }
-
-        void recordActionValue(
-            Hand hand, const std::string& actionPath, const std::set<XrAction>& ignore, float value, XrTime now) {
-            assert(!actionPath.empty());
-
-            if (isnan(value)) {
-                return;
-            }
-
-            const XrPath subActionPath = hand == Hand::Left ? m_leftHandSubaction : m_rightHandSubaction;
-
-            for (auto& action : m_actions) {
-                if (ignore.find(action.first) != ignore.cend()) {
-                    continue;
-                }
-
-                auto& subAction = action.second.subActions[subActionPath];
-                const std::string& path = subAction.path;
-
-                // path.endswith(actionPath)
-                if (path.rfind(actionPath) == path.length() - actionPath.length()) {
-                    // If multiple gestures are bound to the same action, pick the highest value.
-                    const float newFloatValue = subAction.synced ? std::max(subAction.floatValue, value) : value;
-                    const bool newBoolValue = newFloatValue >= m_config.clickThreshold;
-
-                    if (std::abs(subAction.floatValue - newFloatValue) > FLT_EPSILON) {
-                        subAction.floatValue = newFloatValue;
-                        subAction.timeFloatValueChanged = now;
-                        subAction.floatValueChanged = true;
-                    }
-                    if (subAction.boolValue != newBoolValue) {
-                        subAction.boolValue = newBoolValue;
-                        subAction.timeBoolValueChanged = now;
-                        subAction.boolValueChanged = true;
-                    }
-                    subAction.synced = true;
-                }
-            }
+        const SubAction* findSubAction(XrAction action, XrPath subActionPath) const {
+            const std::optional<Hand> hand = subActionPath == m_leftHandSubaction    ? Hand::Left
+                                             : subActionPath == m_rightHandSubaction ? Hand::Right
+                                                                                     : std::optional<Hand>();
+            return m_actionRouter.find(action, hand);
         }
 
         OpenXrApi& m_openXR;
@@ -1028,6 +863,20 @@ namespace {
 
         Config m_config;
         SOCKET m_configSocket{INVALID_SOCKET};
+
+        struct BoundGesture {
+            std::string action[HandCount];
+            bool twoHanded;
+            bool isHapticsGesture;
+
+            // Where to report the value for the menu (if any).
+            float* stateValue;
+        };
+
+        // Indexed like the gestures in the gesture engine.
+        std::vector<BoundGesture> m_boundGestures;
+        std::shared_ptr<IGestureEngine> m_gestureEngine;
+        bool m_needUpdateGestures{true};
         XrPath m_interactionProfile{XR_NULL_PATH};
 
         std::shared_ptr<IDevice> m_graphicsDevice;
@@ -1042,14 +891,15 @@ namespace {
 
         std::map<XrSpace, ActionSpace> m_actionSpaces;
         std::map<XrActionSet, std::set<XrAction>> m_actionSets;
-        std::map<XrAction, Action> m_actions;
+        ActionRouter m_actionRouter;
 
         bool m_trackedRecently[2]{false, false};
         bool m_evaluateHapticsGesture{false};
         XrTime m_lastKeepalive{0};
 
-        using CacheEntry = std::pair<XrTime, std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT>>;
-        mutable std::map<XrSpace, std::deque<CacheEntry>[HandCount]> m_cachedHandJointsPoses;
+        mutable std::map<XrSpace, HandJointsPosesCache[HandCount]> m_cachedHandJointsPoses;
+        mutable std::map<XrSpace, std::array<std::shared_ptr<IHandPosePredictor>, HandCount>> m_handPosePredictors;
+        mutable uint32_t m_numJointsQueries[HandCount]{0, 0};
         mutable std::mutex m_cacheLock;
         mutable std::optional<XrSpace> m_preferredBaseSpace;
         mutable XrTime m_lastTimestampWithPoseTracked[HandCount]{0, 0};
@@ -1069,6 +919,8 @@ namespace {
         hapticsAction = "";
         keepaliveInterval = 0;
         keepaliveAction = "";
+        interpolateCachedPoses = true;
+        extrapolationHorizon = 0;
         pinchAction[0] = pinchAction[1] = "";
         pinchNear = 0.0f;
         pinchFar = 0.05f;
@@ -1095,19 +947,25 @@ namespace {
         indexTipTapAction[1] = "/input/b/click";
         indexTipTapNear = 0.0f;
         indexTipTapFar = 0.07f;
-        // Custom gesture is unconfigured.
-        custom1Action[0] = custom1Action[1] = "";
-        custom1Joint1Index = -1;
-        custom1Joint2Index = -1;
-        custom1Near = 0.0f;
-        custom1Far = 0.1f;
+        // Custom gestures are unconfigured.
+        customGestures.clear();
+    }
+
+    Config::CustomGesture& Config::getCustomGesture(const std::string& name) {
+        auto it = std::find_if(customGestures.begin(), customGestures.end(), [&](const CustomGesture& gesture) {
+            return gesture.name == name;
+        });
+        if (it == customGestures.end()) {
+            it = customGestures.insert(it, CustomGesture{name});
+        }
+        return *it;
     }
 
     void Config::ParseConfigurationStatement(const std::string& line, unsigned int lineNumber) {
         try {
             const auto offset = line.find('=');
             if (offset != std::string::npos) {
-                const std::string name = line.substr(0, offset);
+                std::string name = line.substr(0, offset);
                 const std::string value = line.substr(offset + 1);
                 std::string subName;
                 int side = -1;
@@ -1120,16 +978,45 @@ namespace {
                     subName = name.substr(6);
                 }
 
+                // The 1st custom gesture predates the user-defined gestures.
+                if (name == "custom1.near" || name == "custom1.far") {
+                    name = "gesture." + name;
+                } else if (subName == "custom1") {
+                    subName = "gesture.custom1";
+                }
+                const size_t gestureOffset = name.rfind("gesture.", 0) == 0 ? name.find('.', 8) : std::string::npos;
+
                 if (name == "interaction_profile") {
                     interactionProfile = value;
                 } else if (name == "aim_joint") {
                     aimJointIndex = std::stoi(value);
                 } else if (name == "grip_joint") {
                     gripJointIndex = std::stoi(value);
-                } else if (name == "custom1_joint1") {
-                    custom1Joint1Index = std::stoi(value);
-                } else if (name == "custom1_joint2") {
-                    custom1Joint2Index = std::stoi(value);
+                } else if (name == "custom1_joint1" || name == "custom1_joint2") {
+                    auto& joints = getCustomGesture("custom1").joints;
+                    joints.resize(2, -1);
+                    joints[name.back() - '1'] = std::stoi(value);
+                } else if (gestureOffset != std::string::npos) {
+                    auto& gesture = getCustomGesture(name.substr(8, gestureOffset - 8));
+                    const std::string property = name.substr(gestureOffset + 1);
+                    if (property == "joints") {
+                        std::stringstream ss(value);
+                        std::string component;
+                        gesture.joints.clear();
+                        while (ss >> component) {
+                            gesture.joints.push_back(std::stoi(component));
+                        }
+                    } else if (property == "two_handed") {
+                        gesture.twoHanded = value == "1" || value == "true";
+                    } else if (property == "near") {
+                        gesture.nearDistance = std::stof(value);
+                    } else if (property == "far") {
+                        gesture.farDistance = std::stof(value);
+                    } else {
+                        Log("L%u: Unrecognized option\n", lineNumber);
+                    }
+                } else if (side >= 0 && subName.rfind("gesture.", 0) == 0) {
+                    getCustomGesture(subName.substr(8)).action[side] = value;
                 } else if (name == "click_threshold") {
                     clickThreshold = std::stof(value);
                 } else if (name == "haptics_frequency") {
@@ -1142,6 +1029,10 @@ namespace {
                     keepaliveInterval = (XrTime)(std::stof(value) * 1e9);
                 } else if (name == "keepalive_action") {
                     keepaliveAction = value;
+                } else if (name == "interpolate_cached_poses") {
+                    interpolateCachedPoses = value == "1" || value == "true";
+                } else if (name == "extrapolation_horizon") {
+                    extrapolationHorizon = (XrDuration)(std::stof(value) * 1e9);
                 } else if (side >= 0 && subName == "enabled") {
                     const bool boolValue = value == "1" || value == "true";
                     if (side == 0) {
@@ -1191,7 +1082,6 @@ namespace {
                 PARSE_ACTION("palm_tap", palmTap)
                 PARSE_ACTION("wrist_tap", wristTap)
                 PARSE_ACTION("index_tip_tap", indexTipTap)
-                PARSE_ACTION("custom1", custom1)
 
 #undef PARSE_ACTION
                 else {
@@ -1259,6 +1149,14 @@ namespace {
             Log("Grip pose uses joint: %d\n", gripJointIndex);
             Log("Aim pose uses joint: %d\n", aimJointIndex);
             Log("Click threshold: %.3f\n", clickThreshold);
+            if (!interpolateCachedPoses) {
+                Log("Interpolation of cached poses is disabled\n");
+            }
+            if (extrapolationHorizon > 0) {
+                Log("Extrapolation horizon: %.1f ms\n", extrapolationHorizon / 1e6);
+            } else {
+                Log("Extrapolation of poses is disabled\n");
+            }
         }
         if (!hapticsAction.empty()) {
             if (!isnan(hapticsResponseFrequency)) {
@@ -1269,8 +1167,22 @@ namespace {
         if (!keepaliveAction.empty() && keepaliveInterval) {
             Log("Keepalive every %llu ns: %s\n", keepaliveInterval, keepaliveAction.c_str());
         }
-        if (custom1Joint1Index >= 0 && custom1Joint2Index >= 0) {
-            Log("Custom gesture uses joints: %d %d\n", custom1Joint1Index, custom1Joint2Index);
+        for (const auto& gesture : customGestures) {
+            if (!gesture.isValid()) {
+                if (!gesture.joints.empty()) {
+                    Log("Custom gesture '%s' has invalid joints\n", gesture.name.c_str());
+                }
+                continue;
+            }
+
+            std::string joints;
+            for (const int joint : gesture.joints) {
+                joints += fmt::format(" {}", joint);
+            }
+            Log("Custom gesture '%s' uses joints:%s%s\n",
+                gesture.name.c_str(),
+                joints.c_str(),
+                gesture.twoHanded ? " (two-handed)" : "");
         }
         for (int side = 0; side < HandCount; side++) {
             if ((side == 0 && !leftHandEnabled) || (side == 1 && !rightHandEnabled)) {
@@ -1294,9 +1206,19 @@ namespace {
             LOG_IF_SET("palm tap", palmTap);
             LOG_IF_SET("wrist tap", wristTap);
             LOG_IF_SET("index tip tap", indexTipTap);
-            LOG_IF_SET("custom gesture", custom1);
 
 #undef LOG_IF_SET
+
+            for (const auto& gesture : customGestures) {
+                if (gesture.isValid() && !gesture.action[side].empty()) {
+                    Log("%s hand '%s' gesture translates to: %s (near: %.3f, far: %.3f)\n",
+                        side ? "Right" : "Left",
+                        gesture.name.c_str(),
+                        gesture.action[side].c_str(),
+                        gesture.nearDistance,
+                        gesture.farDistance);
+                }
+            }
         }
     }
 
@@ -0,0 +1,135 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "pch.h"
+
+namespace toolkit::input {
+
+    using HandJointsPoses = std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT>;
+
+    // A fixed-capacity ring of joints poses, sorted by time. The oldest entry is evicted when the ring is full.
+    class HandJointsPosesCache {
+      public:
+        static constexpr size_t Capacity = 16;
+
+        // Cached poses further apart than this are not interpolated.
+        static constexpr XrTime MaxInterpolationInterval = 25000000; // 25ms
+
+        size_t size() const {
+            return m_size;
+        }
+
+        XrTime getTime(size_t index) const {
+            return m_entries[(m_first + index) % Capacity].time;
+        }
+
+        const HandJointsPoses& getPoses(size_t index) const {
+            return m_entries[(m_first + index) % Capacity].poses;
+        }
+
+        // Returns the index of the first entry that is not older than the given time.
+        size_t lowerBound(XrTime time) const {
+            size_t low = 0;
+            size_t high = m_size;
+            while (low < high) {
+                const size_t middle = (low + high) / 2;
+                if (getTime(middle) < time) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            return low;
+        }
+
+        void insert(XrTime time, const HandJointsPoses& poses) {
+            if (m_size == Capacity) {
+                evictOldest();
+            }
+
+            // Entries are mostly inserted in order, in which case there is nothing to move.
+            const size_t index = lowerBound(time);
+            for (size_t i = m_size; i > index; i--) {
+                m_entries[(m_first + i) % Capacity] = m_entries[(m_first + i - 1) % Capacity];
+            }
+            m_entries[(m_first + index) % Capacity] = {time, poses};
+            m_size++;
+        }
+
+        // Look up the poses at the given time. An entry within the tolerance is returned as-is, otherwise the poses are
+        // interpolated between the surrounding entries (when allowed). Returns false when the runtime must be queried.
+        bool find(XrTime time, XrTime tolerance, bool interpolate, HandJointsPoses& jointsPoses) const {
+            using namespace xr::math;
+
+            // Search for the entries around the requested time.
+            const size_t next = lowerBound(time);
+            const XrTime nextDelta = next < m_size ? getTime(next) - time : INT64_MAX;
+            const XrTime previousDelta = next > 0 ? time - getTime(next - 1) : INT64_MAX;
+
+            if (std::min(nextDelta, previousDelta) < tolerance) {
+                jointsPoses = getPoses(nextDelta < previousDelta ? next : next - 1);
+                return true;
+            }
+
+            if (interpolate && nextDelta != INT64_MAX && previousDelta != INT64_MAX &&
+                nextDelta + previousDelta <= MaxInterpolationInterval) {
+                const auto& previousPoses = getPoses(next - 1);
+                const auto& nextPoses = getPoses(next);
+                const float alpha = (float)previousDelta / (nextDelta + previousDelta);
+                for (uint32_t joint = 0; joint < XR_HAND_JOINT_COUNT_EXT; joint++) {
+                    jointsPoses[joint].locationFlags =
+                        previousPoses[joint].locationFlags & nextPoses[joint].locationFlags;
+                    jointsPoses[joint].pose = Pose::Slerp(previousPoses[joint].pose, nextPoses[joint].pose, alpha);
+                    jointsPoses[joint].radius =
+                        previousPoses[joint].radius + alpha * (nextPoses[joint].radius - previousPoses[joint].radius);
+                }
+                return true;
+            }
+
+            return false;
+        }
+
+        void evictOlderThan(XrTime time) {
+            while (m_size > 0 && getTime(0) < time) {
+                evictOldest();
+            }
+        }
+
+      private:
+        void evictOldest() {
+            m_first = (m_first + 1) % Capacity;
+            m_size--;
+        }
+
+        struct Entry {
+            XrTime time;
+            HandJointsPoses poses;
+        };
+
+        std::array<Entry, Capacity> m_entries;
+        size_t m_first{0};
+        size_t m_size{0};
+    };
+
+} // namespace toolkit::input
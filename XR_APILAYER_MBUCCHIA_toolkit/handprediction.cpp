@@ -0,0 +1,203 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+#include "oneeuro.h"
+
+namespace {
+
+    using namespace toolkit;
+    using namespace toolkit::input;
+    using namespace toolkit::math;
+
+    using namespace DirectX;
+    using namespace xr::math;
+
+    // Beyond this gap between two samples (eg: loss of tracking), the motion is estimated again from scratch.
+    constexpr XrDuration MaxSampleInterval = 100'000'000; // 100ms
+
+    // Samples closer than this are too noisy to estimate a velocity and are ignored.
+    constexpr XrDuration MinSampleInterval = 1'000'000; // 1ms
+
+    // The cutoff frequency (Hz) for the velocity estimates.
+    constexpr float VelocityCutoff = 10.f;
+
+    // How quickly the confidence follows the accuracy of the latest prediction.
+    constexpr float ConfidenceSmoothing = 0.3f;
+
+    // Prediction errors below this distance (m) are considered tracking noise.
+    constexpr float NoiseFloor = 0.001f;
+
+    // The rotation vector (axis scaled by the angle in radians) of a unit quaternion, taking the shortest path.
+    XrVector3f ToRotationVector(XrQuaternionf q) {
+        if (q.w < 0.f) {
+            q = {-q.x, -q.y, -q.z, -q.w};
+        }
+        const float sinHalfAngle = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z);
+        if (sinHalfAngle < 1e-6f) {
+            return {2.f * q.x, 2.f * q.y, 2.f * q.z};
+        }
+        const float scale = 2.f * std::atan2(sinHalfAngle, q.w) / sinHalfAngle;
+        return {q.x * scale, q.y * scale, q.z * scale};
+    }
+
+    XrQuaternionf FromRotationVector(const XrVector3f& v) {
+        const float angle = Length(v);
+        if (angle < 1e-6f) {
+            XrQuaternionf q;
+            StoreXrQuaternion(&q, XMQuaternionNormalize(XMVectorSet(0.5f * v.x, 0.5f * v.y, 0.5f * v.z, 1.f)));
+            return q;
+        }
+        const float scale = std::sin(0.5f * angle) / angle;
+        return {v.x * scale, v.y * scale, v.z * scale, std::cos(0.5f * angle)};
+    }
+
+    class HandPosePredictor : public IHandPosePredictor {
+      public:
+        HandPosePredictor(const HandPredictionParameters& parameters) : m_parameters(parameters) {
+        }
+
+        void setParameters(const HandPredictionParameters& parameters) override {
+            m_parameters = parameters;
+        }
+
+        void addSample(XrTime time, const XrHandJointLocationEXT* jointsPoses) override {
+            if (m_hasSample && time - m_latestTime < MinSampleInterval) {
+                return;
+            }
+
+            const XrHandJointLocationEXT& palm = jointsPoses[XR_HAND_JOINT_PALM_EXT];
+            const XrHandJointLocationEXT& previousPalm = m_jointsPoses[XR_HAND_JOINT_PALM_EXT];
+            if (!m_hasSample || time - m_latestTime > MaxSampleInterval || !Pose::IsPoseValid(palm.locationFlags) ||
+                !Pose::IsPoseValid(previousPalm.locationFlags)) {
+                // Hold on to the joints, but there is no motion to extrapolate yet.
+                m_hasVelocity = false;
+                m_confidence = 0.f;
+            } else {
+                const float dt = (time - m_latestTime) / 1e9f;
+
+                // Rate the model against simply holding the latest sample: a model doing no better than that gets no
+                // confidence.
+                if (m_hasVelocity) {
+                    const XrVector3f predicted = previousPalm.pose.position + m_linearVelocity * dt;
+                    const float error = Length(predicted - palm.pose.position);
+                    const float holdError = Length(previousPalm.pose.position - palm.pose.position);
+                    const float accuracy = std::clamp(1.f - error / std::max(holdError, NoiseFloor), 0.f, 1.f);
+                    m_confidence += ConfidenceSmoothing * (accuracy - m_confidence);
+                }
+
+                const XrVector3f linearVelocity = (palm.pose.position - previousPalm.pose.position) * (1.f / dt);
+                // XMQuaternionMultiply(a, b) is the rotation a followed by b.
+                const XMVECTOR previousOrientation = LoadXrQuaternion(previousPalm.pose.orientation);
+                XrQuaternionf deltaRotation;
+                StoreXrQuaternion(&deltaRotation,
+                                  XMQuaternionMultiply(XMQuaternionConjugate(previousOrientation),
+                                                       LoadXrQuaternion(palm.pose.orientation)));
+                const XrVector3f angularVelocity = ToRotationVector(deltaRotation) * (1.f / dt);
+                if (!m_hasVelocity) {
+                    m_linearVelocity = linearVelocity;
+                    m_angularVelocity = angularVelocity;
+                    m_hasVelocity = true;
+                } else {
+                    const float alpha = SmoothingFactor(VelocityCutoff, dt);
+                    m_linearVelocity = Lerp(m_linearVelocity, linearVelocity, alpha);
+                    m_angularVelocity = Lerp(m_angularVelocity, angularVelocity, alpha);
+                }
+            }
+
+            std::copy_n(jointsPoses, XR_HAND_JOINT_COUNT_EXT, m_jointsPoses.begin());
+            m_latestTime = time;
+            m_hasSample = true;
+        }
+
+        XrTime getLatestSampleTime() const override {
+            return m_hasSample ? m_latestTime : 0;
+        }
+
+        bool predict(XrTime time, XrHandJointLocationEXT* jointsPoses) const override {
+            if (!m_hasSample) {
+                return false;
+            }
+
+            std::copy_n(m_jointsPoses.cbegin(), XR_HAND_JOINT_COUNT_EXT, jointsPoses);
+            if (!m_hasVelocity || time <= m_latestTime || m_parameters.horizon <= 0) {
+                return true;
+            }
+
+            const float dt = std::min(time - m_latestTime, m_parameters.horizon) / 1e9f * m_confidence;
+            const XrVector3f translation = m_linearVelocity * dt;
+            const XMVECTOR rotation = LoadXrQuaternion(FromRotationVector(m_angularVelocity * dt));
+
+            // Move the hand as a rigid body around the palm.
+            const XrVector3f& palm = m_jointsPoses[XR_HAND_JOINT_PALM_EXT].pose.position;
+            for (uint32_t joint = 0; joint < XR_HAND_JOINT_COUNT_EXT; joint++) {
+                if (!Pose::IsPoseValid(jointsPoses[joint].locationFlags)) {
+                    continue;
+                }
+
+                XrPosef& pose = jointsPoses[joint].pose;
+                XrVector3f offset;
+                StoreXrVector3(&offset, XMVector3Rotate(LoadXrVector3(pose.position - palm), rotation));
+                pose.position = palm + translation + offset;
+                const XMVECTOR orientation = XMQuaternionMultiply(LoadXrQuaternion(pose.orientation), rotation);
+                StoreXrQuaternion(&pose.orientation, XMQuaternionNormalize(orientation));
+            }
+
+            return true;
+        }
+
+        float getConfidence() const override {
+            return m_hasVelocity ? m_confidence : 0.f;
+        }
+
+        void reset() override {
+            m_hasSample = false;
+            m_hasVelocity = false;
+            m_confidence = 0.f;
+        }
+
+      private:
+        HandPredictionParameters m_parameters;
+
+        bool m_hasSample{false};
+        XrTime m_latestTime{0};
+        std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT> m_jointsPoses{};
+
+        // Of the palm, in the base space.
+        bool m_hasVelocity{false};
+        XrVector3f m_linearVelocity{0.f, 0.f, 0.f};
+        XrVector3f m_angularVelocity{0.f, 0.f, 0.f};
+        float m_confidence{0.f};
+    };
+
+} // namespace
+
+namespace toolkit::input {
+
+    std::shared_ptr<IHandPosePredictor> CreateHandPosePredictor(const HandPredictionParameters& parameters) {
+        return std::make_shared<HandPosePredictor>(parameters);
+    }
+
+} // namespace toolkit::input
@@ -48,7 +48,12 @@ namespace {
       public:
         ImageProcessor(std::shared_ptr<IConfigManager> configManager, std::shared_ptr<IDevice> graphicsDevice)
             : m_configManager(configManager), m_device(graphicsDevice),
-              m_userParams(GetParams(configManager.get(), 1)) {
+              m_userParams(GetParams(configManager.get(), 1)), m_paramsHandles(GetParamsHandles(*configManager, 0)) {
+            m_postProcessSetting = m_configManager->getHandle(SettingPostProcess);
+            m_sunGlassesSetting = m_configManager->getHandle(SettingPostSunGlasses);
+            m_chromaticCorrectionSettings[0] = m_configManager->getHandle(SettingPostChromaticCorrectionR);
+            m_chromaticCorrectionSettings[1] = m_configManager->getHandle(SettingPostChromaticCorrectionB);
+
             createRenderResources();
         }
 
@@ -57,8 +62,15 @@ namespace {
         }
 
         void update() override {
+            // Nothing to do unless a setting changed.
+            const auto changeGeneration = m_configManager->getChangeGeneration();
+            if (changeGeneration == m_lastChangeGeneration) {
+                return;
+            }
+            m_lastChangeGeneration = changeGeneration;
+
             // Generic implementation to support more than just Off/On modes in the future.
-            const auto mode = m_configManager->getEnumValue<PostProcessType>(config::SettingPostProcess);
+            const auto mode = m_configManager->getEnumValue<PostProcessType>(m_postProcessSetting);
             const auto hasModeChanged = mode != m_mode;
 
             if (hasModeChanged)
@@ -115,23 +127,23 @@ namespace {
         }
 
         bool checkUpdateConfig(PostProcessType mode) const {
+            const auto& gains = m_paramsHandles[1];
             if (mode != PostProcessType::Off) {
-                return m_configManager->hasChanged(SettingPostSunGlasses) ||
-                       m_configManager->hasChanged(SettingPostContrast) ||
-                       m_configManager->hasChanged(SettingPostBrightness) ||
-                       m_configManager->hasChanged(SettingPostExposure) ||
-                       m_configManager->hasChanged(SettingPostSaturation) ||
-                       m_configManager->hasChanged(SettingPostVibrance) ||
-                       m_configManager->hasChanged(SettingPostHighlights) ||
-                       m_configManager->hasChanged(SettingPostShadows) ||
-                       m_configManager->hasChanged(SettingPostColorGainR) ||
-                       m_configManager->hasChanged(SettingPostColorGainG) ||
-                       m_configManager->hasChanged(SettingPostColorGainB) ||
-                       m_configManager->hasChanged(SettingPostChromaticCorrectionR) ||
-                       m_configManager->hasChanged(SettingPostChromaticCorrectionB);
+                if (m_configManager->hasChanged(m_sunGlassesSetting) ||
+                    m_configManager->hasChanged(m_chromaticCorrectionSettings[0]) ||
+                    m_configManager->hasChanged(m_chromaticCorrectionSettings[1])) {
+                    return true;
+                }
+                for (const auto& handles : m_paramsHandles) {
+                    for (const auto& handle : handles) {
+                        if (handle && m_configManager->hasChanged(*handle)) {
+                            return true;
+                        }
+                    }
+                }
+                return false;
             } else {
-                return m_configManager->hasChanged(SettingPostColorGainR) ||
-                       m_configManager->hasChanged(SettingPostColorGainB);
+                return m_configManager->hasChanged(*gains[0]) || m_configManager->hasChanged(*gains[2]);
             }
         }
 
@@ -152,9 +164,9 @@ namespace {
                 {{{{-1.0f, 0.5f, 1.0f, 1.0f}}}, {{{-1.0f, 0.0f, 0.0f, 0.0f}}}}, // ((v * 1) - 0)  -> [ 0..+1]
             };
 
-            const auto sunglasses = m_configManager->getEnumValue<PostSunGlassesType>(SettingPostSunGlasses);
+            const auto sunglasses = m_configManager->getEnumValue<PostSunGlassesType>(m_sunGlassesSetting);
             const auto preset = GetPreset(static_cast<size_t>(to_integral(sunglasses)));
-            const auto params = GetParams(m_configManager.get(), 0);
+            const auto params = GetParams(*m_configManager, m_paramsHandles);
 
             // [0..1000] -> [0..1] * Gain - Bias
             for (size_t i = 0; i < 3; i++) {
@@ -165,35 +177,49 @@ namespace {
             // CA Correction stuff.
             if (m_mode == PostProcessType::CACorrection) {
                 m_config.Params3.w = 1;
-                m_config.Params4.x = m_configManager->getValue(SettingPostChromaticCorrectionR) / 100000.0f;
+                m_config.Params4.x = m_configManager->getValue(m_chromaticCorrectionSettings[0]) / 100000.0f;
                 m_config.Params4.y = 1.0f;
-                m_config.Params4.z = m_configManager->getValue(SettingPostChromaticCorrectionB) / 100000.0f;
+                m_config.Params4.z = m_configManager->getValue(m_chromaticCorrectionSettings[1]) / 100000.0f;
                 // Params4.w is patched JIT in process().
             } else {
                 m_config.Params3.w = 0;
             }
         }
 
+        // The settings for the shader parameters, see ImageProcessorConfig. Unused parameters have no setting.
+        using ParamsHandles = std::array<std::array<std::optional<SettingHandle>, 4>, 3>;
+
+        static ParamsHandles GetParamsHandles(const IConfigManager& configManager, size_t index) {
+            static const char* lut[] = {"", "_u1", "_u2", "_u3", "_u4"}; // placeholder up to 4
+            const std::string suffix = lut[std::min(index, std::size(lut) - 1)];
+
+            const auto handle = [&](const std::string& name) { return configManager.getHandle(name + suffix); };
+            return {{{handle(SettingPostContrast),
+                      handle(SettingPostBrightness),
+                      handle(SettingPostExposure),
+                      handle(SettingPostSaturation)},
+                     {handle(SettingPostColorGainR), handle(SettingPostColorGainG), handle(SettingPostColorGainB)},
+                     {handle(SettingPostHighlights), handle(SettingPostShadows), handle(SettingPostVibrance)}}};
+        }
+
+        static std::array<DirectX::XMINT4, 3> GetParams(const IConfigManager& configManager,
+                                                        const ParamsHandles& handles) {
+            const auto value = [&](const std::optional<SettingHandle>& handle) {
+                return handle ? configManager.getValue(*handle) : 0;
+            };
+
+            std::array<DirectX::XMINT4, 3> params;
+            for (size_t i = 0; i < params.size(); i++) {
+                params[i] = DirectX::XMINT4(
+                    value(handles[i][0]), value(handles[i][1]), value(handles[i][2]), value(handles[i][3]));
+            }
+            return params;
+        }
+
         static std::array<DirectX::XMINT4, 3> GetParams(const IConfigManager* configManager, size_t index) {
             using namespace DirectX;
             if (configManager) {
-                static const char* lut[] = {"", "_u1", "_u2", "_u3", "_u4"}; // placeholder up to 4
-                const auto suffix = lut[std::min(index, std::size(lut))];
-
-                return {XMINT4(configManager->getValue(SettingPostContrast + suffix),
-                               configManager->getValue(SettingPostBrightness + suffix),
-                               configManager->getValue(SettingPostExposure + suffix),
-                               configManager->getValue(SettingPostSaturation + suffix)),
-
-                        XMINT4(configManager->getValue(SettingPostColorGainR + suffix),
-                               configManager->getValue(SettingPostColorGainG + suffix),
-                               configManager->getValue(SettingPostColorGainB + suffix),
-                               0),
-
-                        XMINT4(configManager->getValue(SettingPostHighlights + suffix),
-                               configManager->getValue(SettingPostShadows + suffix),
-                               configManager->getValue(SettingPostVibrance + suffix),
-                               0)};
+                return GetParams(*configManager, GetParamsHandles(*configManager, index));
             }
             return {XMINT4(500, 500, 500, 500), XMINT4(500, 500, 500, 0), XMINT4(1000, 0, 0, 0)};
         }
@@ -225,6 +251,11 @@ namespace {
         const std::shared_ptr<IConfigManager> m_configManager;
         const std::shared_ptr<IDevice> m_device;
         const std::array<DirectX::XMINT4, 3> m_userParams;
+        const ParamsHandles m_paramsHandles;
+        SettingHandle m_postProcessSetting;
+        SettingHandle m_sunGlassesSetting;
+        SettingHandle m_chromaticCorrectionSettings[2];
+        uint64_t m_lastChangeGeneration{UINT64_MAX};
 
         std::shared_ptr<IQuadShader> m_shaders[2]; // off, on
         std::shared_ptr<IShaderBuffer> m_cbParams;
@@ -88,6 +88,154 @@ namespace toolkit {
         // A CPU synchronous timer.
         struct ICpuTimer : public ITimer {};
 
+        // The timings that we track percentiles for.
+        enum class FrameTiming { AppCpu = 0, RenderCpu, AppGpu, WaitCpu, EndFrameCpu, UpscalerGpu, MaxValue };
+        constexpr size_t FrameTimingCount = static_cast<size_t>(FrameTiming::MaxValue);
+
+        // The percentiles that we track for each timing (p50, p95, p99).
+        constexpr double FrameTimingQuantiles[] = {0.50, 0.95, 0.99};
+        constexpr size_t FrameTimingQuantileCount = std::size(FrameTimingQuantiles);
+
+        // The timings captured for a single frame.
+        struct FrameStatistics {
+            uint64_t frameIndex{0};
+            int64_t timestampUs{0};
+
+            uint64_t appCpuTimeUs{0};
+            uint64_t renderCpuTimeUs{0};
+            uint64_t appGpuTimeUs{0};
+            uint64_t waitCpuTimeUs{0};
+            uint64_t endFrameCpuTimeUs{0};
+            uint64_t processorGpuTimeUs[2]{0};
+            uint64_t overlayCpuTimeUs{0};
+            uint64_t overlayGpuTimeUs{0};
+            uint64_t handTrackingCpuTimeUs{0};
+            uint64_t predictionTimeUs{0};
+
+            uint64_t getTiming(FrameTiming timing) const {
+                switch (timing) {
+                case FrameTiming::AppCpu:
+                    return appCpuTimeUs;
+                case FrameTiming::RenderCpu:
+                    return renderCpuTimeUs;
+                case FrameTiming::AppGpu:
+                    return appGpuTimeUs;
+                case FrameTiming::WaitCpu:
+                    return waitCpuTimeUs;
+                case FrameTiming::EndFrameCpu:
+                    return endFrameCpuTimeUs;
+                case FrameTiming::UpscalerGpu:
+                    return processorGpuTimeUs[0];
+                default:
+                    return 0;
+                }
+            }
+        };
+
+        // A fixed-capacity history of per-frame statistics.
+        // There must be a single producer (the frame thread), but any number of threads may read concurrently without
+        // ever blocking the producer. Readers must tolerate records being overwritten while they lag behind.
+        struct IFrameStatisticsHistory {
+            virtual ~IFrameStatisticsHistory() = default;
+
+            virtual size_t getCapacity() const = 0;
+
+            // Must only be invoked from the producer thread.
+            virtual void push(const FrameStatistics& stats) = 0;
+
+            // The total number of records pushed so far. The next record to be pushed will use this index.
+            virtual uint64_t getHead() const = 0;
+
+            // Returns false if the record does not exist yet or was already overwritten.
+            virtual bool read(uint64_t index, FrameStatistics& stats) const = 0;
+        };
+
+        // The header of a binary frame statistics file, followed by FrameStatistics records until the end of the file.
+        struct FrameStatisticsFileHeader {
+            static constexpr char Magic[8] = {'O', 'X', 'R', 'T', 'K', 'F', 'S', 'T'};
+            static constexpr uint32_t CurrentVersion = 1;
+
+            char magic[8];
+            uint32_t version;
+            uint32_t recordSize;
+            int64_t startTime; // seconds since the UNIX epoch.
+        };
+
+        // Writes all the records of a frame statistics history to a file, from a background thread.
+        struct IFrameStatisticsRecorder {
+            virtual ~IFrameStatisticsRecorder() = default;
+
+            virtual const std::filesystem::path& getPath() const = 0;
+            virtual uint64_t getNumRecordsWritten() const = 0;
+
+            // Records that were overwritten in the history before the recorder could write them.
+            virtual uint64_t getNumRecordsDropped() const = 0;
+        };
+
+        // A streaming quantile estimator using constant memory.
+        struct IQuantileEstimator {
+            virtual ~IQuantileEstimator() = default;
+
+            virtual void addSample(double value) = 0;
+            virtual double query() const = 0;
+            virtual uint64_t getSampleCount() const = 0;
+            virtual void reset() = 0;
+        };
+
+        // A monotonic clock, in nanoseconds. This abstraction allows to simulate time.
+        struct IClock {
+            virtual ~IClock() = default;
+
+            virtual int64_t now() const = 0;
+
+            // Might return late, depending on the timer resolution and the scheduler.
+            virtual void sleepUntil(int64_t time) = 0;
+
+            // Relinquish the CPU briefly while busy-waiting.
+            virtual void spin() = 0;
+        };
+
+        // Paces the frames of the application to a target frame rate.
+        struct IFrameThrottler {
+            virtual ~IFrameThrottler() = default;
+
+            // Block until it is time to begin waiting for the next frame.
+            virtual void throttle(uint32_t targetFrameRate) = 0;
+
+            // Report the completion of the runtime's xrWaitFrame(), which is aligned with the display refresh.
+            virtual void onFrameWaited(XrDuration predictedDisplayPeriod) = 0;
+
+            virtual void reset() = 0;
+
+            // How late (positive) or early (negative) the last throttle() returned compared to its deadline.
+            virtual int64_t getLastWakeUpError() const = 0;
+            virtual int64_t getSpinThreshold() const = 0;
+        };
+
+        // Waits for the runtime's frames on a persistent thread, while handing out predicted frame states to the
+        // application ahead of time (Turbo Mode).
+        struct IAsyncFrameWaiter {
+            virtual ~IAsyncFrameWaiter() = default;
+
+            // Begin waiting for the next runtime frame. The last frame state is used to extrapolate the next ones.
+            virtual void start(XrTime lastPredictedDisplayTime, XrDuration lastPredictedDisplayPeriod) = 0;
+
+            // Whether a runtime frame was started and not consumed yet.
+            virtual bool isPending() const = 0;
+
+            // Return the frame state for the next application frame. Only blocks when the application is already
+            // the maximum pipeline depth ahead of the runtime.
+            virtual void pollFrame(XrFrameState& frameState) = 0;
+
+            virtual void waitForFrame() = 0;
+            virtual bool waitForFrame(std::chrono::milliseconds timeout) = 0;
+
+            // Retrieve the frame state returned by the runtime. The wait must have completed.
+            virtual XrFrameState consumeFrame() = 0;
+
+            virtual void setPipelineDepth(uint32_t depth) = 0;
+        };
+
         // [-1,+1] (+up) -> [0..1] (+dn)
         inline constexpr XrVector2f NdcToScreen(XrVector2f v) {
             return {(v.x + 1.f) * 0.5f, (v.y - 1.f) * -0.5f};
@@ -186,6 +334,11 @@ namespace toolkit {
         const std::string SettingEyeProjectionDistance = "eye_projection";
         const std::string SettingEyeDebug = "eye_debug";
         const std::string SettingEyeDebugWithController = "eye_controller_debug";
+        const std::string SettingEyeFilter = "eye_filter";
+        const std::string SettingEyeFilterMinCutoff = "eye_filter_min_cutoff";
+        const std::string SettingEyeFilterBeta = "eye_filter_beta";
+        const std::string SettingEyeSaccadeThreshold = "eye_saccade_threshold";
+        const std::string SettingEyeLatency = "eye_latency";
         const std::string SettingResolutionOverride = "override_resolution";
         const std::string SettingResolutionHeight = "resolution_height";
         const std::string SettingDisableInterceptor = "disable_interceptor";
@@ -193,8 +346,11 @@ namespace toolkit {
         const std::string SettingHighRateStats = "high_rate_stats";
         const std::string SettingFrameThrottling = "frame_throttle";
         const std::string SettingTurboMode = "turbo";
+        const std::string SettingTurboPipelineDepth = "turbo_depth";
         const std::string SettingTargetFrameRate = "target_rate";
         const std::string SettingTargetFrameRate2 = "target_rate2";
+        const std::string SettingFrameAnalyzerSwitchPass = "frame_analyzer_switch_pass";
+        const std::string SettingFrameAnalyzerSwitchOccurrence = "frame_analyzer_switch_occurrence";
 
         enum class OffOnType { Off = 0, On, MaxValue };
         enum class NoYesType { No = 0, Yes, MaxValue };
@@ -217,11 +373,39 @@ namespace toolkit {
         enum class FovModeType { Simple, Advanced, MaxValue };
         enum class ScreenshotFileFormat { DDS = 0, PNG, JPG, BMP, MaxValue };
         enum class BlindEye { None = 0, Left, Right, MaxValue };
+        enum class RecordStatsType { Off = 0, Summary, PerFrame, MaxValue };
         constexpr auto MaxFrameRate = 120;
+        constexpr auto MaxTurboPipelineDepth = 3;
 
         template <typename ConfigEnumType>
         extern std::string_view to_string_view(ConfigEnumType);
 
+        // The persistent storage of the configuration values.
+        struct IConfigBackend {
+            virtual ~IConfigBackend() = default;
+
+            virtual std::optional<int> read(const std::string& name) const = 0;
+
+            // The machine-wide values (eg: safe mode, or the options the companion app sets for all applications).
+            // They are used for the settings that read() has no value for.
+            virtual std::optional<int> readGlobal(const std::string& name) const = 0;
+
+            // Commit several values at once.
+            virtual void write(const std::vector<std::pair<std::string, int>>& values) = 0;
+
+            virtual void erase(const std::string& name) = 0;
+            virtual void eraseAll() = 0;
+
+            // Whether the storage might have been modified since the last call. This is only a hint: it can report
+            // our own modifications too.
+            virtual bool pollChanges() = 0;
+        };
+
+        // An interned setting name, see IConfigManager::getHandle().
+        struct SettingHandle {
+            uint32_t index{UINT32_MAX};
+        };
+
         struct IConfigManager {
             virtual ~IConfigManager() = default;
 
@@ -238,6 +422,18 @@ namespace toolkit {
             virtual void setValue(const std::string& name, int value, bool noCommitDelay = false) = 0;
             virtual bool hasChanged(const std::string& name) const = 0;
 
+            // Resolve the name of a setting once, for the lookups in the hot paths. Handles remain valid for the
+            // lifetime of the configuration manager.
+            virtual SettingHandle getHandle(const std::string& name) const = 0;
+            virtual int getValue(SettingHandle handle) const = 0;
+            virtual int peekValue(SettingHandle handle) const = 0;
+            virtual void setValue(SettingHandle handle, int value, bool noCommitDelay = false) = 0;
+            virtual bool hasChanged(SettingHandle handle) const = 0;
+
+            // Incremented whenever any value changes. When it did not move, none of the hasChanged() queries can
+            // return a different result than they did before.
+            virtual uint64_t getChangeGeneration() const = 0;
+
             virtual void deleteValue(const std::string& name) = 0;
             virtual void resetToDefaults() = 0;
 
@@ -262,6 +458,12 @@ namespace toolkit {
                 const auto value = peekValue(name);
                 return static_cast<T>(std::clamp(value, std::underlying_type_t<T>(0), to_integral(T::MaxValue) - 1));
             }
+
+            template <typename T, std::enable_if_t<std::is_enum<T>::value, bool> = true>
+            T getEnumValue(SettingHandle handle) const {
+                const auto value = getValue(handle);
+                return static_cast<T>(std::clamp(value, std::underlying_type_t<T>(0), to_integral(T::MaxValue) - 1));
+            }
         };
 
     } // namespace config
@@ -348,7 +550,7 @@ namespace toolkit {
 
         enum class TextStyle { Normal, Bold };
 
-        enum class FrameAnalyzerHeuristic { Unknown, ForwardRender, DeferredCopy, Fallback };
+        enum class FrameAnalyzerHeuristic { Unknown, ForwardRender, DeferredCopy, Fallback, LearnedSignature };
 
         struct IDevice;
         struct ITexture;
@@ -480,6 +682,24 @@ namespace toolkit {
             }
         };
 
+        // A texture that the CPU can read without stalling the GPU.
+        struct IReadbackTexture {
+            virtual ~IReadbackTexture() = default;
+
+            virtual Api getApi() const = 0;
+            virtual std::shared_ptr<IDevice> getDevice() const = 0;
+            virtual const XrSwapchainCreateInfo& getInfo() const = 0;
+
+            // Enqueue the copy of a region of the source (of the size of the readback texture).
+            virtual void copyFrom(std::shared_ptr<ITexture> source, int32_t srcSlice, uint32_t srcX, uint32_t srcY) = 0;
+
+            // Must only be polled once the copy was submitted (see flushContext()).
+            virtual bool isReady() = 0;
+
+            // Must only be invoked once the copy is ready.
+            virtual void readback(std::vector<uint8_t>& data, uint32_t& rowPitch) = 0;
+        };
+
         // A buffer to be used with shaders.
         struct IShaderBuffer {
             virtual ~IShaderBuffer() = default;
@@ -564,6 +784,9 @@ namespace toolkit {
                                                             uint32_t imageSize = 0,
                                                             const void* initialData = nullptr) = 0;
 
+            virtual std::shared_ptr<IReadbackTexture> createReadbackTexture(const XrSwapchainCreateInfo& info,
+                                                                            std::string_view debugName) = 0;
+
             virtual std::shared_ptr<IShaderBuffer> createBuffer(size_t size,
                                                                 std::string_view debugName,
                                                                 const void* initialData = nullptr,
@@ -699,11 +922,48 @@ namespace toolkit {
                                  std::optional<utilities::Eye> eye = std::nullopt) = 0;
         };
 
+        enum class RenderPassEvent { SetRenderTarget, CopyTexture };
+
+        // Where the eye switches within a frame: at the n-th occurrence of a render pass (identified by a hash of its
+        // event and render target description).
+        struct RenderPassSignature {
+            uint32_t switchPass{0};
+            uint32_t switchOccurrence{0};
+
+            bool isValid() const {
+                return switchOccurrence > 0;
+            }
+
+            bool operator==(const RenderPassSignature& other) const {
+                return switchPass == other.switchPass && switchOccurrence == other.switchOccurrence;
+            }
+            bool operator!=(const RenderPassSignature& other) const {
+                return !(*this == other);
+            }
+        };
+
+        // Learns the render pass signature of an application from the sequence of render passes of its frames, and
+        // predicts the eye being rendered once a signature is known. Only depends on the events it is given, so
+        // recorded event traces can be replayed through it.
+        struct IRenderPassLearner {
+            virtual ~IRenderPassLearner() = default;
+
+            virtual void resetForFrame() = 0;
+            virtual void recordPass(RenderPassEvent event, uint32_t width, uint32_t height, int64_t format) = 0;
+            virtual void endFrame() = 0;
+
+            virtual void setSignature(const RenderPassSignature& signature) = 0;
+            virtual const RenderPassSignature& getSignature() const = 0;
+
+            virtual std::optional<utilities::Eye> getEyeHint() const = 0;
+        };
+
         struct IFrameAnalyzer {
             virtual ~IFrameAnalyzer() = default;
 
             virtual void registerColorSwapchainImage(XrSwapchain swapchain,
                                                      std::shared_ptr<ITexture> source,
+                                                     uint32_t imageIndex,
                                                      utilities::Eye eye) = 0;
 
             virtual void resetForFrame() = 0;
@@ -725,6 +985,14 @@ namespace toolkit {
             virtual FrameAnalyzerHeuristic getCurrentHeuristic() const = 0;
         };
 
+        // The parameters of the VRS mask generation (see GenerateShadingRateMask()).
+        struct alignas(16) ShadingRateMaskConstants {
+            XrVector2f GazeXY;   // ndc
+            XrVector2f InvDim;   // 1/w, 1/h
+            XrVector2f Rings[4]; // 1/(a1^2), 1/(b1^2)
+            uint32_t Rates[4];   // r1, r2, r3, r4
+        };
+
         // A Variable Rate Shader (VRS) control implementation.
         struct IVariableRateShader {
             virtual ~IVariableRateShader() = default;
@@ -752,11 +1020,101 @@ namespace toolkit {
             virtual void stopCapture() = 0;
         };
 
+        struct ScreenshotServiceParameters {
+            // Enough for a few stereo screenshots in a row (burst capture).
+            uint32_t maxCapturesInFlight{8};
+
+            // Beyond this many images waiting to be encoded, new screenshots are dropped.
+            uint32_t maxPendingWrites{16};
+        };
+
+        // Saves textures to files without stalling the frame. The textures are copied into a ring of readback textures,
+        // which are picked up a few frames later and encoded on a worker thread.
+        struct IScreenshotService {
+            virtual ~IScreenshotService() = default;
+
+            // Returns false if the capture was dropped (too many captures in flight).
+            virtual bool capture(std::shared_ptr<ITexture> texture,
+                                 int32_t slice,
+                                 const XrRect2Di& region,
+                                 const std::filesystem::path& path) = 0;
+
+            // Must be invoked once per frame, before any new capture.
+            virtual void update() = 0;
+
+            // The captures in flight, plus the images waiting to be (or being) encoded.
+            virtual uint32_t getNumPending() const = 0;
+        };
+
     } // namespace graphics
 
     namespace input {
         enum class Hand : uint32_t { Left, Right };
 
+        // A gesture measured from the distance between pairs of joints. The value is 1 when the joints are closer than
+        // the near distance and 0 when they are further than the far distance. With several pairs of joints, the lowest
+        // value is ignored and the other ones are averaged.
+        struct GestureDefinition {
+            std::string name;
+
+            // The indices of the joints (see enum XrHandJointEXT).
+            std::vector<std::pair<uint32_t, uint32_t>> joints;
+
+            // Whether the second joint of each pair is on the other hand.
+            bool twoHanded{false};
+
+            float nearDistance{0.f};
+            float farDistance{0.1f};
+        };
+
+        // Evaluates a set of gestures for both hands at once.
+        // The engine only depends on the joints that are submitted, so that recorded hand tracking can be replayed
+        // through it.
+        struct IGestureEngine {
+            virtual ~IGestureEngine() = default;
+
+            virtual void setGestures(const std::vector<GestureDefinition>& gestures) = 0;
+            virtual uint32_t getGestureCount() const = 0;
+
+            // Either hand may be null when it is not tracked.
+            virtual void evaluate(const XrHandJointLocationEXT* leftHandJointsPoses,
+                                  const XrHandJointLocationEXT* rightHandJointsPoses) = 0;
+
+            // The value of the gesture (indexed like in setGestures()), or NAN when a joint could not be located.
+            virtual float getValue(uint32_t gesture, Hand hand) const = 0;
+        };
+
+        struct HandPredictionParameters {
+            // How far ahead of the latest sample the joints may be extrapolated. 0 disables the extrapolation.
+            XrDuration horizon{50'000'000};
+        };
+
+        // Extrapolates the joints of one hand with the motion of the palm (linear and angular velocity) estimated from
+        // the previous samples. The hand is moved as a rigid body, so that the gestures are not affected. The
+        // extrapolation is scaled down by a confidence measuring how well the model predicted the recent samples.
+        // The predictor only depends on the samples that are submitted, so that recorded joints can be replayed through
+        // it.
+        struct IHandPosePredictor {
+            virtual ~IHandPosePredictor() = default;
+
+            virtual void setParameters(const HandPredictionParameters& parameters) = 0;
+
+            // Samples must be submitted in chronological order.
+            virtual void addSample(XrTime time, const XrHandJointLocationEXT* jointsPoses) = 0;
+
+            // The time of the latest sample, or 0 when there is none.
+            virtual XrTime getLatestSampleTime() const = 0;
+
+            // Returns false when there is no sample to extrapolate from. Times before the latest sample return the
+            // latest sample.
+            virtual bool predict(XrTime time, XrHandJointLocationEXT* jointsPoses) const = 0;
+
+            // Between 0 (the latest sample is held) and 1 (the motion is fully extrapolated).
+            virtual float getConfidence() const = 0;
+
+            virtual void reset() = 0;
+        };
+
         struct GesturesState {
             float pinchValue[2]{NAN, NAN};
             float thumbPressValue[2]{NAN, NAN};
@@ -770,7 +1128,9 @@ namespace toolkit {
 
             int64_t handposeAgeUs[2]{0, 0};
             size_t cacheSize[2]{0, 0};
+            uint32_t numJointsQueries[2]{0, 0};
             uint32_t numTrackingLosses[2]{0, 0};
+            float predictionConfidence[2]{NAN, NAN};
             float hapticsFrequency[2]{NAN, NAN};
             int64_t hapticsDurationUs[2]{-2, -2};
         };
@@ -819,6 +1179,41 @@ namespace toolkit {
             XrVector2f rightPoint{};
         };
 
+        enum class GazeMovement { Fixation, Saccade };
+
+        struct GazeFilterParameters {
+            bool enabled{true};
+
+            // One-Euro filter: the cutoff frequency (Hz) when the gaze is still, and how fast it increases with the
+            // speed of the gaze (Hz per NDC/s).
+            float minCutoff{1.f};
+            float beta{5.f};
+
+            // The speed of the gaze (NDC/s) above which the eyes are considered in a saccade.
+            float saccadeVelocity{2.f};
+        };
+
+        // Smoothes the projected gaze (NDC), classifies the eye movements and extrapolates the gaze during saccades.
+        // The filter only depends on the samples that are submitted, so that recorded gaze can be replayed through it.
+        // When disabled, the gaze is passed through and always reported as a saccade.
+        // The gaze is only extrapolated over the age of the samples (eye_latency setting, 0 by default): samples
+        // submitted at the display time are never extrapolated.
+        struct IGazeFilter {
+            virtual ~IGazeFilter() = default;
+
+            virtual void setParameters(const GazeFilterParameters& parameters) = 0;
+
+            // Samples must be submitted in chronological order.
+            virtual void addSample(XrTime time, const XrVector2f gaze[utilities::ViewCount]) = 0;
+
+            // The filtered gaze, predicted for the given display time.
+            virtual void getGaze(XrTime displayTime, XrVector2f gaze[utilities::ViewCount]) const = 0;
+
+            virtual GazeMovement getMovement() const = 0;
+
+            virtual void reset() = 0;
+        };
+
         struct IEyeTracker {
             virtual ~IEyeTracker() = default;
 
@@ -831,6 +1226,7 @@ namespace toolkit {
 
             virtual XrActionSet getActionSet() const = 0;
             virtual bool getProjectedGaze(XrVector2f gaze[utilities::ViewCount]) const = 0;
+            virtual GazeMovement getGazeMovement() const = 0;
 
             virtual bool isProjectionDistanceSupported() const = 0;
 
@@ -841,17 +1237,10 @@ namespace toolkit {
 
     namespace menu {
 
-        struct MenuStatistics {
-            uint64_t appCpuTimeUs{0};
-            uint64_t renderCpuTimeUs{0};
-            uint64_t appGpuTimeUs{0};
-            uint64_t waitCpuTimeUs{0};
-            uint64_t endFrameCpuTimeUs{0};
-            uint64_t processorGpuTimeUs[2]{0};
-            uint64_t overlayCpuTimeUs{0};
-            uint64_t overlayGpuTimeUs{0};
-            uint64_t handTrackingCpuTimeUs{0};
-            uint64_t predictionTimeUs{0};
+        // The timings are averaged over the statistics window.
+        struct MenuStatistics : public utilities::FrameStatistics {
+            // Tail latency over the statistics window, see utilities::FrameTimingQuantiles.
+            uint64_t timingPercentilesUs[utilities::FrameTimingCount][utilities::FrameTimingQuantileCount]{};
 
             float fps{0.0f};
             uint64_t vramUsedSize;
@@ -42,6 +42,9 @@ namespace {
     // 2 frames.
     constexpr uint32_t GpuTimerLatency = 2;
 
+    // Enough history to cover the longest statistics window (1s) at the highest refresh rates.
+    constexpr size_t FrameStatisticsHistorySize = 1024;
+
     struct SwapchainImages {
         std::shared_ptr<graphics::ITexture> appTexture;
         std::shared_ptr<graphics::ITexture> runtimeTexture;
@@ -117,6 +120,13 @@ namespace {
             m_configManager->setDefault(config::SettingEyeDebugWithController, 0);
             m_configManager->setDefault(config::SettingEyeProjectionDistance, 200); // 2m
             m_configManager->setDefault(config::SettingEyeDebug, 0);
+            m_configManager->setDefault(config::SettingEyeFilter, 1);
+            m_configManager->setDefault(config::SettingEyeFilterMinCutoff, 100);  // 1Hz
+            m_configManager->setDefault(config::SettingEyeFilterBeta, 500);       // 5Hz per NDC/s
+            m_configManager->setDefault(config::SettingEyeSaccadeThreshold, 200); // 2 NDC/s
+            // Extrapolation is opt-in: some runtimes already predict the gaze to the display time, and the age of
+            // the samples depends on the eye tracker.
+            m_configManager->setDefault(config::SettingEyeLatency, 0); // in ms
 
             // Upscaling feature.
             m_configManager->setEnumDefault(config::SettingScalingType, config::ScalingType::None);
@@ -199,6 +209,7 @@ namespace {
             m_configManager->setDefault(config::SettingRecordStats, 0);
             m_configManager->setDefault(config::SettingHighRateStats, 0);
             m_configManager->setDefault(config::SettingFrameThrottling, config::MaxFrameRate); // Off
+            m_configManager->setDefault(config::SettingTurboPipelineDepth, 1);
             m_configManager->setDefault(config::SettingTargetFrameRate, config::MaxFrameRate); // Off
             m_configManager->setDefault(config::SettingTargetFrameRate2, 0);
 
@@ -229,6 +240,10 @@ namespace {
             // Commit any update above. This is needed for apps that create an instance, destroy it right away
             // without submitting a frame, then create a new one.
             m_configManager->tick();
+
+            // Resolve the settings that are read on every frame.
+            m_frameThrottlingSetting = m_configManager->getHandle(config::SettingFrameThrottling);
+            m_predictionDampenSetting = m_configManager->getHandle(config::SettingPredictionDampen);
         }
 
         XrResult xrCreateInstance(const XrInstanceCreateInfo* createInfo) override {
@@ -670,6 +685,11 @@ namespace {
 
             const XrResult result = OpenXrApi::xrCreateSession(instance, createInfo, session);
             if (XR_SUCCEEDED(result) && isVrSystem(createInfo->systemId)) {
+                m_frameThrottler = utilities::CreateFrameThrottler(utilities::CreateSystemClock());
+                m_asyncWaiter = utilities::CreateAsyncFrameWaiter([&](XrFrameState& frameState) {
+                    return OpenXrApi::xrWaitFrame(m_vrSession, nullptr, &frameState);
+                });
+
                 // Get the graphics device.
                 const XrBaseInStructure* entry = reinterpret_cast<const XrBaseInStructure*>(createInfo->next);
                 while (entry) {
@@ -751,6 +771,7 @@ namespace {
                     }
 
                     m_postProcessor = graphics::CreateImageProcessor(m_configManager, m_graphicsDevice);
+                    m_screenshotService = graphics::CreateScreenshotService(m_graphicsDevice);
 
                     if (m_graphicsDevice->isEventsSupported()) {
                         if (!m_configManager->getValue("disable_frame_analyzer")) {
@@ -838,7 +859,21 @@ namespace {
                         m_performanceCounters.overlayGpuTimer[i] = m_graphicsDevice->createTimer();
                     }
 
+                    // The history outlives the session, since the statistics recorder may still be reading from it.
+                    if (!m_performanceCounters.history) {
+                        m_performanceCounters.history =
+                            utilities::CreateFrameStatisticsHistory(FrameStatisticsHistorySize);
+                    }
+                    for (size_t i = 0; i < utilities::FrameTimingCount; i++) {
+                        for (size_t j = 0; j < utilities::FrameTimingQuantileCount; j++) {
+                            m_performanceCounters.percentiles[i][j] =
+                                utilities::CreateQuantileEstimator(utilities::FrameTimingQuantiles[j]);
+                        }
+                    }
+
                     m_performanceCounters.lastWindowStart = std::chrono::steady_clock::now();
+                    m_performanceCounters.windowStartIndex = m_performanceCounters.history->getHead();
+                    m_frameStats = {};
 
                     {
                         menu::MenuInfo menuInfo;
@@ -962,9 +997,9 @@ namespace {
 
                 // Wait for any pending operation to complete.
                 if (m_graphicsDevice) {
-                    if (m_asyncWaitPromise.valid()) {
-                        m_asyncWaitPromise.wait_for(5s);
-                        m_asyncWaitPromise = {};
+                    if (m_asyncWaiter->isPending()) {
+                        m_asyncWaiter->waitForFrame(5s);
+                        m_asyncWaiter->consumeFrame();
                     }
 
                     m_graphicsDevice->blockCallbacks();
@@ -996,6 +1031,9 @@ namespace {
                 m_postProcessor.reset();
                 m_frameAnalyzer.reset();
                 m_variableRateShader.reset();
+                m_screenshotService.reset();
+                m_frameThrottler.reset();
+                m_asyncWaiter.reset();
                 for (unsigned int i = 0; i <= GpuTimerLatency; i++) {
                     m_performanceCounters.appGpuTimer[i].reset();
                     m_performanceCounters.overlayGpuTimer[i].reset();
@@ -1005,6 +1043,11 @@ namespace {
                 m_performanceCounters.waitCpuTimer.reset();
                 m_performanceCounters.endFrameCpuTimer.reset();
                 m_performanceCounters.overlayCpuTimer.reset();
+                for (auto& percentiles : m_performanceCounters.percentiles) {
+                    for (auto& percentile : percentiles) {
+                        percentile.reset();
+                    }
+                }
                 m_swapchains.clear();
                 m_menuSwapchainImages.clear();
                 m_menuHandler.reset();
@@ -1226,12 +1269,12 @@ namespace {
             {
                 std::unique_lock lock(m_frameLock);
 
-                if (m_asyncWaitPromise.valid()) {
+                if (m_asyncWaiter && m_asyncWaiter->isPending()) {
                     TraceLocalActivity(local);
 
-                    TraceLoggingWriteStart(local, "AsyncWaitNow");
-                    m_asyncWaitPromise.wait();
-                    TraceLoggingWriteStop(local, "AsyncWaitNow");
+                    TraceLoggingLocalStart(local, "AsyncWaitNow");
+                    m_asyncWaiter->waitForFrame();
+                    TraceLoggingLocalStop(local, "AsyncWaitNow");
                 }
             }
 
@@ -1858,7 +1901,7 @@ namespace {
                 m_performanceCounters.handTrackingTimer->start();
                 if (m_handTracker->locate(space, baseSpace, time, getTimeNow(), *location)) {
                     m_performanceCounters.handTrackingTimer->stop();
-                    m_stats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
+                    m_frameStats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
 
                     TraceLoggingWrite(g_traceProvider,
                                       "xrLocateSpace",
@@ -1913,7 +1956,7 @@ namespace {
                 m_handTracker->sync(m_begunFrameTime, getTimeNow(), *syncInfo);
 
                 m_performanceCounters.handTrackingTimer->stop();
-                m_stats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
+                m_frameStats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
             }
 
             return result;
@@ -1938,7 +1981,7 @@ namespace {
                 m_performanceCounters.handTrackingTimer->start();
                 if (m_handTracker->getActionState(*getInfo, *state)) {
                     m_performanceCounters.handTrackingTimer->stop();
-                    m_stats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
+                    m_frameStats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
 
                     TraceLoggingWrite(g_traceProvider,
                                       "xrGetActionStateBoolean",
@@ -1973,7 +2016,7 @@ namespace {
                 m_performanceCounters.handTrackingTimer->start();
                 if (m_handTracker->getActionState(*getInfo, *state)) {
                     m_performanceCounters.handTrackingTimer->stop();
-                    m_stats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
+                    m_frameStats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
 
                     TraceLoggingWrite(g_traceProvider,
                                       "xrGetActionStateFloat",
@@ -2020,7 +2063,7 @@ namespace {
                 if (supportedPath && m_handTracker->isHandEnabled(hand)) {
                     state->isActive = m_handTracker->isTrackedRecently(hand);
                     m_performanceCounters.handTrackingTimer->stop();
-                    m_stats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
+                    m_frameStats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
 
                     TraceLoggingWrite(g_traceProvider, "xrGetActionStatePose", TLArg(!!state->isActive, "Active"));
 
@@ -2063,7 +2106,7 @@ namespace {
                     auto haptics = reinterpret_cast<const XrHapticVibration*>(hapticFeedback);
                     m_handTracker->handleOutput(hand, haptics->frequency ? haptics->frequency : 1, haptics->duration);
                     m_performanceCounters.handTrackingTimer->stop();
-                    m_stats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
+                    m_frameStats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
                 }
             }
 
@@ -2098,7 +2141,7 @@ namespace {
                 if (supportedPath) {
                     m_handTracker->handleOutput(hand, NAN, 0);
                     m_performanceCounters.handTrackingTimer->stop();
-                    m_stats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
+                    m_frameStats.handTrackingCpuTimeUs += m_performanceCounters.handTrackingTimer->query();
                 }
             }
 
@@ -2115,27 +2158,19 @@ namespace {
 
             TraceLoggingWrite(g_traceProvider, "xrWaitFrame", TLPArg(session, "Session"));
 
-            const auto lastFrameWaitTimestamp = m_lastFrameWaitTimestamp;
             if (isVrSession(session)) {
                 if (m_graphicsDevice) {
                     m_performanceCounters.appCpuTimer->stop();
-                    m_stats.appCpuTimeUs += m_performanceCounters.appCpuTimer->query();
+                    m_frameStats.appCpuTimeUs += m_performanceCounters.appCpuTimer->query();
                 }
 
                 // Do throttling if needed.
-                if (m_isFrameThrottlingPossible) {
-                    const auto frameThrottling = m_configManager->getValue(config::SettingFrameThrottling);
-                    if (frameThrottling < config::MaxFrameRate) {
-                        // TODO: Try to reduce latency by slowing slewing to reduce the predictedDisplayTime.
-
-                        const auto target =
-                            m_lastFrameWaitTimestamp +
-                            std::chrono::microseconds(1000000 / frameThrottling + m_frameThrottleSleepOffset) -
-                            500us /* "running start" */;
-                        std::this_thread::sleep_until(target);
-                    }
+                const auto frameThrottling = m_configManager->getValue(m_frameThrottlingSetting);
+                if (m_isFrameThrottlingPossible && frameThrottling < config::MaxFrameRate) {
+                    m_frameThrottler->throttle(frameThrottling);
+                } else {
+                    m_frameThrottler->reset();
                 }
-                m_lastFrameWaitTimestamp = std::chrono::steady_clock::now();
 
                 m_performanceCounters.waitCpuTimer->start();
             }
@@ -2143,28 +2178,12 @@ namespace {
             std::unique_lock lock(m_frameLock);
 
             XrResult result = XR_ERROR_RUNTIME_FAILURE;
-            if (isVrSession(session) && m_asyncWaitPromise.valid()) {
+            if (isVrSession(session) && m_asyncWaiter->isPending()) {
                 TraceLoggingWrite(g_traceProvider, "AsyncWaitMode");
 
-                // In Turbo mode, we accept pipelining of exactly one frame.
-                if (m_asyncWaitPolled) {
-                    TraceLocalActivity(local);
-
-                    // On second frame poll, we must wait.
-                    TraceLoggingWriteStart(local, "AsyncWaitNow");
-                    m_asyncWaitPromise.wait();
-                    TraceLoggingWriteStop(local, "AsyncWaitNow");
-                }
-                m_asyncWaitPolled = true;
-
-                // In Turbo mode, we don't actually wait, we make up a predicted time.
-                std::unique_lock lock(m_asyncWaitLock);
-                frameState->predictedDisplayTime =
-                    m_asyncWaitCompleted
-                        ? m_lastPredictedDisplayTime
-                        : (m_lastPredictedDisplayTime + (m_lastFrameWaitTimestamp - lastFrameWaitTimestamp).count());
-                frameState->predictedDisplayPeriod = m_lastPredictedDisplayPeriod;
-                frameState->shouldRender = XR_TRUE;
+                // In Turbo mode, we don't actually wait, we make up a predicted time. We only wait if the application
+                // is getting too far ahead of the runtime.
+                m_asyncWaiter->pollFrame(*frameState);
                 result = XR_SUCCESS;
             } else {
                 lock.unlock();
@@ -2175,17 +2194,22 @@ namespace {
                     // We must always store those values to properly handle transitions into Turbo Mode.
                     m_lastPredictedDisplayTime = frameState->predictedDisplayTime;
                     m_lastPredictedDisplayPeriod = frameState->predictedDisplayPeriod;
+
+                    // The runtime just released us in sync with the display, use this as the throttling phase.
+                    if (isVrSession(session)) {
+                        m_frameThrottler->onFrameWaited(frameState->predictedDisplayPeriod);
+                    }
                 }
             }
             if (XR_SUCCEEDED(result) && isVrSession(session)) {
                 m_performanceCounters.waitCpuTimer->stop();
-                m_stats.waitCpuTimeUs += m_performanceCounters.waitCpuTimer->query();
+                m_frameStats.waitCpuTimeUs += m_performanceCounters.waitCpuTimer->query();
 
                 m_savedFrameTime1 = frameState->predictedDisplayTime;
 
                 // Apply prediction dampening if possible and if needed.
                 if (m_hasPerformanceCounterKHR) {
-                    const int predictionDampen = m_configManager->getValue(config::SettingPredictionDampen);
+                    const int predictionDampen = m_configManager->getValue(m_predictionDampenSetting);
                     if (predictionDampen != 100) {
                         // Find the current time.
                         LARGE_INTEGER qpcTimeNow;
@@ -2200,7 +2224,7 @@ namespace {
                             frameState->predictedDisplayTime = xrTimeNow + (predictionDampen * predictionAmount) / 100;
                         }
 
-                        m_stats.predictionTimeUs += predictionAmount;
+                        m_frameStats.predictionTimeUs += predictionAmount;
                     }
                 }
 
@@ -2248,7 +2272,7 @@ namespace {
             }
 
             XrResult result = XR_ERROR_RUNTIME_FAILURE;
-            if (isVrSession(session) && m_asyncWaitPromise.valid()) {
+            if (isVrSession(session) && m_asyncWaiter->isPending()) {
                 // In turbo mode, we do nothing here.
                 TraceLoggingWrite(g_traceProvider, "AsyncWaitMode");
                 result = XR_SUCCESS;
@@ -2263,7 +2287,7 @@ namespace {
 
                 if (m_graphicsDevice) {
                     m_performanceCounters.renderCpuTimer->start();
-                    m_stats.appGpuTimeUs +=
+                    m_frameStats.appGpuTimeUs +=
                         m_performanceCounters.appGpuTimer[m_performanceCounters.gpuTimerIndex]->query();
                     m_performanceCounters.appGpuTimer[m_performanceCounters.gpuTimerIndex]->start();
 
@@ -2315,6 +2339,27 @@ namespace {
             return result;
         }
 
+        // Must be called once all the CPU timings of the frame are known, that is after the overlays are drawn.
+        void publishFrameStatistics() {
+            const auto now = std::chrono::steady_clock::now();
+
+            m_frameStats.frameIndex = m_performanceCounters.history->getHead();
+            m_frameStats.timestampUs =
+                std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+            m_performanceCounters.history->push(m_frameStats);
+
+            for (size_t i = 0; i < utilities::FrameTimingCount; i++) {
+                const auto timing = m_frameStats.getTiming(static_cast<utilities::FrameTiming>(i));
+                for (auto& percentile : m_performanceCounters.percentiles[i]) {
+                    percentile->addSample(static_cast<double>(timing));
+                }
+            }
+
+            m_frameStats = {};
+        }
+
+        // Must be called before the overlays are drawn, so the menu shows the latest statistics. The statistics window
+        // covers the frames published so far, which ends with the previous frame.
         void updateStatisticsForFrame() {
             const auto now = std::chrono::steady_clock::now();
             const auto numFrames = ++m_performanceCounters.numFrames;
@@ -2332,17 +2377,33 @@ namespace {
             }
 
             if (m_configManager->hasChanged(config::SettingRecordStats)) {
-                if (m_configManager->getValue(config::SettingRecordStats)) {
+                if (m_logStats.is_open()) {
+                    m_logStats.close();
+                }
+                m_statsRecorder.reset();
+
+                const auto recordStats =
+                    m_configManager->getEnumValue<config::RecordStatsType>(config::SettingRecordStats);
+                if (recordStats != config::RecordStatsType::Off) {
                     const std::time_t now = std::time(nullptr);
                     char buf[1024];
                     std::strftime(buf, sizeof(buf), "stats_%Y%m%d_%H%M%S", std::localtime(&now));
-                    std::string logFile = (localAppData / "stats" / (std::string(buf) + ".csv")).string();
-                    m_logStats.open(logFile, std::ios_base::ate);
 
-                    // Write headers.
-                    m_logStats << "time,FPS,appCPU (us),renderCPU (us),appGPU (us),VRAM (MB),VRAM (%)\n";
-                } else {
-                    m_logStats.close();
+                    if (recordStats == config::RecordStatsType::Summary) {
+                        std::string logFile = (localAppData / "stats" / (std::string(buf) + ".csv")).string();
+                        m_logStats.open(logFile, std::ios_base::ate);
+
+                        // Write headers.
+                        m_logStats << "time,FPS,appCPU (us),renderCPU (us),appGPU (us),VRAM (MB),VRAM (%)\n";
+                    } else {
+                        // Per-frame recording happens in the background. Use scripts/convert_stats.py to read the file.
+                        try {
+                            m_statsRecorder = utilities::CreateFrameStatisticsRecorder(
+                                m_performanceCounters.history, localAppData / "stats" / (std::string(buf) + ".bin"));
+                        } catch (std::exception& exc) {
+                            Log("Failed to start recording statistics: %s\n", exc.what());
+                        }
+                    }
                 }
             }
 
@@ -2355,18 +2416,58 @@ namespace {
                 // TODO: no need to compute these if no menu handler
                 // or if menu isn't displaying any stats.
 
-                // Push the last averaged statistics.
-                m_stats.appCpuTimeUs /= numFrames;
-                m_stats.renderCpuTimeUs /= numFrames;
-                m_stats.appGpuTimeUs /= numFrames;
-                m_stats.waitCpuTimeUs /= numFrames;
-                m_stats.endFrameCpuTimeUs /= numFrames;
-                m_stats.processorGpuTimeUs[0] /= numFrames;
-                m_stats.processorGpuTimeUs[1] /= numFrames;
-                m_stats.overlayCpuTimeUs /= numFrames;
-                m_stats.overlayGpuTimeUs /= numFrames;
-                m_stats.handTrackingCpuTimeUs /= numFrames;
-                m_stats.predictionTimeUs /= numFrames;
+                // Average the timings of the frames in the window.
+                {
+                    const auto& history = m_performanceCounters.history;
+                    const uint64_t head = history->getHead();
+                    const uint64_t oldest = head - std::min<uint64_t>(head, history->getCapacity());
+
+                    uint64_t numSamples = 0;
+                    for (uint64_t i = std::max(m_performanceCounters.windowStartIndex, oldest); i < head; i++) {
+                        utilities::FrameStatistics frame;
+                        if (!history->read(i, frame)) {
+                            continue;
+                        }
+
+                        m_stats.appCpuTimeUs += frame.appCpuTimeUs;
+                        m_stats.renderCpuTimeUs += frame.renderCpuTimeUs;
+                        m_stats.appGpuTimeUs += frame.appGpuTimeUs;
+                        m_stats.waitCpuTimeUs += frame.waitCpuTimeUs;
+                        m_stats.endFrameCpuTimeUs += frame.endFrameCpuTimeUs;
+                        m_stats.processorGpuTimeUs[0] += frame.processorGpuTimeUs[0];
+                        m_stats.processorGpuTimeUs[1] += frame.processorGpuTimeUs[1];
+                        m_stats.overlayCpuTimeUs += frame.overlayCpuTimeUs;
+                        m_stats.overlayGpuTimeUs += frame.overlayGpuTimeUs;
+                        m_stats.handTrackingCpuTimeUs += frame.handTrackingCpuTimeUs;
+                        m_stats.predictionTimeUs += frame.predictionTimeUs;
+                        numSamples++;
+                    }
+                    m_performanceCounters.windowStartIndex = head;
+
+                    if (numSamples) {
+                        m_stats.appCpuTimeUs /= numSamples;
+                        m_stats.renderCpuTimeUs /= numSamples;
+                        m_stats.appGpuTimeUs /= numSamples;
+                        m_stats.waitCpuTimeUs /= numSamples;
+                        m_stats.endFrameCpuTimeUs /= numSamples;
+                        m_stats.processorGpuTimeUs[0] /= numSamples;
+                        m_stats.processorGpuTimeUs[1] /= numSamples;
+                        m_stats.overlayCpuTimeUs /= numSamples;
+                        m_stats.overlayGpuTimeUs /= numSamples;
+                        m_stats.handTrackingCpuTimeUs /= numSamples;
+                        m_stats.predictionTimeUs /= numSamples;
+                    }
+                }
+
+                // Collect the tail latency for the window.
+                for (size_t i = 0; i < utilities::FrameTimingCount; i++) {
+                    for (size_t j = 0; j < utilities::FrameTimingQuantileCount; j++) {
+                        auto& percentile = m_performanceCounters.percentiles[i][j];
+                        m_stats.timingPercentilesUs[i][j] = static_cast<uint64_t>(percentile->query());
+                        percentile->reset();
+                    }
+                }
+
                 if (highRate) {
                     // We must still do a rolling average for the FPS otherwise the values are all over the place.
                     m_performanceCounters.frameRates.push_front(std::make_pair(duration, numFrames));
@@ -2392,6 +2493,9 @@ namespace {
                 if (m_graphicsDevice->getApi() == graphics::Api::D3D12 &&
                     m_stats.appCpuTimeUs + 500 > m_stats.appGpuTimeUs) {
                     m_stats.appGpuTimeUs = 0;
+                    for (auto& percentile : m_stats.timingPercentilesUs[to_integral(utilities::FrameTiming::AppGpu)]) {
+                        percentile = 0;
+                    }
                 }
 
                 if (m_menuHandler) {
@@ -2410,7 +2514,7 @@ namespace {
                 }
 
                 // Start from fresh!
-                memset(&m_stats, 0, sizeof(m_stats));
+                m_stats = {};
             }
 
             if (m_handTracker && m_menuHandler) {
@@ -2547,9 +2651,17 @@ namespace {
 
             // Handle VPRT.
             auto info = texture->getInfo();
+            const auto srcSlice = (info.arraySize > 1 && suffix == "R") ? 1 : 0;
+
+            // The copy is read back and written to disk in the background over the next frames.
+            if (info.sampleCount == 1) {
+                m_screenshotService->capture(texture, srcSlice, viewport, path);
+                return;
+            }
+
+            // Multisampled textures need a resolve, which only the synchronous path does.
             if (info.arraySize > 1 || viewport.offset.x || viewport.offset.y || info.width != viewport.extent.width ||
                 info.height != viewport.extent.height) {
-                const auto srcSlice = (info.arraySize > 1 && suffix == "R") ? 1 : 0;
                 info.arraySize = 1;
                 info.width = viewport.extent.width;
                 info.height = viewport.extent.height;
@@ -2583,10 +2695,9 @@ namespace {
             updateStatisticsForFrame();
 
             m_performanceCounters.renderCpuTimer->stop();
-            m_stats.renderCpuTimeUs += m_performanceCounters.renderCpuTimer->query();
+            m_frameStats.renderCpuTimeUs += m_performanceCounters.renderCpuTimer->query();
             m_performanceCounters.appGpuTimer[m_performanceCounters.gpuTimerIndex]->stop();
 
-            m_stats.endFrameCpuTimeUs += m_performanceCounters.endFrameCpuTimer->query();
             m_performanceCounters.endFrameCpuTimer->start();
 
             // Toggle to the next set of GPU timers.
@@ -2751,9 +2862,11 @@ namespace {
                         // is texture 1. I'm sure this holds in like 99% of the applications, but still not very clean
                         // to assume.
                         if (m_frameAnalyzer && !useTextureArrays && !swapchainState.registeredWithFrameAnalyzer) {
-                            for (const auto& image : swapchainState.images) {
-                                m_frameAnalyzer->registerColorSwapchainImage(
-                                    view.subImage.swapchain, image.appTexture, (utilities::Eye)eye);
+                            for (uint32_t i = 0; i < swapchainState.images.size(); i++) {
+                                m_frameAnalyzer->registerColorSwapchainImage(view.subImage.swapchain,
+                                                                             swapchainState.images[i].appTexture,
+                                                                             i,
+                                                                             (utilities::Eye)eye);
                             }
                             swapchainState.registeredWithFrameAnalyzer = true;
                         }
@@ -2892,7 +3005,7 @@ namespace {
                             }
 
                             auto timer = swapchainImages.upscalingTimers[eye].get();
-                            m_stats.processorGpuTimeUs[0] += timer->query();
+                            m_frameStats.processorGpuTimeUs[0] += timer->query();
 
                             timer->start();
                             m_upscaler->process(nextInput,
@@ -2908,7 +3021,7 @@ namespace {
                         // Do post-processing and color conversion.
                         {
                             auto timer = swapchainImages.postProcessingTimers[eye].get();
-                            m_stats.processorGpuTimeUs[1] += timer->query();
+                            m_frameStats.processorGpuTimeUs[1] += timer->query();
 
                             timer->start();
                             m_postProcessor->process(nextInput,
@@ -3036,6 +3149,7 @@ namespace {
 
             // We intentionally exclude the overlay from this timer, as it has its own separate timer.
             m_performanceCounters.endFrameCpuTimer->stop();
+            m_frameStats.endFrameCpuTimeUs += m_performanceCounters.endFrameCpuTimer->query();
 
             // Render our overlays.
             bool needMenuSwapchainDelayedRelease = false;
@@ -3045,8 +3159,7 @@ namespace {
                                                             config::HandTrackingVisibility::Hidden;
                 const bool drawEyeGaze = m_eyeTracker && m_configManager->getValue(config::SettingEyeDebug);
 
-                m_stats.overlayCpuTimeUs += m_performanceCounters.overlayCpuTimer->query();
-                m_stats.overlayGpuTimeUs +=
+                m_frameStats.overlayGpuTimeUs +=
                     m_performanceCounters.overlayGpuTimer[m_performanceCounters.gpuTimerIndex]->query();
 
                 m_performanceCounters.overlayCpuTimer->start();
@@ -3194,8 +3307,15 @@ namespace {
 
                 m_performanceCounters.overlayCpuTimer->stop();
                 m_performanceCounters.overlayGpuTimer[m_performanceCounters.gpuTimerIndex]->stop();
+                m_frameStats.overlayCpuTimeUs += m_performanceCounters.overlayCpuTimer->query();
             }
 
+            // All the CPU timings of this frame are known now (the GPU timings are from a few frames ago).
+            publishFrameStatistics();
+
+            // Complete the screenshots from the previous frames before starting new ones.
+            m_screenshotService->update();
+
             // Whether the menu is available or not, we can still use that top-most texture for screenshot.
             // TODO: The screenshot does not work with multi-layer applications.
             const bool requestScreenshot =
@@ -3203,8 +3323,6 @@ namespace {
                 m_configManager->getValue(config::SettingScreenshotEnabled);
 
             if (textureForOverlay[0] && requestScreenshot) {
-                // TODO: this is capturing frame N-3
-                // review the command queues/lists and context flush
                 if (m_configManager->getValue(config::SettingScreenshotEye) != 2 /* Right only */) {
                     takeScreenshot(textureForOverlay[0], "L", viewportForOverlay[0]);
                 }
@@ -3255,7 +3373,7 @@ namespace {
 #endif
 
             {
-                if (m_asyncWaitPromise.valid()) {
+                if (m_asyncWaiter->isPending()) {
                     TraceLocalActivity(local);
 
                     // This is the latest point we must have fully waited a frame before proceeding.
@@ -3264,11 +3382,13 @@ namespace {
                     // to attempt a "double xrWaitFrame" when turning on Turbo. Use a timeout to detect that, and
                     // refrain from enqueing a second wait further down. This isn't a pretty solution, but it is simple
                     // and it seems to work effectively (minus the 1s freeze observed in-game).
-                    TraceLoggingWriteStart(local, "AsyncWaitNow");
-                    const auto ready = m_asyncWaitPromise.wait_for(1s) == std::future_status::ready;
-                    TraceLoggingWriteStop(local, "AsyncWaitNow", TLArg(ready, "Ready"));
+                    TraceLoggingLocalStart(local, "AsyncWaitNow");
+                    const auto ready = m_asyncWaiter->waitForFrame(1s);
+                    TraceLoggingLocalStop(local, "AsyncWaitNow", TLArg(ready, "Ready"));
                     if (ready) {
-                        m_asyncWaitPromise = {};
+                        const auto frameState = m_asyncWaiter->consumeFrame();
+                        m_lastPredictedDisplayTime = frameState.predictedDisplayTime;
+                        m_lastPredictedDisplayPeriod = frameState.predictedDisplayPeriod;
                     }
 
                     CHECK_XRCMD(OpenXrApi::xrBeginFrame(m_vrSession, nullptr));
@@ -3278,30 +3398,10 @@ namespace {
 
                 m_graphicsDevice->unblockCallbacks();
 
-                if (m_configManager->getValue(config::SettingTurboMode) && !m_asyncWaitPromise.valid()) {
-                    m_asyncWaitPolled = false;
-                    m_asyncWaitCompleted = false;
-
-                    // In Turbo mode, we kick off a wait thread immediately.
-                    TraceLoggingWrite(g_traceProvider, "AsyncWaitStart");
-                    m_asyncWaitPromise = std::async(std::launch::async, [&] {
-                        TraceLocalActivity(local);
-
-                        XrFrameState frameState{XR_TYPE_FRAME_STATE};
-                        TraceLoggingWriteStart(local, "AsyncWaitFrame");
-                        CHECK_XRCMD(OpenXrApi::xrWaitFrame(m_vrSession, nullptr, &frameState));
-                        TraceLoggingWriteStop(local,
-                                              "AsyncWaitFrame",
-                                              TLArg(frameState.predictedDisplayTime, "PredictedDisplayTime"),
-                                              TLArg(frameState.predictedDisplayPeriod, "PredictedDisplayPeriod"));
-                        {
-                            std::unique_lock lock(m_asyncWaitLock);
-                            m_lastPredictedDisplayTime = frameState.predictedDisplayTime;
-                            m_lastPredictedDisplayPeriod = frameState.predictedDisplayPeriod;
-
-                            m_asyncWaitCompleted = true;
-                        }
-                    });
+                if (m_configManager->getValue(config::SettingTurboMode) && !m_asyncWaiter->isPending()) {
+                    // In Turbo mode, we kick off the wait thread immediately.
+                    m_asyncWaiter->setPipelineDepth(m_configManager->getValue(config::SettingTurboPipelineDepth));
+                    m_asyncWaiter->start(m_lastPredictedDisplayTime, m_lastPredictedDisplayPeriod);
                 }
 
                 return result;
@@ -3433,17 +3533,15 @@ namespace {
         XrVector2f m_projCenters[utilities::ViewCount];
         XrVector2f m_eyeGaze[utilities::ViewCount];
         XrView m_posesForFrame[utilities::ViewCount];
-        std::chrono::time_point<std::chrono::steady_clock> m_lastFrameWaitTimestamp{};
-        uint32_t m_frameThrottleSleepOffset{0};
+        std::shared_ptr<utilities::IFrameThrottler> m_frameThrottler;
 
-        std::mutex m_asyncWaitLock;
-        std::future<void> m_asyncWaitPromise;
+        std::shared_ptr<utilities::IAsyncFrameWaiter> m_asyncWaiter;
         XrTime m_lastPredictedDisplayTime{0};
         XrTime m_lastPredictedDisplayPeriod{0};
-        bool m_asyncWaitPolled{false};
-        bool m_asyncWaitCompleted{false};
 
         std::shared_ptr<config::IConfigManager> m_configManager;
+        config::SettingHandle m_frameThrottlingSetting;
+        config::SettingHandle m_predictionDampenSetting;
 
         std::shared_ptr<graphics::IDevice> m_graphicsDevice;
         std::map<XrSwapchain, SwapchainState> m_swapchains;
@@ -3463,6 +3561,7 @@ namespace {
         std::shared_ptr<graphics::IImageProcessor> m_upscaler;
         std::shared_ptr<graphics::IImageProcessor> m_postProcessor;
         std::shared_ptr<graphics::IVariableRateShader> m_variableRateShader;
+        std::shared_ptr<graphics::IScreenshotService> m_screenshotService;
 
         std::vector<int> m_keyModifiers;
         int m_keyScreenshot;
@@ -3488,10 +3587,17 @@ namespace {
             uint32_t framesInPeriod{0};
             std::chrono::steady_clock::duration timePeriod{0s};
             uint32_t numFrames{0};
+
+            std::shared_ptr<utilities::IFrameStatisticsHistory> history;
+            uint64_t windowStartIndex{0};
+            std::shared_ptr<utilities::IQuantileEstimator> percentiles[utilities::FrameTimingCount]
+                                                                      [utilities::FrameTimingQuantileCount];
         } m_performanceCounters;
 
+        utilities::FrameStatistics m_frameStats{};
         menu::MenuStatistics m_stats{};
         std::ofstream m_logStats;
+        std::shared_ptr<utilities::IFrameStatisticsRecorder> m_statsRecorder;
         bool m_hasPerformanceCounterKHR{false};
         bool m_hasVisibilityMaskKHR{false};
     };
@@ -3510,6 +3616,7 @@ namespace toolkit {
 
     void ResetInstance() {
         g_instance.reset();
+        log::ShutdownLog();
     }
 
 } // namespace toolkit
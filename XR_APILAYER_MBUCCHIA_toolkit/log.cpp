@@ -37,18 +37,268 @@ namespace toolkit::log {
 
     namespace {
 
+        // The messages are formatted by the caller into a bounded ring (multiple producers), and written out (debugger
+        // output and log file) by a background thread (single consumer). The timestamp is only formatted by the
+        // writer.
+        class AsyncLogger {
+          public:
+            void log(const char* fmt, va_list va) {
+                const auto now = std::chrono::system_clock::now();
+                uint32_t suppressed = 0;
+                if (isRateLimited(fmt, now, suppressed)) {
+                    return;
+                }
+                if (suppressed) {
+                    enqueuef(now, "(%u similar messages were suppressed)\n", suppressed);
+                }
+                enqueue(now, fmt, va);
+
+                ensureWriterStarted();
+                if (m_isWriterIdle.load()) {
+                    std::unique_lock lock(m_writerLock);
+                    m_writerWakeUp.notify_one();
+                }
+            }
+
+            // Write all the pending messages from the calling thread.
+            void drain() {
+                // The writer thread might have crashed while holding the lock (unhandled exception): do not wait
+                // forever, and give up rather than writing concurrently with the writer.
+                std::unique_lock lock(m_consumerLock, std::defer_lock);
+                for (int i = 0; i < 100 && !lock.try_lock(); i++) {
+                    std::this_thread::sleep_for(1ms);
+                }
+                if (lock.owns_lock()) {
+                    writePending();
+                }
+            }
+
+            // Stop the writer thread and uninstall the exception filter. The next message restarts them.
+            void shutdown() {
+                std::unique_lock lifetimeLock(m_lifetimeLock);
+                if (!m_writerThread.joinable()) {
+                    return;
+                }
+
+                SetUnhandledExceptionFilter(m_previousExceptionFilter);
+                m_previousExceptionFilter = nullptr;
+                m_isWriterStarted.store(false, std::memory_order_release);
+
+                {
+                    std::unique_lock lock(m_writerLock);
+                    m_stopWriter = true;
+                    m_writerWakeUp.notify_one();
+                }
+                m_writerThread.join();
+
+                // Messages enqueued while stopping.
+                std::unique_lock lock(m_consumerLock);
+                writePending();
+            }
+
+          private:
+            static constexpr size_t RingSize = 512;
+            static constexpr size_t MaxMessageLength = 1024;
+
+            // Beyond this many messages per second from the same call site, messages are suppressed.
+            static constexpr uint32_t RateLimitPerSecond = 20;
+            static constexpr size_t RateLimitTableSize = 64;
+
+            struct Message {
+                std::atomic<uint64_t> sequence;
+                std::chrono::system_clock::time_point time;
+                char text[MaxMessageLength];
+            };
+
+            struct RateLimit {
+                std::atomic<const char*> fmt{nullptr};
+                std::atomic<int64_t> windowStart{0};
+                std::atomic<uint32_t> count{0};
+                std::atomic<uint32_t> suppressed{0};
+            };
+
+            bool isRateLimited(const char* fmt,
+                               std::chrono::system_clock::time_point now,
+                               uint32_t& suppressedInPreviousWindow) {
+                // The table is keyed by format string, which identifies the call site. Collisions and races only make
+                // the accounting approximate.
+                RateLimit& entry = m_rateLimits[(std::hash<const void*>{}(fmt) >> 4) % RateLimitTableSize];
+                const int64_t second =
+                    std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+
+                if (entry.fmt.load(std::memory_order_relaxed) != fmt ||
+                    entry.windowStart.load(std::memory_order_relaxed) != second) {
+                    entry.fmt.store(fmt, std::memory_order_relaxed);
+                    entry.windowStart.store(second, std::memory_order_relaxed);
+                    entry.count.store(1, std::memory_order_relaxed);
+                    suppressedInPreviousWindow = entry.suppressed.exchange(0, std::memory_order_relaxed);
+                    return false;
+                }
+
+                if (entry.count.fetch_add(1, std::memory_order_relaxed) >= RateLimitPerSecond) {
+                    entry.suppressed.fetch_add(1, std::memory_order_relaxed);
+                    return true;
+                }
+                return false;
+            }
+
+            void enqueuef(std::chrono::system_clock::time_point now, const char* fmt, ...) {
+                va_list va;
+                va_start(va, fmt);
+                enqueue(now, fmt, va);
+                va_end(va);
+            }
+
+            void enqueue(std::chrono::system_clock::time_point now, const char* fmt, va_list va) {
+                // Reserve a slot (bounded queue from D. Vyukov).
+                uint64_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+                Message* message;
+                while (true) {
+                    message = &m_ring[position % RingSize];
+                    const uint64_t sequence = message->sequence.load(std::memory_order_acquire);
+                    const int64_t diff = (int64_t)sequence - (int64_t)position;
+                    if (diff == 0) {
+                        if (m_enqueuePosition.compare_exchange_weak(
+                                position, position + 1, std::memory_order_relaxed)) {
+                            break;
+                        }
+                    } else if (diff < 0) {
+                        // The ring is full: do not block the caller.
+                        m_numDropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    } else {
+                        position = m_enqueuePosition.load(std::memory_order_relaxed);
+                    }
+                }
+
+                message->time = now;
+                vsnprintf_s(message->text, sizeof(message->text), _TRUNCATE, fmt, va);
+                message->sequence.store(position + 1, std::memory_order_release);
+            }
+
+            void ensureWriterStarted() {
+                if (m_isWriterStarted.load(std::memory_order_acquire)) {
+                    return;
+                }
+
+                std::unique_lock lifetimeLock(m_lifetimeLock);
+                if (m_writerThread.joinable()) {
+                    return;
+                }
+
+                m_stopWriter = false;
+                m_writerThread = std::thread([&] { writerThread(); });
+                m_previousExceptionFilter = SetUnhandledExceptionFilter(onUnhandledException);
+                m_isWriterStarted.store(true, std::memory_order_release);
+            }
+
+            static LONG WINAPI onUnhandledException(EXCEPTION_POINTERS* exceptionInfo);
+
+            void writerThread() {
+                while (true) {
+                    {
+                        std::unique_lock lock(m_consumerLock);
+                        writePending();
+                    }
+
+                    std::unique_lock lock(m_writerLock);
+                    if (m_stopWriter) {
+                        break;
+                    }
+                    m_isWriterIdle.store(true);
+                    if (!hasPending()) {
+                        // The timeout is a safety net for a wake-up that could be missed.
+                        m_writerWakeUp.wait_for(lock, 100ms);
+                    }
+                    m_isWriterIdle.store(false);
+                }
+            }
+
+            bool hasPending() const {
+                const uint64_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+                return m_ring[position % RingSize].sequence.load(std::memory_order_acquire) == position + 1;
+            }
+
+            // Must be called with the consumer lock held.
+            void writePending() {
+                bool hasWritten = false;
+                while (hasPending()) {
+                    const uint64_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+                    Message& message = m_ring[position % RingSize];
+                    write(message.time, message.text);
+                    message.sequence.store(position + RingSize, std::memory_order_release);
+                    m_dequeuePosition.store(position + 1, std::memory_order_relaxed);
+                    hasWritten = true;
+                }
+
+                const uint32_t numDropped = m_numDropped.exchange(0, std::memory_order_relaxed);
+                if (numDropped) {
+                    char text[64];
+                    sprintf_s(text, "(%u messages were dropped)\n", numDropped);
+                    write(std::chrono::system_clock::now(), text);
+                    hasWritten = true;
+                }
+
+                if (hasWritten && logStream.is_open()) {
+                    logStream.flush();
+                }
+            }
+
+            void write(std::chrono::system_clock::time_point time, const char* text) {
+                const std::time_t t = std::chrono::system_clock::to_time_t(time);
+
+                char buf[64];
+                std::strftime(buf, sizeof(buf), "[OXRTK] %Y-%m-%d %H:%M:%S %z: ", std::localtime(&t));
+                OutputDebugStringA(buf);
+                OutputDebugStringA(text);
+                if (logStream.is_open()) {
+                    logStream << buf << text;
+                }
+            }
+
+            std::unique_ptr<Message[]> m_ring = [] {
+                auto ring = std::make_unique<Message[]>(RingSize);
+                for (size_t i = 0; i < RingSize; i++) {
+                    ring[i].sequence.store(i, std::memory_order_relaxed);
+                }
+                return ring;
+            }();
+            std::atomic<uint64_t> m_enqueuePosition{0};
+            // Only written with the consumer lock held. The writer also reads it to decide whether to sleep.
+            std::atomic<uint64_t> m_dequeuePosition{0};
+            std::atomic<uint32_t> m_numDropped{0};
+            std::mutex m_consumerLock;
+
+            RateLimit m_rateLimits[RateLimitTableSize];
+
+            std::mutex m_lifetimeLock;
+            std::thread m_writerThread;
+            LPTOP_LEVEL_EXCEPTION_FILTER m_previousExceptionFilter{nullptr};
+            std::atomic<bool> m_isWriterStarted{false};
+            std::atomic<bool> m_isWriterIdle{false};
+            std::mutex m_writerLock;
+            bool m_stopWriter{false};
+            std::condition_variable m_writerWakeUp;
+        };
+
+        // Never destroyed: the writer thread is still running at process exit when the application does not destroy its
+        // instance.
+        AsyncLogger& GetLogger() {
+            static AsyncLogger* logger = new AsyncLogger;
+            return *logger;
+        }
+
+        LONG WINAPI AsyncLogger::onUnhandledException(EXCEPTION_POINTERS* exceptionInfo) {
+            // Do not lose the messages leading to a crash.
+            auto& logger = GetLogger();
+            logger.drain();
+            return logger.m_previousExceptionFilter ? logger.m_previousExceptionFilter(exceptionInfo)
+                                                    : EXCEPTION_CONTINUE_SEARCH;
+        }
+
         // Utility logging function.
         void InternalLog(const char* fmt, va_list va) {
-            const std::time_t now = std::time(nullptr);
-
-            char buf[1024];
-            size_t offset = std::strftime(buf, sizeof(buf), "[OXRTK] %Y-%m-%d %H:%M:%S %z: ", std::localtime(&now));
-            vsnprintf_s(buf + offset, sizeof(buf) - offset, _TRUNCATE, fmt, va);
-            OutputDebugStringA(buf);
-            if (logStream.is_open()) {
-                logStream << buf;
-                logStream.flush();
-            }
+            GetLogger().log(fmt, va);
         }
     } // namespace
 
@@ -68,4 +318,12 @@ namespace toolkit::log {
 #endif
     }
 
+    void FlushLog() {
+        GetLogger().drain();
+    }
+
+    void ShutdownLog() {
+        GetLogger().shutdown();
+    }
+
 } // namespace toolkit::log
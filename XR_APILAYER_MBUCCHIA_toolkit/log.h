@@ -62,7 +62,26 @@ namespace toolkit::log {
 
 #define IsTraceEnabled() TraceLoggingProviderEnabled(g_traceProvider, 0, 0)
 
-#define TraceLocalActivity(activity) TraceLoggingActivity<g_traceProvider> activity;
+    // Local activities are only started when a trace session is listening. The provider state is sampled once when
+    // declaring the activity, so that the start and stop events are always paired. When tracing is off, the hooks skip
+    // creating the activity ID and formatting the arguments.
+#define TraceLocalActivity(activity)                                                                                   \
+    TraceLoggingActivity<g_traceProvider> activity;                                                                    \
+    const bool activity##IsTracing = IsTraceEnabled();
+
+#define TraceLoggingLocalStart(activity, name, ...)                                                                    \
+    do {                                                                                                               \
+        if (activity##IsTracing) {                                                                                     \
+            TraceLoggingWriteStart(activity, name, ##__VA_ARGS__);                                                     \
+        }                                                                                                              \
+    } while (0)
+
+#define TraceLoggingLocalStop(activity, name, ...)                                                                     \
+    do {                                                                                                               \
+        if (activity##IsTracing) {                                                                                     \
+            TraceLoggingWriteStop(activity, name, ##__VA_ARGS__);                                                      \
+        }                                                                                                              \
+    } while (0)
 
 #define TLArg(var, ...) TraceLoggingValue(var, ##__VA_ARGS__)
 #define TLPArg(var, ...) TraceLoggingValue(fmt::format("0x{:08x}", (uintptr_t)(var)).c_str(), ##__VA_ARGS__)
@@ -73,4 +92,11 @@ namespace toolkit::log {
     // Debug logging function. Can make things very slow (only enabled on Debug builds).
     void DebugLog(const char* fmt, ...);
 
+    // Write out all the pending messages (logging is asynchronous).
+    void FlushLog();
+
+    // Write out all the pending messages and stop the background writer (logging again restarts it). Must not be
+    // called from DllMain(), since it waits for the writer thread.
+    void ShutdownLog();
+
 } // namespace toolkit::log
@@ -985,6 +985,25 @@ namespace {
                                     TIMING_STAT("hnd CPU", handTrackingCpuTimeUs);
                                 }
 
+#define PERCENTILE_STAT(label, timing)                                                                                 \
+    {                                                                                                                  \
+        const auto& percentiles = m_stats.timingPercentilesUs[to_integral(timing)];                                    \
+        m_device->drawString(fmt::format(label ": {}/{}/{}", percentiles[0], percentiles[1], percentiles[2]),          \
+                             OVERLAY_COMMON);                                                                          \
+        top += 1.05f * fontSize;                                                                                       \
+    }
+                                top += 1.05f * fontSize;
+                                m_device->drawString("p50/p95/p99", OVERLAY_COMMON);
+                                top += 1.05f * fontSize;
+                                PERCENTILE_STAT("app CPU", FrameTiming::AppCpu);
+                                PERCENTILE_STAT("rdr CPU", FrameTiming::RenderCpu);
+                                PERCENTILE_STAT("app GPU", FrameTiming::AppGpu);
+                                PERCENTILE_STAT("wait", FrameTiming::WaitCpu);
+                                PERCENTILE_STAT("lay CPU", FrameTiming::EndFrameCpu);
+                                PERCENTILE_STAT("scl GPU", FrameTiming::UpscalerGpu);
+#undef PERCENTILE_STAT
+                                top += 1.05f * fontSize;
+
                                 m_device->drawString(fmt::format("{}{} / {}{}",
                                                                  m_stats.hasColorBuffer[0] ? "C" : "_",
                                                                  m_stats.hasDepthBuffer[0] ? "D" : "_",
@@ -1053,6 +1072,18 @@ namespace {
                                                          OVERLAY_COMMON);
                                     top += 1.05f * fontSize;
 
+                                    m_device->drawString(fmt::format("qry: {}/{}",
+                                                                     m_gesturesState.numJointsQueries[0],
+                                                                     m_gesturesState.numJointsQueries[1]),
+                                                         OVERLAY_COMMON);
+                                    top += 1.05f * fontSize;
+
+                                    m_device->drawString(fmt::format("pred: {:.2f}/{:.2f}",
+                                                                     m_gesturesState.predictionConfidence[0],
+                                                                     m_gesturesState.predictionConfidence[1]),
+                                                         OVERLAY_COMMON);
+                                    top += 1.05f * fontSize;
+
                                     m_device->drawString(fmt::format("age: {:.1f}/{:.1f}",
                                                                      m_gesturesState.handposeAgeUs[0] / 1000000.0f,
                                                                      m_gesturesState.handposeAgeUs[1] / 1000000.0f),
@@ -1455,6 +1486,15 @@ namespace {
                                      0,
                                      MenuEntry::LastVal<OffOnType>(),
                                      MenuEntry::FmtEnum<OffOnType>});
+            MenuGroup turboGroup(this, [&] { return m_configManager->peekValue(SettingTurboMode); });
+            m_menuEntries.push_back({MenuIndent::SubGroupIndent,
+                                     "Pipeline depth",
+                                     MenuEntryType::Slider,
+                                     SettingTurboPipelineDepth,
+                                     1,
+                                     MaxTurboPipelineDepth,
+                                     [&](int value) { return fmt::format("{}", value); }});
+            turboGroup.finalize();
 
             MenuGroup frameThrottlingGroup(this, [&] {
                 return !m_isMotionReprojectionRateSupported || m_configManager->peekEnumValue<MotionReprojection>(
@@ -1480,8 +1520,8 @@ namespace {
                                      MenuEntryType::Choice,
                                      SettingRecordStats,
                                      0,
-                                     MenuEntry::LastVal<NoYesType>(),
-                                     MenuEntry::FmtEnum<NoYesType>});
+                                     MenuEntry::LastVal<RecordStatsType>(),
+                                     MenuEntry::FmtEnum<RecordStatsType>});
             MenuGroup statisticsGroup(this, [&] {
                 return m_configManager->peekValue(SettingOverlayType) || m_configManager->peekValue(SettingRecordStats);
             });
@@ -0,0 +1,47 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "pch.h"
+
+namespace toolkit::math {
+
+    // Helpers for the One-Euro filters of the gaze and of the hand motion.
+    // See "1 Euro Filter: A Simple Speed-based Low-pass Filter for Noisy Input in Interactive Systems", Casiez et al.
+
+    // The weight of a new sample for an exponential smoothing with the given cutoff frequency (Hz).
+    inline float SmoothingFactor(float cutoff, float dt) {
+        const float tau = 1.f / (2.f * (float)M_PI * cutoff);
+        return 1.f / (1.f + tau / dt);
+    }
+
+    inline XrVector2f Lerp(const XrVector2f& a, const XrVector2f& b, float alpha) {
+        return {a.x + alpha * (b.x - a.x), a.y + alpha * (b.y - a.y)};
+    }
+
+    inline XrVector3f Lerp(const XrVector3f& a, const XrVector3f& b, float alpha) {
+        return {a.x + alpha * (b.x - a.x), a.y + alpha * (b.y - a.y), a.z + alpha * (b.z - a.z)};
+    }
+
+} // namespace toolkit::math
@@ -30,11 +30,13 @@
 #include <chrono>
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <condition_variable>
 #include <cstdarg>
 #include <ctime>
 #include <deque>
 #include <iomanip>
 #include <iostream>
+#include <list>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
@@ -45,6 +47,7 @@
 #include <optional>
 #include <set>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 using namespace std::chrono_literals;
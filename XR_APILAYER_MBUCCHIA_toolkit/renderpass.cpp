@@ -0,0 +1,204 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+
+namespace {
+
+    using namespace toolkit;
+    using namespace toolkit::graphics;
+    using namespace toolkit::utilities;
+
+    // Frames with more render passes than this are not analyzed.
+    constexpr size_t MaxPassesPerFrame = 1024;
+
+    // The render passes of each eye must span at least this many passes, and at least this fraction of the frame.
+    constexpr size_t MinSegmentPasses = 4;
+    constexpr size_t MinSegmentFraction = 4; // 1/4th
+
+    // A signature is adopted once it was found identically in this many consecutive frames. The same number of
+    // consecutive frames without the expected eye switch is needed to replace a signature.
+    constexpr uint32_t LearningFrames = 30;
+
+    // FNV-1a hash of the render pass description. It must remain stable across sessions since signatures are
+    // persisted.
+    uint32_t HashPass(RenderPassEvent event, uint32_t width, uint32_t height, int64_t format) {
+        uint32_t hash = 2166136261u;
+        const auto mix = [&hash](uint64_t value) {
+            for (uint32_t i = 0; i < 8; i++) {
+                hash = (hash ^ (uint8_t)(value >> (i * 8))) * 16777619u;
+            }
+        };
+        mix((uint64_t)event);
+        mix(width);
+        mix(height);
+        mix((uint64_t)format);
+        return hash;
+    }
+
+    class RenderPassLearner : public IRenderPassLearner {
+      public:
+        void resetForFrame() override {
+            m_eye = Eye::Left;
+            m_lastPass.reset();
+            m_occurrences = 0;
+
+            // Only record the passes while we do not have a signature that works.
+            m_isRecording = !m_signature.isValid() || m_missedFrames > 0;
+            if (!m_isRecording) {
+                m_candidateFrames = 0;
+            }
+            m_passes.clear();
+        }
+
+        void recordPass(RenderPassEvent event, uint32_t width, uint32_t height, int64_t format) override {
+            const uint32_t pass = HashPass(event, width, height, format);
+
+            // Applications often bind the same render target several times in a row.
+            if (m_lastPass == pass) {
+                return;
+            }
+            m_lastPass = pass;
+
+            if (m_isRecording) {
+                if (m_passes.size() < MaxPassesPerFrame) {
+                    m_passes.push_back(pass);
+                } else {
+                    m_isRecording = false;
+                    m_candidateFrames = 0;
+                }
+            }
+
+            if (m_signature.isValid() && pass == m_signature.switchPass &&
+                ++m_occurrences == m_signature.switchOccurrence) {
+                m_eye = Eye::Right;
+            }
+        }
+
+        void endFrame() override {
+            if (m_signature.isValid()) {
+                m_missedFrames = m_occurrences >= m_signature.switchOccurrence ? 0 : m_missedFrames + 1;
+            }
+
+            if (!m_isRecording) {
+                return;
+            }
+
+            // The search is quadratic with the number of passes, but most frames have the same passes as the previous
+            // one.
+            if (m_passes != m_previousPasses) {
+                m_previousCandidate = findSignature();
+                std::swap(m_passes, m_previousPasses);
+            }
+
+            const auto candidate = m_previousCandidate;
+            if (candidate.isValid() && candidate == m_candidate) {
+                m_candidateFrames++;
+            } else {
+                m_candidate = candidate;
+                m_candidateFrames = candidate.isValid() ? 1 : 0;
+            }
+
+            if (m_candidateFrames >= LearningFrames && (!m_signature.isValid() || m_missedFrames >= LearningFrames)) {
+                m_signature = m_candidate;
+                m_missedFrames = 0;
+                m_candidateFrames = 0;
+            }
+        }
+
+        void setSignature(const RenderPassSignature& signature) override {
+            m_signature = signature;
+            m_missedFrames = 0;
+            m_candidateFrames = 0;
+        }
+
+        const RenderPassSignature& getSignature() const override {
+            return m_signature;
+        }
+
+        std::optional<Eye> getEyeHint() const override {
+            // Do not trust a signature that did not match the previous frame (eg: loading screen, change of
+            // resolution).
+            if (!m_signature.isValid() || m_missedFrames > 0) {
+                return std::nullopt;
+            }
+            return m_eye;
+        }
+
+      private:
+        // Look for the longest sequence of passes immediately repeated (a "tandem repeat"), which is what rendering
+        // one eye then the other looks like. Passes shared by both eyes (eg: shadow maps) or done after both eyes
+        // (eg: post-processing, UI, mirror window) may surround the repeat. The eye switches at the start of the
+        // second occurrence.
+        RenderPassSignature findSignature() const {
+            const size_t count = m_passes.size();
+            const size_t minLength = std::max(MinSegmentPasses, count / MinSegmentFraction);
+
+            for (size_t length = count / 2; length >= minLength; length--) {
+                size_t run = 0;
+                for (size_t i = 0; i + length < count; i++) {
+                    if (m_passes[i] != m_passes[i + length]) {
+                        run = 0;
+                        continue;
+                    }
+
+                    if (++run == length) {
+                        const size_t split = i + 1;
+                        RenderPassSignature signature;
+                        signature.switchPass = m_passes[split];
+                        signature.switchOccurrence = (uint32_t)std::count(
+                            m_passes.cbegin(), m_passes.cbegin() + split + 1, signature.switchPass);
+                        return signature;
+                    }
+                }
+            }
+
+            return {};
+        }
+
+        RenderPassSignature m_signature;
+        uint32_t m_missedFrames{0};
+
+        Eye m_eye{Eye::Left};
+        std::optional<uint32_t> m_lastPass;
+        uint32_t m_occurrences{0};
+
+        bool m_isRecording{false};
+        std::vector<uint32_t> m_passes;
+        std::vector<uint32_t> m_previousPasses;
+        RenderPassSignature m_previousCandidate;
+        RenderPassSignature m_candidate;
+        uint32_t m_candidateFrames{0};
+    };
+
+} // namespace
+
+namespace toolkit::graphics {
+
+    std::shared_ptr<IRenderPassLearner> CreateRenderPassLearner() {
+        return std::make_shared<RenderPassLearner>();
+    }
+
+} // namespace toolkit::graphics
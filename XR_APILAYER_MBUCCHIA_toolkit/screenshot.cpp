@@ -0,0 +1,390 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+#include "log.h"
+
+#include <wincodec.h>
+
+namespace {
+
+    using namespace toolkit;
+    using namespace toolkit::graphics;
+    using namespace toolkit::log;
+
+    struct PixelFormat {
+        DXGI_FORMAT format;
+        WICPixelFormatGUID wicFormat;
+        uint32_t bytesPerPixel;
+    };
+
+    const PixelFormat PixelFormats[] = {
+        {DXGI_FORMAT_R8G8B8A8_TYPELESS, GUID_WICPixelFormat32bppRGBA, 4},
+        {DXGI_FORMAT_R8G8B8A8_UNORM, GUID_WICPixelFormat32bppRGBA, 4},
+        {DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, GUID_WICPixelFormat32bppRGBA, 4},
+        {DXGI_FORMAT_B8G8R8A8_TYPELESS, GUID_WICPixelFormat32bppBGRA, 4},
+        {DXGI_FORMAT_B8G8R8A8_UNORM, GUID_WICPixelFormat32bppBGRA, 4},
+        {DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, GUID_WICPixelFormat32bppBGRA, 4},
+        {DXGI_FORMAT_B8G8R8X8_TYPELESS, GUID_WICPixelFormat32bppBGR, 4},
+        {DXGI_FORMAT_B8G8R8X8_UNORM, GUID_WICPixelFormat32bppBGR, 4},
+        {DXGI_FORMAT_B8G8R8X8_UNORM_SRGB, GUID_WICPixelFormat32bppBGR, 4},
+        {DXGI_FORMAT_R10G10B10A2_TYPELESS, GUID_WICPixelFormat32bppRGBA1010102, 4},
+        {DXGI_FORMAT_R10G10B10A2_UNORM, GUID_WICPixelFormat32bppRGBA1010102, 4},
+        {DXGI_FORMAT_R16G16B16A16_FLOAT, GUID_WICPixelFormat64bppRGBAHalf, 8},
+        {DXGI_FORMAT_R16G16B16A16_UNORM, GUID_WICPixelFormat64bppRGBA, 8},
+        {DXGI_FORMAT_R32G32B32A32_FLOAT, GUID_WICPixelFormat128bppRGBAFloat, 16},
+    };
+
+    const PixelFormat* GetPixelFormat(DXGI_FORMAT format) {
+        for (const auto& pixelFormat : PixelFormats) {
+            if (pixelFormat.format == format) {
+                return &pixelFormat;
+            }
+        }
+        return nullptr;
+    }
+
+    // See https://docs.microsoft.com/en-us/windows/win32/direct3ddds/dds-header.
+    struct DDSPixelFormat {
+        uint32_t size;
+        uint32_t flags;
+        uint32_t fourCC;
+        uint32_t RGBBitCount;
+        uint32_t RBitMask;
+        uint32_t GBitMask;
+        uint32_t BBitMask;
+        uint32_t ABitMask;
+    };
+
+    struct DDSHeader {
+        uint32_t magic;
+        uint32_t size;
+        uint32_t flags;
+        uint32_t height;
+        uint32_t width;
+        uint32_t pitchOrLinearSize;
+        uint32_t depth;
+        uint32_t mipMapCount;
+        uint32_t reserved1[11];
+        DDSPixelFormat ddspf;
+        uint32_t caps;
+        uint32_t caps2;
+        uint32_t caps3;
+        uint32_t caps4;
+        uint32_t reserved2;
+
+        // DDS_HEADER_DXT10.
+        DXGI_FORMAT dxgiFormat;
+        uint32_t resourceDimension;
+        uint32_t miscFlag;
+        uint32_t arraySize;
+        uint32_t miscFlags2;
+    };
+    static_assert(sizeof(DDSHeader) == 4 + 124 + 20);
+
+    // An image read back from the GPU, waiting to be encoded.
+    struct PendingWrite {
+        std::filesystem::path path;
+        DXGI_FORMAT format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t rowPitch;
+        std::vector<uint8_t> data;
+    };
+
+    class ScreenshotService : public IScreenshotService {
+      public:
+        ScreenshotService(std::shared_ptr<IDevice> device, const ScreenshotServiceParameters& parameters)
+            : m_device(device), m_parameters(parameters) {
+            m_thread = std::thread([&] { writerThread(); });
+        }
+
+        ~ScreenshotService() override {
+            // Do not lose the captures that have already completed.
+            update();
+
+            {
+                std::unique_lock lock(m_lock);
+                m_stop = true;
+            }
+            m_wakeUp.notify_all();
+            m_thread.join();
+
+            if (m_numCapturesInFlight) {
+                Log("%u screenshot(s) were lost\n", m_numCapturesInFlight.load());
+            }
+        }
+
+        bool capture(std::shared_ptr<ITexture> texture,
+                     int32_t slice,
+                     const XrRect2Di& region,
+                     const std::filesystem::path& path) override {
+            XrSwapchainCreateInfo info = texture->getInfo();
+            info.width = region.extent.width;
+            info.height = region.extent.height;
+            info.arraySize = 1;
+            info.mipCount = 1;
+
+            // Prefer recycling a readback texture of the same size and format.
+            Capture* freeCapture = nullptr;
+            for (auto& capture : m_captures) {
+                if (capture.inUse) {
+                    continue;
+                }
+                const auto& readbackInfo = capture.readback->getInfo();
+                if (readbackInfo.width == info.width && readbackInfo.height == info.height &&
+                    readbackInfo.format == info.format) {
+                    freeCapture = &capture;
+                    break;
+                }
+                if (!freeCapture) {
+                    freeCapture = &capture;
+                }
+            }
+            if (!freeCapture || freeCapture->readback->getInfo().width != info.width ||
+                freeCapture->readback->getInfo().height != info.height ||
+                freeCapture->readback->getInfo().format != info.format) {
+                if (!freeCapture) {
+                    if (m_captures.size() >= m_parameters.maxCapturesInFlight) {
+                        Log("Too many screenshots in flight, dropping %S\n", path.c_str());
+                        return false;
+                    }
+                    freeCapture = &m_captures.emplace_back();
+                }
+                freeCapture->readback = m_device->createReadbackTexture(info, "Screenshot Readback");
+            }
+
+            freeCapture->readback->copyFrom(texture, slice, region.offset.x, region.offset.y);
+            freeCapture->path = path;
+            freeCapture->inUse = true;
+            m_numCapturesInFlight++;
+
+            return true;
+        }
+
+        void update() override {
+            for (auto& capture : m_captures) {
+                if (!capture.inUse || !capture.readback->isReady()) {
+                    continue;
+                }
+
+                const auto& info = capture.readback->getInfo();
+                PendingWrite write;
+                write.path = capture.path;
+                write.format = (DXGI_FORMAT)info.format;
+                write.width = info.width;
+                write.height = info.height;
+                capture.readback->readback(write.data, write.rowPitch);
+                capture.inUse = false;
+                m_numCapturesInFlight--;
+
+                std::unique_lock lock(m_lock);
+                if (m_pendingWrites.size() >= m_parameters.maxPendingWrites) {
+                    Log("Too many screenshots pending, dropping %S\n", write.path.c_str());
+                    continue;
+                }
+                m_pendingWrites.push_back(std::move(write));
+                m_wakeUp.notify_all();
+            }
+        }
+
+        uint32_t getNumPending() const override {
+            std::unique_lock lock(m_lock);
+            return m_numCapturesInFlight + (uint32_t)m_pendingWrites.size() + (m_isWriting ? 1 : 0);
+        }
+
+      private:
+        struct Capture {
+            std::shared_ptr<IReadbackTexture> readback;
+            std::filesystem::path path;
+            bool inUse{false};
+        };
+
+        void writerThread() {
+            const HRESULT hrInit = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+            std::unique_lock lock(m_lock);
+            while (true) {
+                m_wakeUp.wait(lock, [&] { return m_stop || !m_pendingWrites.empty(); });
+                if (m_pendingWrites.empty()) {
+                    break;
+                }
+
+                PendingWrite write = std::move(m_pendingWrites.front());
+                m_pendingWrites.pop_front();
+                m_isWriting = true;
+                lock.unlock();
+
+                TraceLocalActivity(local);
+                TraceLoggingLocalStart(local, "Screenshot_Write", TLArg(write.path.c_str(), "Path"));
+
+                try {
+                    if (write.path.extension() == ".dds") {
+                        writeDDS(write);
+                    } else {
+                        writeWIC(write);
+                    }
+                    Log("Screenshot saved to %S\n", write.path.c_str());
+                } catch (std::exception& exc) {
+                    Log("Failed to take screenshot: %s\n", exc.what());
+                    std::error_code ec;
+                    std::filesystem::remove(write.path, ec);
+                }
+
+                TraceLoggingLocalStop(local, "Screenshot_Write");
+
+                lock.lock();
+                m_isWriting = false;
+            }
+            lock.unlock();
+
+            m_wicFactory = nullptr;
+            if (SUCCEEDED(hrInit)) {
+                CoUninitialize();
+            }
+        }
+
+        void writeDDS(const PendingWrite& write) const {
+            const auto pixelFormat = GetPixelFormat(write.format);
+            const uint32_t bytesPerPixel = pixelFormat ? pixelFormat->bytesPerPixel : 0;
+            if (!bytesPerPixel) {
+                throw std::runtime_error(fmt::format("Unsupported format: {}", (int)write.format));
+            }
+            const uint32_t pitch = write.width * bytesPerPixel;
+
+            // Always use the DX10 header extension, which supports all formats.
+            DDSHeader header{};
+            header.magic = 0x20534444; // "DDS "
+            header.size = 124;
+            header.flags = 0x1 | 0x2 | 0x4 | 0x8 | 0x1000; // CAPS | HEIGHT | WIDTH | PITCH | PIXELFORMAT
+            header.height = write.height;
+            header.width = write.width;
+            header.pitchOrLinearSize = pitch;
+            header.mipMapCount = 1;
+            header.ddspf.size = sizeof(DDSPixelFormat);
+            header.ddspf.flags = 0x4; // FOURCC
+            header.ddspf.fourCC = MAKEFOURCC('D', 'X', '1', '0');
+            header.caps = 0x1000; // TEXTURE
+            header.dxgiFormat = write.format;
+            header.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+            header.arraySize = 1;
+
+            std::ofstream file(write.path, std::ios_base::binary);
+            if (!file.is_open()) {
+                throw std::runtime_error("Failed to create file");
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (uint32_t y = 0; y < write.height; y++) {
+                file.write(reinterpret_cast<const char*>(write.data.data() + (size_t)y * write.rowPitch), pitch);
+            }
+            if (!file.flush()) {
+                throw std::runtime_error("Failed to write file");
+            }
+        }
+
+        void writeWIC(const PendingWrite& write) {
+            const auto pixelFormat = GetPixelFormat(write.format);
+            if (!pixelFormat) {
+                throw std::runtime_error(fmt::format("Unsupported format: {}", (int)write.format));
+            }
+
+            const auto& containerFormat = write.path.extension() == ".png"   ? GUID_ContainerFormatPng
+                                          : write.path.extension() == ".bmp" ? GUID_ContainerFormatBmp
+                                                                             : GUID_ContainerFormatJpeg;
+
+            if (!m_wicFactory) {
+                CHECK_HRCMD(CoCreateInstance(
+                    CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(set(m_wicFactory))));
+            }
+
+            ComPtr<IWICStream> stream;
+            CHECK_HRCMD(m_wicFactory->CreateStream(set(stream)));
+            CHECK_HRCMD(stream->InitializeFromFilename(write.path.c_str(), GENERIC_WRITE));
+
+            ComPtr<IWICBitmapEncoder> encoder;
+            CHECK_HRCMD(m_wicFactory->CreateEncoder(containerFormat, nullptr, set(encoder)));
+            CHECK_HRCMD(encoder->Initialize(get(stream), WICBitmapEncoderNoCache));
+
+            ComPtr<IWICBitmapFrameEncode> frame;
+            ComPtr<IPropertyBag2> properties;
+            CHECK_HRCMD(encoder->CreateNewFrame(set(frame), set(properties)));
+            CHECK_HRCMD(frame->Initialize(get(properties)));
+            CHECK_HRCMD(frame->SetSize(write.width, write.height));
+            CHECK_HRCMD(frame->SetResolution(72, 72));
+
+            // Screenshots do not include the alpha channel. The encoder might pick a different format.
+            WICPixelFormatGUID targetFormat = GUID_WICPixelFormat24bppBGR;
+            CHECK_HRCMD(frame->SetPixelFormat(&targetFormat));
+
+            ComPtr<IWICBitmap> source;
+            CHECK_HRCMD(m_wicFactory->CreateBitmapFromMemory(write.width,
+                                                             write.height,
+                                                             pixelFormat->wicFormat,
+                                                             write.rowPitch,
+                                                             (UINT)write.data.size(),
+                                                             const_cast<BYTE*>(write.data.data()),
+                                                             set(source)));
+
+            ComPtr<IWICFormatConverter> converter;
+            CHECK_HRCMD(m_wicFactory->CreateFormatConverter(set(converter)));
+            CHECK_HRCMD(converter->Initialize(
+                get(source), targetFormat, WICBitmapDitherTypeNone, nullptr, 0, WICBitmapPaletteTypeMedianCut));
+
+            const WICRect rect{0, 0, (INT)write.width, (INT)write.height};
+            CHECK_HRCMD(frame->WriteSource(get(converter), &rect));
+            CHECK_HRCMD(frame->Commit());
+            CHECK_HRCMD(encoder->Commit());
+        }
+
+        const std::shared_ptr<IDevice> m_device;
+        const ScreenshotServiceParameters m_parameters;
+
+        // Only accessed from the frame thread.
+        std::list<Capture> m_captures;
+
+        // Updated from the frame thread, but read by getNumPending() from any thread.
+        std::atomic<uint32_t> m_numCapturesInFlight{0};
+
+        std::thread m_thread;
+        mutable std::mutex m_lock;
+        std::condition_variable m_wakeUp;
+        bool m_stop{false};
+        std::deque<PendingWrite> m_pendingWrites;
+        bool m_isWriting{false};
+
+        // Only accessed from the writer thread.
+        ComPtr<IWICImagingFactory> m_wicFactory;
+    };
+
+} // namespace
+
+namespace toolkit::graphics {
+
+    std::shared_ptr<IScreenshotService> CreateScreenshotService(std::shared_ptr<IDevice> graphicsDevice,
+                                                                const ScreenshotServiceParameters& parameters) {
+        return std::make_shared<ScreenshotService>(graphicsDevice, parameters);
+    }
+
+} // namespace toolkit::graphics
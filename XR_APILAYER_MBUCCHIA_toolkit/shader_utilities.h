@@ -48,6 +48,65 @@ namespace toolkit::utilities::shader {
         CompileShader(code.data(), code.size(), entryPoint, blob, nullptr, nullptr, target);
     }
 
+    // Incremental 64-bit FNV-1a hash, used for the shader cache keys.
+    class ShaderHash {
+      public:
+        ShaderHash& add(const void* data, size_t size);
+
+        // The terminator is included, so that consecutive strings cannot alias.
+        ShaderHash& add(std::string_view str) {
+            add(str.data(), str.size());
+            return add("", 1);
+        }
+
+        uint64_t get() const {
+            return m_hash;
+        }
+
+      private:
+        uint64_t m_hash{14695981039346656037ull};
+    };
+
+    // A content-addressed store for compiled shaders. Each entry records the includes that were resolved during
+    // compilation, so that modifying an include invalidates the entry. This class does not depend on the compiler.
+    class ShaderCache {
+      public:
+        struct Dependency {
+            std::string name;
+            uint64_t hash;
+        };
+
+        // Return the current hash of a dependency, or nothing if it can no longer be resolved.
+        using DependencyResolver = std::function<std::optional<uint64_t>(const std::string& name)>;
+
+        ShaderCache(std::filesystem::path directory) : m_directory(std::move(directory)) {
+        }
+
+        // The key covers everything that affects the compiler output, except for the includes, which are validated
+        // against the entry.
+        static uint64_t getKey(const void* data,
+                               size_t size,
+                               const D3D_SHADER_MACRO* defines,
+                               const char* entryPoint,
+                               const char* target,
+                               uint32_t flags,
+                               uint32_t compilerVersion);
+
+        // Any missing, outdated or corrupted entry is a miss.
+        std::optional<std::vector<uint8_t>> load(uint64_t key, const DependencyResolver& resolveDependency) const;
+
+        // The entry is written to a temporary file then renamed, so that a concurrent reader never sees a partial
+        // entry. Failures are not fatal.
+        void store(uint64_t key, const std::vector<Dependency>& dependencies, const void* data, size_t size) const;
+
+        std::filesystem::path getEntryPath(uint64_t key) const {
+            return m_directory / fmt::format("{:016x}.bin", key);
+        }
+
+      private:
+        const std::filesystem::path m_directory;
+    };
+
     struct IncludeHeader : ID3DInclude {
         IncludeHeader(std::vector<std::filesystem::path> includePaths) : m_includePaths(std::move(includePaths)) {
         }
@@ -0,0 +1,175 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "shader_utilities.h"
+#include "log.h"
+
+namespace {
+
+    // Bump this to invalidate all the existing cache entries.
+    constexpr uint32_t ShaderCacheVersion = 1;
+
+    constexpr char ShaderCacheMagic[8] = {'O', 'X', 'R', 'T', 'K', 'S', 'H', 'C'};
+
+    template <typename T>
+    void WriteValue(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    bool ReadValue(std::ifstream& file, T& value) {
+        return !!file.read(reinterpret_cast<char*>(&value), sizeof(value));
+    }
+
+} // namespace
+
+namespace toolkit::utilities::shader {
+
+    ShaderHash& ShaderHash::add(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            m_hash = (m_hash ^ bytes[i]) * 1099511628211ull;
+        }
+        return *this;
+    }
+
+    uint64_t ShaderCache::getKey(const void* data,
+                                 size_t size,
+                                 const D3D_SHADER_MACRO* defines,
+                                 const char* entryPoint,
+                                 const char* target,
+                                 uint32_t flags,
+                                 uint32_t compilerVersion) {
+        ShaderHash key;
+        key.add(&ShaderCacheVersion, sizeof(ShaderCacheVersion));
+        key.add(&compilerVersion, sizeof(compilerVersion));
+        key.add(&flags, sizeof(flags));
+        key.add(data, size);
+        for (const D3D_SHADER_MACRO* define = defines; define && define->Name; define++) {
+            key.add(define->Name);
+            key.add(define->Definition ? define->Definition : "");
+        }
+        key.add(entryPoint);
+        key.add(target);
+        return key.get();
+    }
+
+    std::optional<std::vector<uint8_t>> ShaderCache::load(uint64_t key,
+                                                          const DependencyResolver& resolveDependency) const {
+        const auto path = getEntryPath(key);
+        std::error_code ec;
+        const uint64_t fileSize = std::filesystem::file_size(path, ec);
+        std::ifstream file(path, std::ios_base::binary);
+        if (ec || !file.is_open()) {
+            return {};
+        }
+
+        char magic[sizeof(ShaderCacheMagic)];
+        uint32_t version;
+        uint64_t entryKey;
+        uint32_t numDependencies;
+        if (!file.read(magic, sizeof(magic)) || memcmp(magic, ShaderCacheMagic, sizeof(magic)) ||
+            !ReadValue(file, version) || version != ShaderCacheVersion || !ReadValue(file, entryKey) ||
+            entryKey != key || !ReadValue(file, numDependencies)) {
+            return {};
+        }
+
+        for (uint32_t i = 0; i < numDependencies; i++) {
+            uint32_t length;
+            if (!ReadValue(file, length) || length > MAX_PATH) {
+                return {};
+            }
+            std::string name(length, '\0');
+            uint64_t hash;
+            if (!file.read(name.data(), length) || !ReadValue(file, hash)) {
+                return {};
+            }
+
+            const auto currentHash = resolveDependency(name);
+            if (!currentHash || *currentHash != hash) {
+                DebugLog("Shader cache entry %016llx is outdated (%s)\n", key, name.c_str());
+                return {};
+            }
+        }
+
+        uint64_t size;
+        if (!ReadValue(file, size) || size > fileSize) {
+            return {};
+        }
+        std::vector<uint8_t> blob(size);
+        uint64_t hash;
+        if (!file.read(reinterpret_cast<char*>(blob.data()), size) || !ReadValue(file, hash) ||
+            hash != ShaderHash().add(blob.data(), blob.size()).get()) {
+            return {};
+        }
+
+        return blob;
+    }
+
+    void ShaderCache::store(uint64_t key,
+                            const std::vector<Dependency>& dependencies,
+                            const void* data,
+                            size_t size) const {
+        const auto path = getEntryPath(key);
+        auto temporaryPath = path;
+        temporaryPath += fmt::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        std::error_code ec;
+        std::filesystem::create_directories(m_directory, ec);
+        {
+            std::ofstream file(temporaryPath, std::ios_base::binary | std::ios_base::trunc);
+            if (!file.is_open()) {
+                Log("Failed to create shader cache entry %s\n", temporaryPath.string().c_str());
+                return;
+            }
+
+            file.write(ShaderCacheMagic, sizeof(ShaderCacheMagic));
+            WriteValue(file, ShaderCacheVersion);
+            WriteValue(file, key);
+            WriteValue(file, static_cast<uint32_t>(dependencies.size()));
+            for (const auto& dependency : dependencies) {
+                WriteValue(file, static_cast<uint32_t>(dependency.name.size()));
+                file.write(dependency.name.data(), dependency.name.size());
+                WriteValue(file, dependency.hash);
+            }
+            WriteValue(file, static_cast<uint64_t>(size));
+            file.write(static_cast<const char*>(data), size);
+            WriteValue(file, ShaderHash().add(data, size).get());
+
+            if (!file.flush()) {
+                file.close();
+                std::filesystem::remove(temporaryPath, ec);
+                Log("Failed to write shader cache entry %s\n", temporaryPath.string().c_str());
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporaryPath, path, ec);
+        if (ec) {
+            // Another process or thread might have won the race with the same entry.
+            std::filesystem::remove(temporaryPath, ec);
+        }
+    }
+
+} // namespace toolkit::utilities::shader
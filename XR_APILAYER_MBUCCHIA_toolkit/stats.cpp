@@ -0,0 +1,366 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+#include "log.h"
+
+namespace {
+
+    using namespace toolkit;
+    using namespace toolkit::log;
+    using namespace toolkit::utilities;
+
+    static_assert(sizeof(FrameStatistics) % sizeof(uint64_t) == 0, "FrameStatistics must not need padding");
+
+    // A single-producer/multi-reader ring buffer of frame statistics.
+    // Each slot is protected by a sequence number (seqlock): the producer marks the slot as being written (odd value),
+    // copies the record, then publishes the slot (even value). Readers retry or bail out if the sequence number changed
+    // while they were copying, so the producer never waits.
+    class FrameStatisticsHistory : public IFrameStatisticsHistory {
+      public:
+        FrameStatisticsHistory(size_t capacity) : m_capacity(capacity), m_slots(capacity) {
+        }
+
+        size_t getCapacity() const override {
+            return m_capacity;
+        }
+
+        void push(const FrameStatistics& stats) override {
+            const uint64_t index = m_head.load(std::memory_order_relaxed);
+            Slot& slot = m_slots[index % m_capacity];
+
+            slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot.stats = stats;
+            slot.sequence.store(2 * index + 2, std::memory_order_release);
+
+            m_head.store(index + 1, std::memory_order_release);
+        }
+
+        uint64_t getHead() const override {
+            return m_head.load(std::memory_order_acquire);
+        }
+
+        bool read(uint64_t index, FrameStatistics& stats) const override {
+            const Slot& slot = m_slots[index % m_capacity];
+            const uint64_t expected = 2 * index + 2;
+
+            for (int attempt = 0; attempt < 2; attempt++) {
+                const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+                if (before != expected) {
+                    // The slot was never written for this index, or was since reused for a more recent frame.
+                    return false;
+                }
+
+                stats = slot.stats;
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+      private:
+        struct Slot {
+            std::atomic<uint64_t> sequence{0};
+            FrameStatistics stats{};
+        };
+
+        const size_t m_capacity;
+        std::vector<Slot> m_slots;
+        std::atomic<uint64_t> m_head{0};
+    };
+
+    // Writes the frame statistics to a binary file from a background thread.
+    // The frame thread only publishes into the history, and this thread drains the history periodically. The records are
+    // batched into a buffer that is written to the file in large chunks, away from the frame thread.
+    class FrameStatisticsRecorder : public IFrameStatisticsRecorder {
+      public:
+        FrameStatisticsRecorder(std::shared_ptr<IFrameStatisticsHistory> history, const std::filesystem::path& path)
+            : m_history(history), m_path(path) {
+            m_file.open(m_path, std::ios_base::binary | std::ios_base::trunc);
+            if (!m_file.is_open()) {
+                throw std::runtime_error("Failed to open statistics file");
+            }
+
+            FrameStatisticsFileHeader header{};
+            std::copy(std::begin(FrameStatisticsFileHeader::Magic),
+                      std::end(FrameStatisticsFileHeader::Magic),
+                      std::begin(header.magic));
+            header.version = FrameStatisticsFileHeader::CurrentVersion;
+            header.recordSize = sizeof(FrameStatistics);
+            header.startTime = std::time(nullptr);
+            m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+            // Only record the frames from now on.
+            m_nextIndex = m_history->getHead();
+            m_buffer.reserve(BufferSize);
+
+            m_thread = std::thread([&] { recorderThread(); });
+        }
+
+        ~FrameStatisticsRecorder() override {
+            {
+                std::unique_lock lock(m_lock);
+                m_stop = true;
+            }
+            m_wakeUp.notify_all();
+            m_thread.join();
+
+            Log("Recorded %llu frames to %s (%llu dropped)\n",
+                m_numRecordsWritten.load(),
+                m_path.string().c_str(),
+                m_numRecordsDropped.load());
+        }
+
+        const std::filesystem::path& getPath() const override {
+            return m_path;
+        }
+
+        uint64_t getNumRecordsWritten() const override {
+            return m_numRecordsWritten;
+        }
+
+        uint64_t getNumRecordsDropped() const override {
+            return m_numRecordsDropped;
+        }
+
+      private:
+        void recorderThread() {
+            std::unique_lock lock(m_lock);
+            while (true) {
+                const bool stop = m_wakeUp.wait_for(lock, PollPeriod, [&] { return m_stop; });
+
+                drain();
+
+                // Only write to the file once enough data is accumulated, or when exiting.
+                if (stop || m_buffer.size() >= BufferSize / 2) {
+                    flush();
+                }
+                if (stop) {
+                    break;
+                }
+            }
+            m_file.close();
+        }
+
+        void drain() {
+            const uint64_t head = m_history->getHead();
+
+            // Skip what we cannot catch up with.
+            const uint64_t oldest = head - std::min<uint64_t>(head, m_history->getCapacity());
+            if (m_nextIndex < oldest) {
+                m_numRecordsDropped += oldest - m_nextIndex;
+                m_nextIndex = oldest;
+            }
+
+            while (m_nextIndex < head) {
+                FrameStatistics stats;
+                if (m_history->read(m_nextIndex, stats)) {
+                    m_buffer.push_back(stats);
+                } else {
+                    m_numRecordsDropped++;
+                }
+                m_nextIndex++;
+            }
+        }
+
+        void flush() {
+            if (m_buffer.empty()) {
+                return;
+            }
+
+            TraceLoggingWrite(g_traceProvider, "FrameStatisticsRecorder_Flush", TLArg(m_buffer.size(), "Records"));
+
+            m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size() * sizeof(FrameStatistics));
+            m_file.flush();
+            m_numRecordsWritten += m_buffer.size();
+            m_buffer.clear();
+        }
+
+        // Must be short enough that the history never wraps between two polls.
+        static constexpr auto PollPeriod = 100ms;
+        static constexpr size_t BufferSize = 1024;
+
+        const std::shared_ptr<IFrameStatisticsHistory> m_history;
+        const std::filesystem::path m_path;
+        std::ofstream m_file;
+
+        std::thread m_thread;
+        std::mutex m_lock;
+        std::condition_variable m_wakeUp;
+        bool m_stop{false};
+
+        uint64_t m_nextIndex{0};
+        std::vector<FrameStatistics> m_buffer;
+        std::atomic<uint64_t> m_numRecordsWritten{0};
+        std::atomic<uint64_t> m_numRecordsDropped{0};
+    };
+
+    // The P-square algorithm for dynamic calculation of quantiles without storing observations.
+    // https://www.cse.wustl.edu/~jain/papers/ftp/psqr.pdf
+    class QuantileEstimator : public IQuantileEstimator {
+      public:
+        QuantileEstimator(double quantile) : m_quantile(quantile) {
+            reset();
+        }
+
+        void addSample(double value) override {
+            // Bootstrap with the first 5 observations.
+            if (m_count < 5) {
+                m_heights[m_count++] = value;
+                if (m_count == 5) {
+                    std::sort(std::begin(m_heights), std::end(m_heights));
+                }
+                return;
+            }
+
+            // Find the cell that contains the new observation, and adjust the extreme markers if needed.
+            int cell;
+            if (value < m_heights[0]) {
+                m_heights[0] = value;
+                cell = 0;
+            } else if (value >= m_heights[4]) {
+                m_heights[4] = value;
+                cell = 3;
+            } else {
+                cell = 0;
+                while (cell < 3 && value >= m_heights[cell + 1]) {
+                    cell++;
+                }
+            }
+
+            for (int i = cell + 1; i < 5; i++) {
+                m_positions[i]++;
+            }
+            for (int i = 0; i < 5; i++) {
+                m_desiredPositions[i] += m_increments[i];
+            }
+
+            // Adjust the heights of the middle markers if they are off their desired positions.
+            for (int i = 1; i < 4; i++) {
+                const double delta = m_desiredPositions[i] - m_positions[i];
+                if ((delta >= 1 && m_positions[i + 1] - m_positions[i] > 1) ||
+                    (delta <= -1 && m_positions[i - 1] - m_positions[i] < -1)) {
+                    const int direction = delta >= 0 ? 1 : -1;
+
+                    const double candidate = parabolic(i, direction);
+                    if (m_heights[i - 1] < candidate && candidate < m_heights[i + 1]) {
+                        m_heights[i] = candidate;
+                    } else {
+                        m_heights[i] = linear(i, direction);
+                    }
+                    m_positions[i] += direction;
+                }
+            }
+
+            m_count++;
+        }
+
+        double query() const override {
+            if (m_count == 0) {
+                return 0.0;
+            }
+
+            if (m_count <= 5) {
+                // Not enough observations yet, use the exact quantile.
+                double sorted[5];
+                std::copy_n(m_heights, m_count, sorted);
+                std::sort(sorted, sorted + m_count);
+                return sorted[static_cast<size_t>(std::round((m_count - 1) * m_quantile))];
+            }
+
+            return m_heights[2];
+        }
+
+        uint64_t getSampleCount() const override {
+            return m_count;
+        }
+
+        void reset() override {
+            m_count = 0;
+            for (int i = 0; i < 5; i++) {
+                m_heights[i] = 0.0;
+                m_positions[i] = i;
+            }
+
+            m_desiredPositions[0] = 0.0;
+            m_desiredPositions[1] = 2.0 * m_quantile;
+            m_desiredPositions[2] = 4.0 * m_quantile;
+            m_desiredPositions[3] = 2.0 + 2.0 * m_quantile;
+            m_desiredPositions[4] = 4.0;
+
+            m_increments[0] = 0.0;
+            m_increments[1] = m_quantile / 2.0;
+            m_increments[2] = m_quantile;
+            m_increments[3] = (1.0 + m_quantile) / 2.0;
+            m_increments[4] = 1.0;
+        }
+
+      private:
+        double parabolic(int i, int d) const {
+            const double n_1 = m_positions[i - 1];
+            const double n = m_positions[i];
+            const double n1 = m_positions[i + 1];
+            return m_heights[i] + d / (n1 - n_1) *
+                                      ((n - n_1 + d) * (m_heights[i + 1] - m_heights[i]) / (n1 - n) +
+                                       (n1 - n - d) * (m_heights[i] - m_heights[i - 1]) / (n - n_1));
+        }
+
+        double linear(int i, int d) const {
+            return m_heights[i] + d * (m_heights[i + d] - m_heights[i]) / (m_positions[i + d] - m_positions[i]);
+        }
+
+        const double m_quantile;
+
+        uint64_t m_count;
+        double m_heights[5];
+        int64_t m_positions[5];
+        double m_desiredPositions[5];
+        double m_increments[5];
+    };
+
+} // namespace
+
+namespace toolkit::utilities {
+
+    std::shared_ptr<IFrameStatisticsHistory> CreateFrameStatisticsHistory(size_t capacity) {
+        return std::make_shared<FrameStatisticsHistory>(capacity);
+    }
+
+    std::shared_ptr<IQuantileEstimator> CreateQuantileEstimator(double quantile) {
+        return std::make_shared<QuantileEstimator>(quantile);
+    }
+
+    std::shared_ptr<IFrameStatisticsRecorder>
+    CreateFrameStatisticsRecorder(std::shared_ptr<IFrameStatisticsHistory> history,
+                                  const std::filesystem::path& path) {
+        return std::make_shared<FrameStatisticsRecorder>(history, path);
+    }
+
+} // namespace toolkit::utilities
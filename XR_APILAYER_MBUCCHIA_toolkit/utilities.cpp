@@ -25,6 +25,7 @@
 
 #include "factories.h"
 #include "interfaces.h"
+#include "layer.h"
 #include "shader_utilities.h"
 #include "log.h"
 
@@ -101,6 +102,7 @@ namespace toolkit::config {
     DECLARE_ENUM_TO_STRING_VIEW(FovModeType, {"Simple", "Advanced"})
     DECLARE_ENUM_TO_STRING_VIEW(ScreenshotFileFormat, {"DDS", "PNG", "JPG", "BMP"})
     DECLARE_ENUM_TO_STRING_VIEW(BlindEye, {"None", "Left", "Right"})
+    DECLARE_ENUM_TO_STRING_VIEW(RecordStatsType, {"Off", "Summary", "Per-frame"})
 
 #undef DECLARE_ENUM_TO_STRING_VIEW
 
@@ -372,33 +374,108 @@ namespace toolkit::utilities {
 
 namespace toolkit::utilities::shader {
 
-    void CompileShader(const std::filesystem::path& shaderFile,
-                       const char* entryPoint,
-                       ID3DBlob** blob,
-                       const D3D_SHADER_MACRO* defines /*= nullptr*/,
-                       ID3DInclude* includes /* = nullptr*/,
-                       const char* target /* = "cs_5_0"*/) {
-        DWORD flags =
-            D3DCOMPILE_PACK_MATRIX_COLUMN_MAJOR | D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_WARNINGS_ARE_ERRORS;
+    namespace {
+
+        // Wraps an include handler to record the includes resolved during compilation.
+        struct RecordingInclude : ID3DInclude {
+            RecordingInclude(ID3DInclude* includes) : m_includes(includes) {
+            }
+
+            HRESULT
+            Open(D3D_INCLUDE_TYPE includeType, LPCSTR pFileName, LPCVOID pParentData, LPCVOID* ppData, UINT* pBytes) {
+                const HRESULT hr = m_includes->Open(includeType, pFileName, pParentData, ppData, pBytes);
+                if (SUCCEEDED(hr)) {
+                    m_dependencies.push_back({pFileName, ShaderHash().add(*ppData, *pBytes).get()});
+                }
+                return hr;
+            }
+
+            HRESULT Close(LPCVOID pData) {
+                return m_includes->Close(pData);
+            }
+
+            ID3DInclude* const m_includes;
+            std::vector<ShaderCache::Dependency> m_dependencies;
+        };
+
+        std::optional<uint64_t> HashInclude(ID3DInclude* includes, const std::string& name) {
+            LPCVOID data = nullptr;
+            UINT bytes = 0;
+            if (FAILED(includes->Open(D3D_INCLUDE_LOCAL, name.c_str(), nullptr, &data, &bytes))) {
+                return {};
+            }
+            const uint64_t hash = ShaderHash().add(data, bytes).get();
+            includes->Close(data);
+            return hash;
+        }
+
+        void CompileShaderCached(const void* data,
+                                 size_t size,
+                                 const char* sourceName,
+                                 const char* entryPoint,
+                                 ID3DBlob** blob,
+                                 const D3D_SHADER_MACRO* defines,
+                                 ID3DInclude* includes,
+                                 const char* target) {
+            DWORD flags =
+                D3DCOMPILE_PACK_MATRIX_COLUMN_MAJOR | D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_WARNINGS_ARE_ERRORS;
 #ifdef _DEBUG
-        flags |= D3DCOMPILE_SKIP_OPTIMIZATION | D3DCOMPILE_DEBUG;
+            flags |= D3DCOMPILE_SKIP_OPTIMIZATION | D3DCOMPILE_DEBUG;
 #else
-        flags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
+            flags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
 #endif
-        if (!includes) {
-            includes = D3D_COMPILE_STANDARD_FILE_INCLUDE;
-        }
 
-        ComPtr<ID3DBlob> cdErrorBlob;
-        const HRESULT hr =
-            D3DCompileFromFile(shaderFile.c_str(), defines, includes, entryPoint, target, flags, 0, blob, &cdErrorBlob);
+            const uint64_t key =
+                ShaderCache::getKey(data, size, defines, entryPoint, target, flags, D3D_COMPILER_VERSION);
 
-        if (FAILED(hr)) {
-            if (cdErrorBlob) {
-                Log("%s", (char*)cdErrorBlob->GetBufferPointer());
+            const ShaderCache cache(localAppData / "shaders");
+            const auto cached =
+                cache.load(key, [&](const std::string& name) { return HashInclude(includes, name); });
+            if (cached) {
+                CHECK_HRCMD(D3DCreateBlob(cached->size(), blob));
+                memcpy((*blob)->GetBufferPointer(), cached->data(), cached->size());
+                return;
             }
-            CHECK_HRESULT(hr, "Failed to compile shader file");
+
+            RecordingInclude recordingIncludes(includes);
+            ComPtr<ID3DBlob> cdErrorBlob;
+            const HRESULT hr = D3DCompile(
+                data, size, sourceName, defines, &recordingIncludes, entryPoint, target, flags, 0, blob, &cdErrorBlob);
+
+            if (FAILED(hr)) {
+                if (cdErrorBlob) {
+                    Log("%s", (char*)cdErrorBlob->GetBufferPointer());
+                }
+                CHECK_HRESULT(hr, "Failed to compile shader");
+            }
+
+            cache.store(key, recordingIncludes.m_dependencies, (*blob)->GetBufferPointer(), (*blob)->GetBufferSize());
+        }
+
+    } // namespace
+
+    void CompileShader(const std::filesystem::path& shaderFile,
+                       const char* entryPoint,
+                       ID3DBlob** blob,
+                       const D3D_SHADER_MACRO* defines /*= nullptr*/,
+                       ID3DInclude* includes /* = nullptr*/,
+                       const char* target /* = "cs_5_0"*/) {
+        std::ifstream file(shaderFile, std::ios_base::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error(fmt::format("Failed to open shader file: {}", shaderFile.string()));
         }
+        const std::vector<char> source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        // Like D3D_COMPILE_STANDARD_FILE_INCLUDE, resolve the includes relative to the shader file.
+        IncludeHeader defaultIncludes({shaderFile.parent_path()});
+        CompileShaderCached(source.data(),
+                            source.size(),
+                            shaderFile.string().c_str(),
+                            entryPoint,
+                            blob,
+                            defines,
+                            includes ? includes : &defaultIncludes,
+                            target);
     }
 
     void CompileShader(const void* data,
@@ -408,28 +485,11 @@ namespace toolkit::utilities::shader {
                        const D3D_SHADER_MACRO* defines /*= nullptr*/,
                        ID3DInclude* includes /* = nullptr*/,
                        const char* target /* = "cs_5_0"*/) {
-        DWORD flags =
-            D3DCOMPILE_PACK_MATRIX_COLUMN_MAJOR | D3DCOMPILE_ENABLE_STRICTNESS | D3DCOMPILE_WARNINGS_ARE_ERRORS;
-#ifdef _DEBUG
-        flags |= D3DCOMPILE_SKIP_OPTIMIZATION | D3DCOMPILE_DEBUG;
-#else
-        flags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
-#endif
-        if (!includes) {
-            // TODO: pSourceName must be a file name to derive relative paths from.
-            includes = D3D_COMPILE_STANDARD_FILE_INCLUDE;
-        }
-
-        ComPtr<ID3DBlob> cdErrorBlob;
-        const HRESULT hr =
-            D3DCompile(data, size, nullptr, defines, includes, entryPoint, target, flags, 0, blob, &cdErrorBlob);
-
-        if (FAILED(hr)) {
-            if (cdErrorBlob) {
-                Log("%s", (char*)cdErrorBlob->GetBufferPointer());
-            }
-            CHECK_HRESULT(hr, "Failed to compile shader");
-        }
+        // Like D3D_COMPILE_STANDARD_FILE_INCLUDE without a source name, resolve the includes relative to the current
+        // directory.
+        IncludeHeader defaultIncludes({std::filesystem::current_path()});
+        CompileShaderCached(
+            data, size, nullptr, entryPoint, blob, defines, includes ? includes : &defaultIncludes, target);
     }
 
     HRESULT IncludeHeader::Open(
@@ -449,7 +509,7 @@ namespace toolkit::utilities::shader {
                 return S_OK;
             }
         }
-        throw std::runtime_error("Error opening shader file include header");
+        return E_FAIL;
     }
 
     HRESULT IncludeHeader::Close(LPCVOID pData) {
@@ -61,9 +61,23 @@ namespace {
 
     using namespace xr::math;
 
-    // The number of frames before freeing an unused set of VRS mask textures.
+    // The number of rings drawn into the masks.
+    constexpr uint32_t NumRings = 3;
+
+    // The number of frames before we stop preparing masks for a render target size that is no longer used.
     constexpr uint16_t MaxAge = 100;
 
+    // The number of masks (for all render target sizes and gaze positions) kept in the cache.
+    constexpr size_t MaxCachedMasks = 16;
+
+    // The granularity of the gaze position (in NDC) when using eye tracking. Masks are reused for as long as the gaze
+    // stays within the same cell.
+    constexpr float GazeQuantum = 1.f / 64;
+
+    // The xrWaitFrame() loop might cause to have 2 frames in-flight, so an evicted mask is only released after those 2
+    // frames.
+    constexpr uint64_t MaskReleaseLatency = 2;
+
     template <typename T>
     constexpr T integer_log2(T n) noexcept {
         // _HAS_CXX20: std::bit_width(m_tileSize) - 1;
@@ -87,28 +101,44 @@ namespace {
         SHADING_RATE_COUNT
     };
 
-    // Constant buffer
-    struct alignas(16) ShadingConstants {
-        XrVector2f GazeXY;   // ndc
-        XrVector2f InvDim;   // 1/w, 1/h
-        XrVector2f Rings[4]; // 1/(a1^2), 1/(b1^2)
-        uint32_t Rates[4];   // r1, r2, r3, r4
+    struct ShadingRateMaskKey {
+        uint32_t widthInTiles;
+        uint32_t heightInTiles;
+
+        // The quantized gaze location for each view. Always 0 when not using eye tracking.
+        int16_t gaze[ViewCount][2];
+
+        bool operator==(const ShadingRateMaskKey& other) const {
+            return widthInTiles == other.widthInTiles && heightInTiles == other.heightInTiles &&
+                   !memcmp(gaze, other.gaze, sizeof(gaze));
+        }
+    };
+
+    struct ShadingRateMaskKeyHash {
+        size_t operator()(const ShadingRateMaskKey& key) const {
+            static_assert(sizeof(key.gaze) == sizeof(uint64_t));
+            uint64_t gaze;
+            memcpy(&gaze, key.gaze, sizeof(gaze));
+
+            const size_t hash = std::hash<uint64_t>{}((uint64_t)key.widthInTiles << 32 | key.heightInTiles);
+            return hash ^ (std::hash<uint64_t>{}(gaze) + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+        }
     };
 
     struct ShadingRateMask {
-        uint32_t widthInTiles;
-        uint32_t heightInTiles;
+        ShadingRateMaskKey key;
 
         // The generation of this mask. If the generation is too old, the mask must be updated.
         uint64_t gen;
 
-        // The number of frames since the mask was last used during a rendering pass.
-        uint16_t age;
-
-        std::shared_ptr<IShaderBuffer> cbShading[ViewCount * 2 + 2];
         std::shared_ptr<ITexture> mask[ViewCount + 1];
         std::shared_ptr<ITexture> maskDoubleWide;
         std::shared_ptr<ITexture> maskTextureArray;
+
+        // D3D11 only.
+        ComPtr<ID3D11NvShadingRateResourceView> nvViews[ViewCount + 1];
+        ComPtr<ID3D11NvShadingRateResourceView> nvViewDoubleWide;
+        ComPtr<ID3D11NvShadingRateResourceView> nvViewTextureArray;
     };
 
     inline XrVector2f MakeRingParam(XrVector2f size) {
@@ -150,21 +180,24 @@ namespace {
             disable();
 
             // TODO: Leak NVAPI resources for now, since there is an occasional crash.
-            for (size_t i = 0; i < m_NvShadingRateResources.views.size(); i++) {
-                LeakNVAPIResource(i);
+            for (auto& mask : m_shadingRateMasks) {
+                LeakNVAPIResource(*mask);
+            }
+            for (auto& retired : m_retiredMasks) {
+                LeakNVAPIResource(*retired.second);
             }
         }
 
-        void LeakNVAPIResource(size_t index) {
-            for (auto& view : m_NvShadingRateResources.views[index]) {
+        void LeakNVAPIResource(ShadingRateMask& mask) {
+            for (auto& view : mask.nvViews) {
                 view.Detach();
             }
-            m_NvShadingRateResources.viewsDoubleWide[index].Detach();
-            m_NvShadingRateResources.viewsTextureArray[index].Detach();
+            mask.nvViewDoubleWide.Detach();
+            mask.nvViewTextureArray.Detach();
         }
 
         void beginSession(XrSession session) override {
-            // Create HAM buffers.
+            // Retrieve the HAM. It is rasterized on the CPU into a coverage map for each mask size.
             if (m_hasVisibilityMask) {
                 for (uint32_t i = 0; i < ViewCount; i++) {
                     XrVisibilityMaskKHR mask{XR_TYPE_VISIBILITY_MASK_KHR};
@@ -180,33 +213,18 @@ namespace {
                         break;
                     }
 
-                    std::vector<XrVector2f> rawVertices(mask.vertexCountOutput);
-                    std::vector<uint32_t> rawIndices(mask.indexCountOutput);
+                    m_hamVertices[i].resize(mask.vertexCountOutput);
+                    m_hamIndices[i].resize(mask.indexCountOutput);
 
-                    mask.indexCapacityInput = (uint32_t)rawIndices.size();
-                    mask.indices = rawIndices.data();
-                    mask.vertexCapacityInput = (uint32_t)rawVertices.size();
-                    mask.vertices = rawVertices.data();
+                    mask.indexCapacityInput = (uint32_t)m_hamIndices[i].size();
+                    mask.indices = m_hamIndices[i].data();
+                    mask.vertexCapacityInput = (uint32_t)m_hamVertices[i].size();
+                    mask.vertices = m_hamVertices[i].data();
                     CHECK_XRCMD(m_openXR.xrGetVisibilityMaskKHR(session,
                                                                 XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO,
                                                                 i,
                                                                 XR_VISIBILITY_MASK_TYPE_HIDDEN_TRIANGLE_MESH_KHR,
                                                                 &mask));
-
-                    std::vector<SimpleMeshVertex> vertices(mask.vertexCountOutput);
-                    for (uint32_t j = 0; j < vertices.size(); j++) {
-                        vertices[j].Position = {rawVertices[j].x, rawVertices[j].y, -1.0f};
-                        vertices[j].Color = {(float)m_shadingRates[SHADING_RATE_CULL],
-                                             (float)m_shadingRates[SHADING_RATE_CULL],
-                                             (float)m_shadingRates[SHADING_RATE_CULL]};
-                    }
-
-                    std::vector<uint16_t> indices(mask.indexCountOutput);
-                    for (uint32_t j = 0; j < indices.size(); j++) {
-                        indices[j] = rawIndices[j];
-                    }
-
-                    m_HAM[i] = m_device->createSimpleMesh(vertices, indices, "VRS HAM");
                 }
             }
 
@@ -215,15 +233,21 @@ namespace {
 
         void endSession() override {
             for (uint32_t i = 0; i < ViewCount; i++) {
-                m_HAM[i].reset();
+                m_hamVertices[i].clear();
+                m_hamIndices[i].clear();
+            }
+
+            {
+                std::unique_lock lock(m_shadingRateMaskLock);
+                m_hamCoverage.clear();
             }
 
             m_isHAMReady = false;
         }
 
         void beginFrame(XrTime frameTime) override {
-            if (m_HAM[0] && m_HAM[1] && !m_isHAMReady) {
-                // Create projection for stamping HAM.
+            if (!m_hamIndices[0].empty() && !m_hamIndices[1].empty() && !m_isHAMReady) {
+                // Retrieve the FOV to project the HAM.
                 XrViewLocateInfo info{XR_TYPE_VIEW_LOCATE_INFO};
                 info.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
                 info.displayTime = frameTime;
@@ -238,9 +262,7 @@ namespace {
                 uint32_t viewCountOutput;
                 CHECK_XRCMD(m_openXR.xrLocateViews(m_session, &info, &state, 2, &viewCountOutput, eyeInViewSpace));
                 for (uint32_t i = 0; i < ViewCount; i++) {
-                    m_viewProjection[i].Pose = Pose::Identity();
-                    m_viewProjection[i].Fov = eyeInViewSpace[i].fov;
-                    m_viewProjection[i].NearFar = {0.001f, 100.f};
+                    m_hamFov[i] = eyeInViewSpace[i].fov;
                 }
 
                 CHECK_XRCMD(m_openXR.xrDestroySpace(info.space));
@@ -250,64 +272,72 @@ namespace {
                 m_currentGen++;
             }
 
-            // When using eye tracking we must render the views every frame.
+            // When using eye tracking, the gaze is part of the mask key: we only need to render the masks when the
+            // gaze moves to a location that is not in the cache.
             if (m_usingEyeTracking) {
                 // TODO: What do we do upon (permanent) loss of tracking?
                 updateGaze();
-
-                m_currentGen++;
             }
 
+            // The masks are generated on the CPU: we only upload and copy resources, which does not alter the
+            // pipeline state of the application.
             m_device->blockCallbacks();
-            m_device->saveContext();
 
             {
                 std::unique_lock lock(m_shadingRateMaskLock);
 
-                // Update all masks.
-                size_t index = 0;
-                for (auto it = m_shadingRateMask.begin(); it != m_shadingRateMask.end();) {
-                    // Age all masks.
-                    if (++it->age > MaxAge) {
-                        // Evict old entries. If a mask is used in a frame, its age is to 0.
-                        TraceLocalActivity(local);
-                        TraceLoggingWriteStart(local,
-                                               "VariableRateShading_DestroyMask",
-                                               TLArg(it->widthInTiles, "WidthInTiles"),
-                                               TLArg(it->heightInTiles, "HeightInTiles"),
-                                               TLArg("DiedOfAge", "State"));
-
-                        it = m_shadingRateMask.erase(it);
-
-                        if (m_NvShadingRateResources.views.size()) {
-                            // TODO: Leak NVAPI resources for now, since there is an occasional crash.
-                            LeakNVAPIResource(index);
-                            m_NvShadingRateResources.views.erase(m_NvShadingRateResources.views.begin() + index);
-                            m_NvShadingRateResources.viewsDoubleWide.erase(
-                                m_NvShadingRateResources.viewsDoubleWide.begin() + index);
-                            m_NvShadingRateResources.viewsTextureArray.erase(
-                                m_NvShadingRateResources.viewsTextureArray.begin() + index);
-                        }
-
-                        TraceLoggingWriteStop(local, "VariableRateShading_DestroyMask");
-                    } else {
-                        // If this mask is still valid...
+                // Release the evicted masks that the application can no longer be using.
+                m_frameIndex++;
+                while (!m_retiredMasks.empty() && m_retiredMasks.front().first + MaskReleaseLatency < m_frameIndex) {
+                    TraceLoggingWrite(g_traceProvider,
+                                      "VariableRateShading_DestroyMask",
+                                      TLArg(m_retiredMasks.front().second->key.widthInTiles, "WidthInTiles"),
+                                      TLArg(m_retiredMasks.front().second->key.heightInTiles, "HeightInTiles"),
+                                      TLArg("Released", "State"));
+                    m_retiredMasks.pop_front();
+                }
 
-                        // ...and is pending creation, create it.
-                        if (!it->mask[0]) {
-                            createMaskResources(*it);
-                        }
+                // While the eyes fixate, only follow the gaze once it has moved by more than a tile, so that the small
+                // eye movements (and the residual noise) do not cause the masks to be regenerated.
+                const bool isFixating = m_usingEyeTracking && m_eyeTracker &&
+                                        m_eyeTracker->getGazeMovement() == input::GazeMovement::Fixation;
+                const XrVector2f tileInNdc{2.f * m_tileSize / m_actualRenderWidth,
+                                           2.f * m_tileSize * m_renderRatio / m_actualRenderWidth};
+                for (size_t i = 0; i < ViewCount; i++) {
+                    if (isFixating && std::abs(m_gazeLocation[i].x - m_latchedGazeLocation[i].x) < tileInNdc.x &&
+                        std::abs(m_gazeLocation[i].y - m_latchedGazeLocation[i].y) < tileInNdc.y) {
+                        continue;
+                    }
+                    m_latchedGazeLocation[i] = m_gazeLocation[i];
 
-                        // ...and eventually, update it.
-                        updateViews(*it);
+                    for (size_t j = 0; j < 2; j++) {
+                        const float value = j == 0 ? m_gazeLocation[i].x : m_gazeLocation[i].y;
+                        m_currentGazeKey[i][j] = m_usingEyeTracking ? (int16_t)std::round(value / GazeQuantum) : 0;
+                    }
+                }
 
-                        it++;
-                        index++;
+                // Prepare the masks for the current gaze for all render target sizes in use.
+                for (auto it = m_maskSizes.begin(); it != m_maskSizes.end();) {
+                    const uint32_t widthInTiles = (uint32_t)(it->first >> 32);
+                    const uint32_t heightInTiles = (uint32_t)it->first;
+
+                    // Age all sizes. If a size is used in a frame, its age is reset to 0.
+                    if (++it->second > MaxAge) {
+                        TraceLoggingWrite(g_traceProvider,
+                                          "VariableRateShading_ForgetSize",
+                                          TLArg(widthInTiles, "WidthInTiles"),
+                                          TLArg(heightInTiles, "HeightInTiles"),
+                                          TLArg("DiedOfAge", "State"));
+
+                        it = m_maskSizes.erase(it);
+                        continue;
                     }
+
+                    updateViews(*acquireMask(makeMaskKey(widthInTiles, heightInTiles)));
+                    it++;
                 }
             }
 
-            m_device->restoreContext();
             m_device->flushContext(false, false);
             m_device->unblockCallbacks();
 
@@ -336,6 +366,13 @@ namespace {
         }
 
         void update() override {
+            // Nothing to do unless a setting changed.
+            const auto changeGeneration = m_configManager->getChangeGeneration();
+            if (changeGeneration == m_lastChangeGeneration) {
+                return;
+            }
+            m_lastChangeGeneration = changeGeneration;
+
             const auto mode = m_configManager->getEnumValue<VariableShadingRateType>(config::SettingVRS);
             const auto hasModeChanged = mode != m_mode;
 
@@ -390,19 +427,18 @@ namespace {
             const Eye eye = eyeHint.value_or(Eye::Both);
             TraceLoggingWrite(g_traceProvider, "EnableVariableRateShading", TLArg(isDoubleWide, "IsDoubleWide"));
 
-            size_t maskIndex;
+            // Hold a reference, since the mask may be evicted by beginFrame() while we use it.
+            std::shared_ptr<const ShadingRateMask> mask;
             {
                 std::unique_lock lock(m_shadingRateMaskLock);
 
-                if (!getMaskIndex(isDoubleWide ? info.width / 2 : info.width, info.height, maskIndex)) {
+                mask = getMask(isDoubleWide ? info.width / 2 : info.width, info.height);
+                if (!mask) {
                     // Creation was deferred to the next frame.
                     TraceLoggingWrite(
                         g_traceProvider, "SkipEnableVariableRateShading", TLArg("DeferredCreation", "Reason"));
                     return true;
                 }
-
-                // Reset the age to keep this mask active.
-                m_shadingRateMask[maskIndex].age = 0;
             }
 
             if (auto context11 = context->getAs<D3D11>()) {
@@ -420,11 +456,11 @@ namespace {
                 desc.pViewports = m_nvRates;
                 CHECK_NVCMD(NvAPI_D3D11_RSSetViewportsPixelShadingRates(context11, &desc));
 
-                auto& mask = isDoubleWide          ? m_NvShadingRateResources.viewsDoubleWide[maskIndex]
-                             : info.arraySize == 2 ? m_NvShadingRateResources.viewsTextureArray[maskIndex]
-                                                   : m_NvShadingRateResources.views[maskIndex][(size_t)eye];
+                const auto& view = isDoubleWide          ? mask->nvViewDoubleWide
+                                   : info.arraySize == 2 ? mask->nvViewTextureArray
+                                                         : mask->nvViews[(size_t)eye];
 
-                CHECK_NVCMD(NvAPI_D3D11_RSSetShadingRateResourceView(context11, get(mask)));
+                CHECK_NVCMD(NvAPI_D3D11_RSSetShadingRateResourceView(context11, get(view)));
 
                 doCapture(/* post */);
                 doCapture(renderTarget, eyeHint);
@@ -442,8 +478,7 @@ namespace {
 
                 // TODO: With DX12, the mask cannot be a texture array. For now we just use the generic mask.
 
-                auto mask = isDoubleWide ? m_shadingRateMask[maskIndex].maskDoubleWide
-                                         : m_shadingRateMask[maskIndex].mask[(size_t)eye];
+                const auto& texture = isDoubleWide ? mask->maskDoubleWide : mask->mask[(size_t)eye];
 
                 // RSSetShadingRate() function sets both the combiners and the per-drawcall shading rate.
                 // We set to 1X1 for all sources and all combiners to MAX, so that the coarsest wins (per-drawcall,
@@ -451,7 +486,7 @@ namespace {
                 static const D3D12_SHADING_RATE_COMBINER combiners[D3D12_RS_SET_SHADING_RATE_COMBINER_COUNT] = {
                     D3D12_SHADING_RATE_COMBINER_MAX, D3D12_SHADING_RATE_COMBINER_MAX};
                 vrsCommandList->RSSetShadingRate(D3D12_SHADING_RATE_1X1, combiners);
-                vrsCommandList->RSSetShadingRateImage(mask->getAs<D3D12>());
+                vrsCommandList->RSSetShadingRateImage(texture->getAs<D3D12>());
             } else {
                 throw std::runtime_error("Unsupported graphics runtime");
             }
@@ -545,23 +580,6 @@ namespace {
 
       private:
         void createRenderResources(uint32_t renderWidth, uint32_t renderHeigh) {
-            // Initialize compute shader
-            {
-                const auto shadersDir = dllHome / "shaders";
-                const auto shaderFile = shadersDir / "VRS.hlsl";
-
-                utilities::shader::Defines defines;
-                defines.add("VRS_TILE_X", m_tileSize);
-                defines.add("VRS_TILE_Y", m_tileSize);
-                defines.add("VRS_NUM_RATES", 3);
-
-                // Dispatch 64 threads per group.
-                defines.add("VRS_NUM_THREADS_X", 8);
-                defines.add("VRS_NUM_THREADS_Y", 8);
-
-                m_csShading = m_device->createComputeShader(shaderFile, "mainCS", "VRS CS", {1, 1, 1}, defines.get());
-            }
-
             // Initialize API-specific shading rate resources.
             if (auto device11 = m_device->getAs<D3D11>()) {
                 m_NvShadingRateResources.initialize();
@@ -738,53 +756,105 @@ namespace {
             m_gazeLocation[2].y = m_gazeOffset[2].y;
         }
 
-        bool getMaskIndex(uint32_t width, uint32_t height, size_t& index) {
+        ShadingRateMaskKey makeMaskKey(uint32_t widthInTiles, uint32_t heightInTiles) const {
+            ShadingRateMaskKey key;
+            key.widthInTiles = widthInTiles;
+            key.heightInTiles = heightInTiles;
+            memcpy(key.gaze, m_currentGazeKey, sizeof(key.gaze));
+            return key;
+        }
+
+        std::shared_ptr<const ShadingRateMask> getMask(uint32_t width, uint32_t height) {
             const auto texW = xr::math::DivideRoundingUp(width, m_tileSize);
             const auto texH = xr::math::DivideRoundingUp(height, m_tileSize);
 
-            // Look-up existing resources.
-            for (size_t i = 0; i < m_shadingRateMask.size(); i++) {
-                if (m_shadingRateMask[i].widthInTiles == texW && m_shadingRateMask[i].heightInTiles == texH) {
-                    index = i;
+            // Keep this size active (or request it).
+            const auto size = m_maskSizes.insert_or_assign((uint64_t)texW << 32 | texH, 0);
+            if (size.second) {
+                TraceLoggingWrite(g_traceProvider,
+                                  "VariableRateShading_CreateMask",
+                                  TLArg(width, "Width"),
+                                  TLArg(height, "Height"),
+                                  TLArg(texW, "WidthInTiles"),
+                                  TLArg(texH, "HeightInTiles"),
+                                  TLArg("Deferred", "State"));
+            }
+
+            // Creation of the mask is deferred to the next beginFrame() event.
+            const auto cached = m_shadingRateMaskCache.find(makeMaskKey(texW, texH));
+            return cached != m_shadingRateMaskCache.end() ? *cached->second : nullptr;
+        }
 
-                    // Do not return invalid masks deferred to the next frame.
-                    return !!m_shadingRateMask[i].mask[0];
+        std::shared_ptr<ShadingRateMask> acquireMask(const ShadingRateMaskKey& key) {
+            // Look-up existing resources and mark them as most recently used.
+            const auto cached = m_shadingRateMaskCache.find(key);
+            if (cached != m_shadingRateMaskCache.end()) {
+                m_shadingRateMasks.splice(m_shadingRateMasks.begin(), m_shadingRateMasks, cached->second);
+                return m_shadingRateMasks.front();
+            }
+
+            if (m_shadingRateMasks.size() >= MaxCachedMasks) {
+                // Recycle the textures of the least recently used mask of the same size if possible. This is the
+                // common case, since the masks for the other gaze positions are all the same size.
+                const auto sameSize = std::find_if(
+                    m_shadingRateMasks.rbegin(),
+                    m_shadingRateMasks.rend(),
+                    [&](const std::shared_ptr<ShadingRateMask>& mask) {
+                        return mask->key.widthInTiles == key.widthInTiles &&
+                               mask->key.heightInTiles == key.heightInTiles;
+                    });
+                if (sameSize != m_shadingRateMasks.rend()) {
+                    TraceLoggingWrite(g_traceProvider,
+                                      "VariableRateShading_RecycleMask",
+                                      TLArg(key.widthInTiles, "WidthInTiles"),
+                                      TLArg(key.heightInTiles, "HeightInTiles"));
+
+                    m_shadingRateMaskCache.erase((*sameSize)->key);
+                    (*sameSize)->key = key;
+                    (*sameSize)->gen = 0;
+                    m_shadingRateMasks.splice(
+                        m_shadingRateMasks.begin(), m_shadingRateMasks, std::prev(sameSize.base()));
+                    m_shadingRateMaskCache.insert_or_assign(key, m_shadingRateMasks.begin());
+                    return m_shadingRateMasks.front();
                 }
+
+                // Otherwise evict the least recently used mask. The application might still be using it in the frames
+                // in-flight, so its resources are released later.
+                auto& oldest = m_shadingRateMasks.back();
+                TraceLoggingWrite(g_traceProvider,
+                                  "VariableRateShading_DestroyMask",
+                                  TLArg(oldest->key.widthInTiles, "WidthInTiles"),
+                                  TLArg(oldest->key.heightInTiles, "HeightInTiles"),
+                                  TLArg("Evicted", "State"));
+
+                m_shadingRateMaskCache.erase(oldest->key);
+                m_retiredMasks.emplace_back(m_frameIndex, std::move(oldest));
+                m_shadingRateMasks.pop_back();
             }
 
-            TraceLoggingWrite(g_traceProvider,
-                              "VariableRateShading_CreateMask",
-                              TLArg(width, "Width"),
-                              TLArg(height, "Height"),
-                              TLArg(texW, "WidthInTiles"),
-                              TLArg(texH, "HeightInTiles"),
-                              TLArg("Deferred", "State"));
-
-            ShadingRateMask newMask;
-            newMask.widthInTiles = texW;
-            newMask.heightInTiles = texH;
-            newMask.age = 0;
-            newMask.gen = 0;
-
-            // Defer creation to the next beginFrame() event.
-            m_shadingRateMask.push_back(newMask);
+            auto newMask = std::make_shared<ShadingRateMask>();
+            newMask->key = key;
+            newMask->gen = 0;
+            createMaskResources(*newMask);
+            m_shadingRateMasks.push_front(newMask);
+            m_shadingRateMaskCache.insert_or_assign(key, m_shadingRateMasks.begin());
 
-            return false;
+            return newMask;
         }
 
         void createMaskResources(ShadingRateMask& mask) {
             TraceLocalActivity(local);
-            TraceLoggingWriteStart(local,
+            TraceLoggingLocalStart(local,
                                    "VariableRateShading_CreateMask",
-                                   TLArg(mask.widthInTiles, "WidthInTiles"),
-                                   TLArg(mask.heightInTiles, "HeightInTiles"),
+                                   TLArg(mask.key.widthInTiles, "WidthInTiles"),
+                                   TLArg(mask.key.heightInTiles, "HeightInTiles"),
                                    TLArg("Current", "State"));
 
             // Initialize shading rate resources
             XrSwapchainCreateInfo info;
             ZeroMemory(&info, sizeof(info));
-            info.width = mask.widthInTiles;
-            info.height = mask.heightInTiles;
+            info.width = mask.key.widthInTiles;
+            info.height = mask.key.heightInTiles;
             info.format = DXGI_FORMAT_R8_UINT;
             info.arraySize = 1;
             info.mipCount = 1;
@@ -797,14 +867,10 @@ namespace {
             }
             info.width *= 2;
             mask.maskDoubleWide = m_device->createTexture(info, "VRS DoubleWide TEX2D");
-            info.width = mask.widthInTiles;
+            info.width = mask.key.widthInTiles;
             info.arraySize = 2;
             mask.maskTextureArray = m_device->createTexture(info, "VRS TextureArray TEX2D");
 
-            for (auto& it : mask.cbShading) {
-                it = m_device->createBuffer(sizeof(ShadingConstants), "VRS CB");
-            }
-
             if (auto device11 = m_device->getAs<D3D11>()) {
                 NV_D3D11_SHADING_RATE_RESOURCE_VIEW_DESC desc;
                 ZeroMemory(&desc, sizeof(desc));
@@ -813,35 +879,21 @@ namespace {
                 desc.ViewDimension = NV_SRRV_DIMENSION_TEXTURE2D;
                 desc.Texture2D.MipSlice = 0;
 
-                const auto newIndex = m_NvShadingRateResources.views.size();
-                m_NvShadingRateResources.views.push_back({});
-                m_NvShadingRateResources.viewsDoubleWide.push_back({});
-                m_NvShadingRateResources.viewsTextureArray.push_back({});
-
                 for (size_t i = 0; i < std::size(mask.mask); i++) {
-                    CHECK_NVCMD(
-                        NvAPI_D3D11_CreateShadingRateResourceView(device11,
-                                                                  mask.mask[i]->getAs<D3D11>(),
-                                                                  &desc,
-                                                                  set(m_NvShadingRateResources.views[newIndex][i])));
+                    CHECK_NVCMD(NvAPI_D3D11_CreateShadingRateResourceView(
+                        device11, mask.mask[i]->getAs<D3D11>(), &desc, set(mask.nvViews[i])));
                 }
 
-                CHECK_NVCMD(
-                    NvAPI_D3D11_CreateShadingRateResourceView(device11,
-                                                              mask.maskDoubleWide->getAs<D3D11>(),
-                                                              &desc,
-                                                              set(m_NvShadingRateResources.viewsDoubleWide[newIndex])));
+                CHECK_NVCMD(NvAPI_D3D11_CreateShadingRateResourceView(
+                    device11, mask.maskDoubleWide->getAs<D3D11>(), &desc, set(mask.nvViewDoubleWide)));
 
                 desc.ViewDimension = NV_SRRV_DIMENSION_TEXTURE2DARRAY;
                 desc.Texture2DArray.ArraySize = 2;
                 CHECK_NVCMD(NvAPI_D3D11_CreateShadingRateResourceView(
-                    device11,
-                    mask.maskTextureArray->getAs<D3D11>(),
-                    &desc,
-                    set(m_NvShadingRateResources.viewsTextureArray[newIndex])));
+                    device11, mask.maskTextureArray->getAs<D3D11>(), &desc, set(mask.nvViewTextureArray)));
             }
 
-            TraceLoggingWriteStop(local, "VariableRateShading_CreateMask");
+            TraceLoggingLocalStop(local, "VariableRateShading_CreateMask");
         }
 
         void updateViews(ShadingRateMask& mask) {
@@ -852,64 +904,73 @@ namespace {
             mask.gen = m_currentGen;
 
             TraceLocalActivity(local);
-            TraceLoggingWriteStart(local,
+            TraceLoggingLocalStart(local,
                                    "VariableRateShading_UpdateMask",
-                                   TLArg(mask.widthInTiles, "WidthInTiles"),
-                                   TLArg(mask.heightInTiles, "HeightInTiles"));
+                                   TLArg(mask.key.widthInTiles, "WidthInTiles"),
+                                   TLArg(mask.key.heightInTiles, "HeightInTiles"));
 
-            for (size_t i = 0; i < std::size(mask.mask); i++) {
-                m_device->setRenderTargets(1, &mask.mask[i]);
-                m_device->clearColor(
-                    0.f, 0.f, (float)mask.heightInTiles, (float)mask.widthInTiles, {255.f, 255.f, 255.f, 255.f});
+            const auto widthInTiles = mask.key.widthInTiles;
+            const auto heightInTiles = mask.key.heightInTiles;
 
-                // Initialize mask with HAM culling if needed.
-                if (i < ViewCount && m_isHAMReady && !m_configManager->peekValue(SettingDisableHAM) &&
-                    m_configManager->getValue(SettingVRSCullHAM)) {
-                    m_device->setViewProjection(m_viewProjection[i]);
-                    m_device->draw(m_HAM[i], Pose::Identity(), {1.f, 1.f, 1.f}, true);
+            // With eye tracking, render the pattern for the (quantized) gaze that this mask is for.
+            const auto getGazeLocation = [&](size_t eye) {
+                if (m_usingEyeTracking && eye < ViewCount) {
+                    return XrVector2f{mask.key.gaze[eye][0] * GazeQuantum, mask.key.gaze[eye][1] * GazeQuantum};
                 }
-            }
+                return m_gazeLocation[eye];
+            };
+
+            const bool cullHAM = m_isHAMReady && !m_configManager->peekValue(SettingDisableHAM) &&
+                                 m_configManager->getValue(SettingVRSCullHAM);
 
-            // Draw the rings into the mask.
-            const auto dispatchX = xr::math::DivideRoundingUp(mask.widthInTiles, 8);
-            const auto dispatchY = xr::math::DivideRoundingUp(mask.heightInTiles, 8);
-            for (size_t i = 0; i < std::size(mask.mask) + 1; i++) {
-                size_t target = std::min(i, std::size(mask.mask) - 1);
-                size_t eye = i;
-                ShadingConstants constants;
-                if (m_usingEyeTracking) {
-                    // The combined mask has both eyes.
-                    eye = eye % 2;
+            // Generate the masks on the CPU (see GenerateShadingRateMask()).
+            const uint32_t rowPitch = alignTo(widthInTiles, m_device->getTextureAlignmentConstraint());
+            m_maskScratch.resize((size_t)rowPitch * heightInTiles);
+            for (size_t i = 0; i < std::size(mask.mask); i++) {
+                // Initialize mask with HAM culling if needed.
+                const std::vector<uint8_t>* coverage =
+                    i < ViewCount && cullHAM ? &getHAMCoverage(i, widthInTiles, heightInTiles) : nullptr;
+                for (uint32_t y = 0; y < heightInTiles; y++) {
+                    uint8_t* row = m_maskScratch.data() + (size_t)y * rowPitch;
+                    for (uint32_t x = 0; x < widthInTiles; x++) {
+                        row[x] = coverage && (*coverage)[(size_t)y * widthInTiles + x]
+                                     ? m_shadingRates[SHADING_RATE_CULL]
+                                     : 255;
+                    }
                 }
-                constants = makeShadingConstants(eye, mask.widthInTiles, mask.heightInTiles);
-                mask.cbShading[i]->uploadData(&constants, sizeof(constants));
-
-                m_csShading->updateThreadGroups({dispatchX, dispatchY, 1});
-                m_device->setShader(m_csShading, SamplerType::NearestClamp);
-                m_device->setShaderInput(0, mask.cbShading[i]);
-                mask.mask[target]->setState(D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-                m_device->setShaderOutput(0, mask.mask[target]);
-                m_device->dispatchShader();
-                mask.mask[target]->setState(D3D12_RESOURCE_STATE_COPY_SOURCE);
-            }
-            if (m_usingEyeTracking && m_needMirroredPattern) {
-                for (size_t i = 0; i < 2; i++) {
-                    const auto constants = makeShadingConstants(i, mask.widthInTiles, mask.heightInTiles, true);
-                    mask.cbShading[i]->uploadData(&constants, sizeof(constants));
-
-                    m_csShading->updateThreadGroups({dispatchX, dispatchY, 1});
-                    m_device->setShader(m_csShading, SamplerType::NearestClamp);
-                    m_device->setShaderInput(0, mask.cbShading[i]);
-                    mask.mask[i]->setState(D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
-                    m_device->setShaderOutput(0, mask.mask[i]);
-                    m_device->dispatchShader();
-                    mask.mask[i]->setState(D3D12_RESOURCE_STATE_COPY_SOURCE);
+
+                // Draw the rings into the mask. The combined mask has both eyes when using eye tracking.
+                const auto drawRings = [&](size_t eye, bool upsideDown) {
+                    const auto constants =
+                        makeShadingConstants(eye, getGazeLocation(eye), widthInTiles, heightInTiles, upsideDown);
+                    GenerateShadingRateMask(constants,
+                                            NumRings,
+                                            0,
+                                            widthInTiles,
+                                            heightInTiles,
+                                            m_maskScratch.data(),
+                                            rowPitch);
+                };
+                if (i < ViewCount) {
+                    drawRings(i, false);
+                    if (m_usingEyeTracking && m_needMirroredPattern) {
+                        drawRings(i, true);
+                    }
+                } else if (m_usingEyeTracking) {
+                    for (size_t eye = 0; eye < ViewCount; eye++) {
+                        drawRings(eye, false);
+                    }
+                } else {
+                    drawRings(i, false);
                 }
+
+                mask.mask[i]->uploadData(m_maskScratch.data(), rowPitch);
+                mask.mask[i]->setState(D3D12_RESOURCE_STATE_COPY_SOURCE);
             }
 
             // Copy to the double wide/texture arrays mask.
             mask.mask[0]->copyTo(mask.maskDoubleWide, 0, 0, 0);
-            mask.mask[1]->copyTo(mask.maskDoubleWide, mask.widthInTiles, 0, 0);
+            mask.mask[1]->copyTo(mask.maskDoubleWide, widthInTiles, 0, 0);
             mask.mask[0]->copyTo(mask.maskTextureArray, 0, 0, 0);
             mask.mask[1]->copyTo(mask.maskTextureArray, 0, 0, 1);
 
@@ -917,15 +978,49 @@ namespace {
                 mask.mask[i]->setState(D3D12_RESOURCE_STATE_SHADING_RATE_SOURCE);
             }
 
-            TraceLoggingWriteStop(local, "VariableRateShading_UpdateMask");
+            TraceLoggingLocalStop(local, "VariableRateShading_UpdateMask");
+        }
+
+        const std::vector<uint8_t>& getHAMCoverage(size_t view, uint32_t widthInTiles, uint32_t heightInTiles) {
+            // The HAM only changes with the session, so we rasterize it only once per mask size.
+            auto& coverage = m_hamCoverage[(uint64_t)widthInTiles << 32 | heightInTiles][view];
+            if (coverage.empty()) {
+                TraceLocalActivity(local);
+                TraceLoggingLocalStart(local,
+                                       "VariableRateShading_RasterizeHAM",
+                                       TLArg(view, "View"),
+                                       TLArg(widthInTiles, "WidthInTiles"),
+                                       TLArg(heightInTiles, "HeightInTiles"));
+
+                // Project the HAM (view space at z = -1) to NDC.
+                const XrFovf& fov = m_hamFov[view];
+                const float tanLeft = std::tan(fov.angleLeft);
+                const float tanRight = std::tan(fov.angleRight);
+                const float tanDown = std::tan(fov.angleDown);
+                const float tanUp = std::tan(fov.angleUp);
+
+                std::vector<XrVector2f> vertices(m_hamVertices[view].size());
+                for (size_t i = 0; i < vertices.size(); i++) {
+                    vertices[i].x = (2.f * m_hamVertices[view][i].x - (tanRight + tanLeft)) / (tanRight - tanLeft);
+                    vertices[i].y = (2.f * m_hamVertices[view][i].y - (tanUp + tanDown)) / (tanUp - tanDown);
+                }
+
+                coverage.resize((size_t)widthInTiles * heightInTiles);
+                RasterizeTileCoverage(
+                    vertices, m_hamIndices[view], widthInTiles, heightInTiles, coverage.data(), widthInTiles);
+
+                TraceLoggingLocalStop(local, "VariableRateShading_RasterizeHAM");
+            }
+            return coverage;
         }
 
-        ShadingConstants makeShadingConstants(size_t eye, uint32_t texW, uint32_t texH, bool upsideDown = false) {
-            ShadingConstants constants;
+        ShadingRateMaskConstants
+        makeShadingConstants(size_t eye, XrVector2f gaze, uint32_t texW, uint32_t texH, bool upsideDown = false) {
+            ShadingRateMaskConstants constants;
             if (!upsideDown) {
-                constants.GazeXY = m_gazeLocation[eye];
+                constants.GazeXY = gaze;
             } else {
-                constants.GazeXY = {m_gazeLocation[eye].x, -m_gazeLocation[eye].y};
+                constants.GazeXY = {gaze.x, -gaze.y};
             }
             constants.InvDim = {1.f / texW, 1.f / texH};
             for (size_t i = 0; i < std::size(m_Rings); i++) {
@@ -1103,14 +1198,30 @@ namespace {
         // ShadingRates to Graphics API specific rates LUT.
         uint8_t m_shadingRates[SHADING_RATE_COUNT];
 
-        std::shared_ptr<IComputeShader> m_csShading;
-        std::vector<ShadingRateMask> m_shadingRateMask;
+        // The masks, from most to least recently used. The render threads hold a reference to the mask they use.
+        std::list<std::shared_ptr<ShadingRateMask>> m_shadingRateMasks;
+        std::unordered_map<ShadingRateMaskKey,
+                           std::list<std::shared_ptr<ShadingRateMask>>::iterator,
+                           ShadingRateMaskKeyHash>
+            m_shadingRateMaskCache;
+        // The evicted masks, and the frame when they were evicted. The GPU might still be using their resources.
+        std::deque<std::pair<uint64_t, std::shared_ptr<ShadingRateMask>>> m_retiredMasks;
+        uint64_t m_frameIndex{0};
+        // The render target sizes (in tiles) in use, and the number of frames since they were last used.
+        std::unordered_map<uint64_t, uint16_t> m_maskSizes;
+        int16_t m_currentGazeKey[ViewCount][2]{};
+        uint64_t m_lastChangeGeneration{UINT64_MAX};
+        XrVector2f m_latchedGazeLocation[ViewCount]{};
         std::mutex m_shadingRateMaskLock;
 
         bool m_isHAMEnabled{false};
         bool m_isHAMReady{false};
-        ViewProjection m_viewProjection[ViewCount];
-        std::shared_ptr<ISimpleMesh> m_HAM[ViewCount];
+        XrFovf m_hamFov[ViewCount];
+        std::vector<XrVector2f> m_hamVertices[ViewCount];
+        std::vector<uint32_t> m_hamIndices[ViewCount];
+        // The tiles covered by the HAM, for each mask size (in tiles) in use.
+        std::unordered_map<uint64_t, std::array<std::vector<uint8_t>, ViewCount>> m_hamCoverage;
+        std::vector<uint8_t> m_maskScratch;
 
         struct {
             // Must appear first.
@@ -1129,13 +1240,10 @@ namespace {
                 // Make sure to unload NvAPI on destruction
                 deferredUnloadNvAPI.needUnload = true;
             }
-            std::vector<std::array<ComPtr<ID3D11NvShadingRateResourceView>, ViewCount + 1>> views;
-            std::vector<ComPtr<ID3D11NvShadingRateResourceView>> viewsDoubleWide;
-            std::vector<ComPtr<ID3D11NvShadingRateResourceView>> viewsTextureArray;
 
         } m_NvShadingRateResources;
 
-        // We use a constant table and a varying shading rate texture filled with a compute shader.
+        // We use a constant table and a varying shading rate texture filled on the CPU.
         inline static NV_D3D11_VIEWPORT_SHADING_RATE_DESC
             m_nvRates[D3D11_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE] = {};
 
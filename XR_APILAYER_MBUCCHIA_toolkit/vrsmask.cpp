@@ -0,0 +1,221 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+#include "log.h"
+
+#include <intrin.h>
+#include <immintrin.h>
+
+namespace {
+
+    using namespace toolkit;
+    using namespace toolkit::graphics;
+
+    bool IsAvx2Supported() {
+        static const bool isSupported = [] {
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+
+            // The OS must also save the AVX registers (OSXSAVE + XCR0).
+            __cpuid(info, 1);
+            const bool hasOsxsave = info[2] & (1 << 27);
+            const bool hasAvx = info[2] & (1 << 28);
+            if (!hasOsxsave || !hasAvx || (_xgetbv(0) & 6) != 6) {
+                return false;
+            }
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+        }();
+
+        return isSupported;
+    }
+
+    // The SIMD path must perform the same operations in the same order as the scalar helpers below, so that both paths
+    // produce identical masks.
+
+    inline float TileToNdcX(uint32_t x, const ShadingRateMaskConstants& constants) {
+        const float u = (x + 0.5f) * constants.InvDim.x;
+        return (2.f * u + -1.f) - constants.GazeXY.x;
+    }
+
+    inline float TileToNdcY(uint32_t y, const ShadingRateMaskConstants& constants) {
+        const float v = (y + 0.5f) * constants.InvDim.y;
+        return (-2.f * v + 1.f) - constants.GazeXY.y;
+    }
+
+    inline uint8_t
+    GetRate(float x2, float y2, const ShadingRateMaskConstants& constants, uint32_t numRings, uint8_t defaultRate) {
+        for (uint32_t i = 0; i < numRings; i++) {
+            if (x2 * constants.Rings[i].x + y2 * constants.Rings[i].y <= 1.f) {
+                return static_cast<uint8_t>(constants.Rates[i]);
+            }
+        }
+        return defaultRate;
+    }
+
+    void GenerateRowScalar(uint8_t* row,
+                           uint32_t start,
+                           uint32_t widthInTiles,
+                           float y2,
+                           const ShadingRateMaskConstants& constants,
+                           uint32_t numRings,
+                           uint8_t defaultRate) {
+        for (uint32_t x = start; x < widthInTiles; x++) {
+            const float ndcX = TileToNdcX(x, constants);
+            row[x] = std::min(row[x], GetRate(ndcX * ndcX, y2, constants, numRings, defaultRate));
+        }
+    }
+
+    // Process 8 tiles at a time. Returns the number of tiles processed.
+    uint32_t GenerateRowAvx2(uint8_t* row,
+                             uint32_t widthInTiles,
+                             float y2,
+                             const ShadingRateMaskConstants& constants,
+                             uint32_t numRings,
+                             uint8_t defaultRate) {
+        const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+        const __m256 invDimX = _mm256_set1_ps(constants.InvDim.x);
+        const __m256 two = _mm256_set1_ps(2.f);
+        const __m256 minusOne = _mm256_set1_ps(-1.f);
+        const __m256 one = _mm256_set1_ps(1.f);
+        const __m256 gazeX = _mm256_set1_ps(constants.GazeXY.x);
+        const __m256 y2s = _mm256_set1_ps(y2);
+
+        uint32_t x = 0;
+        for (; x + 8 <= widthInTiles; x += 8) {
+            const __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps((float)x), laneOffsets), invDimX);
+            const __m256 ndcX = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(two, u), minusOne), gazeX);
+            const __m256 x2 = _mm256_mul_ps(ndcX, ndcX);
+
+            // Walk the rings from the outermost, so that the innermost ring wins.
+            __m256i rates = _mm256_set1_epi32(defaultRate);
+            for (uint32_t i = numRings; i-- > 0;) {
+                const __m256 distance = _mm256_add_ps(_mm256_mul_ps(x2, _mm256_set1_ps(constants.Rings[i].x)),
+                                                      _mm256_mul_ps(y2s, _mm256_set1_ps(constants.Rings[i].y)));
+                const __m256 isInside = _mm256_cmp_ps(distance, one, _CMP_LE_OQ);
+                const __m256i ringRate = _mm256_set1_epi32(constants.Rates[i]);
+                rates = _mm256_castps_si256(
+                    _mm256_blendv_ps(_mm256_castsi256_ps(rates), _mm256_castsi256_ps(ringRate), isInside));
+            }
+
+            // Narrow down to 8 bytes and merge with the existing mask.
+            const __m128i rates16 =
+                _mm_packus_epi32(_mm256_castsi256_si128(rates), _mm256_extracti128_si256(rates, 1));
+            const __m128i rates8 = _mm_packus_epi16(rates16, rates16);
+            const __m128i current = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + x));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(row + x), _mm_min_epu8(current, rates8));
+        }
+
+        return x;
+    }
+
+} // namespace
+
+namespace toolkit::graphics {
+
+    void GenerateShadingRateMask(const ShadingRateMaskConstants& constants,
+                                 uint32_t numRings,
+                                 uint8_t defaultRate,
+                                 uint32_t widthInTiles,
+                                 uint32_t heightInTiles,
+                                 uint8_t* mask,
+                                 size_t rowPitch,
+                                 bool allowSimd) {
+        numRings = std::min(numRings, (uint32_t)std::size(constants.Rings));
+        const bool useAvx2 = allowSimd && IsAvx2Supported();
+
+        for (uint32_t y = 0; y < heightInTiles; y++) {
+            uint8_t* row = mask + y * rowPitch;
+
+            const float ndcY = TileToNdcY(y, constants);
+            const float y2 = ndcY * ndcY;
+
+            const uint32_t start =
+                useAvx2 ? GenerateRowAvx2(row, widthInTiles, y2, constants, numRings, defaultRate) : 0;
+            GenerateRowScalar(row, start, widthInTiles, y2, constants, numRings, defaultRate);
+        }
+    }
+
+    void RasterizeTileCoverage(const std::vector<XrVector2f>& vertices,
+                               const std::vector<uint32_t>& indices,
+                               uint32_t widthInTiles,
+                               uint32_t heightInTiles,
+                               uint8_t* coverage,
+                               size_t rowPitch) {
+        // NDC to tile space (y flip), where the center of tile (x, y) is at (x + 0.5, y + 0.5).
+        const auto toTile = [&](const XrVector2f& ndc) {
+            return XrVector2f{(ndc.x + 1.f) * 0.5f * widthInTiles, (1.f - ndc.y) * 0.5f * heightInTiles};
+        };
+        const auto edge = [](const XrVector2f& a, const XrVector2f& b, float x, float y) {
+            return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+        };
+
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            if (indices[i] >= vertices.size() || indices[i + 1] >= vertices.size() ||
+                indices[i + 2] >= vertices.size()) {
+                continue;
+            }
+
+            const XrVector2f v0 = toTile(vertices[indices[i]]);
+            const XrVector2f v1 = toTile(vertices[indices[i + 1]]);
+            const XrVector2f v2 = toTile(vertices[indices[i + 2]]);
+
+            // Accept either winding order, and skip degenerate triangles.
+            const float area = edge(v0, v1, v2.x, v2.y);
+            if (area == 0.f) {
+                continue;
+            }
+            const float sign = area > 0.f ? 1.f : -1.f;
+
+            // Bounding box of the tile centers to test.
+            const float minX = std::min({v0.x, v1.x, v2.x}), maxX = std::max({v0.x, v1.x, v2.x});
+            const float minY = std::min({v0.y, v1.y, v2.y}), maxY = std::max({v0.y, v1.y, v2.y});
+            const int x0 = std::max((int)std::ceil(minX - 0.5f), 0);
+            const int x1 = std::min((int)std::floor(maxX - 0.5f), (int)widthInTiles - 1);
+            const int y0 = std::max((int)std::ceil(minY - 0.5f), 0);
+            const int y1 = std::min((int)std::floor(maxY - 0.5f), (int)heightInTiles - 1);
+
+            for (int y = y0; y <= y1; y++) {
+                uint8_t* row = coverage + y * rowPitch;
+                const float centerY = y + 0.5f;
+                for (int x = x0; x <= x1; x++) {
+                    const float centerX = x + 0.5f;
+
+                    // Be conservative on the edges: it is better to not cull a tile than to cull a visible one.
+                    if (sign * edge(v0, v1, centerX, centerY) > 0.f && sign * edge(v1, v2, centerX, centerY) > 0.f &&
+                        sign * edge(v2, v0, centerX, centerY) > 0.f) {
+                        row[x] = 1;
+                    }
+                }
+            }
+        }
+    }
+
+} // namespace toolkit::graphics
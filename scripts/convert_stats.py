@@ -0,0 +1,174 @@
+# MIT License
+#
+# Copyright(c) 2021-2022 Matthieu Bucchianeri
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this softwareand associated documentation files(the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions :
+#
+# The above copyright noticeand this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Converts the per-frame statistics recorded by the OpenXR Toolkit (stats_*.bin files) to CSV or JSON.
+#
+# Usage: python convert_stats.py <stats.bin> [--format csv|json] [--output <file>]
+
+import argparse
+import csv
+import datetime
+import json
+import math
+import os
+import struct
+import sys
+
+# Must match utilities::FrameStatisticsFileHeader.
+HEADER_FORMAT = '<8sIIq'
+HEADER_MAGIC = b'OXRTKFST'
+SUPPORTED_VERSION = 1
+
+# Must match utilities::FrameStatistics.
+RECORD_FORMAT = '<Qq11Q'
+RECORD_FIELDS = [
+    'frameIndex',
+    'timestampUs',
+    'appCpuTimeUs',
+    'renderCpuTimeUs',
+    'appGpuTimeUs',
+    'waitCpuTimeUs',
+    'endFrameCpuTimeUs',
+    'upscalerGpuTimeUs',
+    'postProcessGpuTimeUs',
+    'overlayCpuTimeUs',
+    'overlayGpuTimeUs',
+    'handTrackingCpuTimeUs',
+    'predictionTimeUs',
+]
+
+# The timings for which we derive percentiles.
+TIMING_FIELDS = RECORD_FIELDS[2:]
+PERCENTILES = [50, 95, 99]
+
+
+def read_stats(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+
+    header_size = struct.calcsize(HEADER_FORMAT)
+    if len(data) < header_size:
+        raise ValueError('File is too small')
+
+    magic, version, record_size, start_time = struct.unpack_from(HEADER_FORMAT, data, 0)
+    if magic != HEADER_MAGIC:
+        raise ValueError('Not a statistics file')
+    if version != SUPPORTED_VERSION:
+        raise ValueError('Unsupported version: {}'.format(version))
+    if record_size < struct.calcsize(RECORD_FORMAT):
+        raise ValueError('Unexpected record size: {}'.format(record_size))
+
+    frames = []
+    # A partially written record (eg: crash during recording) is ignored.
+    for offset in range(header_size, len(data) - record_size + 1, record_size):
+        frames.append(dict(zip(RECORD_FIELDS, struct.unpack_from(RECORD_FORMAT, data, offset))))
+
+    return start_time, frames
+
+
+def percentile(sorted_values, p):
+    if not sorted_values:
+        return 0
+    # Nearest-rank method.
+    rank = max(1, int(math.ceil(p / 100.0 * len(sorted_values))))
+    return sorted_values[rank - 1]
+
+
+def summarize(frames):
+    summary = {'frames': len(frames), 'dropped': 0, 'fps': 0.0, 'timings': {}}
+    if not frames:
+        return summary
+
+    first, last = frames[0], frames[-1]
+    summary['dropped'] = (last['frameIndex'] - first['frameIndex'] + 1) - len(frames)
+    duration = (last['timestampUs'] - first['timestampUs']) / 1e6
+    if duration > 0:
+        summary['fps'] = (len(frames) - 1) / duration
+
+    frame_times = sorted(b['timestampUs'] - a['timestampUs'] for a, b in zip(frames, frames[1:]))
+    for name, values in [('frameTimeUs', frame_times)] + [(f, sorted(fr[f] for fr in frames)) for f in TIMING_FIELDS]:
+        entry = {'mean': sum(values) / len(values) if values else 0, 'max': values[-1] if values else 0}
+        for p in PERCENTILES:
+            entry['p{}'.format(p)] = percentile(values, p)
+        summary['timings'][name] = entry
+
+    return summary
+
+
+def write_csv(path, frames, summary):
+    with open(path, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['frameIndex', 'timeUs', 'frameTimeUs'] + TIMING_FIELDS)
+        start = frames[0]['timestampUs'] if frames else 0
+        previous = None
+        for frame in frames:
+            frame_time = frame['timestampUs'] - previous['timestampUs'] if previous else 0
+            writer.writerow([frame['frameIndex'], frame['timestampUs'] - start, frame_time] +
+                            [frame[f] for f in TIMING_FIELDS])
+            previous = frame
+
+    summary_path = os.path.splitext(path)[0] + '_summary.csv'
+    with open(summary_path, 'w', newline='') as f:
+        writer = csv.writer(f)
+        writer.writerow(['timing', 'mean'] + ['p{}'.format(p) for p in PERCENTILES] + ['max'])
+        for name, entry in summary['timings'].items():
+            writer.writerow([name, '{:.1f}'.format(entry['mean'])] + [entry['p{}'.format(p)] for p in PERCENTILES] +
+                            [entry['max']])
+
+
+def write_json(path, start_time, frames, summary):
+    with open(path, 'w') as f:
+        json.dump({'startTime': datetime.datetime.fromtimestamp(start_time).isoformat(),
+                   'summary': summary,
+                   'frames': frames}, f, indent=1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Convert OpenXR Toolkit per-frame statistics.')
+    parser.add_argument('input', help='The stats_*.bin file')
+    parser.add_argument('--format', choices=['csv', 'json'], default='csv')
+    parser.add_argument('--output', help='The output file (defaults to the input file with a new extension)')
+    args = parser.parse_args()
+
+    try:
+        start_time, frames = read_stats(args.input)
+    except (OSError, ValueError) as e:
+        print('Failed to read {}: {}'.format(args.input, e), file=sys.stderr)
+        return 1
+
+    summary = summarize(frames)
+    output = args.output or os.path.splitext(args.input)[0] + '.' + args.format
+    if args.format == 'csv':
+        write_csv(output, frames, summary)
+    else:
+        write_json(output, start_time, frames, summary)
+
+    print('{} frames ({} dropped), {:.1f} FPS'.format(summary['frames'], summary['dropped'], summary['fps']))
+    for name, entry in summary['timings'].items():
+        print('  {:<22} mean {:>9.1f}  p50 {:>7}  p95 {:>7}  p99 {:>7}  max {:>7}'.format(
+            name, entry['mean'], entry['p50'], entry['p95'], entry['p99'], entry['max']))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
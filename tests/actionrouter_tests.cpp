@@ -0,0 +1,541 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "pch.h"
+
+#include "actionrouter.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::input;
+
+    constexpr float ClickThreshold = 0.75f;
+
+    const XrActionSet GameplaySet = reinterpret_cast<XrActionSet>(100);
+    const XrActionSet MenuSet = reinterpret_cast<XrActionSet>(101);
+
+    XrAction MakeAction(uint64_t id) {
+        return reinterpret_cast<XrAction>(id);
+    }
+
+    // The actions of a typical application, bound on the HP Reverb G2 controllers.
+    const XrAction Trigger = MakeAction(1);
+    const XrAction Squeeze = MakeAction(2);
+    const XrAction ThumbstickClick = MakeAction(3);
+    const XrAction PrimaryButton = MakeAction(4);
+    const XrAction Menu = MakeAction(5);
+    const XrAction MenuSelect = MakeAction(6);
+
+    void BindController(ActionRouter& router) {
+        router.clearBindings();
+        for (const char* hand : {"/user/hand/left", "/user/hand/right"}) {
+            const std::string prefix = hand;
+            router.bind(Trigger, GameplaySet, prefix + "/input/trigger/value");
+            router.bind(Squeeze, GameplaySet, prefix + "/input/squeeze/value");
+            router.bind(ThumbstickClick, GameplaySet, prefix + "/input/thumbstick/click");
+            router.bind(Menu, GameplaySet, prefix + "/input/menu/click");
+            router.bind(MenuSelect, MenuSet, prefix + "/input/trigger/value");
+        }
+        router.bind(PrimaryButton, GameplaySet, "/user/hand/left/input/x/click");
+        router.bind(PrimaryButton, GameplaySet, "/user/hand/right/input/a/click");
+        Assert::IsFalse(router.bind(Menu, GameplaySet, "/user/gamepad/input/menu/click"));
+        router.bindSystemClick();
+    }
+
+    // Pinch, squeeze and a one-handed gesture, with the haptics and keepalive actions.
+    void SetSources(ActionRouter& router) {
+        router.setSources({{"/input/trigger/value", "/input/trigger/value"},
+                           {"/input/squeeze/value", "/input/squeeze/value"},
+                           {"", "/input/a/click"}},
+                          "/input/menu/click",
+                          "/input/thumbstick/click");
+    }
+
+    XrActionsSyncInfo MakeSyncInfo(const std::vector<XrActiveActionSet>& actionSets) {
+        XrActionsSyncInfo syncInfo{XR_TYPE_ACTIONS_SYNC_INFO};
+        syncInfo.countActiveActionSets = (uint32_t)actionSets.size();
+        syncInfo.activeActionSets = actionSets.data();
+        return syncInfo;
+    }
+
+    float GetFloat(const ActionRouter& router, XrAction action, Hand hand) {
+        const SubAction* subAction = router.find(action, hand);
+        Assert::IsNotNull(subAction);
+        return subAction->floatValue;
+    }
+
+    bool GetBool(const ActionRouter& router, XrAction action, Hand hand) {
+        const SubAction* subAction = router.find(action, hand);
+        Assert::IsNotNull(subAction);
+        return subAction->boolValue;
+    }
+
+    // The routing as it was before the table: each value walks all the bound actions, with a lookup per sub-action
+    // path and a suffix comparison.
+    class LegacyActionRouter {
+      public:
+        LegacyActionRouter(XrPath leftHand, XrPath rightHand) : m_leftHand(leftHand), m_rightHand(rightHand) {
+        }
+
+        void bind(XrAction action, XrActionSet actionSet, const std::string& fullPath) {
+            const bool isLeft = fullPath.find("/user/hand/left") == 0;
+            auto& entry = m_actions[action];
+            entry.actionSet = actionSet;
+            SubAction subAction;
+            subAction.hand = isLeft ? Hand::Left : Hand::Right;
+            subAction.path = fullPath;
+            entry.subActions.insert_or_assign(isLeft ? m_leftHand : m_rightHand, subAction);
+        }
+
+        void beginSync(const XrActionsSyncInfo& syncInfo) {
+            m_ignore.clear();
+            for (auto& action : m_actions) {
+                bool foundActionSet = false;
+                for (uint32_t i = 0; i < syncInfo.countActiveActionSets; i++) {
+                    if (action.second.actionSet == XR_NULL_HANDLE ||
+                        action.second.actionSet == syncInfo.activeActionSets[i].actionSet) {
+                        foundActionSet = true;
+                        break;
+                    }
+                }
+                if (!foundActionSet) {
+                    m_ignore.insert(action.first);
+                }
+                for (auto& subAction : action.second.subActions) {
+                    subAction.second.synced = false;
+                }
+            }
+        }
+
+        void record(Hand hand, const std::string& actionPath, float value, XrTime now) {
+            const XrPath subActionPath = hand == Hand::Left ? m_leftHand : m_rightHand;
+            for (auto& action : m_actions) {
+                if (m_ignore.find(action.first) != m_ignore.cend()) {
+                    continue;
+                }
+
+                auto& subAction = action.second.subActions[subActionPath];
+                const std::string& path = subAction.path;
+
+                // path.endswith(actionPath)
+                if (path.rfind(actionPath) == path.length() - actionPath.length()) {
+                    const float newFloatValue = subAction.synced ? std::max(subAction.floatValue, value) : value;
+                    const bool newBoolValue = newFloatValue >= ClickThreshold;
+                    if (std::abs(subAction.floatValue - newFloatValue) > FLT_EPSILON) {
+                        subAction.floatValue = newFloatValue;
+                        subAction.timeFloatValueChanged = now;
+                        subAction.floatValueChanged = true;
+                    }
+                    if (subAction.boolValue != newBoolValue) {
+                        subAction.boolValue = newBoolValue;
+                        subAction.timeBoolValueChanged = now;
+                        subAction.boolValueChanged = true;
+                    }
+                    subAction.synced = true;
+                }
+            }
+        }
+
+        const SubAction* find(XrAction action, XrPath subActionPath) const {
+            const auto actionIt = m_actions.find(action);
+            if (actionIt == m_actions.cend()) {
+                return nullptr;
+            }
+            auto subActionIt = actionIt->second.subActions.find(subActionPath);
+            if (subActionIt == actionIt->second.subActions.cend()) {
+                if (actionIt->second.subActions.empty()) {
+                    return nullptr;
+                }
+                subActionIt = actionIt->second.subActions.begin();
+            }
+            return &subActionIt->second;
+        }
+
+      private:
+        struct LegacyAction {
+            XrActionSet actionSet;
+            std::map<XrPath, SubAction> subActions;
+        };
+
+        const XrPath m_leftHand;
+        const XrPath m_rightHand;
+        std::map<XrAction, LegacyAction> m_actions;
+        std::set<XrAction> m_ignore;
+    };
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(ActionRouterTests) {
+        const std::vector<XrActiveActionSet> m_gameplay{{GameplaySet, XR_NULL_PATH}};
+
+      public:
+        TEST_METHOD(RoutesGestureValues) {
+            ActionRouter router;
+            BindController(router);
+            SetSources(router);
+            router.beginSync(MakeSyncInfo(m_gameplay));
+
+            router.record(Hand::Left, 0, 0.9f, ClickThreshold, 10);
+            router.record(Hand::Right, 1, 0.5f, ClickThreshold, 10);
+            router.record(Hand::Right, 2, 1.f, ClickThreshold, 10);
+
+            Assert::AreEqual(0.9f, GetFloat(router, Trigger, Hand::Left));
+            Assert::IsTrue(GetBool(router, Trigger, Hand::Left));
+            Assert::AreEqual((XrTime)10, router.find(Trigger, Hand::Left)->timeBoolValueChanged);
+            Assert::AreEqual(0.f, GetFloat(router, Trigger, Hand::Right));
+            Assert::AreEqual(0.5f, GetFloat(router, Squeeze, Hand::Right));
+            Assert::IsFalse(GetBool(router, Squeeze, Hand::Right));
+            Assert::IsTrue(GetBool(router, PrimaryButton, Hand::Right));
+            Assert::IsFalse(GetBool(router, PrimaryButton, Hand::Left));
+
+            // NaN values are not recorded.
+            router.record(Hand::Left, 0, NAN, ClickThreshold, 11);
+            Assert::AreEqual(0.9f, GetFloat(router, Trigger, Hand::Left));
+        }
+
+        TEST_METHOD(OnlyRoutesToSyncedActionSets) {
+            ActionRouter router;
+            BindController(router);
+            SetSources(router);
+
+            // The trigger is bound in both action sets.
+            router.beginSync(MakeSyncInfo(m_gameplay));
+            Assert::AreEqual(2u, router.getNumRoutedSubActions(Hand::Left, 0));
+            router.record(Hand::Left, 0, 1.f, ClickThreshold, 10);
+            Assert::IsTrue(GetBool(router, Trigger, Hand::Left));
+            Assert::IsFalse(GetBool(router, MenuSelect, Hand::Left));
+
+            const std::vector<XrActiveActionSet> menu{{MenuSet, XR_NULL_PATH}};
+            router.beginSync(MakeSyncInfo(menu));
+            router.record(Hand::Left, 0, 0.f, ClickThreshold, 20);
+            router.record(Hand::Left, 0, 1.f, ClickThreshold, 20);
+            Assert::IsTrue(GetBool(router, MenuSelect, Hand::Left));
+            Assert::AreEqual((XrTime)10, router.find(Trigger, Hand::Left)->timeBoolValueChanged);
+        }
+
+        TEST_METHOD(RebuildsRoutesOnRegisterBindings) {
+            ActionRouter router;
+            BindController(router);
+            SetSources(router);
+            router.beginSync(MakeSyncInfo(m_gameplay));
+            router.record(Hand::Right, 0, 1.f, ClickThreshold, 10);
+            Assert::IsTrue(GetBool(router, Trigger, Hand::Right));
+
+            // The application suggests other bindings: the trigger moves to another action.
+            const XrAction fire = MakeAction(50);
+            router.clearBindings();
+            router.bind(fire, GameplaySet, "/user/hand/right/input/trigger/value");
+            router.bindSystemClick();
+            router.beginSync(MakeSyncInfo(m_gameplay));
+
+            Assert::IsNull(router.find(Trigger, Hand::Right));
+            Assert::AreEqual(1u, router.getNumRoutedSubActions(Hand::Right, 0));
+            Assert::AreEqual(0u, router.getNumRoutedSubActions(Hand::Right, 1));
+            router.record(Hand::Right, 0, 1.f, ClickThreshold, 20);
+            Assert::IsTrue(GetBool(router, fire, Hand::Right));
+        }
+
+        TEST_METHOD(RebuildsRoutesOnSourcesChange) {
+            ActionRouter router;
+            BindController(router);
+            SetSources(router);
+            router.beginSync(MakeSyncInfo(m_gameplay));
+
+            // The mapping configuration changes: the 1st gesture now drives the squeeze.
+            router.setSources({{"/input/squeeze/value", "/input/squeeze/value"}}, "", "");
+            router.beginSync(MakeSyncInfo(m_gameplay));
+            Assert::AreEqual(1u, router.getHapticsSource());
+            Assert::AreEqual(0u, router.getNumRoutedSubActions(Hand::Left, router.getHapticsSource()));
+            router.record(Hand::Left, 0, 1.f, ClickThreshold, 10);
+            Assert::IsTrue(GetBool(router, Squeeze, Hand::Left));
+            Assert::IsFalse(GetBool(router, Trigger, Hand::Left));
+        }
+
+        TEST_METHOD(RoutesToMultipleSubActions) {
+            ActionRouter router;
+            BindController(router);
+            const XrAction triggerTouch = MakeAction(51);
+            router.bind(triggerTouch, GameplaySet, "/user/hand/right/input/trigger/value");
+
+            // Two gestures to the same action: the highest value wins.
+            router.setSources({{"/input/trigger/value", "/input/trigger/value"},
+                               {"/input/trigger/value", "/input/trigger/value"}},
+                              "",
+                              "");
+            const std::vector<XrActiveActionSet> both{{GameplaySet, XR_NULL_PATH}, {MenuSet, XR_NULL_PATH}};
+            router.beginSync(MakeSyncInfo(both));
+            Assert::AreEqual(2u, router.getNumRoutedSubActions(Hand::Left, 0));
+            Assert::AreEqual(3u, router.getNumRoutedSubActions(Hand::Right, 0));
+
+            router.record(Hand::Right, 0, 0.8f, ClickThreshold, 10);
+            router.record(Hand::Right, 1, 0.3f, ClickThreshold, 10);
+            for (const XrAction action : {Trigger, MenuSelect, triggerTouch}) {
+                Assert::AreEqual(0.8f, GetFloat(router, action, Hand::Right));
+            }
+
+            // The next sync starts over.
+            router.beginSync(MakeSyncInfo(both));
+            router.record(Hand::Right, 0, 0.3f, ClickThreshold, 20);
+            router.record(Hand::Right, 1, 0.2f, ClickThreshold, 20);
+            Assert::AreEqual(0.3f, GetFloat(router, triggerTouch, Hand::Right));
+        }
+
+        TEST_METHOD(RoutesHapticsAndKeepalive) {
+            ActionRouter router;
+            BindController(router);
+            SetSources(router);
+            router.beginSync(MakeSyncInfo(m_gameplay));
+
+            // After the 3 gestures.
+            Assert::AreEqual(3u, router.getHapticsSource());
+            Assert::AreEqual(4u, router.getKeepaliveSource());
+
+            router.record(Hand::Left, router.getHapticsSource(), 1.f, ClickThreshold, 10);
+            Assert::IsTrue(GetBool(router, Menu, Hand::Left));
+            Assert::IsFalse(GetBool(router, Menu, Hand::Right));
+
+            router.record(Hand::Right, router.getKeepaliveSource(), 1.f, ClickThreshold, 10);
+            Assert::IsTrue(GetBool(router, ThumbstickClick, Hand::Right));
+            Assert::IsFalse(GetBool(router, ThumbstickClick, Hand::Left));
+        }
+
+        TEST_METHOD(TracksSystemClickOnBothHands) {
+            ActionRouter router;
+            BindController(router);
+            router.setSources({{"", "/input/system/click"}}, "", "");
+            router.beginSync(MakeSyncInfo(m_gameplay));
+
+            // The dummy action is not in an action set, and it has one sub-action per hand.
+            const SubAction* left = router.find(XR_NULL_HANDLE, Hand::Left);
+            const SubAction* right = router.find(XR_NULL_HANDLE, Hand::Right);
+            Assert::IsTrue(left != right);
+            Assert::IsTrue(left->hand == Hand::Left);
+            Assert::IsTrue(right->hand == Hand::Right);
+            Assert::AreEqual(std::string("/user/hand/right/input/system/click"), right->path);
+
+            Assert::IsFalse(router.isSystemClickPressed());
+            router.record(Hand::Right, 0, 1.f, ClickThreshold, 10);
+            Assert::IsTrue(router.isSystemClickPressed());
+            Assert::IsFalse(left->boolValue);
+
+            // Tracking loss of the right hand releases the button.
+            router.zero(Hand::Right, 20);
+            Assert::IsFalse(router.isSystemClickPressed());
+        }
+
+        TEST_METHOD(UsesBoundSystemClick) {
+            ActionRouter router;
+            const XrAction home = MakeAction(52);
+            router.bind(home, GameplaySet, "/user/hand/left/input/system/click");
+            router.bindSystemClick();
+            router.setSources({{"/input/system/click", "/input/system/click"}}, "", "");
+            router.beginSync(MakeSyncInfo(m_gameplay));
+
+            Assert::IsNull(router.find(XR_NULL_HANDLE, Hand::Left));
+            router.record(Hand::Left, 0, 1.f, ClickThreshold, 10);
+            Assert::IsTrue(router.isSystemClickPressed());
+        }
+
+        TEST_METHOD(ZeroesHandOnTrackingLoss) {
+            ActionRouter router;
+            BindController(router);
+            SetSources(router);
+            router.beginSync(MakeSyncInfo(m_gameplay));
+            router.record(Hand::Left, 0, 1.f, ClickThreshold, 10);
+            router.record(Hand::Left, 1, 0.5f, ClickThreshold, 10);
+            router.record(Hand::Right, 0, 1.f, ClickThreshold, 10);
+
+            Assert::IsTrue(router.zero(Hand::Left, 20));
+            const SubAction* trigger = router.find(Trigger, Hand::Left);
+            Assert::AreEqual(0.f, trigger->floatValue);
+            Assert::IsFalse(trigger->boolValue);
+            Assert::IsTrue(trigger->floatValueChanged);
+            Assert::IsTrue(trigger->boolValueChanged);
+            Assert::AreEqual((XrTime)20, trigger->timeFloatValueChanged);
+            Assert::AreEqual((XrTime)20, trigger->timeBoolValueChanged);
+            const SubAction* squeeze = router.find(Squeeze, Hand::Left);
+            Assert::AreEqual(0.f, squeeze->floatValue);
+            Assert::IsFalse(squeeze->boolValueChanged);
+            Assert::AreEqual((XrTime)0, squeeze->timeBoolValueChanged);
+
+            // Only the values that were not 0 are reported as changed.
+            const SubAction* menu = router.find(Menu, Hand::Left);
+            Assert::IsFalse(menu->floatValueChanged);
+            Assert::AreEqual((XrTime)0, menu->timeFloatValueChanged);
+
+            // The other hand is untouched.
+            Assert::IsTrue(GetBool(router, Trigger, Hand::Right));
+
+            // Nothing left to zero.
+            Assert::IsFalse(router.zero(Hand::Left, 30));
+            Assert::AreEqual((XrTime)20, trigger->timeFloatValueChanged);
+        }
+
+        TEST_METHOD(FallsBackToBoundHand) {
+            ActionRouter router;
+            BindController(router);
+
+            // Bound on both hands.
+            Assert::IsTrue(router.find(Trigger, Hand::Right)->hand == Hand::Right);
+            Assert::IsTrue(router.find(Trigger, std::nullopt)->hand == Hand::Left);
+
+            // Bound on one hand only.
+            const XrAction rightOnly = MakeAction(53);
+            router.bind(rightOnly, GameplaySet, "/user/hand/right/input/b/click");
+            Assert::IsTrue(router.find(rightOnly, Hand::Left)->hand == Hand::Right);
+            Assert::IsTrue(router.find(rightOnly, std::nullopt)->hand == Hand::Right);
+
+            Assert::IsNull(router.find(MakeAction(999), Hand::Left));
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkSync)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkSync) {
+            // 14 actions on each hand, 7 gestures bound on both hands, 2 action sets synced.
+            const char* const inputs[] = {"/input/trigger/value",
+                                          "/input/trigger/touch",
+                                          "/input/squeeze/value",
+                                          "/input/thumbstick/x",
+                                          "/input/thumbstick/y",
+                                          "/input/thumbstick/click",
+                                          "/input/menu/click",
+                                          "/input/aim/pose",
+                                          "/input/grip/pose",
+                                          "/input/system/click",
+                                          "/input/a/click",
+                                          "/input/b/click",
+                                          "/output/haptic",
+                                          "/input/thumbrest/touch"};
+            const char* const gestures[] = {"/input/trigger/value",
+                                            "/input/squeeze/value",
+                                            "/input/thumbstick/click",
+                                            "/input/a/click",
+                                            "/input/b/click",
+                                            "/input/menu/click",
+                                            "/input/trigger/touch"};
+            constexpr uint32_t NumGestures = (uint32_t)std::size(gestures);
+            constexpr uint32_t NumSyncs = 90 * 60;
+            constexpr XrPath LeftHand = 1;
+            constexpr XrPath RightHand = 2;
+
+            ActionRouter router;
+            LegacyActionRouter legacyRouter(LeftHand, RightHand);
+            std::vector<XrAction> actions;
+            router.clearBindings();
+            for (uint32_t i = 0; i < std::size(inputs); i++) {
+                const XrAction action = MakeAction(i + 1);
+                const XrActionSet actionSet = i % 2 ? GameplaySet : MenuSet;
+                actions.push_back(action);
+                for (const char* hand : {"/user/hand/left", "/user/hand/right"}) {
+                    router.bind(action, actionSet, std::string(hand) + inputs[i]);
+                    legacyRouter.bind(action, actionSet, std::string(hand) + inputs[i]);
+                }
+            }
+            router.bindSystemClick();
+
+            std::vector<std::array<std::string, HandCount>> gestureActions;
+            for (const char* gesture : gestures) {
+                gestureActions.push_back({gesture, gesture});
+            }
+            router.setSources(gestureActions, "", "");
+
+            const std::vector<XrActiveActionSet> activeSets{{GameplaySet, XR_NULL_PATH}, {MenuSet, XR_NULL_PATH}};
+            const XrActionsSyncInfo syncInfo = MakeSyncInfo(activeSets);
+            const auto gestureValue = [](uint32_t sync, uint32_t gesture, uint32_t side) {
+                return ((sync * 7 + gesture * 3 + side) % 11) / 10.f;
+            };
+
+            const auto start = std::chrono::high_resolution_clock::now();
+            for (uint32_t sync = 0; sync < NumSyncs; sync++) {
+                router.beginSync(syncInfo);
+                for (uint32_t side = 0; side < HandCount; side++) {
+                    for (uint32_t i = 0; i < NumGestures; i++) {
+                        router.record((Hand)side, i, gestureValue(sync, i, side), ClickThreshold, sync);
+                    }
+                }
+            }
+            const auto routerDuration = std::chrono::high_resolution_clock::now() - start;
+
+            const auto legacyStart = std::chrono::high_resolution_clock::now();
+            for (uint32_t sync = 0; sync < NumSyncs; sync++) {
+                legacyRouter.beginSync(syncInfo);
+                for (uint32_t side = 0; side < HandCount; side++) {
+                    for (uint32_t i = 0; i < NumGestures; i++) {
+                        legacyRouter.record((Hand)side, gestures[i], gestureValue(sync, i, side), sync);
+                    }
+                }
+            }
+            const auto legacyDuration = std::chrono::high_resolution_clock::now() - legacyStart;
+
+            // Both routings produce the same action states.
+            for (const XrAction action : actions) {
+                for (uint32_t side = 0; side < HandCount; side++) {
+                    const SubAction* subAction = router.find(action, (Hand)side);
+                    const SubAction* legacySubAction = legacyRouter.find(action, side ? RightHand : LeftHand);
+                    Assert::AreEqual(legacySubAction->floatValue, subAction->floatValue);
+                    Assert::AreEqual(legacySubAction->boolValue, subAction->boolValue);
+                    Assert::AreEqual(legacySubAction->timeFloatValueChanged, subAction->timeFloatValueChanged);
+                    Assert::AreEqual(legacySubAction->timeBoolValueChanged, subAction->timeBoolValueChanged);
+                }
+            }
+
+            // The lookups of xrGetActionState*().
+            constexpr uint32_t NumLookups = 1000000;
+            float checksum = 0;
+            const auto lookupStart = std::chrono::high_resolution_clock::now();
+            for (uint32_t i = 0; i < NumLookups; i++) {
+                checksum += router.find(actions[i % actions.size()], (Hand)(i & 1))->floatValue;
+            }
+            const auto lookupDuration = std::chrono::high_resolution_clock::now() - lookupStart;
+            float legacyChecksum = 0;
+            const auto legacyLookupStart = std::chrono::high_resolution_clock::now();
+            for (uint32_t i = 0; i < NumLookups; i++) {
+                legacyChecksum +=
+                    legacyRouter.find(actions[i % actions.size()], (i & 1) ? RightHand : LeftHand)->floatValue;
+            }
+            const auto legacyLookupDuration = std::chrono::high_resolution_clock::now() - legacyLookupStart;
+            Assert::AreEqual(legacyChecksum, checksum);
+
+            const auto perSync = [](auto duration) {
+                return std::chrono::duration<double, std::micro>(duration).count() / NumSyncs;
+            };
+            const auto perLookup = [](auto duration) {
+                return std::chrono::duration<double, std::nano>(duration).count() / NumLookups;
+            };
+            Logger::WriteMessage(fmt::format("recording: {:.2f} us per sync (map/endswith: {:.2f} us)",
+                                             perSync(routerDuration),
+                                             perSync(legacyDuration))
+                                     .c_str());
+            Logger::WriteMessage(fmt::format("action state lookup: {:.1f} ns (map/endswith: {:.1f} ns)",
+                                             perLookup(lookupDuration),
+                                             perLookup(legacyLookupDuration))
+                                     .c_str());
+        }
+    };
+
+} // namespace tests
@@ -0,0 +1,376 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+
+#include "fakes.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace fakes;
+    using namespace toolkit::config;
+
+    // The settings polled on every frame by the VRS, the post-processor and the frame throttling.
+    const std::vector<std::string> PolledSettings = {
+        SettingVRS,
+        SettingVRSQuality,
+        SettingVRSPattern,
+        SettingVRSOuter,
+        SettingVRSOuterRadius,
+        SettingVRSMiddle,
+        SettingVRSInnerRadius,
+        SettingVRSInner,
+        SettingVRSXOffset,
+        SettingVRSXScale,
+        SettingVRSYOffset,
+        SettingVRSPreferHorizontal,
+        SettingVRSLeftRightBias,
+        SettingVRSScaleFilter,
+        SettingVRSCullHAM,
+        SettingPostProcess,
+        SettingPostSunGlasses,
+        SettingPostContrast,
+        SettingPostBrightness,
+        SettingPostExposure,
+        SettingPostSaturation,
+        SettingPostVibrance,
+        SettingPostColorGainR,
+        SettingPostColorGainG,
+        SettingPostColorGainB,
+        SettingPostHighlights,
+        SettingPostShadows,
+        SettingPostChromaticCorrectionR,
+        SettingPostChromaticCorrectionB,
+        SettingFrameThrottling,
+        SettingPredictionDampen,
+    };
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(ConfigTests) {
+        const std::filesystem::path m_directory = std::filesystem::temp_directory_path() / "OXRTK_config_tests";
+
+      public:
+        TEST_METHOD_INITIALIZE(Setup) {
+            std::filesystem::remove_all(m_directory);
+        }
+
+        TEST_METHOD_CLEANUP(Cleanup) {
+            std::filesystem::remove_all(m_directory);
+        }
+
+        TEST_METHOD(HandleAndNameShareValue) {
+            auto backend = std::make_shared<FakeConfigBackend>();
+            backend->values[SettingPostContrast] = 600;
+            auto configManager = CreateConfigManager(backend);
+            configManager->setDefault(SettingPostBrightness, 500);
+
+            const auto contrast = configManager->getHandle(SettingPostContrast);
+            const auto brightness = configManager->getHandle(SettingPostBrightness);
+            Assert::AreEqual(600, configManager->getValue(contrast));
+            Assert::AreEqual(500, configManager->getValue(brightness));
+
+            configManager->setValue(SettingPostContrast, 700);
+            Assert::AreEqual(700, configManager->peekValue(contrast));
+            configManager->setValue(brightness, 400);
+            Assert::AreEqual(400, configManager->peekValue(SettingPostBrightness));
+
+            // Interning is done once.
+            Assert::AreEqual(contrast.index, configManager->getHandle(SettingPostContrast).index);
+        }
+
+        TEST_METHOD(ChangesAreClearedByGetValue) {
+            auto backend = std::make_shared<FakeConfigBackend>();
+            auto configManager = CreateConfigManager(backend);
+            configManager->setDefault(SettingVRS, 0);
+            const auto vrs = configManager->getHandle(SettingVRS);
+
+            // New values are reported as changed until read.
+            Assert::IsTrue(configManager->hasChanged(vrs));
+            configManager->peekValue(vrs);
+            Assert::IsTrue(configManager->hasChanged(SettingVRS));
+            configManager->getValue(vrs);
+            Assert::IsFalse(configManager->hasChanged(vrs));
+
+            configManager->setValue(vrs, 1);
+            Assert::IsTrue(configManager->hasChanged(SettingVRS));
+            Assert::AreEqual(1, configManager->getValue(SettingVRS));
+            Assert::IsFalse(configManager->hasChanged(vrs));
+
+            // A name that was never used did not change.
+            Assert::IsFalse(configManager->hasChanged("not_a_setting"));
+        }
+
+        TEST_METHOD(ChangeGenerationOnlyMovesOnChanges) {
+            auto backend = std::make_shared<FakeConfigBackend>();
+            auto configManager = CreateConfigManager(backend);
+            for (const auto& name : PolledSettings) {
+                configManager->setDefault(name, 0);
+            }
+
+            auto generation = configManager->getChangeGeneration();
+            for (int i = 0; i < 100; i++) {
+                configManager->tick();
+                for (const auto& name : PolledSettings) {
+                    configManager->getValue(name);
+                }
+                Assert::AreEqual(generation, configManager->getChangeGeneration());
+            }
+
+            configManager->setValue(SettingPostExposure, 10);
+            Assert::AreNotEqual(generation, configManager->getChangeGeneration());
+
+            // Our own write must not be seen as an external change.
+            generation = configManager->getChangeGeneration();
+            for (int i = 0; i < 100; i++) {
+                configManager->tick();
+            }
+            Assert::AreEqual(generation, configManager->getChangeGeneration());
+        }
+
+        TEST_METHOD(WritesAreDeferredAndBatched) {
+            auto backend = std::make_shared<FakeConfigBackend>();
+            auto configManager = CreateConfigManager(backend);
+            configManager->setValue(SettingPostContrast, 1);
+            configManager->setValue(SettingPostBrightness, 2);
+
+            for (int i = 0; i < 21; i++) {
+                configManager->tick();
+            }
+            Assert::AreEqual(0u, backend->numWrites);
+
+            configManager->tick();
+            Assert::AreEqual(1u, backend->numWrites);
+            Assert::AreEqual(1, backend->values[SettingPostContrast]);
+            Assert::AreEqual(2, backend->values[SettingPostBrightness]);
+
+            configManager->setValue(SettingPostContrast, 3, true /* noCommitDelay */);
+            configManager->tick();
+            Assert::AreEqual(2u, backend->numWrites);
+            Assert::AreEqual(3, backend->values[SettingPostContrast]);
+        }
+
+        TEST_METHOD(ExternalChangesAreRefreshed) {
+            auto backend = std::make_shared<FakeConfigBackend>();
+            auto configManager = CreateConfigManager(backend);
+            const auto contrast = configManager->getHandle(SettingPostContrast);
+            configManager->getValue(contrast);
+
+            // The backend is only read when it reports a change.
+            const auto numReads = backend->numReads;
+            for (int i = 0; i < 100; i++) {
+                configManager->tick();
+            }
+            Assert::AreEqual(numReads, backend->numReads);
+
+            backend->modify(SettingPostContrast, 800);
+            configManager->tick();
+            Assert::IsTrue(configManager->hasChanged(contrast));
+            Assert::AreEqual(800, configManager->getValue(contrast));
+
+            // An external change cancels a pending write.
+            configManager->setValue(contrast, 900);
+            backend->modify(SettingPostContrast, 850);
+            for (int i = 0; i < 30; i++) {
+                configManager->tick();
+            }
+            Assert::AreEqual(850, configManager->getValue(contrast));
+            Assert::AreEqual(0u, backend->numWrites);
+        }
+
+        TEST_METHOD(DeleteValueKeepsHandle) {
+            auto backend = std::make_shared<FakeConfigBackend>();
+            backend->values[SettingPostContrast] = 600;
+            auto configManager = CreateConfigManager(backend);
+            configManager->setDefault(SettingPostContrast, 500);
+            const auto contrast = configManager->getHandle(SettingPostContrast);
+
+            configManager->deleteValue(SettingPostContrast);
+            Assert::AreEqual(500, configManager->getValue(contrast));
+            Assert::IsFalse(backend->values.count(SettingPostContrast));
+        }
+
+        TEST_METHOD(GlobalValuesAreFallback) {
+            // The companion app only writes these options for all applications.
+            auto backend = std::make_shared<FakeConfigBackend>();
+            backend->globals[SettingScreenshotEnabled] = 1;
+            backend->globals[SettingMenuEyeVisibility] = 2;
+            backend->values[SettingMenuEyeVisibility] = 1;
+            auto configManager = CreateConfigManager(backend);
+            configManager->setDefault(SettingScreenshotEnabled, 0);
+            configManager->setDefault(SettingMenuEyeVisibility, 0);
+
+            Assert::AreEqual(1, configManager->getValue(SettingScreenshotEnabled));
+            Assert::AreEqual(1, configManager->getValue(SettingMenuEyeVisibility));
+
+            // Changes of the global values are picked up too.
+            backend->globals[SettingScreenshotEnabled] = 0;
+            backend->modified = true;
+            configManager->tick();
+            Assert::IsTrue(configManager->hasChanged(SettingScreenshotEnabled));
+            Assert::AreEqual(0, configManager->getValue(SettingScreenshotEnabled));
+        }
+
+        TEST_METHOD(SafeModeIsGlobal) {
+            auto backend = std::make_shared<FakeConfigBackend>();
+            backend->values["safe_mode"] = 1;
+            backend->values["developer"] = 1;
+            Assert::IsFalse(CreateConfigManager(backend)->isSafeMode());
+            Assert::IsFalse(CreateConfigManager(backend)->isDeveloper());
+
+            backend->globals["safe_mode"] = 1;
+            backend->globals["developer"] = 1;
+            backend->values[SettingPostContrast] = 600;
+            auto configManager = CreateConfigManager(backend);
+            Assert::IsTrue(configManager->isSafeMode());
+            Assert::IsTrue(configManager->isDeveloper());
+
+            // Safe mode ignores the stored values.
+            configManager->setDefault(SettingPostContrast, 500);
+            Assert::AreEqual(500, configManager->getValue(SettingPostContrast));
+        }
+
+        TEST_METHOD(FileBackendFallsBackToGlobalValues) {
+            auto globals = std::make_shared<FakeConfigBackend>();
+            globals->globals[SettingScreenshotEnabled] = 1;
+            globals->globals[SettingScreenshotEye] = 2;
+            globals->globals["developer"] = 1;
+
+            const auto path = m_directory / "settings" / "app.cfg";
+            {
+                auto configManager = CreateConfigManager(CreateFileConfigBackend(path, globals));
+                Assert::IsTrue(configManager->isDeveloper());
+                Assert::AreEqual(1, configManager->getValue(SettingScreenshotEnabled));
+
+                configManager->setValue(SettingScreenshotEye, 1, true /* noCommitDelay */);
+                configManager->tick();
+            }
+
+            // The per-application value takes precedence over the global one.
+            auto backend = CreateFileConfigBackend(path, globals);
+            Assert::AreEqual(1, backend->read(SettingScreenshotEye).value_or(0));
+            Assert::IsFalse(backend->read(SettingScreenshotEnabled).has_value());
+            Assert::AreEqual(1, backend->readGlobal(SettingScreenshotEnabled).value_or(0));
+            Assert::AreEqual(1, CreateConfigManager(backend)->getValue(SettingScreenshotEye));
+
+            // Without a global backend, there are no global values.
+            Assert::IsFalse(CreateFileConfigBackend(path, nullptr)->readGlobal(SettingScreenshotEnabled).has_value());
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkFramePolling)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkFramePolling) {
+            constexpr uint32_t NumFrames = 90 * 60;
+            auto backend = std::make_shared<FakeConfigBackend>();
+            auto configManager = CreateConfigManager(backend);
+            for (const auto& name : PolledSettings) {
+                configManager->setDefault(name, 0);
+            }
+
+            // Populate the configuration manager like the layer does.
+            for (int i = 0; i < 100; i++) {
+                configManager->setDefault("other_setting_" + std::to_string(i), i);
+            }
+
+            std::vector<SettingHandle> handles;
+            for (const auto& name : PolledSettings) {
+                handles.push_back(configManager->getHandle(name));
+                configManager->getValue(handles.back());
+            }
+
+            // The menu changes one value every second.
+            const auto replay = [&](const auto& poll) {
+                uint32_t numUpdates = 0;
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (uint32_t frame = 0; frame < NumFrames; frame++) {
+                    if (frame % 90 == 0) {
+                        configManager->setValue(handles[frame / 90 % handles.size()], frame);
+                    }
+                    configManager->tick();
+                    numUpdates += poll();
+                }
+                const auto duration = std::chrono::high_resolution_clock::now() - start;
+                Assert::AreEqual(NumFrames / 90, numUpdates);
+                return std::chrono::duration<double, std::nano>(duration).count() / NumFrames;
+            };
+
+            // hasChanged() and getValue() by name, through the compatibility layer.
+            const auto byName = replay([&] {
+                uint32_t numUpdates = 0;
+                for (const auto& name : PolledSettings) {
+                    if (configManager->hasChanged(name)) {
+                        configManager->getValue(name);
+                        numUpdates++;
+                    }
+                }
+                return numUpdates;
+            });
+
+            // The same with interned handles.
+            const auto byHandle = replay([&] {
+                uint32_t numUpdates = 0;
+                for (const auto& handle : handles) {
+                    if (configManager->hasChanged(handle)) {
+                        configManager->getValue(handle);
+                        numUpdates++;
+                    }
+                }
+                return numUpdates;
+            });
+
+            // Skip the polling entirely when the change generation did not move, like the update() methods do.
+            uint64_t lastGeneration = 0;
+            const auto byGeneration = replay([&] {
+                uint32_t numUpdates = 0;
+                const auto generation = configManager->getChangeGeneration();
+                if (generation != lastGeneration) {
+                    lastGeneration = generation;
+                    for (const auto& handle : handles) {
+                        if (configManager->hasChanged(handle)) {
+                            configManager->getValue(handle);
+                            numUpdates++;
+                        }
+                    }
+                }
+                return numUpdates;
+            });
+
+            Logger::WriteMessage(fmt::format("{} settings polled per frame (including tick()): {:.0f} ns by name, "
+                                             "{:.0f} ns by handle, {:.0f} ns with the change generation",
+                                             PolledSettings.size(),
+                                             byName,
+                                             byHandle,
+                                             byGeneration)
+                                     .c_str());
+            Assert::IsTrue(byHandle < byName);
+        }
+    };
+
+} // namespace tests
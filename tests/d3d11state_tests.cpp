@@ -0,0 +1,385 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "d3d11state.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::graphics::d3d11;
+
+    // Stands for an ID3DDeviceContextState.
+    struct FakeContextState {
+        ULONG AddRef() {
+            return ++refCount;
+        }
+
+        ULONG Release() {
+            return --refCount;
+        }
+
+        ULONG refCount{1};
+        D3D11_PRIMITIVE_TOPOLOGY topology{D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED};
+    };
+
+    // A device context that counts the calls made to it and the number of pipeline slots that they read or write.
+    // It only keeps the topology and the viewports, and it reports all the other slots as empty.
+    class CountingContext {
+      public:
+        // Input assembler.
+        void IAGetInputLayout(ID3D11InputLayout** layout) {
+            count(1);
+            *layout = nullptr;
+        }
+        void IASetInputLayout(ID3D11InputLayout*) {
+            count(1);
+        }
+        void IAGetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY* topology) {
+            count(1);
+            *topology = m_topology;
+        }
+        void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) {
+            count(1);
+            m_topology = topology;
+        }
+        void IAGetVertexBuffers(UINT, UINT numBuffers, ID3D11Buffer** buffers, UINT* strides, UINT* offsets) {
+            getArray(numBuffers, buffers);
+            std::fill_n(strides, numBuffers, 0);
+            std::fill_n(offsets, numBuffers, 0);
+        }
+        void IASetVertexBuffers(UINT, UINT numBuffers, ID3D11Buffer* const*, const UINT*, const UINT*) {
+            count(numBuffers);
+        }
+        void IAGetIndexBuffer(ID3D11Buffer** buffer, DXGI_FORMAT* format, UINT* offset) {
+            count(1);
+            *buffer = nullptr;
+            *format = DXGI_FORMAT_UNKNOWN;
+            *offset = 0;
+        }
+        void IASetIndexBuffer(ID3D11Buffer*, DXGI_FORMAT, UINT) {
+            count(1);
+        }
+
+        // Output merger.
+        void OMGetRenderTargets(UINT numViews, ID3D11RenderTargetView** views, ID3D11DepthStencilView** depth) {
+            getArray(numViews, views);
+            m_numSlots++;
+            *depth = nullptr;
+        }
+        void OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const*, ID3D11DepthStencilView*) {
+            count(numViews + 1);
+        }
+        void OMGetDepthStencilState(ID3D11DepthStencilState** state, UINT* stencilRef) {
+            count(1);
+            *state = nullptr;
+            *stencilRef = 0;
+        }
+        void OMSetDepthStencilState(ID3D11DepthStencilState*, UINT) {
+            count(1);
+        }
+        void OMGetBlendState(ID3D11BlendState** state, FLOAT blendFactor[4], UINT* sampleMask) {
+            count(1);
+            *state = nullptr;
+            std::fill_n(blendFactor, 4, 0.f);
+            *sampleMask = 0xffffffff;
+        }
+        void OMSetBlendState(ID3D11BlendState*, const FLOAT[4], UINT) {
+            count(1);
+        }
+
+        // Shader stages.
+#define FAKE_SHADER_STAGE(stage, programType)                                                                          \
+    void stage##GetShader(programType** program, ID3D11ClassInstance**, UINT*) {                                       \
+        count(1);                                                                                                      \
+        *program = nullptr;                                                                                            \
+    }                                                                                                                  \
+    void stage##SetShader(programType*, ID3D11ClassInstance* const*, UINT) {                                           \
+        count(1);                                                                                                      \
+    }                                                                                                                  \
+    void stage##GetConstantBuffers(UINT, UINT numBuffers, ID3D11Buffer** buffers) {                                    \
+        getArray(numBuffers, buffers);                                                                                 \
+    }                                                                                                                  \
+    void stage##SetConstantBuffers(UINT, UINT numBuffers, ID3D11Buffer* const*) {                                      \
+        count(numBuffers);                                                                                             \
+    }                                                                                                                  \
+    void stage##GetSamplers(UINT, UINT numSamplers, ID3D11SamplerState** samplers) {                                   \
+        getArray(numSamplers, samplers);                                                                               \
+    }                                                                                                                  \
+    void stage##SetSamplers(UINT, UINT numSamplers, ID3D11SamplerState* const*) {                                      \
+        count(numSamplers);                                                                                            \
+    }                                                                                                                  \
+    void stage##GetShaderResources(UINT, UINT numViews, ID3D11ShaderResourceView** views) {                            \
+        getArray(numViews, views);                                                                                     \
+    }                                                                                                                  \
+    void stage##SetShaderResources(UINT, UINT numViews, ID3D11ShaderResourceView* const*) {                            \
+        count(numViews);                                                                                               \
+    }
+
+        FAKE_SHADER_STAGE(VS, ID3D11VertexShader);
+        FAKE_SHADER_STAGE(PS, ID3D11PixelShader);
+        FAKE_SHADER_STAGE(GS, ID3D11GeometryShader);
+        FAKE_SHADER_STAGE(DS, ID3D11DomainShader);
+        FAKE_SHADER_STAGE(HS, ID3D11HullShader);
+        FAKE_SHADER_STAGE(CS, ID3D11ComputeShader);
+
+#undef FAKE_SHADER_STAGE
+
+        void CSGetUnorderedAccessViews(UINT, UINT numViews, ID3D11UnorderedAccessView** views) {
+            getArray(numViews, views);
+        }
+        void CSSetUnorderedAccessViews(UINT, UINT numViews, ID3D11UnorderedAccessView* const*, const UINT*) {
+            count(numViews);
+        }
+
+        // Rasterizer.
+        void RSGetState(ID3D11RasterizerState** state) {
+            count(1);
+            *state = nullptr;
+        }
+        void RSSetState(ID3D11RasterizerState*) {
+            count(1);
+        }
+        void RSGetViewports(UINT* numViewports, D3D11_VIEWPORT* viewports) {
+            count(*numViewports);
+            *numViewports = std::min(*numViewports, (UINT)m_viewports.size());
+            std::copy_n(m_viewports.begin(), *numViewports, viewports);
+        }
+        void RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports) {
+            count(numViewports);
+            m_viewports.assign(viewports, viewports + numViewports);
+        }
+        void RSGetScissorRects(UINT* numRects, D3D11_RECT*) {
+            count(*numRects);
+            *numRects = 0;
+        }
+        void RSSetScissorRects(UINT numRects, const D3D11_RECT*) {
+            count(numRects);
+        }
+
+        void ClearState() {
+            count(1);
+            m_topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+            m_viewports.clear();
+        }
+
+        void SwapDeviceContextState(FakeContextState* state, FakeContextState** previousState) {
+            count(1);
+            m_numSwaps++;
+            m_currentState->topology = m_topology;
+            if (previousState) {
+                *previousState = m_hasPreviousState ? m_currentState : nullptr;
+            } else {
+                m_currentState->Release();
+            }
+            m_currentState = state;
+            m_currentState->AddRef();
+            m_topology = m_currentState->topology;
+        }
+
+        FakeContextState* getCurrentState() const {
+            return m_currentState;
+        }
+
+        uint32_t getNumSwaps() const {
+            return m_numSwaps;
+        }
+
+        // Make SwapDeviceContextState() fail to return the previous state.
+        void loseStateObject() {
+            m_hasPreviousState = false;
+        }
+
+        D3D11_PRIMITIVE_TOPOLOGY getTopology() const {
+            return m_topology;
+        }
+
+        const std::vector<D3D11_VIEWPORT>& getViewports() const {
+            return m_viewports;
+        }
+
+        uint32_t getNumCalls() const {
+            return m_numCalls;
+        }
+
+        uint32_t getNumSlots() const {
+            return m_numSlots;
+        }
+
+        void resetCounters() {
+            m_numCalls = m_numSlots = 0;
+        }
+
+      private:
+        void count(uint32_t numSlots) {
+            m_numCalls++;
+            m_numSlots += numSlots;
+        }
+
+        template <typename T>
+        void getArray(UINT count, T** objects) {
+            this->count(count);
+            std::fill_n(objects, count, nullptr);
+        }
+
+        FakeContextState m_applicationState;
+        FakeContextState* m_currentState{&m_applicationState};
+        bool m_hasPreviousState{true};
+        uint32_t m_numSwaps{0};
+        D3D11_PRIMITIVE_TOPOLOGY m_topology{D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST};
+        std::vector<D3D11_VIEWPORT> m_viewports{{0, 0, 1920, 1080, 0, 1}, {1920, 0, 1920, 1080, 0, 1}};
+
+        uint32_t m_numCalls{0};
+        uint32_t m_numSlots{0};
+    };
+
+    using ContextSaver = D3D11ContextSaver<CountingContext, CountingContext, FakeContextState>;
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(D3D11StateTests) {
+      public:
+        TEST_METHOD(SwapRestoresApplicationState) {
+            CountingContext context;
+            FakeContextState toolkitState;
+            ContextSaver saver;
+            saver.initialize(&context, &context, &toolkitState);
+            FakeContextState* const applicationState = context.getCurrentState();
+
+            saver.save(true);
+            Assert::IsTrue(context.getCurrentState() == &toolkitState);
+            Assert::IsTrue(saver.isSaved());
+            context.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+
+            saver.restore();
+            Assert::IsTrue(context.getCurrentState() == applicationState);
+            Assert::AreEqual((int)D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, (int)context.getTopology());
+            Assert::IsFalse(saver.isSaved());
+
+            // Our state is cleared before being swapped out.
+            Assert::AreEqual((int)D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED, (int)toolkitState.topology);
+        }
+
+        TEST_METHOD(SnapshotWithoutStateObject) {
+            CountingContext context;
+            ContextSaver saver;
+            saver.initialize(&context, nullptr, nullptr);
+
+            saver.save(true);
+            Assert::AreEqual((int)D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED, (int)context.getTopology());
+            Assert::AreEqual((size_t)0, context.getViewports().size());
+            context.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+
+            saver.restore();
+            Assert::AreEqual((int)D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, (int)context.getTopology());
+            Assert::AreEqual((size_t)2, context.getViewports().size());
+            Assert::AreEqual(1920.0, (double)context.getViewports()[1].TopLeftX, 0.0);
+            Assert::IsFalse(saver.isSaved());
+        }
+
+        TEST_METHOD(SnapshotWhenNotClearing) {
+            CountingContext context;
+            FakeContextState toolkitState;
+            ContextSaver saver;
+            saver.initialize(&context, &context, &toolkitState);
+            FakeContextState* const applicationState = context.getCurrentState();
+
+            // The toolkit draws on top of the application state (eg: the menu): it must not be swapped out.
+            saver.save(false);
+            Assert::IsTrue(context.getCurrentState() == applicationState);
+            Assert::AreEqual((int)D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, (int)context.getTopology());
+            context.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+
+            saver.restore();
+            Assert::AreEqual((int)D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, (int)context.getTopology());
+        }
+
+        TEST_METHOD(SnapshotWithoutPreviousStateObject) {
+            CountingContext context;
+            FakeContextState toolkitState;
+            ContextSaver saver;
+            saver.initialize(&context, &context, &toolkitState);
+            context.loseStateObject();
+
+            // Our state object stays bound, and it is not swapped out on restore().
+            saver.save(true);
+            Assert::IsTrue(context.getCurrentState() == &toolkitState);
+            Assert::IsTrue(saver.isSaved());
+            context.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+            saver.restore();
+            Assert::IsTrue(context.getCurrentState() == &toolkitState);
+            Assert::IsFalse(saver.isSaved());
+
+            // From then on, the application state is saved with a snapshot.
+            context.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+            saver.save(true);
+            Assert::AreEqual(1u, context.getNumSwaps());
+            Assert::IsTrue(context.getCurrentState() == &toolkitState);
+            Assert::AreEqual((int)D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED, (int)context.getTopology());
+            context.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_POINTLIST);
+
+            saver.restore();
+            Assert::AreEqual(1u, context.getNumSwaps());
+            Assert::IsTrue(context.getCurrentState() == &toolkitState);
+            Assert::AreEqual((int)D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, (int)context.getTopology());
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkComCallsPerFrame)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkComCallsPerFrame) {
+            // Saves per frame: VRS mask update, upscaling, overlay and menu.
+            constexpr uint32_t SavesPerFrame = 4;
+
+            const auto measure = [&](bool useStateObject) {
+                CountingContext context;
+                FakeContextState toolkitState;
+                ContextSaver saver;
+                saver.initialize(&context, useStateObject ? &context : nullptr, &toolkitState);
+                context.resetCounters();
+                for (uint32_t i = 0; i < SavesPerFrame; i++) {
+                    saver.save(true);
+                    saver.restore();
+                }
+                return std::make_pair(context.getNumCalls(), context.getNumSlots());
+            };
+
+            const auto snapshot = measure(false);
+            const auto swap = measure(true);
+
+            Logger::WriteMessage(fmt::format("snapshot: {} calls, {} slots per frame", snapshot.first, snapshot.second)
+                                     .c_str());
+            Logger::WriteMessage(
+                fmt::format("swap:     {} calls, {} slots per frame", swap.first, swap.second).c_str());
+            Logger::WriteMessage("Each slot bound by the application also costs an AddRef()/Release() pair with a "
+                                 "snapshot.");
+
+            Assert::AreEqual(3u * SavesPerFrame, swap.first);
+            Assert::IsTrue(snapshot.second > 1000 * SavesPerFrame);
+        }
+    };
+
+} // namespace tests
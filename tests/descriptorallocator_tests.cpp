@@ -0,0 +1,166 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "d3dcommon.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::graphics::d3dcommon;
+
+    // Allocate like D3D12Heap does for the heaps that are not shader-visible: add a page twice as large when full.
+    DescriptorAllocator::Location AllocateOrGrow(DescriptorAllocator& allocator, uint32_t& lastPageSize) {
+        auto location = allocator.allocate();
+        if (!location) {
+            lastPageSize *= 2;
+            allocator.addPage(lastPageSize);
+            location = allocator.allocate();
+        }
+        Assert::IsTrue(location.has_value());
+        return *location;
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(DescriptorAllocatorTests) {
+      public:
+        TEST_METHOD(AllocatesUntilFull) {
+            DescriptorAllocator allocator;
+            allocator.initialize(0);
+            allocator.addPage(4);
+
+            for (uint32_t i = 0; i < 4; i++) {
+                const auto location = allocator.allocate();
+                Assert::IsTrue(location.has_value());
+                Assert::AreEqual((size_t)0, location->page);
+                Assert::AreEqual(i, location->index);
+            }
+            Assert::IsFalse(allocator.allocate().has_value());
+            Assert::AreEqual(4u, allocator.getNumAllocated());
+        }
+
+        TEST_METHOD(GrowsWithPages) {
+            DescriptorAllocator allocator;
+            allocator.initialize(0);
+            allocator.addPage(4);
+
+            uint32_t lastPageSize = 4;
+            for (uint32_t i = 0; i < 5; i++) {
+                AllocateOrGrow(allocator, lastPageSize);
+            }
+
+            Assert::AreEqual(12u, allocator.getCapacity());
+            Assert::AreEqual(5u, allocator.getNumAllocated());
+        }
+
+        TEST_METHOD(RecyclesAfterLatency) {
+            DescriptorAllocator allocator;
+            allocator.initialize(2);
+            allocator.addPage(4);
+
+            std::vector<DescriptorAllocator::Location> locations;
+            for (uint32_t i = 0; i < 4; i++) {
+                locations.push_back(*allocator.allocate());
+            }
+            Assert::IsTrue(allocator.free(locations[1].page, locations[1].index, locations[1].generation));
+            Assert::AreEqual(3u, allocator.getNumAllocated());
+
+            // The command lists of the next 2 flushes might still reference the descriptor.
+            allocator.recycle();
+            Assert::IsFalse(allocator.allocate().has_value());
+            allocator.recycle();
+            Assert::IsFalse(allocator.allocate().has_value());
+            allocator.recycle();
+
+            const auto recycled = allocator.allocate();
+            Assert::IsTrue(recycled.has_value());
+            Assert::AreEqual(1u, recycled->index);
+            Assert::AreEqual(locations[1].generation + 1, recycled->generation);
+        }
+
+        TEST_METHOD(DetectsStaleRelease) {
+            DescriptorAllocator allocator;
+            allocator.initialize(0);
+            allocator.addPage(4);
+
+            const auto location = *allocator.allocate();
+            Assert::IsTrue(allocator.free(location.page, location.index, location.generation));
+            Assert::IsFalse(allocator.free(location.page, location.index, location.generation));
+
+            // Once reused, the descriptor cannot be released with the old generation either.
+            allocator.recycle();
+            const auto reused = *allocator.allocate();
+            Assert::AreEqual(location.index, reused.index);
+            Assert::IsFalse(allocator.free(location.page, location.index, location.generation));
+            Assert::IsTrue(allocator.free(reused.page, reused.index, reused.generation));
+
+            Assert::AreEqual(0u, allocator.getNumAllocated());
+        }
+
+        TEST_METHOD(RejectsUnknownDescriptor) {
+            DescriptorAllocator allocator;
+            allocator.initialize(0);
+            allocator.addPage(4);
+            allocator.allocate();
+
+            Assert::IsFalse(allocator.free(1, 0, 0));
+            Assert::IsFalse(allocator.free(0, 1, 0));
+            Assert::AreEqual(1u, allocator.getNumAllocated());
+        }
+
+        TEST_METHOD(LongSessionDoesNotLeak) {
+            constexpr uint32_t RecycleLatency = 32;
+            DescriptorAllocator allocator;
+            allocator.initialize(RecycleLatency);
+            uint32_t lastPageSize = 128;
+            allocator.addPage(lastPageSize);
+
+            // Each frame creates views for short-lived textures (wrapped render targets, VRS masks, intermediates
+            // after a resolution change), which are released a few frames later.
+            std::mt19937 random(1);
+            std::deque<std::pair<uint32_t, DescriptorAllocator::Location>> live;
+            for (uint32_t frame = 0; frame < 100000; frame++) {
+                const uint32_t numNewViews = frame % 1000 == 0 ? 64 : random() % 8;
+                for (uint32_t i = 0; i < numNewViews; i++) {
+                    live.push_back({frame + 1 + random() % 16, AllocateOrGrow(allocator, lastPageSize)});
+                }
+                std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+                while (!live.empty() && live.front().first <= frame) {
+                    const auto& location = live.front().second;
+                    Assert::IsTrue(allocator.free(location.page, location.index, location.generation));
+                    live.pop_front();
+                }
+                allocator.recycle();
+            }
+
+            Assert::AreEqual((uint32_t)live.size(), allocator.getNumAllocated());
+            // The views in use, plus the ones released during the recycle latency: about (16 + 32) * 4, with bursts.
+            Assert::IsTrue(allocator.getCapacity() <= 128 + 256 + 512);
+        }
+    };
+
+} // namespace tests
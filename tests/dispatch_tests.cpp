@@ -0,0 +1,146 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "framework/dispatch.gen.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::dispatch;
+
+    // Functions that the loader and the applications resolve through our xrGetInstanceProcAddr() but that we do not
+    // intercept.
+    const char* const PassThroughFunctions[] = {
+        "xrGetInstanceProperties",
+        "xrResultToString",
+        "xrStructureTypeToString",
+        "xrGetSystemProperties",
+        "xrEnumerateEnvironmentBlendModes",
+        "xrEnumerateReferenceSpaces",
+        "xrCreateReferenceSpace",
+        "xrGetReferenceSpaceBoundsRect",
+        "xrEnumerateSwapchainFormats",
+        "xrEnumerateViewConfigurations",
+        "xrGetViewConfigurationProperties",
+        "xrStringToPath",
+        "xrPathToString",
+        "xrCreateActionSet",
+        "xrDestroyActionSet",
+        "xrGetActionStateVector2f",
+        "xrEnumerateBoundSourcesForAction",
+        "xrGetInputSourceLocalizedName",
+        "xrRequestExitSession",
+        "xrGetD3D11GraphicsRequirementsKHR",
+    };
+
+    std::vector<const char*> GetInterceptedFunctions() {
+        std::vector<const char*> names;
+        for (const char* name : DispatchTable) {
+            if (name) {
+                names.push_back(name);
+            }
+        }
+        return names;
+    }
+
+    // The resolution as it was done before the perfect hash: one string compare per intercepted function.
+    uint32_t FindDispatchSlotByCompare(const std::vector<const char*>& interceptedFunctions, const char* name) {
+        const std::string apiName(name);
+        for (uint32_t i = 0; i < interceptedFunctions.size(); i++) {
+            if (apiName == interceptedFunctions[i]) {
+                return i;
+            }
+        }
+        return NoDispatchSlot;
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(DispatchTests) {
+      public:
+        TEST_METHOD(FindsInterceptedFunctions) {
+            const auto interceptedFunctions = GetInterceptedFunctions();
+            Assert::IsTrue(interceptedFunctions.size() > 1);
+            for (const char* name : interceptedFunctions) {
+                // Use a copy, so the match cannot come from comparing the pointers.
+                const std::string copy(name);
+                const uint32_t slot = FindDispatchSlot(copy.c_str());
+                Assert::IsTrue(slot != NoDispatchSlot);
+                Assert::AreEqual(std::string(name), std::string(DispatchTable[slot]));
+            }
+        }
+
+        TEST_METHOD(IgnoresOtherFunctions) {
+            for (const char* name : PassThroughFunctions) {
+                Assert::AreEqual(NoDispatchSlot, FindDispatchSlot(name));
+            }
+
+            // Names hashing to the slot of an intercepted function.
+            Assert::AreEqual(NoDispatchSlot, FindDispatchSlot(""));
+            Assert::AreEqual(NoDispatchSlot, FindDispatchSlot("xrEndFram"));
+            Assert::AreEqual(NoDispatchSlot, FindDispatchSlot("xrEndFrameX"));
+            Assert::AreEqual(NoDispatchSlot, FindDispatchSlot("xrDestroyInstance "));
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkLookups)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkLookups) {
+            const auto interceptedFunctions = GetInterceptedFunctions();
+
+            // The names queried by a typical application: every intercepted function and as many other functions.
+            std::vector<std::string> queries(interceptedFunctions.begin(), interceptedFunctions.end());
+            queries.insert(queries.end(), std::begin(PassThroughFunctions), std::end(PassThroughFunctions));
+            constexpr int Iterations = 20000;
+
+            const auto measure = [&](auto&& find) {
+                uint32_t numFound = 0;
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (int i = 0; i < Iterations; i++) {
+                    for (const auto& name : queries) {
+                        numFound += find(name.c_str()) != NoDispatchSlot;
+                    }
+                }
+                const auto duration = std::chrono::high_resolution_clock::now() - start;
+                Assert::AreEqual((uint32_t)(Iterations * interceptedFunctions.size()), numFound);
+                return std::chrono::duration<double, std::nano>(duration).count() / (Iterations * queries.size());
+            };
+
+            const double compareNs =
+                measure([&](const char* name) { return FindDispatchSlotByCompare(interceptedFunctions, name); });
+            const double hashNs = measure([](const char* name) { return FindDispatchSlot(name); });
+
+            Logger::WriteMessage(fmt::format("{} intercepted functions, {} names queried",
+                                             interceptedFunctions.size(),
+                                             queries.size())
+                                     .c_str());
+            Logger::WriteMessage(fmt::format("string compares: {:.1f} ns per lookup", compareNs).c_str());
+            Logger::WriteMessage(fmt::format("perfect hash:    {:.1f} ns per lookup", hashNs).c_str());
+        }
+    };
+
+} // namespace tests
@@ -0,0 +1,250 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "d3dcommon.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::graphics::d3dcommon;
+
+    // Stands for the context and texture wrappers, which are the only allocations of the hooks.
+    class FakeWrapper {
+      public:
+        FakeWrapper(const void* native) : m_native(native) {
+            numCreated++;
+        }
+
+        void reset(const void* native) {
+            m_native = native;
+        }
+
+        void detach() {
+            m_native = nullptr;
+        }
+
+        const void* getNative() const {
+            return m_native;
+        }
+
+        inline static std::atomic<uint32_t> numCreated{0};
+
+      private:
+        const void* m_native;
+    };
+
+    template <typename Lease>
+    std::shared_ptr<FakeWrapper> Wrap(Lease& lease, const void* native) {
+        auto& wrapper = lease.wrapper();
+        if (!wrapper) {
+            wrapper = std::make_shared<FakeWrapper>(native);
+        } else {
+            wrapper->reset(native);
+        }
+        return wrapper;
+    }
+
+    // A hooked call: a command list (or context) binding a render target (or copying a texture).
+    struct HookEvent {
+        const void* context;
+        const void* texture;
+    };
+
+    // The OMSetRenderTargets() stream of a deferred renderer: shadow cascades, G-buffer, lighting, transparency and
+    // post-processing for each eye, with the command lists being recorded from several threads.
+    std::vector<HookEvent> MakeDeferredRendererStream(uint32_t numFrames) {
+        static uint8_t contexts[4];
+        static uint8_t textures[32];
+
+        std::vector<HookEvent> stream;
+        for (uint32_t frame = 0; frame < numFrames; frame++) {
+            for (uint32_t eye = 0; eye < 2; eye++) {
+                const void* context = &contexts[(frame + eye) % std::size(contexts)];
+                for (uint32_t cascade = 0; cascade < 4; cascade++) {
+                    stream.push_back({context, &textures[cascade]});
+                }
+                for (uint32_t gbuffer = 0; gbuffer < 4; gbuffer++) {
+                    stream.push_back({context, &textures[4 + gbuffer]});
+                }
+                stream.push_back({context, &textures[8 + eye]});
+                stream.push_back({context, &textures[10 + eye]});
+                for (uint32_t pass = 0; pass < 8; pass++) {
+                    stream.push_back({context, &textures[12 + (pass % 2) * 2 + eye]});
+                }
+                stream.push_back({context, &textures[16 + eye]});
+            }
+        }
+        return stream;
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(EventWrapperPoolTests) {
+      public:
+        TEST_METHOD_INITIALIZE(Initialize) {
+            FakeWrapper::numCreated = 0;
+        }
+
+        TEST_METHOD(ReusesReleasedWrappers) {
+            EventWrapperPool<FakeWrapper> pool;
+            int natives[2];
+
+            for (uint32_t i = 0; i < 100; i++) {
+                EventWrapperPool<FakeWrapper>::Lease lease(pool);
+                const auto wrapper = Wrap(lease, &natives[i % 2]);
+                Assert::IsTrue(wrapper->getNative() == &natives[i % 2]);
+            }
+
+            Assert::AreEqual(1u, FakeWrapper::numCreated.load());
+        }
+
+        TEST_METHOD(DetachesAfterHook) {
+            EventWrapperPool<FakeWrapper> pool;
+            int native;
+
+            const FakeWrapper* wrapper;
+            {
+                EventWrapperPool<FakeWrapper>::Lease lease(pool);
+                wrapper = Wrap(lease, &native).get();
+            }
+
+            // The pool still owns the wrapper, but it does not reference the native object anymore.
+            Assert::IsNull(wrapper->getNative());
+        }
+
+        TEST_METHOD(HeldWrapperIsNotReused) {
+            EventWrapperPool<FakeWrapper> pool;
+            int natives[2];
+
+            std::shared_ptr<FakeWrapper> held;
+            {
+                EventWrapperPool<FakeWrapper>::Lease lease(pool);
+                held = Wrap(lease, &natives[0]);
+            }
+            {
+                EventWrapperPool<FakeWrapper>::Lease lease(pool);
+                Wrap(lease, &natives[1]);
+            }
+
+            // An event handler keeping the wrapper sees it unchanged.
+            Assert::IsTrue(held->getNative() == &natives[0]);
+            Assert::AreEqual(2u, FakeWrapper::numCreated.load());
+        }
+
+        TEST_METHOD(FallsBackWhenExhausted) {
+            EventWrapperPool<FakeWrapper, 2> pool;
+            int natives[3];
+
+            EventWrapperPool<FakeWrapper, 2>::Lease lease1(pool);
+            EventWrapperPool<FakeWrapper, 2>::Lease lease2(pool);
+            EventWrapperPool<FakeWrapper, 2>::Lease lease3(pool);
+            const auto wrapper1 = Wrap(lease1, &natives[0]);
+            const auto wrapper2 = Wrap(lease2, &natives[1]);
+            const auto wrapper3 = Wrap(lease3, &natives[2]);
+
+            Assert::IsTrue(wrapper1 != wrapper2 && wrapper2 != wrapper3 && wrapper1 != wrapper3);
+            Assert::IsTrue(wrapper3->getNative() == &natives[2]);
+        }
+
+        TEST_METHOD(ClearReleasesWrappers) {
+            EventWrapperPool<FakeWrapper> pool;
+            int native;
+
+            std::weak_ptr<FakeWrapper> weak;
+            {
+                EventWrapperPool<FakeWrapper>::Lease lease(pool);
+                weak = Wrap(lease, &native);
+            }
+            Assert::IsFalse(weak.expired());
+
+            pool.clear();
+            Assert::IsTrue(weak.expired());
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkHookStream)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkHookStream) {
+            constexpr uint32_t NumFrames = 10000;
+            constexpr uint32_t NumThreads = 4;
+            const auto stream = MakeDeferredRendererStream(NumFrames);
+
+            // The event handler, like the frame analyzer, only looks at the wrappers.
+            std::atomic<uintptr_t> sink{0};
+            const auto onSetRenderTarget = [&](std::shared_ptr<FakeWrapper> context,
+                                               std::shared_ptr<FakeWrapper> renderTarget) {
+                sink.fetch_add((uintptr_t)renderTarget->getNative() ^ (uintptr_t)context->getNative(),
+                               std::memory_order_relaxed);
+            };
+
+            // Each thread replays its share of the stream.
+            const auto replay = [&](auto&& hook) {
+                FakeWrapper::numCreated = 0;
+                const auto start = std::chrono::high_resolution_clock::now();
+                std::vector<std::thread> threads;
+                for (uint32_t t = 0; t < NumThreads; t++) {
+                    threads.emplace_back([&, t] {
+                        for (size_t i = t; i < stream.size(); i += NumThreads) {
+                            hook(stream[i]);
+                        }
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join();
+                }
+                const auto duration = std::chrono::high_resolution_clock::now() - start;
+                return std::chrono::duration<double, std::nano>(duration).count() / stream.size();
+            };
+
+            const double allocatingLatency = replay([&](const HookEvent& event) {
+                onSetRenderTarget(std::make_shared<FakeWrapper>(event.context),
+                                  std::make_shared<FakeWrapper>(event.texture));
+            });
+            const uint32_t allocatingCount = FakeWrapper::numCreated;
+
+            EventWrapperPool<FakeWrapper> contextWrappers;
+            EventWrapperPool<FakeWrapper> textureWrappers;
+            const double pooledLatency = replay([&](const HookEvent& event) {
+                EventWrapperPool<FakeWrapper>::Lease contextLease(contextWrappers);
+                EventWrapperPool<FakeWrapper>::Lease renderTargetLease(textureWrappers);
+                onSetRenderTarget(Wrap(contextLease, event.context), Wrap(renderTargetLease, event.texture));
+            });
+            const uint32_t pooledCount = FakeWrapper::numCreated;
+
+            Logger::WriteMessage(fmt::format("{} hooks on {} threads", stream.size(), NumThreads).c_str());
+            Logger::WriteMessage(
+                fmt::format("make_shared: {} allocations, {:.1f} ns/hook", allocatingCount, allocatingLatency).c_str());
+            Logger::WriteMessage(
+                fmt::format("pooled:      {} allocations, {:.1f} ns/hook", pooledCount, pooledLatency).c_str());
+
+            // Only the warm-up allocates: at most one wrapper of each kind per pool slot.
+            Assert::AreEqual((uint32_t)(2 * stream.size()), allocatingCount);
+            Assert::IsTrue(pooledCount <= 2 * 8);
+        }
+    };
+
+} // namespace tests
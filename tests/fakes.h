@@ -0,0 +1,137 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// Minimal implementations of the layer's interfaces, shared by the tests.
+
+namespace fakes {
+
+    using namespace toolkit::config;
+    using namespace toolkit::graphics;
+
+    // A texture that only has a description and an identity.
+    class FakeTexture : public ITexture {
+      public:
+        FakeTexture(uint32_t width, uint32_t height, int64_t format, uint32_t arraySize = 1) {
+            m_info.width = width;
+            m_info.height = height;
+            m_info.format = format;
+            m_info.arraySize = arraySize;
+        }
+
+        Api getApi() const override {
+            return Api::D3D11;
+        }
+        std::shared_ptr<IDevice> getDevice() const override {
+            return nullptr;
+        }
+        const XrSwapchainCreateInfo& getInfo() const override {
+            return m_info;
+        }
+        bool isArray() const override {
+            return m_info.arraySize > 1;
+        }
+        std::shared_ptr<IShaderInputTextureView> getShaderResourceView(int32_t slice) const override {
+            return nullptr;
+        }
+        std::shared_ptr<IComputeShaderOutputView> getUnorderedAccessView(int32_t slice) const override {
+            return nullptr;
+        }
+        std::shared_ptr<IRenderTargetView> getRenderTargetView(int32_t slice) const override {
+            return nullptr;
+        }
+        std::shared_ptr<IDepthStencilView> getDepthStencilView(int32_t slice) const override {
+            return nullptr;
+        }
+        void uploadData(const void* buffer, uint32_t rowPitch, int32_t slice) override {
+        }
+        void copyTo(std::shared_ptr<ITexture> destination) override {
+        }
+        void copyTo(uint32_t srcX, uint32_t srcY, int32_t srcSlice, std::shared_ptr<ITexture> destination) override {
+        }
+        void copyTo(std::shared_ptr<ITexture> destination, uint32_t dstX, uint32_t dstY, int32_t dstSlice) override {
+        }
+        void saveToFile(const std::filesystem::path& path) const override {
+        }
+        void setState(D3D12_RESOURCE_STATES newState) override {
+        }
+        void pushState(D3D12_RESOURCE_STATES newState) override {
+        }
+        void popState() override {
+        }
+        void* getNativePtr() const override {
+            // The native texture is a distinct object in the application's heap.
+            return (void*)this;
+        }
+
+      private:
+        XrSwapchainCreateInfo m_info{};
+    };
+
+    // An in-memory storage, that counts the accesses of the configuration manager.
+    class FakeConfigBackend : public IConfigBackend {
+      public:
+        std::optional<int> read(const std::string& name) const override {
+            numReads++;
+            const auto it = values.find(name);
+            return it != values.cend() ? std::optional<int>(it->second) : std::nullopt;
+        }
+
+        std::optional<int> readGlobal(const std::string& name) const override {
+            const auto it = globals.find(name);
+            return it != globals.cend() ? std::optional<int>(it->second) : std::nullopt;
+        }
+
+        void write(const std::vector<std::pair<std::string, int>>& writes) override {
+            numWrites++;
+            for (const auto& value : writes) {
+                values[value.first] = value.second;
+            }
+        }
+
+        void erase(const std::string& name) override {
+            values.erase(name);
+        }
+
+        void eraseAll() override {
+            values.clear();
+        }
+
+        bool pollChanges() override {
+            return std::exchange(modified, false);
+        }
+
+        // Stands for the companion app writing a value.
+        void modify(const std::string& name, int value) {
+            values[name] = value;
+            modified = true;
+        }
+
+        std::map<std::string, int> values;
+        std::map<std::string, int> globals;
+        bool modified{false};
+        mutable uint32_t numReads{0};
+        uint32_t numWrites{0};
+    };
+
+} // namespace fakes
@@ -0,0 +1,537 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "d3dcommon.h"
+#include "eyeswapchains.h"
+#include "factories.h"
+#include "interfaces.h"
+
+#include "fakes.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace fakes;
+    using namespace toolkit::config;
+    using namespace toolkit::graphics;
+    using namespace toolkit::graphics::d3dcommon;
+    using namespace toolkit::utilities;
+
+    constexpr int64_t FormatRGBA16F = 10;
+    constexpr int64_t FormatRGB10A2 = 24;
+    constexpr int64_t FormatRGBA8 = 28;
+    constexpr int64_t FormatRGBA8sRGB = 29;
+    constexpr int64_t FormatD32 = 40;
+
+    constexpr uint32_t EyeWidth = 2016;
+    constexpr uint32_t EyeHeight = 2224;
+    constexpr uint32_t SwapchainImageCount = 3;
+
+    struct TraceEvent {
+        RenderPassEvent event;
+        std::shared_ptr<ITexture> source;
+        std::shared_ptr<ITexture> target;
+        // The eye being rendered, as the application knows it.
+        std::optional<Eye> eye;
+    };
+
+    // The render target stream of a deferred renderer, as recorded from the hooks: shadow cascades shared by both
+    // eyes, then for each eye a G-buffer, the lighting, a bloom chain and tone mapping at the eye resolution, copied
+    // into the swapchain image at the end. The UI and the mirror window come last.
+    // Some engines copy both eyes into a texture of their own instead (eg: for their own distortion pass), and none of
+    // the render targets are swapchain images.
+    class DeferredRenderer {
+      public:
+        DeferredRenderer(bool copyToSwapchain = true) : m_copyToSwapchain(copyToSwapchain) {
+            for (uint32_t i = 0; i < 4; i++) {
+                m_shadowMaps.push_back(std::make_shared<FakeTexture>(2048, 2048, FormatD32));
+            }
+            for (const int64_t format : {FormatRGBA8, FormatRGB10A2, FormatRGBA16F}) {
+                m_gBuffer.push_back(std::make_shared<FakeTexture>(EyeWidth, EyeHeight, format));
+            }
+            m_lighting = std::make_shared<FakeTexture>(EyeWidth, EyeHeight, FormatRGBA16F);
+            for (uint32_t i = 1; i <= 3; i++) {
+                m_bloom.push_back(std::make_shared<FakeTexture>(EyeWidth >> i, EyeHeight >> i, FormatRGBA16F));
+            }
+            m_toneMapped = std::make_shared<FakeTexture>(EyeWidth, EyeHeight, FormatRGBA8);
+            m_ui = std::make_shared<FakeTexture>(1024, 1024, FormatRGBA8);
+            m_mirror = std::make_shared<FakeTexture>(1920, 1080, FormatRGBA8);
+            m_stereo = std::make_shared<FakeTexture>(2 * EyeWidth, EyeHeight, FormatRGBA8);
+
+            for (uint32_t eye = 0; eye < 2; eye++) {
+                m_swapchains[eye] = (XrSwapchain)(uintptr_t)(0x1000 + eye);
+                for (uint32_t i = 0; i < SwapchainImageCount; i++) {
+                    m_swapchainImages[eye].push_back(
+                        std::make_shared<FakeTexture>(EyeWidth, EyeHeight, FormatRGBA8sRGB));
+                }
+            }
+        }
+
+        void registerSwapchains(IFrameAnalyzer& analyzer) const {
+            for (uint32_t eye = 0; eye < 2; eye++) {
+                for (uint32_t i = 0; i < SwapchainImageCount; i++) {
+                    analyzer.registerColorSwapchainImage(m_swapchains[eye], m_swapchainImages[eye][i], i, (Eye)eye);
+                }
+            }
+        }
+
+        std::vector<TraceEvent> recordFrame(uint32_t frame) const {
+            std::vector<TraceEvent> trace;
+            const auto setRenderTarget = [&](const std::shared_ptr<ITexture>& target, std::optional<Eye> eye) {
+                trace.push_back({RenderPassEvent::SetRenderTarget, nullptr, target, eye});
+            };
+
+            for (const auto& shadowMap : m_shadowMaps) {
+                setRenderTarget(shadowMap, std::nullopt);
+            }
+            for (uint32_t eye = 0; eye < 2; eye++) {
+                for (const auto& target : m_gBuffer) {
+                    setRenderTarget(target, (Eye)eye);
+                }
+                setRenderTarget(m_lighting, (Eye)eye);
+                for (auto it = m_bloom.cbegin(); it != m_bloom.cend(); it++) {
+                    setRenderTarget(*it, (Eye)eye);
+                }
+                for (auto it = m_bloom.crbegin() + 1; it != m_bloom.crend(); it++) {
+                    setRenderTarget(*it, (Eye)eye);
+                }
+                setRenderTarget(m_lighting, (Eye)eye);
+                setRenderTarget(m_toneMapped, (Eye)eye);
+                trace.push_back({RenderPassEvent::CopyTexture,
+                                 m_toneMapped,
+                                 m_copyToSwapchain ? m_swapchainImages[eye][frame % SwapchainImageCount] : m_stereo,
+                                 (Eye)eye});
+            }
+            setRenderTarget(m_ui, std::nullopt);
+            setRenderTarget(m_mirror, std::nullopt);
+
+            return trace;
+        }
+
+        XrSwapchain getSwapchain(Eye eye) const {
+            return m_swapchains[(uint32_t)eye];
+        }
+
+        const std::vector<std::shared_ptr<ITexture>>& getSwapchainImages(Eye eye) const {
+            return m_swapchainImages[(uint32_t)eye];
+        }
+
+      private:
+        const bool m_copyToSwapchain;
+        std::vector<std::shared_ptr<ITexture>> m_shadowMaps;
+        std::vector<std::shared_ptr<ITexture>> m_gBuffer;
+        std::shared_ptr<ITexture> m_lighting;
+        std::vector<std::shared_ptr<ITexture>> m_bloom;
+        std::shared_ptr<ITexture> m_toneMapped;
+        std::shared_ptr<ITexture> m_ui;
+        std::shared_ptr<ITexture> m_mirror;
+        std::shared_ptr<ITexture> m_stereo;
+
+        XrSwapchain m_swapchains[2];
+        std::vector<std::shared_ptr<ITexture>> m_swapchainImages[2];
+    };
+
+    void ReplayEvent(IFrameAnalyzer& analyzer, const TraceEvent& event) {
+        if (event.event == RenderPassEvent::SetRenderTarget) {
+            analyzer.onSetRenderTarget(nullptr, event.target);
+        } else {
+            analyzer.onCopyTexture(event.source, event.target);
+        }
+    }
+
+    struct ReplayResult {
+        // The eye render passes for which the analyzer had no hint or the wrong one.
+        uint32_t numMissedPasses{0};
+        uint32_t numWrongPasses{0};
+    };
+
+    ReplayResult ReplayFrame(IFrameAnalyzer& analyzer, const std::vector<TraceEvent>& trace) {
+        ReplayResult result;
+        analyzer.resetForFrame();
+        for (const auto& event : trace) {
+            ReplayEvent(analyzer, event);
+            if (event.eye && event.event == RenderPassEvent::SetRenderTarget) {
+                const auto hint = analyzer.getEyeHint();
+                result.numMissedPasses += !hint;
+                result.numWrongPasses += hint && hint != event.eye;
+            }
+        }
+        analyzer.prepareForEndFrame();
+        return result;
+    }
+
+    // The previous look-up of the swapchain images (one ordered set per eye), as the reference for the benchmark.
+    class SetBasedEyeLookup {
+      public:
+        void registerImage(const std::shared_ptr<ITexture>& texture, Eye eye) {
+            m_eyeSwapchainImages[(uint32_t)eye].insert(texture->getNativePtr());
+        }
+
+        std::optional<Eye> find(const std::shared_ptr<ITexture>& texture) const {
+            const void* nativePtr = texture->getNativePtr();
+            if (m_eyeSwapchainImages[0].find(nativePtr) != m_eyeSwapchainImages[0].cend()) {
+                return Eye::Left;
+            }
+            if (m_eyeSwapchainImages[1].find(nativePtr) != m_eyeSwapchainImages[1].cend()) {
+                return Eye::Right;
+            }
+            return std::nullopt;
+        }
+
+      private:
+        std::set<const void*> m_eyeSwapchainImages[2];
+    };
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(FrameAnalyzerTests) {
+        std::shared_ptr<FakeConfigBackend> m_backend = std::make_shared<FakeConfigBackend>();
+        std::shared_ptr<IConfigManager> m_configManager = CreateConfigManager(m_backend);
+
+        std::shared_ptr<IFrameAnalyzer> createFrameAnalyzer(
+            FrameAnalyzerHeuristic heuristic = FrameAnalyzerHeuristic::Unknown) const {
+            return CreateFrameAnalyzer(m_configManager, nullptr, EyeWidth, EyeHeight, heuristic);
+        }
+
+      public:
+        TEST_METHOD(DetectsDeferredCopy) {
+            DeferredRenderer renderer;
+            auto analyzer = createFrameAnalyzer();
+            renderer.registerSwapchains(*analyzer);
+
+            for (uint32_t frame = 0; frame < 10; frame++) {
+                analyzer->resetForFrame();
+                for (const auto& event : renderer.recordFrame(frame)) {
+                    ReplayEvent(*analyzer, event);
+
+                    // Once detected, the eye is known when each pass begins and switches after the copy.
+                    if (frame > 0 && event.eye && event.event == RenderPassEvent::SetRenderTarget) {
+                        Assert::IsTrue(analyzer->getEyeHint() == event.eye);
+                    }
+                }
+                analyzer->prepareForEndFrame();
+                Assert::IsTrue(analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::DeferredCopy);
+            }
+        }
+
+        TEST_METHOD(DetectsForwardRender) {
+            DeferredRenderer renderer;
+            auto analyzer = createFrameAnalyzer();
+            renderer.registerSwapchains(*analyzer);
+
+            analyzer->resetForFrame();
+            analyzer->onSetRenderTarget(nullptr, renderer.getSwapchainImages(Eye::Left)[0]);
+            Assert::IsFalse(analyzer->getEyeHint().has_value());
+            analyzer->onSetRenderTarget(nullptr, renderer.getSwapchainImages(Eye::Right)[0]);
+            analyzer->prepareForEndFrame();
+            Assert::IsTrue(analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::ForwardRender);
+
+            analyzer->resetForFrame();
+            analyzer->onSetRenderTarget(nullptr, renderer.getSwapchainImages(Eye::Right)[1]);
+            Assert::IsTrue(analyzer->getEyeHint() == Eye::Right);
+            analyzer->onSetRenderTarget(nullptr, renderer.getSwapchainImages(Eye::Left)[1]);
+            Assert::IsTrue(analyzer->getEyeHint() == Eye::Left);
+        }
+
+        TEST_METHOD(SharedSwapchainIsLeftEye) {
+            // The same image registered for both eyes (eg: a double-wide swapchain) was always reported as the left
+            // eye, in whichever order it is registered.
+            auto image = std::make_shared<FakeTexture>(EyeWidth, EyeHeight, FormatRGBA8sRGB);
+            const auto swapchain = (XrSwapchain)(uintptr_t)0x2000;
+            for (const Eye first : {Eye::Left, Eye::Right}) {
+                auto analyzer = createFrameAnalyzer(FrameAnalyzerHeuristic::ForwardRender);
+                analyzer->registerColorSwapchainImage(swapchain, image, 0, first);
+                analyzer->registerColorSwapchainImage(
+                    swapchain, image, 0, first == Eye::Left ? Eye::Right : Eye::Left);
+
+                analyzer->resetForFrame();
+                analyzer->onSetRenderTarget(nullptr, image);
+                analyzer->prepareForEndFrame();
+                Assert::IsTrue(analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::Unknown);
+            }
+        }
+
+        TEST_METHOD(IgnoresOtherTextures) {
+            DeferredRenderer renderer;
+            auto analyzer = createFrameAnalyzer(FrameAnalyzerHeuristic::ForwardRender);
+            renderer.registerSwapchains(*analyzer);
+
+            // Same size as the swapchains but not a swapchain image, and a texture array at the same address.
+            analyzer->resetForFrame();
+            analyzer->onSetRenderTarget(nullptr, std::make_shared<FakeTexture>(EyeWidth, EyeHeight, FormatRGBA8));
+            analyzer->onSetRenderTarget(nullptr, std::make_shared<FakeTexture>(EyeWidth, EyeHeight, FormatRGBA8, 2));
+            analyzer->onSetRenderTarget(nullptr, std::make_shared<FakeTexture>(1024, 1024, FormatRGBA8));
+            analyzer->prepareForEndFrame();
+            Assert::IsTrue(analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::Unknown);
+            Assert::IsFalse(analyzer->getEyeHint().has_value());
+        }
+
+        TEST_METHOD(SwapchainAcquisitionFallback) {
+            DeferredRenderer renderer;
+            auto analyzer = createFrameAnalyzer(FrameAnalyzerHeuristic::Fallback);
+            renderer.registerSwapchains(*analyzer);
+
+            // The fallback is only committed to after a delay, in case a better heuristic is found.
+            for (uint32_t frame = 0; frame < 100; frame++) {
+                analyzer->resetForFrame();
+                analyzer->prepareForEndFrame();
+            }
+            Assert::IsTrue(analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::Fallback);
+
+            analyzer->resetForFrame();
+            analyzer->onAcquireSwapchain(renderer.getSwapchain(Eye::Right));
+            Assert::IsTrue(analyzer->getEyeHint() == Eye::Right);
+            analyzer->onReleaseSwapchain(renderer.getSwapchain(Eye::Right));
+            Assert::IsTrue(analyzer->getEyeHint() == Eye::Left);
+
+            // Unknown swapchains are ignored.
+            analyzer->onAcquireSwapchain((XrSwapchain)(uintptr_t)0x3000);
+            Assert::IsTrue(analyzer->getEyeHint() == Eye::Left);
+        }
+
+        TEST_METHOD(LearnsSignatureWithoutSwapchainRenderTarget) {
+            DeferredRenderer renderer(false /* copyToSwapchain */);
+            auto analyzer = createFrameAnalyzer();
+            renderer.registerSwapchains(*analyzer);
+
+            uint32_t frame = 0;
+            for (; frame < 100 && analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::Unknown; frame++) {
+                ReplayFrame(*analyzer, renderer.recordFrame(frame));
+            }
+            Assert::IsTrue(analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::LearnedSignature);
+            Logger::WriteMessage(fmt::format("signature learned after {} frames", frame).c_str());
+
+            for (uint32_t i = 0; i < 100; i++, frame++) {
+                const auto result = ReplayFrame(*analyzer, renderer.recordFrame(frame));
+                Assert::AreEqual(0u, result.numMissedPasses);
+                Assert::AreEqual(0u, result.numWrongPasses);
+            }
+
+            // The signature is persisted for the next session.
+            m_configManager->tick();
+            Assert::IsTrue(m_configManager->getValue(SettingFrameAnalyzerSwitchOccurrence) > 0);
+        }
+
+        TEST_METHOD(PersistedSignaturePredictsFromFirstFrame) {
+            DeferredRenderer renderer(false /* copyToSwapchain */);
+            {
+                auto analyzer = createFrameAnalyzer();
+                renderer.registerSwapchains(*analyzer);
+                for (uint32_t frame = 0; frame < 100; frame++) {
+                    ReplayFrame(*analyzer, renderer.recordFrame(frame));
+                }
+            }
+
+            auto analyzer = createFrameAnalyzer();
+            renderer.registerSwapchains(*analyzer);
+            Assert::IsTrue(analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::LearnedSignature);
+            for (uint32_t frame = 0; frame < 200; frame++) {
+                const auto result = ReplayFrame(*analyzer, renderer.recordFrame(frame));
+                Assert::AreEqual(0u, result.numMissedPasses);
+                Assert::AreEqual(0u, result.numWrongPasses);
+            }
+        }
+
+        TEST_METHOD(StaleSignatureIsRelearned) {
+            // A signature from a previous version of the application, that does not match anymore.
+            m_backend->values[SettingFrameAnalyzerSwitchPass] = 0x12345678;
+            m_backend->values[SettingFrameAnalyzerSwitchOccurrence] = 2;
+
+            DeferredRenderer renderer(false /* copyToSwapchain */);
+            auto analyzer = createFrameAnalyzer();
+            renderer.registerSwapchains(*analyzer);
+            Assert::IsTrue(analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::LearnedSignature);
+
+            // The persisted signature is trusted for the first frame. After that, no hint rather than a wrong one,
+            // until the actual signature is learned.
+            const auto firstFrame = ReplayFrame(*analyzer, renderer.recordFrame(0));
+            Assert::AreEqual(0u, firstFrame.numMissedPasses);
+            uint32_t frame = 1;
+            for (; frame < 200; frame++) {
+                const auto result = ReplayFrame(*analyzer, renderer.recordFrame(frame));
+                Assert::AreEqual(0u, result.numWrongPasses);
+                if (!result.numMissedPasses) {
+                    break;
+                }
+            }
+            Logger::WriteMessage(fmt::format("signature learned again after {} frames", frame).c_str());
+            Assert::IsTrue(frame < 100);
+            Assert::AreNotEqual(0x12345678, m_configManager->peekValue(SettingFrameAnalyzerSwitchPass));
+        }
+
+        TEST_METHOD(StaleSignatureFallsBack) {
+            m_backend->values[SettingFrameAnalyzerSwitchPass] = 0x12345678;
+            m_backend->values[SettingFrameAnalyzerSwitchOccurrence] = 2;
+
+            // The application does not render the eyes one after the other anymore: no signature can be learned,
+            // but the swapchain images are written to.
+            DeferredRenderer renderer;
+            auto analyzer = createFrameAnalyzer();
+            renderer.registerSwapchains(*analyzer);
+            std::vector<TraceEvent> trace;
+            for (const auto& event : renderer.recordFrame(0)) {
+                if (event.event == RenderPassEvent::CopyTexture) {
+                    trace.push_back(event);
+                }
+            }
+
+            uint32_t frame = 0;
+            for (; frame < 1000 && analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::LearnedSignature;
+                 frame++) {
+                ReplayFrame(*analyzer, trace);
+            }
+            Assert::AreEqual(100u, frame);
+            Assert::IsTrue(analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::DeferredCopy);
+
+            // The stale signature is not used by the next session.
+            m_configManager->tick();
+            Assert::IsFalse(m_backend->values.count(SettingFrameAnalyzerSwitchPass));
+            Assert::IsTrue(createFrameAnalyzer()->getCurrentHeuristic() == FrameAnalyzerHeuristic::Unknown);
+        }
+
+        TEST_METHOD(StaleSignatureFallsBackToSwapchainAcquisition) {
+            m_backend->values[SettingFrameAnalyzerSwitchPass] = 0x12345678;
+            m_backend->values[SettingFrameAnalyzerSwitchOccurrence] = 2;
+
+            DeferredRenderer renderer;
+            auto analyzer = createFrameAnalyzer();
+            renderer.registerSwapchains(*analyzer);
+
+            // Nothing to learn from.
+            uint32_t frame = 0;
+            for (; frame < 1000 && analyzer->getCurrentHeuristic() != FrameAnalyzerHeuristic::Fallback; frame++) {
+                ReplayFrame(*analyzer, {});
+            }
+            Assert::AreEqual(200u, frame);
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkSignatureSearch)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkSignatureSearch) {
+            // The worst case: a long frame without any repeat (eg: a menu), so the learner keeps searching.
+            constexpr uint32_t NumFrames = 90 * 10;
+            constexpr uint32_t NumPasses = 1000;
+
+            const auto replay = [&](bool isVarying) {
+                auto learner = CreateRenderPassLearner();
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (uint32_t frame = 0; frame < NumFrames; frame++) {
+                    learner->resetForFrame();
+                    for (uint32_t pass = 0; pass < NumPasses; pass++) {
+                        learner->recordPass(RenderPassEvent::SetRenderTarget,
+                                            pass + 1,
+                                            (isVarying && pass == 0) ? frame + 1 : 1,
+                                            FormatRGBA8);
+                    }
+                    learner->endFrame();
+                }
+                const auto duration = std::chrono::high_resolution_clock::now() - start;
+                Assert::IsFalse(learner->getSignature().isValid());
+                return std::chrono::duration<double, std::micro>(duration).count() / NumFrames;
+            };
+
+            const auto varying = replay(true);
+            const auto repeating = replay(false);
+            Logger::WriteMessage(fmt::format("{} passes per frame while learning: {:.1f} us per frame when the passes "
+                                             "change every frame, {:.1f} us when they repeat",
+                                             NumPasses,
+                                             varying,
+                                             repeating)
+                                     .c_str());
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkDeferredRendererStream)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkDeferredRendererStream) {
+            constexpr uint32_t NumFrames = 90 * 60;
+
+            DeferredRenderer renderer;
+            std::vector<std::vector<TraceEvent>> trace;
+            size_t numEvents = 0;
+            for (uint32_t frame = 0; frame < NumFrames; frame++) {
+                trace.push_back(renderer.recordFrame(frame));
+                numEvents += trace.back().size();
+            }
+
+            // The hooks, once the deferred rendering is detected.
+            auto analyzer = createFrameAnalyzer();
+            renderer.registerSwapchains(*analyzer);
+            uint32_t numEyeHints = 0;
+            const auto startAnalyzer = std::chrono::high_resolution_clock::now();
+            for (const auto& frame : trace) {
+                analyzer->resetForFrame();
+                for (const auto& event : frame) {
+                    ReplayEvent(*analyzer, event);
+                    numEyeHints += analyzer->getEyeHint().has_value();
+                }
+                analyzer->prepareForEndFrame();
+            }
+            const auto analyzerDuration = std::chrono::high_resolution_clock::now() - startAnalyzer;
+            Assert::IsTrue(analyzer->getCurrentHeuristic() == FrameAnalyzerHeuristic::DeferredCopy);
+            Assert::IsTrue(numEyeHints > numEvents * 9 / 10);
+
+            // Only the membership look-ups, with the table used by the frame analyzer.
+            SetBasedEyeLookup setLookup;
+            EyeSwapchainImages eyeSwapchainImages;
+            for (const Eye eye : {Eye::Left, Eye::Right}) {
+                const auto& images = renderer.getSwapchainImages(eye);
+                for (uint32_t i = 0; i < images.size(); i++) {
+                    setLookup.registerImage(images[i], eye);
+                    eyeSwapchainImages.registerImage(renderer.getSwapchain(eye), images[i], i, eye);
+                }
+            }
+            const auto replayLookups = [&](const auto& isEyeSwapchainImage) {
+                uint32_t numFound = 0;
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (const auto& frame : trace) {
+                    for (const auto& event : frame) {
+                        numFound += isEyeSwapchainImage(event.target);
+                    }
+                }
+                const auto duration = std::chrono::high_resolution_clock::now() - start;
+                Assert::AreEqual(NumFrames * 2, numFound);
+                return std::chrono::duration<double, std::nano>(duration).count() / numEvents;
+            };
+            const auto setLookupDuration = replayLookups(
+                [&](const std::shared_ptr<ITexture>& texture) { return setLookup.find(texture).has_value(); });
+            const auto flatLookupDuration = replayLookups(
+                [&](const std::shared_ptr<ITexture>& texture) { return eyeSwapchainImages.find(texture) != nullptr; });
+
+            Logger::WriteMessage(
+                fmt::format("{} events per frame: {:.1f} ns per event through the frame analyzer; look-ups alone: "
+                            "{:.1f} ns with std::set, {:.1f} ns with the flat table",
+                            numEvents / NumFrames,
+                            std::chrono::duration<double, std::nano>(analyzerDuration).count() / numEvents,
+                            setLookupDuration,
+                            flatLookupDuration)
+                    .c_str());
+        }
+    };
+
+} // namespace tests
@@ -0,0 +1,198 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::utilities;
+
+    constexpr int64_t Microseconds = 1'000;
+    constexpr int64_t Milliseconds = 1'000'000;
+
+    // A clock where time only advances when the throttler sleeps or spins (or when the test says so). Sleeping
+    // overshoots its target by a random amount, like the OS scheduler would.
+    class SimulatedClock : public IClock {
+      public:
+        SimulatedClock(double meanSleepOvershoot) : m_overshoot(1.0 / meanSleepOvershoot) {
+        }
+
+        int64_t now() const override {
+            return m_time;
+        }
+
+        void sleepUntil(int64_t time) override {
+            if (time > m_time) {
+                m_time = time + static_cast<int64_t>(m_overshoot(m_random));
+            }
+        }
+
+        void spin() override {
+            m_time += SpinDuration;
+        }
+
+        void advance(int64_t duration) {
+            m_time += duration;
+        }
+
+        // Emulate the runtime's xrWaitFrame() returning on the next V-sync.
+        void waitForVsync(int64_t displayPeriod) {
+            m_time = (m_time / displayPeriod + 1) * displayPeriod;
+        }
+
+        static constexpr int64_t SpinDuration = 200;
+
+      private:
+        int64_t m_time{1'000 * Milliseconds};
+        std::mt19937 m_random{1};
+        std::exponential_distribution<double> m_overshoot;
+    };
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(FrameThrottlerTests) {
+      public:
+        TEST_METHOD(NoTargetDoesNotWait) {
+            auto clock = std::make_shared<SimulatedClock>(300.0 * Microseconds);
+            auto throttler = CreateFrameThrottler(clock);
+
+            const int64_t start = clock->now();
+            throttler->throttle(0);
+            Assert::AreEqual(start, clock->now());
+        }
+
+        TEST_METHOD(PacesWithoutDisplayPeriod) {
+            auto clock = std::make_shared<SimulatedClock>(300.0 * Microseconds);
+            auto throttler = CreateFrameThrottler(clock);
+
+            // 60 Hz with 2 ms of application work per frame.
+            const auto intervals = runFrames(*clock, *throttler, 60, 0, 2 * Milliseconds);
+            Assert::AreEqual(1e9 / 60, average(intervals), 50.0 * Microseconds);
+
+            // Never early, and almost always within one spin of the deadline. A late wake-up happens when the
+            // scheduler overshoots by more than the spin threshold (the next deadline is not pushed back).
+            size_t lateWakeUps = 0;
+            for (const auto error : m_wakeUpErrors) {
+                Assert::IsTrue(error >= 0);
+                if (error > SimulatedClock::SpinDuration) {
+                    lateWakeUps++;
+                }
+            }
+            Assert::IsTrue(lateWakeUps <= m_wakeUpErrors.size() / 20);
+        }
+
+        TEST_METHOD(SnapsToDisplayPeriod) {
+            auto clock = std::make_shared<SimulatedClock>(300.0 * Microseconds);
+            auto throttler = CreateFrameThrottler(clock);
+
+            // 45 Hz on a 90 Hz display: every other V-sync.
+            const int64_t displayPeriod = 11'111'111;
+            const auto intervals = runFrames(*clock, *throttler, 45, displayPeriod, 3 * Milliseconds);
+            for (const auto interval : intervals) {
+                Assert::AreEqual(2 * displayPeriod, interval);
+            }
+        }
+
+        TEST_METHOD(DoesNotCatchUpAfterStall) {
+            auto clock = std::make_shared<SimulatedClock>(300.0 * Microseconds);
+            auto throttler = CreateFrameThrottler(clock);
+
+            runFrames(*clock, *throttler, 60, 0, 2 * Milliseconds);
+
+            // A loading screen.
+            clock->advance(500 * Milliseconds);
+
+            // The next frames must not be rushed to make up for the lost time.
+            const auto intervals = runFrames(*clock, *throttler, 60, 0, 2 * Milliseconds, 1 /* warmUpFrames */);
+            for (const auto interval : intervals) {
+                Assert::IsTrue(interval > 1'000'000'000 / 60 / 2);
+            }
+            Assert::AreEqual(1e9 / 60, average(intervals), 50.0 * Microseconds);
+        }
+
+        TEST_METHOD(AdaptsSpinThreshold) {
+            // A precise timer should lead to spinning less than the maximum.
+            {
+                auto clock = std::make_shared<SimulatedClock>(50.0 * Microseconds);
+                auto throttler = CreateFrameThrottler(clock);
+                runFrames(*clock, *throttler, 60, 0, 2 * Milliseconds);
+                Assert::IsTrue(throttler->getSpinThreshold() < 500 * Microseconds);
+            }
+
+            // A coarse timer (eg: 1 ms scheduler quantum) should lead to spinning up to the maximum.
+            {
+                auto clock = std::make_shared<SimulatedClock>(1.5 * Milliseconds);
+                auto throttler = CreateFrameThrottler(clock);
+                runFrames(*clock, *throttler, 60, 0, 2 * Milliseconds);
+                Assert::AreEqual(int64_t(2 * Milliseconds), throttler->getSpinThreshold());
+            }
+        }
+
+      private:
+        // Run the frame loop for a while, and return the intervals between the frames after warm up (the first frame is
+        // the reference for the first interval, hence at least 1 frame of warm up).
+        std::vector<int64_t> runFrames(SimulatedClock& clock,
+                                       IFrameThrottler& throttler,
+                                       uint32_t targetFrameRate,
+                                       int64_t displayPeriod,
+                                       int64_t frameWork,
+                                       int warmUpFrames = 10) {
+            constexpr int Frames = 200;
+
+            std::vector<int64_t> intervals;
+            m_wakeUpErrors.clear();
+            int64_t previous = 0;
+            for (int i = 0; i < warmUpFrames + Frames; i++) {
+                throttler.throttle(targetFrameRate);
+
+                if (displayPeriod) {
+                    clock.waitForVsync(displayPeriod);
+                    throttler.onFrameWaited(displayPeriod);
+                }
+
+                if (i >= warmUpFrames) {
+                    intervals.push_back(clock.now() - previous);
+                    m_wakeUpErrors.push_back(throttler.getLastWakeUpError());
+                }
+                previous = clock.now();
+
+                clock.advance(frameWork);
+            }
+
+            return intervals;
+        }
+
+        static double average(const std::vector<int64_t>& values) {
+            return std::accumulate(values.cbegin(), values.cend(), 0.0) / values.size();
+        }
+
+        std::vector<int64_t> m_wakeUpErrors;
+    };
+
+} // namespace tests
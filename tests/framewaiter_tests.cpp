@@ -0,0 +1,207 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::utilities;
+
+    constexpr XrDuration DisplayPeriod = 11'111'111;
+
+    // A runtime whose xrWaitFrame() blocks until the test lets the next V-sync happen.
+    class FakeRuntime {
+      public:
+        XrResult waitFrame(XrFrameState& frameState) {
+            std::unique_lock lock(m_lock);
+            m_waiting = true;
+            m_stateChanged.notify_all();
+            m_stateChanged.wait(lock, [&] { return m_vsyncs > 0; });
+            m_vsyncs--;
+            m_waiting = false;
+            m_numWaits++;
+
+            if (m_nextResult != XR_SUCCESS) {
+                return std::exchange(m_nextResult, XR_SUCCESS);
+            }
+
+            m_displayTime += DisplayPeriod;
+            frameState.predictedDisplayTime = m_displayTime;
+            frameState.predictedDisplayPeriod = DisplayPeriod;
+            frameState.shouldRender = XR_TRUE;
+            return XR_SUCCESS;
+        }
+
+        void vsync() {
+            std::unique_lock lock(m_lock);
+            m_vsyncs++;
+            m_stateChanged.notify_all();
+        }
+
+        void waitUntilBlocked() {
+            std::unique_lock lock(m_lock);
+            m_stateChanged.wait(lock, [&] { return m_waiting; });
+        }
+
+        void failNextWait(XrResult result) {
+            std::unique_lock lock(m_lock);
+            m_nextResult = result;
+        }
+
+        XrTime getDisplayTime() const {
+            std::unique_lock lock(m_lock);
+            return m_displayTime;
+        }
+
+        uint32_t getNumWaits() const {
+            std::unique_lock lock(m_lock);
+            return m_numWaits;
+        }
+
+        std::function<XrResult(XrFrameState&)> getWaitFrame() {
+            return [this](XrFrameState& frameState) { return waitFrame(frameState); };
+        }
+
+      private:
+        mutable std::mutex m_lock;
+        std::condition_variable m_stateChanged;
+        uint32_t m_vsyncs{0};
+        bool m_waiting{false};
+        uint32_t m_numWaits{0};
+        XrResult m_nextResult{XR_SUCCESS};
+        XrTime m_displayTime{1'000'000'000};
+    };
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(AsyncFrameWaiterTests) {
+      public:
+        TEST_METHOD(PollDoesNotBlockOnRuntime) {
+            FakeRuntime runtime;
+            auto waiter = CreateAsyncFrameWaiter(runtime.getWaitFrame());
+
+            waiter->start(runtime.getDisplayTime(), DisplayPeriod);
+            Assert::IsTrue(waiter->isPending());
+            runtime.waitUntilBlocked();
+
+            // The runtime frame is not ready: the application is handed an extrapolated frame one period ahead.
+            XrFrameState frameState{XR_TYPE_FRAME_STATE};
+            waiter->pollFrame(frameState);
+            Assert::AreEqual(runtime.getDisplayTime() + DisplayPeriod, frameState.predictedDisplayTime);
+            Assert::AreEqual(DisplayPeriod, frameState.predictedDisplayPeriod);
+            Assert::IsFalse(waiter->waitForFrame(10ms));
+
+            runtime.vsync();
+            waiter->waitForFrame();
+            const XrFrameState runtimeFrameState = waiter->consumeFrame();
+            Assert::AreEqual(runtime.getDisplayTime(), runtimeFrameState.predictedDisplayTime);
+            Assert::IsFalse(waiter->isPending());
+        }
+
+        TEST_METHOD(PipelineDepthBoundsFramesAhead) {
+            for (uint32_t depth = 1; depth <= 3; depth++) {
+                FakeRuntime runtime;
+                auto waiter = CreateAsyncFrameWaiter(runtime.getWaitFrame());
+                waiter->setPipelineDepth(depth);
+
+                waiter->start(runtime.getDisplayTime(), DisplayPeriod);
+                runtime.waitUntilBlocked();
+
+                // The first polls up to the pipeline depth return immediately, the next one blocks on the runtime.
+                XrFrameState frameState{XR_TYPE_FRAME_STATE};
+                for (uint32_t i = 0; i < depth; i++) {
+                    waiter->pollFrame(frameState);
+                }
+                auto blockedPoll = std::async(std::launch::async, [&] {
+                    XrFrameState frameState{XR_TYPE_FRAME_STATE};
+                    waiter->pollFrame(frameState);
+                    return frameState;
+                });
+                Assert::IsTrue(blockedPoll.wait_for(50ms) == std::future_status::timeout);
+
+                runtime.vsync();
+                const XrFrameState blockedFrameState = blockedPoll.get();
+
+                // Extrapolated from the runtime frame that was just waited.
+                Assert::AreEqual(runtime.getDisplayTime() + depth * DisplayPeriod,
+                                 blockedFrameState.predictedDisplayTime);
+                waiter->consumeFrame();
+            }
+        }
+
+        TEST_METHOD(OneRuntimeWaitPerStart) {
+            FakeRuntime runtime;
+            auto waiter = CreateAsyncFrameWaiter(runtime.getWaitFrame());
+
+            for (uint32_t i = 1; i <= 10; i++) {
+                waiter->start(runtime.getDisplayTime(), DisplayPeriod);
+
+                // Starting again while pending is a no-op.
+                waiter->start(runtime.getDisplayTime(), DisplayPeriod);
+
+                runtime.vsync();
+                waiter->waitForFrame();
+                waiter->consumeFrame();
+                Assert::AreEqual(i, runtime.getNumWaits());
+            }
+        }
+
+        TEST_METHOD(RuntimeFailureDoesNotHang) {
+            FakeRuntime runtime;
+            auto waiter = CreateAsyncFrameWaiter(runtime.getWaitFrame());
+
+            const XrTime lastDisplayTime = runtime.getDisplayTime();
+            runtime.failNextWait(XR_ERROR_RUNTIME_FAILURE);
+            waiter->start(lastDisplayTime, DisplayPeriod);
+
+            XrFrameState frameState{XR_TYPE_FRAME_STATE};
+            waiter->pollFrame(frameState);
+            runtime.vsync();
+
+            // A blocked poll must be released with an extrapolated frame state.
+            waiter->pollFrame(frameState);
+            Assert::AreEqual(lastDisplayTime + DisplayPeriod, frameState.predictedDisplayTime);
+            Assert::IsTrue(waiter->waitForFrame(1000ms));
+            Assert::AreEqual(lastDisplayTime + DisplayPeriod, waiter->consumeFrame().predictedDisplayTime);
+        }
+
+        TEST_METHOD(DestroyWhileIdle) {
+            FakeRuntime runtime;
+            {
+                auto waiter = CreateAsyncFrameWaiter(runtime.getWaitFrame());
+                waiter->start(runtime.getDisplayTime(), DisplayPeriod);
+                runtime.vsync();
+                waiter->waitForFrame();
+                waiter->consumeFrame();
+            }
+            Assert::AreEqual(1u, runtime.getNumWaits());
+        }
+    };
+
+} // namespace tests
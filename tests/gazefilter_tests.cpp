@@ -0,0 +1,209 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::input;
+    using namespace toolkit::utilities;
+
+    constexpr XrDuration FramePeriod = 11'111'111; // 90Hz
+    constexpr XrDuration Millisecond = 1'000'000;
+
+    struct GazeSample {
+        XrTime time;
+        XrVector2f trueGaze;
+        XrVector2f measuredGaze;
+    };
+
+    // A recorded-like trace: a fixation, a 0.5 NDC horizontal saccade lasting 40ms, and another fixation. The tracker
+    // adds noise, and reports the gaze as it was the given latency ago.
+    std::vector<GazeSample> MakeTrace(XrDuration latency, float noise = 0.01f) {
+        constexpr XrTime SaccadeStart = 500 * Millisecond;
+        constexpr XrDuration SaccadeDuration = 40 * Millisecond;
+        const auto gazeAt = [&](XrTime time) -> XrVector2f {
+            const float progress = std::clamp((float)(time - SaccadeStart) / SaccadeDuration, 0.f, 1.f);
+            // Smooth step, like the velocity profile of a saccade.
+            return {-0.25f + 0.5f * progress * progress * (3 - 2 * progress), 0.1f};
+        };
+
+        std::mt19937 random(42);
+        std::normal_distribution<float> distribution(0.f, noise);
+        std::vector<GazeSample> trace;
+        for (XrTime time = 0; time < 1000 * Millisecond; time += FramePeriod) {
+            const XrVector2f measured = gazeAt(time - latency);
+            trace.push_back(
+                {time, gazeAt(time), {measured.x + distribution(random), measured.y + distribution(random)}});
+        }
+        return trace;
+    }
+
+    bool IsDuringSaccade(XrTime time) {
+        return time >= 500 * Millisecond && time < 540 * Millisecond;
+    }
+
+    struct ReplayResult {
+        float meanFixationError{0};
+        float meanSaccadeError{0};
+        uint32_t numSaccadeFrames{0};
+        uint32_t numSaccadeFramesOutsideSaccade{0};
+    };
+
+    // Replay the trace like the eye tracker does: the sample is submitted at its age, then the gaze is predicted for
+    // the display time.
+    ReplayResult Replay(IGazeFilter& filter, const std::vector<GazeSample>& trace, XrDuration latency) {
+        ReplayResult result;
+        uint32_t numFixationFrames = 0;
+        uint32_t numSaccadeFrames = 0;
+        for (const auto& sample : trace) {
+            const XrVector2f measured[ViewCount] = {sample.measuredGaze, sample.measuredGaze};
+            filter.addSample(sample.time - latency, measured);
+            XrVector2f gaze[ViewCount];
+            filter.getGaze(sample.time, gaze);
+
+            const float error = std::hypot(gaze[0].x - sample.trueGaze.x, gaze[0].y - sample.trueGaze.y);
+            // Leave the filter some time to settle after the saccade.
+            if (IsDuringSaccade(sample.time)) {
+                result.meanSaccadeError += error;
+                numSaccadeFrames++;
+            } else if (sample.time > 200 * Millisecond &&
+                       (sample.time < 500 * Millisecond || sample.time > 800 * Millisecond)) {
+                result.meanFixationError += error;
+                numFixationFrames++;
+            }
+
+            if (filter.getMovement() == GazeMovement::Saccade) {
+                result.numSaccadeFrames++;
+                if (sample.time < 500 * Millisecond || sample.time > 600 * Millisecond) {
+                    result.numSaccadeFramesOutsideSaccade++;
+                }
+            }
+        }
+        result.meanFixationError /= numFixationFrames;
+        result.meanSaccadeError /= numSaccadeFrames;
+        return result;
+    }
+
+    ReplayResult ReplayRaw(const std::vector<GazeSample>& trace) {
+        GazeFilterParameters parameters;
+        parameters.enabled = false;
+        auto filter = CreateGazeFilter(parameters);
+        return Replay(*filter, trace, 0);
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(GazeFilterTests) {
+      public:
+        TEST_METHOD(SmoothsFixations) {
+            const auto trace = MakeTrace(0);
+            const auto raw = ReplayRaw(trace);
+            const auto filtered = Replay(*CreateGazeFilter({}), trace, 0);
+
+            Logger::WriteMessage(fmt::format("fixation error: {:.4f} NDC raw, {:.4f} NDC filtered",
+                                             raw.meanFixationError,
+                                             filtered.meanFixationError)
+                                     .c_str());
+            Assert::IsTrue(filtered.meanFixationError < raw.meanFixationError / 2);
+        }
+
+        TEST_METHOD(DetectsSaccade) {
+            const auto result = Replay(*CreateGazeFilter({}), MakeTrace(0), 0);
+
+            Assert::IsTrue(result.numSaccadeFrames > 0);
+            Assert::AreEqual(0u, result.numSaccadeFramesOutsideSaccade);
+        }
+
+        TEST_METHOD(DisabledPassesThrough) {
+            GazeFilterParameters parameters;
+            parameters.enabled = false;
+            auto filter = CreateGazeFilter(parameters);
+
+            for (const auto& sample : MakeTrace(20 * Millisecond)) {
+                const XrVector2f measured[ViewCount] = {sample.measuredGaze, {0.f, 0.f}};
+                filter->addSample(sample.time - 20 * Millisecond, measured);
+                XrVector2f gaze[ViewCount];
+                filter->getGaze(sample.time, gaze);
+                Assert::AreEqual(sample.measuredGaze.x, gaze[0].x, 0.f);
+                Assert::AreEqual(sample.measuredGaze.y, gaze[0].y, 0.f);
+                Assert::IsTrue(filter->getMovement() == GazeMovement::Saccade);
+            }
+        }
+
+        TEST_METHOD(NoExtrapolationWithoutLatency) {
+            // With the default eye_latency of 0, the samples are submitted at the display time.
+            auto filter = CreateGazeFilter({});
+            for (const auto& sample : MakeTrace(0)) {
+                const XrVector2f measured[ViewCount] = {sample.measuredGaze, sample.measuredGaze};
+                filter->addSample(sample.time, measured);
+
+                XrVector2f gaze[ViewCount];
+                filter->getGaze(sample.time, gaze);
+                XrVector2f notPredicted[ViewCount];
+                filter->getGaze(sample.time - FramePeriod, notPredicted);
+                Assert::AreEqual(notPredicted[0].x, gaze[0].x, 0.f);
+            }
+        }
+
+        TEST_METHOD(CompensatesLatencyDuringSaccades) {
+            constexpr XrDuration Latency = 20 * Millisecond;
+            const auto trace = MakeTrace(Latency);
+
+            const auto uncompensated = Replay(*CreateGazeFilter({}), trace, 0);
+            const auto compensated = Replay(*CreateGazeFilter({}), trace, Latency);
+
+            Logger::WriteMessage(fmt::format("saccade error with 20ms latency: {:.4f} NDC uncompensated, {:.4f} NDC "
+                                             "compensated",
+                                             uncompensated.meanSaccadeError,
+                                             compensated.meanSaccadeError)
+                                     .c_str());
+            Assert::IsTrue(compensated.meanSaccadeError < uncompensated.meanSaccadeError);
+
+            // Fixations are not extrapolated, so the compensation does not add noise.
+            Assert::AreEqual(uncompensated.meanFixationError, compensated.meanFixationError, 0.001f);
+        }
+
+        TEST_METHOD(RestartsAfterTrackingLoss) {
+            auto filter = CreateGazeFilter({});
+            const XrVector2f before[ViewCount] = {{-0.5f, 0.f}, {-0.5f, 0.f}};
+            for (XrTime time = 0; time < 100 * Millisecond; time += FramePeriod) {
+                filter->addSample(time, before);
+            }
+
+            const XrVector2f after[ViewCount] = {{0.5f, 0.f}, {0.5f, 0.f}};
+            filter->addSample(500 * Millisecond, after);
+            XrVector2f gaze[ViewCount];
+            filter->getGaze(500 * Millisecond, gaze);
+            Assert::AreEqual(0.5f, gaze[0].x, 0.f);
+            Assert::IsTrue(filter->getMovement() == GazeMovement::Fixation);
+        }
+    };
+
+} // namespace tests
@@ -0,0 +1,307 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::input;
+
+    constexpr XrSpaceLocationFlags ValidFlags =
+        XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT;
+
+    using HandJoints = std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT>;
+
+    // The built-in gestures, as hand2controller.cpp defines them.
+    std::vector<GestureDefinition> GetBuiltinGestures() {
+        return {
+            {"pinch", {{XR_HAND_JOINT_THUMB_TIP_EXT, XR_HAND_JOINT_INDEX_TIP_EXT}}, false, 0.f, 0.05f},
+            {"thumbPress", {{XR_HAND_JOINT_INDEX_INTERMEDIATE_EXT, XR_HAND_JOINT_THUMB_TIP_EXT}}, false, 0.f, 0.05f},
+            {"indexBend", {{XR_HAND_JOINT_INDEX_PROXIMAL_EXT, XR_HAND_JOINT_INDEX_TIP_EXT}}, false, 0.045f, 0.07f},
+            {"fingerGun",
+             {{XR_HAND_JOINT_THUMB_TIP_EXT, XR_HAND_JOINT_MIDDLE_INTERMEDIATE_EXT}},
+             false,
+             0.01f,
+             0.03f},
+            {"squeeze",
+             {{XR_HAND_JOINT_MIDDLE_TIP_EXT, XR_HAND_JOINT_MIDDLE_METACARPAL_EXT},
+              {XR_HAND_JOINT_RING_TIP_EXT, XR_HAND_JOINT_RING_METACARPAL_EXT},
+              {XR_HAND_JOINT_LITTLE_TIP_EXT, XR_HAND_JOINT_LITTLE_METACARPAL_EXT}},
+             false,
+             0.035f,
+             0.07f},
+            {"palmTap", {{XR_HAND_JOINT_PALM_EXT, XR_HAND_JOINT_INDEX_TIP_EXT}}, true, 0.02f, 0.06f},
+            {"wristTap", {{XR_HAND_JOINT_WRIST_EXT, XR_HAND_JOINT_INDEX_TIP_EXT}}, true, 0.04f, 0.05f},
+            {"indexTipTap", {{XR_HAND_JOINT_INDEX_TIP_EXT, XR_HAND_JOINT_INDEX_TIP_EXT}}, true, 0.0f, 0.07f},
+        };
+    }
+
+    // User-defined gestures like the .cfg mapping files may declare.
+    std::vector<GestureDefinition> GetCustomGestures(uint32_t count) {
+        std::vector<GestureDefinition> gestures;
+        for (uint32_t i = 0; i < count; i++) {
+            const uint32_t finger = 6 + (i % 4) * 5;
+            gestures.push_back({fmt::format("custom{}", i + 1),
+                                {{XR_HAND_JOINT_THUMB_TIP_EXT, finger + 4}, {XR_HAND_JOINT_THUMB_TIP_EXT, finger + 3}},
+                                i % 3 == 0,
+                                0.01f * (i % 3),
+                                0.05f + 0.01f * (i % 5)});
+        }
+        return gestures;
+    }
+
+    // A recorded-like hand tracking stream: the fingers curl and extend over time, the hands move towards each
+    // other, and the runtime occasionally fails to locate a joint.
+    class HandRecording {
+      public:
+        HandRecording(float invalidRate) : m_invalidRate(invalidRate), m_random(42) {
+        }
+
+        void next(HandJoints& left, HandJoints& right) {
+            m_time += 1.f / 90;
+            fill(left, -1.f);
+            fill(right, 1.f);
+        }
+
+      private:
+        void fill(HandJoints& joints, float side) {
+            const float curl = 0.5f + 0.5f * std::sin(m_time * 3.f + side);
+            const float handX = side * (0.1f + 0.05f * std::sin(m_time));
+            for (uint32_t joint = 0; joint < XR_HAND_JOINT_COUNT_EXT; joint++) {
+                // Finger (0 for the thumb) and position along the finger (0 for the metacarpal).
+                const uint32_t finger = joint < XR_HAND_JOINT_THUMB_METACARPAL_EXT ? 0 : (joint - 2) / 5;
+                const uint32_t segment = joint < XR_HAND_JOINT_THUMB_METACARPAL_EXT ? 0 : (joint - 2) % 5;
+                const float length = 0.02f * segment * (1.f - 0.6f * curl);
+
+                auto& location = joints[joint];
+                location.locationFlags = m_validDistribution(m_random) < m_invalidRate ? 0 : ValidFlags;
+                location.pose = {{0, 0, 0, 1},
+                                 {handX + side * 0.02f * finger,
+                                  1.2f + (joint == XR_HAND_JOINT_WRIST_EXT ? -0.05f : 0.f) + 0.01f * curl * segment,
+                                  -0.3f - length}};
+                location.radius = 0.01f;
+            }
+        }
+
+        const float m_invalidRate;
+        std::mt19937 m_random;
+        std::uniform_real_distribution<float> m_validDistribution{0.f, 1.f};
+        float m_time{0.f};
+    };
+
+    // The evaluation before the gesture engine: one joint pair at a time, straight from the joints array.
+    float ComputeJointActionValue(const XrHandJointLocationEXT& joint1,
+                                  const XrHandJointLocationEXT& joint2,
+                                  float nearDistance,
+                                  float farDistance) {
+        if (!xr::math::Pose::IsPoseValid(joint1.locationFlags) || !xr::math::Pose::IsPoseValid(joint2.locationFlags)) {
+            return NAN;
+        }
+        const XrVector3f delta = joint1.pose.position - joint2.pose.position;
+        const float distance = std::sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
+        return 1.f - (std::clamp(distance, nearDistance, farDistance) - nearDistance) / (farDistance - nearDistance);
+    }
+
+    float EvaluateReference(const GestureDefinition& gesture, const HandJoints& hand, const HandJoints& otherHand) {
+        float sum = 0.f;
+        float lowest = INFINITY;
+        for (const auto& joints : gesture.joints) {
+            const float value = ComputeJointActionValue(hand[joints.first],
+                                                        (gesture.twoHanded ? otherHand : hand)[joints.second],
+                                                        gesture.nearDistance,
+                                                        gesture.farDistance);
+            if (gesture.joints.size() == 1) {
+                return value;
+            }
+            sum += value;
+            lowest = std::min(lowest, value);
+        }
+
+        // Ignore the lowest value, average the other ones.
+        return (sum - lowest) / (gesture.joints.size() - 1);
+    }
+
+    void AssertSameValue(float expected, float actual) {
+        Assert::AreEqual(std::isnan(expected), std::isnan(actual));
+        if (!std::isnan(expected)) {
+            Assert::AreEqual(expected, actual, 1e-5f);
+        }
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(GesturesTests) {
+      public:
+        TEST_METHOD(MatchesReferenceOnRecording) {
+            auto gestures = GetBuiltinGestures();
+            const auto custom = GetCustomGestures(7);
+            gestures.insert(gestures.end(), custom.begin(), custom.end());
+
+            for (const bool allowSimd : {true, false}) {
+                auto engine = CreateGestureEngine(allowSimd);
+                engine->setGestures(gestures);
+                Assert::AreEqual((uint32_t)gestures.size(), engine->getGestureCount());
+
+                HandRecording recording(0.02f);
+                HandJoints left, right;
+                uint32_t numNan = 0;
+                for (uint32_t frame = 0; frame < 900; frame++) {
+                    recording.next(left, right);
+                    engine->evaluate(left.data(), right.data());
+
+                    for (uint32_t i = 0; i < gestures.size(); i++) {
+                        const float leftValue = EvaluateReference(gestures[i], left, right);
+                        AssertSameValue(leftValue, engine->getValue(i, Hand::Left));
+                        AssertSameValue(EvaluateReference(gestures[i], right, left),
+                                        engine->getValue(i, Hand::Right));
+                        numNan += std::isnan(leftValue);
+                    }
+                }
+
+                // The recording exercised the invalid joints.
+                Assert::IsTrue(numNan > 0);
+            }
+        }
+
+        TEST_METHOD(UntrackedHand) {
+            auto engine = CreateGestureEngine();
+            engine->setGestures(GetBuiltinGestures());
+
+            HandRecording recording(0.f);
+            HandJoints left, right;
+            recording.next(left, right);
+            engine->evaluate(left.data(), nullptr);
+
+            for (uint32_t i = 0; i < engine->getGestureCount(); i++) {
+                const bool twoHanded = GetBuiltinGestures()[i].twoHanded;
+                Assert::AreEqual(twoHanded, std::isnan(engine->getValue(i, Hand::Left)));
+                Assert::IsTrue(std::isnan(engine->getValue(i, Hand::Right)));
+            }
+
+            // Out of range.
+            Assert::IsTrue(std::isnan(engine->getValue(engine->getGestureCount(), Hand::Left)));
+        }
+
+        TEST_METHOD(NearAndFarDistances) {
+            auto engine = CreateGestureEngine();
+            engine->setGestures(
+                {{"pinch", {{XR_HAND_JOINT_THUMB_TIP_EXT, XR_HAND_JOINT_INDEX_TIP_EXT}}, false, 0.02f, 0.06f}});
+
+            HandJoints left{}, right{};
+            for (auto& joint : left) {
+                joint.locationFlags = ValidFlags;
+                joint.pose.orientation.w = 1;
+            }
+            const auto evaluate = [&](float distance) {
+                left[XR_HAND_JOINT_INDEX_TIP_EXT].pose.position.x = distance;
+                engine->evaluate(left.data(), right.data());
+                return engine->getValue(0, Hand::Left);
+            };
+            Assert::AreEqual(1.f, evaluate(0.01f), 1e-6f);
+            Assert::AreEqual(1.f, evaluate(0.02f), 1e-6f);
+            Assert::AreEqual(0.5f, evaluate(0.04f), 1e-6f);
+            Assert::AreEqual(0.f, evaluate(0.06f), 1e-6f);
+            Assert::AreEqual(0.f, evaluate(0.5f), 1e-6f);
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkRecording)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkRecording) {
+            constexpr uint32_t NumFrames = 90 * 60;
+
+            // Pre-record the frames, so that only the evaluation is measured.
+            HandRecording recording(0.02f);
+            std::vector<HandJoints> left(NumFrames), right(NumFrames);
+            for (uint32_t frame = 0; frame < NumFrames; frame++) {
+                recording.next(left[frame], right[frame]);
+            }
+
+            const auto replay = [&](const std::vector<GestureDefinition>& gestures, auto evaluate) {
+                float checksum = 0.f;
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (uint32_t frame = 0; frame < NumFrames; frame++) {
+                    checksum += evaluate(gestures, left[frame], right[frame]);
+                }
+                const auto duration = std::chrono::high_resolution_clock::now() - start;
+                Assert::IsFalse(std::isinf(checksum));
+                return std::chrono::duration<double, std::nano>(duration).count() / NumFrames;
+            };
+
+            const auto reference = [](const std::vector<GestureDefinition>& gestures,
+                                      const HandJoints& left,
+                                      const HandJoints& right) {
+                float sum = 0.f;
+                for (const auto& gesture : gestures) {
+                    sum += std::max(EvaluateReference(gesture, left, right), 0.f);
+                    sum += std::max(EvaluateReference(gesture, right, left), 0.f);
+                }
+                return sum;
+            };
+            const auto withEngine = [](bool allowSimd) {
+                return [engine = CreateGestureEngine(allowSimd), gestures = (const void*)nullptr](
+                           const std::vector<GestureDefinition>& definitions,
+                           const HandJoints& left,
+                           const HandJoints& right) mutable {
+                    if (gestures != &definitions) {
+                        gestures = &definitions;
+                        engine->setGestures(definitions);
+                    }
+                    engine->evaluate(left.data(), right.data());
+                    float sum = 0.f;
+                    for (uint32_t i = 0; i < engine->getGestureCount(); i++) {
+                        sum += std::max(engine->getValue(i, Hand::Left), 0.f);
+                        sum += std::max(engine->getValue(i, Hand::Right), 0.f);
+                    }
+                    return sum;
+                };
+            };
+
+            auto gestures = GetBuiltinGestures();
+            for (const uint32_t numCustom : {0u, 24u}) {
+                const auto custom = GetCustomGestures(numCustom);
+                auto definitions = gestures;
+                definitions.insert(definitions.end(), custom.begin(), custom.end());
+
+                const auto perGesture = replay(definitions, reference);
+                const auto scalar = replay(definitions, withEngine(false));
+                const auto simd = replay(definitions, withEngine(true));
+
+                Logger::WriteMessage(fmt::format("{} gestures, both hands: {:.0f} ns per gesture, {:.0f} ns batched "
+                                                 "scalar, {:.0f} ns batched SSE",
+                                                 definitions.size(),
+                                                 perGesture,
+                                                 scalar,
+                                                 simd)
+                                         .c_str());
+            }
+        }
+    };
+
+} // namespace tests
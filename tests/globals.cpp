@@ -0,0 +1,47 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "layer.h"
+
+// The globals normally defined by the layer's entry point (framework/entry.cpp), which is not part of the tests.
+
+namespace toolkit {
+    std::filesystem::path dllHome;
+    std::filesystem::path localAppData;
+
+    // The singleton is normally created by layer.cpp. The tests install their own OpenXrApi implementation.
+    std::unique_ptr<OpenXrApi> g_instance;
+
+    OpenXrApi* GetInstance() {
+        return g_instance.get();
+    }
+
+    void ResetInstance() {
+        g_instance.reset();
+    }
+
+    namespace log {
+        std::ofstream logStream;
+    } // namespace log
+} // namespace toolkit
@@ -0,0 +1,198 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "handjoints.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::input;
+
+    constexpr XrTime Millisecond = 1000000;
+    constexpr XrTime GracePeriod = 2 * Millisecond;
+
+    constexpr XrSpaceLocationFlags ValidFlags =
+        XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT;
+    constexpr XrSpaceLocationFlags TrackedFlags =
+        XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+
+    // All the joints at the same position along X.
+    HandJointsPoses MakePoses(float x, XrSpaceLocationFlags flags = ValidFlags | TrackedFlags, float radius = 0.01f) {
+        HandJointsPoses poses;
+        for (auto& joint : poses) {
+            joint.locationFlags = flags;
+            joint.pose = {{0, 0, 0, 1}, {x, 0, 0}};
+            joint.radius = radius;
+        }
+        return poses;
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(HandJointsTests) {
+      public:
+        TEST_METHOD(KeepsEntriesSorted) {
+            HandJointsPosesCache cache;
+            for (const XrTime time : {30, 10, 50, 20, 40}) {
+                cache.insert(time * Millisecond, MakePoses((float)time));
+            }
+
+            Assert::AreEqual((size_t)5, cache.size());
+            for (size_t i = 0; i < cache.size(); i++) {
+                Assert::AreEqual((XrTime)(i + 1) * 10 * Millisecond, cache.getTime(i));
+                Assert::AreEqual((i + 1) * 10.f, cache.getPoses(i)[0].pose.position.x, 0.f);
+            }
+        }
+
+        TEST_METHOD(EvictsOldestWhenFull) {
+            HandJointsPosesCache cache;
+            for (XrTime i = 0; i < HandJointsPosesCache::Capacity + 3; i++) {
+                cache.insert(i * Millisecond, MakePoses((float)i));
+            }
+
+            Assert::AreEqual(HandJointsPosesCache::Capacity, cache.size());
+            Assert::AreEqual(3 * Millisecond, cache.getTime(0));
+            Assert::AreEqual((XrTime)(HandJointsPosesCache::Capacity + 2) * Millisecond,
+                             cache.getTime(cache.size() - 1));
+
+            cache.evictOlderThan(10 * Millisecond);
+            Assert::AreEqual(HandJointsPosesCache::Capacity + 3 - 10, cache.size());
+            Assert::AreEqual(10 * Millisecond, cache.getTime(0));
+
+            cache.evictOlderThan(100 * Millisecond);
+            Assert::AreEqual((size_t)0, cache.size());
+        }
+
+        TEST_METHOD(FindsNearestWithinTolerance) {
+            HandJointsPosesCache cache;
+            cache.insert(10 * Millisecond, MakePoses(1));
+            cache.insert(13 * Millisecond, MakePoses(2));
+
+            HandJointsPoses poses;
+            Assert::IsTrue(cache.find(11 * Millisecond, GracePeriod, false, poses));
+            Assert::AreEqual(1.f, poses[0].pose.position.x, 0.f);
+            Assert::IsTrue(cache.find(12 * Millisecond, GracePeriod, false, poses));
+            Assert::AreEqual(2.f, poses[0].pose.position.x, 0.f);
+            Assert::IsTrue(cache.find(14 * Millisecond, GracePeriod, false, poses));
+            Assert::AreEqual(2.f, poses[0].pose.position.x, 0.f);
+
+            Assert::IsFalse(cache.find(8 * Millisecond, GracePeriod, false, poses));
+            Assert::IsFalse(cache.find(15 * Millisecond, GracePeriod, false, poses));
+        }
+
+        TEST_METHOD(InterpolatesBetweenEntries) {
+            HandJointsPosesCache cache;
+            cache.insert(10 * Millisecond, MakePoses(0, ValidFlags | TrackedFlags, 0.01f));
+            cache.insert(20 * Millisecond, MakePoses(1, ValidFlags, 0.03f));
+
+            HandJointsPoses poses;
+            Assert::IsFalse(cache.find(15 * Millisecond, GracePeriod, false, poses));
+            Assert::IsTrue(cache.find(15 * Millisecond, GracePeriod, true, poses));
+            for (const auto& joint : poses) {
+                Assert::AreEqual(0.5f, joint.pose.position.x, 0.0001f);
+                Assert::AreEqual(0.02f, joint.radius, 0.0001f);
+                Assert::AreEqual((uint64_t)ValidFlags, (uint64_t)joint.locationFlags);
+            }
+
+            Assert::IsTrue(cache.find(17500000, GracePeriod, true, poses));
+            Assert::AreEqual(0.75f, poses[XR_HAND_JOINT_INDEX_TIP_EXT].pose.position.x, 0.0001f);
+        }
+
+        TEST_METHOD(DoesNotInterpolateAcrossGaps) {
+            HandJointsPosesCache cache;
+            cache.insert(10 * Millisecond, MakePoses(0));
+            cache.insert(10 * Millisecond + HandJointsPosesCache::MaxInterpolationInterval + 1, MakePoses(1));
+
+            HandJointsPoses poses;
+            Assert::IsFalse(cache.find(20 * Millisecond, GracePeriod, true, poses));
+
+            // Never extrapolate.
+            Assert::IsFalse(cache.find(5 * Millisecond, GracePeriod, true, poses));
+            Assert::IsFalse(cache.find(100 * Millisecond, GracePeriod, true, poses));
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkFrameLoop)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkFrameLoop) {
+            // At 90 Hz, each frame the layer looks up the poses at the predicted display time (xrSyncActions() and
+            // the hands rendering), and the application locates the grip and aim spaces at times slightly off the
+            // display time (eg: a physics tick).
+            constexpr XrTime FramePeriod = 11111111;
+            constexpr uint32_t NumFrames = 90 * 60;
+            const XrTime queryOffsets[] = {0, 0, 0, 1 * Millisecond, -4 * Millisecond, 3 * Millisecond};
+
+            const auto replay = [&](bool interpolate, uint32_t& numRuntimeQueries) {
+                HandJointsPosesCache cache;
+                HandJointsPoses poses;
+                numRuntimeQueries = 0;
+                float checksum = 0;
+
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (uint32_t frame = 0; frame < NumFrames; frame++) {
+                    const XrTime displayTime = 1000 * Millisecond + frame * FramePeriod;
+                    cache.evictOlderThan(displayTime - 2 * FramePeriod);
+                    for (const XrTime offset : queryOffsets) {
+                        const XrTime time = displayTime + offset;
+                        if (!cache.find(time, GracePeriod, interpolate, poses)) {
+                            // Stands for xrLocateHandJointsEXT().
+                            numRuntimeQueries++;
+                            poses = MakePoses((float)frame);
+                            cache.insert(time, poses);
+                        }
+                        checksum += poses[0].pose.position.x;
+                    }
+                }
+                const auto duration = std::chrono::high_resolution_clock::now() - start;
+                Assert::IsTrue(checksum > 0);
+
+                return std::chrono::duration<double, std::nano>(duration).count() /
+                       (NumFrames * std::size(queryOffsets));
+            };
+
+            uint32_t numQueriesWithoutInterpolation;
+            const double withoutInterpolationNs = replay(false, numQueriesWithoutInterpolation);
+            uint32_t numQueriesWithInterpolation;
+            const double withInterpolationNs = replay(true, numQueriesWithInterpolation);
+
+            const uint32_t numLookups = NumFrames * (uint32_t)std::size(queryOffsets);
+            Logger::WriteMessage(fmt::format("{} lookups over {} frames", numLookups, NumFrames).c_str());
+            Logger::WriteMessage(fmt::format("no interpolation: {} runtime queries, {:.1f} ns per lookup",
+                                             numQueriesWithoutInterpolation,
+                                             withoutInterpolationNs)
+                                     .c_str());
+            Logger::WriteMessage(fmt::format("interpolation:    {} runtime queries, {:.1f} ns per lookup",
+                                             numQueriesWithInterpolation,
+                                             withInterpolationNs)
+                                     .c_str());
+
+            Assert::IsTrue(numQueriesWithoutInterpolation < numLookups);
+            Assert::IsTrue(numQueriesWithInterpolation < numQueriesWithoutInterpolation);
+        }
+    };
+
+} // namespace tests
@@ -0,0 +1,232 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "d3dcommon.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::graphics::d3dcommon;
+
+    // Descriptors handles are small increments from one another.
+    constexpr uintptr_t HandleBase = 0x10000;
+    constexpr uintptr_t HandleIncrement = 32;
+
+    uintptr_t MakeHandle(size_t index) {
+        return HandleBase + index * HandleIncrement;
+    }
+
+    // About the size of a render target descriptor entry (resource and D3D12_RESOURCE_DESC).
+    struct Value {
+        uint64_t sequence;
+        uint64_t desc[7];
+    };
+
+    Value MakeValue(uint64_t sequence) {
+        return {sequence, {}};
+    }
+
+    // A value that is long to copy, so that readers are likely to notice an entry recycled while they copy it.
+    struct LargeValue {
+        uint64_t words[64];
+    };
+
+    LargeValue MakeLargeValue(uint64_t sequence) {
+        LargeValue value;
+        std::fill(std::begin(value.words), std::end(value.words), sequence);
+        return value;
+    }
+
+    // The previous implementation (an ordered map under a lock), as the reference for the benchmark.
+    class LockedHandleMap {
+      public:
+        bool insertOrAssign(uintptr_t handle, const Value& value) {
+            std::unique_lock lock(m_lock);
+            return m_map.insert_or_assign(handle, value).second;
+        }
+
+        std::optional<Value> find(uintptr_t handle) const {
+            std::unique_lock lock(m_lock);
+            const auto it = m_map.find(handle);
+            return it != m_map.cend() ? std::optional<Value>(it->second) : std::nullopt;
+        }
+
+      private:
+        std::map<uintptr_t, Value> m_map;
+        mutable std::mutex m_lock;
+    };
+
+    // Look up the handles from several threads (like OMSetRenderTargets() from command list recording threads), while
+    // one thread keeps re-creating views (like CreateRenderTargetView()). Returns the average time per look-up.
+    template <typename Map>
+    double MeasureLookups(Map& map, size_t numHandles, uint32_t numReaders, size_t lookupsPerReader) {
+        for (size_t i = 0; i < numHandles; i++) {
+            map.insertOrAssign(MakeHandle(i), MakeValue(i));
+        }
+
+        std::atomic<bool> stop{false};
+        std::thread writer([&] {
+            std::mt19937 random(1);
+            for (uint64_t sequence = numHandles; !stop.load(std::memory_order_relaxed); sequence++) {
+                map.insertOrAssign(MakeHandle(random() % numHandles), MakeValue(sequence));
+                std::this_thread::yield();
+            }
+        });
+
+        std::vector<std::future<double>> readers;
+        for (uint32_t r = 0; r < numReaders; r++) {
+            readers.push_back(std::async(std::launch::async, [&, r] {
+                std::mt19937 random(r + 2);
+                uint64_t found = 0;
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (size_t i = 0; i < lookupsPerReader; i++) {
+                    found += map.find(MakeHandle(random() % numHandles)) ? 1 : 0;
+                }
+                const auto duration = std::chrono::high_resolution_clock::now() - start;
+                Assert::AreEqual((uint64_t)lookupsPerReader, found);
+                return std::chrono::duration<double, std::nano>(duration).count() / lookupsPerReader;
+            }));
+        }
+
+        double total = 0;
+        for (auto& reader : readers) {
+            total += reader.get();
+        }
+        stop = true;
+        writer.join();
+
+        return total / numReaders;
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(HandleMapTests) {
+      public:
+        TEST_METHOD(InsertAndFind) {
+            LockFreeHandleMap<Value> map;
+
+            Assert::IsTrue(map.insertOrAssign(MakeHandle(1), MakeValue(1)));
+            Assert::IsTrue(map.insertOrAssign(MakeHandle(2), MakeValue(2)));
+            Assert::IsFalse(map.insertOrAssign(MakeHandle(1), MakeValue(3)));
+            Assert::AreEqual((size_t)2, map.size());
+
+            Assert::AreEqual((uint64_t)3, map.find(MakeHandle(1))->sequence);
+            Assert::AreEqual((uint64_t)2, map.find(MakeHandle(2))->sequence);
+            Assert::IsFalse(map.find(MakeHandle(3)).has_value());
+        }
+
+        TEST_METHOD(GrowKeepsEntries) {
+            LockFreeHandleMap<Value> map;
+
+            constexpr size_t NumHandles = 10000;
+            for (size_t i = 0; i < NumHandles; i++) {
+                map.insertOrAssign(MakeHandle(i), MakeValue(i));
+            }
+
+            Assert::AreEqual(NumHandles, map.size());
+            for (size_t i = 0; i < NumHandles; i++) {
+                const auto value = map.find(MakeHandle(i));
+                Assert::IsTrue(value.has_value());
+                Assert::AreEqual((uint64_t)i, value->sequence);
+            }
+        }
+
+        TEST_METHOD(OverwritesRecycleEntries) {
+            LockFreeHandleMap<Value> map;
+
+            // Without any reader, each overwritten entry is recycled after at most two updates.
+            constexpr size_t NumHandles = 100;
+            for (uint64_t sequence = 0; sequence < 100 * NumHandles; sequence++) {
+                map.insertOrAssign(MakeHandle(sequence % NumHandles), MakeValue(sequence));
+            }
+
+            Assert::AreEqual(NumHandles, map.size());
+            Assert::IsTrue(map.getNumAllocatedEntries() <= NumHandles + 2);
+            Assert::AreEqual((uint64_t)(99 * NumHandles), map.find(MakeHandle(0))->sequence);
+        }
+
+        TEST_METHOD(ConcurrentLookupsDoNotTear) {
+            LockFreeHandleMap<LargeValue> map;
+
+            constexpr size_t NumHandles = 64;
+            for (size_t i = 0; i < NumHandles; i++) {
+                map.insertOrAssign(MakeHandle(i), MakeLargeValue(i));
+            }
+
+            std::atomic<bool> stop{false};
+            std::vector<std::future<uint64_t>> readers;
+            for (uint32_t r = 0; r < 4; r++) {
+                readers.push_back(std::async(std::launch::async, [&, r] {
+                    std::mt19937 random(r);
+                    uint64_t numTorn = 0;
+                    while (!stop.load(std::memory_order_relaxed)) {
+                        const auto value = map.find(MakeHandle(random() % NumHandles));
+                        if (!value || std::any_of(std::begin(value->words), std::end(value->words), [&](uint64_t word) {
+                                return word != value->words[0];
+                            })) {
+                            numTorn++;
+                        }
+                    }
+                    return numTorn;
+                }));
+            }
+
+            // Overwrite and add handles, so that both the entries and the tables are recycled under the readers.
+            for (uint64_t sequence = NumHandles; sequence < 200000; sequence++) {
+                map.insertOrAssign(MakeHandle(sequence % (NumHandles * 8)), MakeLargeValue(sequence));
+            }
+            stop = true;
+
+            for (auto& reader : readers) {
+                Assert::AreEqual((uint64_t)0, reader.get());
+            }
+            Assert::AreEqual(NumHandles * 8, map.size());
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkLookups)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkLookups) {
+            constexpr size_t NumHandles = 2000;
+            constexpr size_t LookupsPerReader = 1000000;
+
+            for (uint32_t numReaders : {1u, 2u, 4u, 8u}) {
+                LockedHandleMap lockedMap;
+                const double locked = MeasureLookups(lockedMap, NumHandles, numReaders, LookupsPerReader);
+                LockFreeHandleMap<Value> lockFreeMap;
+                const double lockFree = MeasureLookups(lockFreeMap, NumHandles, numReaders, LookupsPerReader);
+
+                Logger::WriteMessage(fmt::format("{} reader(s): map+mutex {:.1f} ns/lookup, lock-free {:.1f} ns/lookup",
+                                                 numReaders,
+                                                 locked,
+                                                 lockFree)
+                                         .c_str());
+            }
+        }
+    };
+
+} // namespace tests
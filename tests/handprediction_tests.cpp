@@ -0,0 +1,218 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::input;
+
+    constexpr XrTime Millisecond = 1000000;
+    constexpr XrDuration FramePeriod = 11111111; // 90Hz
+
+    constexpr XrSpaceLocationFlags ValidFlags =
+        XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT;
+
+    using HandJoints = std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT>;
+
+    // A recorded-like hand motion: the palm sweeps sideways (eg: reaching for a switch) while the hand turns around
+    // the vertical axis. The fingers are offset from the palm, and increasingly curled.
+    HandJoints GetJointsAt(XrTime time, float noise = 0.f, std::mt19937* random = nullptr) {
+        const float t = time / 1e9f;
+        const float x = 0.2f * std::sin(2.f * t);
+        const float angle = 0.5f * std::sin(1.5f * t);
+
+        std::normal_distribution<float> distribution(0.f, noise);
+        HandJoints joints;
+        for (uint32_t joint = 0; joint < XR_HAND_JOINT_COUNT_EXT; joint++) {
+            const float offset = 0.01f * joint;
+            const float curl = 0.05f * joint;
+            joints[joint].locationFlags = ValidFlags;
+            // The curl (around the X axis of the hand) followed by the turn of the hand (around the Y axis).
+            joints[joint].pose.orientation = {std::cos(angle / 2) * std::sin(curl / 2),
+                                              std::sin(angle / 2) * std::cos(curl / 2),
+                                              -std::sin(angle / 2) * std::sin(curl / 2),
+                                              std::cos(angle / 2) * std::cos(curl / 2)};
+            joints[joint].pose.position = {x + offset * std::cos(angle), 1.2f, -0.3f - offset * std::sin(angle)};
+            if (random) {
+                joints[joint].pose.position.x += distribution(*random);
+                joints[joint].pose.position.y += distribution(*random);
+                joints[joint].pose.position.z += distribution(*random);
+            }
+            joints[joint].radius = 0.01f;
+        }
+        return joints;
+    }
+
+    float GetMeanJointError(const HandJoints& expected, const HandJoints& actual) {
+        float error = 0.f;
+        for (uint32_t joint = 0; joint < XR_HAND_JOINT_COUNT_EXT; joint++) {
+            const XrVector3f delta = expected[joint].pose.position - actual[joint].pose.position;
+            error += std::sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
+        }
+        return error / XR_HAND_JOINT_COUNT_EXT;
+    }
+
+    // The mean angle (radians) between the expected and actual orientations of the joints.
+    float GetMeanJointAngleError(const HandJoints& expected, const HandJoints& actual) {
+        float error = 0.f;
+        for (uint32_t joint = 0; joint < XR_HAND_JOINT_COUNT_EXT; joint++) {
+            const XrQuaternionf& a = expected[joint].pose.orientation;
+            const XrQuaternionf& b = actual[joint].pose.orientation;
+            const float dot = std::abs(a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w);
+            error += 2.f * std::acos(std::min(dot, 1.f));
+        }
+        return error / XR_HAND_JOINT_COUNT_EXT;
+    }
+
+    // Replay the recording like hand2controller.cpp does: the runtime is queried once per frame, and the poses are
+    // predicted for the display time, ahead of the latest sample.
+    float Replay(IHandPosePredictor& predictor,
+                 XrDuration lookAhead,
+                 float noise = 0.f,
+                 float (*getError)(const HandJoints&, const HandJoints&) = GetMeanJointError) {
+        std::mt19937 random(42);
+        float error = 0.f;
+        uint32_t numFrames = 0;
+        for (XrTime time = FramePeriod; time < 2000 * Millisecond; time += FramePeriod) {
+            const HandJoints sample = GetJointsAt(time, noise, &random);
+            predictor.addSample(time, sample.data());
+
+            HandJoints predicted;
+            Assert::IsTrue(predictor.predict(time + lookAhead, predicted.data()));
+            if (time > 200 * Millisecond) {
+                error += getError(GetJointsAt(time + lookAhead), predicted);
+                numFrames++;
+            }
+        }
+        return error / numFrames;
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(HandPredictionTests) {
+      public:
+        TEST_METHOD(DisabledHoldsLatestSample) {
+            // The default of the layer (extrapolation_horizon=0).
+            auto predictor = CreateHandPosePredictor({0});
+
+            HandJoints predicted;
+            Assert::IsFalse(predictor->predict(FramePeriod, predicted.data()));
+
+            HandJoints latest;
+            for (XrTime time = FramePeriod; time < 500 * Millisecond; time += FramePeriod) {
+                latest = GetJointsAt(time);
+                predictor->addSample(time, latest.data());
+            }
+            Assert::IsTrue(predictor->predict(600 * Millisecond, predicted.data()));
+            Assert::AreEqual(0.f, GetMeanJointError(latest, predicted), 0.f);
+        }
+
+        TEST_METHOD(ExtrapolationReducesErrorOnRecording) {
+            constexpr XrDuration LookAhead = 30 * Millisecond;
+            auto holding = CreateHandPosePredictor({0});
+            auto extrapolating = CreateHandPosePredictor({50 * Millisecond});
+
+            const float holdError = Replay(*holding, LookAhead);
+            const float extrapolationError = Replay(*extrapolating, LookAhead);
+
+            Logger::WriteMessage(fmt::format("mean joint error 30ms ahead: {:.2f} mm holding, {:.2f} mm extrapolating",
+                                             holdError * 1000,
+                                             extrapolationError * 1000)
+                                     .c_str());
+            Assert::IsTrue(extrapolationError < holdError / 2);
+            Assert::IsTrue(extrapolating->getConfidence() > 0.5f);
+        }
+
+        TEST_METHOD(ExtrapolationRotatesJointsOnRecording) {
+            constexpr XrDuration LookAhead = 30 * Millisecond;
+            auto holding = CreateHandPosePredictor({0});
+            auto extrapolating = CreateHandPosePredictor({50 * Millisecond});
+
+            // The turn of the hand must be applied on top of the curl of each joint.
+            const float holdError = Replay(*holding, LookAhead, 0.f, GetMeanJointAngleError);
+            const float extrapolationError = Replay(*extrapolating, LookAhead, 0.f, GetMeanJointAngleError);
+
+            Logger::WriteMessage(
+                fmt::format("mean joint angle error 30ms ahead: {:.3f} deg holding, {:.3f} deg extrapolating",
+                            holdError * 180 / (float)M_PI,
+                            extrapolationError * 180 / (float)M_PI)
+                    .c_str());
+            Assert::IsTrue(extrapolationError < holdError / 2);
+        }
+
+        TEST_METHOD(NoisyTrackingIsNotAmplified) {
+            constexpr XrDuration LookAhead = 30 * Millisecond;
+
+            // Tracking noise much larger than the motion over one frame.
+            auto holding = CreateHandPosePredictor({0});
+            auto extrapolating = CreateHandPosePredictor({50 * Millisecond});
+            const float holdError = Replay(*holding, LookAhead, 0.01f);
+            const float extrapolationError = Replay(*extrapolating, LookAhead, 0.01f);
+
+            Logger::WriteMessage(fmt::format("with 10mm noise: {:.2f} mm holding, {:.2f} mm extrapolating",
+                                             holdError * 1000,
+                                             extrapolationError * 1000)
+                                     .c_str());
+            Assert::IsTrue(extrapolationError < holdError * 1.2f);
+        }
+
+        TEST_METHOD(HorizonLimitsExtrapolation) {
+            auto predictor = CreateHandPosePredictor({20 * Millisecond});
+            XrTime time = FramePeriod;
+            for (; time < 1000 * Millisecond; time += FramePeriod) {
+                predictor->addSample(time, GetJointsAt(time).data());
+            }
+            time -= FramePeriod;
+
+            HandJoints atHorizon, beyondHorizon;
+            predictor->predict(time + 20 * Millisecond, atHorizon.data());
+            predictor->predict(time + 200 * Millisecond, beyondHorizon.data());
+            Assert::AreEqual(0.f, GetMeanJointError(atHorizon, beyondHorizon), 0.f);
+        }
+
+        TEST_METHOD(RestartsAfterTrackingLoss) {
+            auto predictor = CreateHandPosePredictor({50 * Millisecond});
+            for (XrTime time = FramePeriod; time < 500 * Millisecond; time += FramePeriod) {
+                predictor->addSample(time, GetJointsAt(time).data());
+            }
+            Assert::IsTrue(predictor->getConfidence() > 0.f);
+
+            // The hand comes back elsewhere: there is no motion to extrapolate until the next sample.
+            const HandJoints reappeared = GetJointsAt(1500 * Millisecond);
+            predictor->addSample(1500 * Millisecond, reappeared.data());
+            Assert::AreEqual(0.f, predictor->getConfidence());
+
+            HandJoints predicted;
+            predictor->predict(1530 * Millisecond, predicted.data());
+            Assert::AreEqual(0.f, GetMeanJointError(reappeared, predicted), 0.f);
+        }
+    };
+
+} // namespace tests
@@ -0,0 +1,336 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "layer.h"
+#include "log.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace toolkit {
+    extern std::unique_ptr<OpenXrApi> g_instance;
+
+    namespace log {
+        extern std::ofstream logStream;
+    } // namespace log
+} // namespace toolkit
+
+namespace {
+
+    using namespace toolkit;
+    using namespace toolkit::log;
+
+    LONG WINAPI SentinelExceptionFilter(EXCEPTION_POINTERS*) {
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+
+    uint32_t g_numEvaluations = 0;
+
+    const char* CountEvaluation(const char* value) {
+        g_numEvaluations++;
+        return value;
+    }
+
+    // A hook as instrumented before local activities were gated on the provider state.
+    uint32_t HookWithActivity(void* object, uint32_t value) {
+        TraceLoggingActivity<g_traceProvider> local;
+        TraceLoggingWriteStart(local, "LogTests_Hook", TLPArg(object, "Object"), TLArg(value, "Value"));
+        value = value * 3 + 1;
+        TraceLoggingWriteStop(local, "LogTests_Hook", TLArg(value, "Result"));
+        return value;
+    }
+
+    uint32_t HookWithLocalActivity(void* object, uint32_t value) {
+        TraceLocalActivity(local);
+        TraceLoggingLocalStart(local, "LogTests_Hook", TLPArg(object, "Object"), TLArg(value, "Value"));
+        value = value * 3 + 1;
+        TraceLoggingLocalStop(local, "LogTests_Hook", TLArg(value, "Result"));
+        return value;
+    }
+
+    // A runtime that returns immediately, so that only the cost of the layer's hooks is measured.
+    XrResult XRAPI_CALL RuntimeLocateSpace(XrSpace, XrSpace, XrTime time, XrSpaceLocation* location) {
+        location->locationFlags = static_cast<XrSpaceLocationFlags>(time & 1);
+        return XR_SUCCESS;
+    }
+
+    XrResult XRAPI_CALL RuntimeGetActionStateBoolean(XrSession,
+                                                     const XrActionStateGetInfo*,
+                                                     XrActionStateBoolean* state) {
+        state->currentState = !state->currentState;
+        return XR_SUCCESS;
+    }
+
+    XrResult XRAPI_CALL RuntimeGetInstanceProcAddr(XrInstance, const char* name, PFN_xrVoidFunction* function) {
+        if (!strcmp(name, "xrLocateSpace")) {
+            *function = reinterpret_cast<PFN_xrVoidFunction>(RuntimeLocateSpace);
+        } else if (!strcmp(name, "xrGetActionStateBoolean")) {
+            *function = reinterpret_cast<PFN_xrVoidFunction>(RuntimeGetActionStateBoolean);
+        } else {
+            return XR_ERROR_FUNCTION_UNSUPPORTED;
+        }
+        return XR_SUCCESS;
+    }
+
+    // A layer that does not override any API: the hooks go straight to the runtime.
+    class PassThroughLayer : public OpenXrApi {};
+
+    // The xrLocateSpace() wrapper as generated before local activities were gated on the provider state.
+    XrResult LocateSpaceWithActivity(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location) {
+        TraceLoggingActivity<g_traceProvider> local;
+        TraceLoggingWriteStart(local, "xrLocateSpace");
+
+        XrResult result;
+        try {
+            result = GetInstance()->xrLocateSpace(space, baseSpace, time, location);
+        } catch (std::exception& exc) {
+            TraceLoggingWriteTagged(local, "xrLocateSpace_Error", TLArg(exc.what(), "Error"));
+            Log("xrLocateSpace: %s\n", exc.what());
+            result = XR_ERROR_RUNTIME_FAILURE;
+        }
+
+        TraceLoggingWriteStop(local, "xrLocateSpace", TLArg(xr::ToCString(result), "Result"));
+
+        return result;
+    }
+
+    // Idem for xrGetActionStateBoolean().
+    XrResult GetActionStateBooleanWithActivity(XrSession session,
+                                               const XrActionStateGetInfo* getInfo,
+                                               XrActionStateBoolean* state) {
+        TraceLoggingActivity<g_traceProvider> local;
+        TraceLoggingWriteStart(local, "xrGetActionStateBoolean");
+
+        XrResult result;
+        try {
+            result = GetInstance()->xrGetActionStateBoolean(session, getInfo, state);
+        } catch (std::exception& exc) {
+            TraceLoggingWriteTagged(local, "xrGetActionStateBoolean_Error", TLArg(exc.what(), "Error"));
+            Log("xrGetActionStateBoolean: %s\n", exc.what());
+            result = XR_ERROR_RUNTIME_FAILURE;
+        }
+
+        TraceLoggingWriteStop(local, "xrGetActionStateBoolean", TLArg(xr::ToCString(result), "Result"));
+
+        return result;
+    }
+
+    uint32_t CountLines(const std::filesystem::path& path, const std::string& needle) {
+        std::ifstream file(path);
+        uint32_t count = 0;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.find(needle) != std::string::npos) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(LogTests) {
+        const std::filesystem::path m_logFile = std::filesystem::temp_directory_path() / "OXRTK_log_tests.log";
+
+      public:
+        TEST_METHOD_INITIALIZE(Setup) {
+            // Other tests may have started the writer.
+            ShutdownLog();
+            logStream.open(m_logFile, std::ios_base::trunc);
+        }
+
+        TEST_METHOD_CLEANUP(Cleanup) {
+            ShutdownLog();
+            logStream.close();
+            std::filesystem::remove(m_logFile);
+        }
+
+        TEST_METHOD(ShutdownWritesPendingMessages) {
+            for (int i = 0; i < 10; i++) {
+                Log("LogTests pending %d\n", i);
+            }
+            ShutdownLog();
+
+            logStream.flush();
+            Assert::AreEqual(10u, CountLines(m_logFile, "LogTests pending"));
+        }
+
+        TEST_METHOD(LogRestartsAfterShutdown) {
+            Log("LogTests before shutdown\n");
+            ShutdownLog();
+            Log("LogTests after shutdown\n");
+            Log("LogTests after shutdown\n");
+            ShutdownLog();
+
+            // A second shutdown is harmless.
+            ShutdownLog();
+
+            logStream.flush();
+            Assert::AreEqual(1u, CountLines(m_logFile, "LogTests before shutdown"));
+            Assert::AreEqual(2u, CountLines(m_logFile, "LogTests after shutdown"));
+        }
+
+        TEST_METHOD(FlushWritesFromCallingThread) {
+            Log("LogTests flushed\n");
+            FlushLog();
+
+            // The writer thread might have written the message first, but it must not be written twice.
+            logStream.flush();
+            Assert::AreEqual(1u, CountLines(m_logFile, "LogTests flushed"));
+        }
+
+        TEST_METHOD(ShutdownRestoresExceptionFilter) {
+            const LPTOP_LEVEL_EXCEPTION_FILTER originalFilter = SetUnhandledExceptionFilter(SentinelExceptionFilter);
+
+            Log("LogTests exception filter\n");
+            const LPTOP_LEVEL_EXCEPTION_FILTER installedFilter = SetUnhandledExceptionFilter(SentinelExceptionFilter);
+            Assert::IsTrue(installedFilter != SentinelExceptionFilter);
+            SetUnhandledExceptionFilter(installedFilter);
+
+            ShutdownLog();
+            const LPTOP_LEVEL_EXCEPTION_FILTER restoredFilter = SetUnhandledExceptionFilter(originalFilter);
+            Assert::IsTrue(restoredFilter == SentinelExceptionFilter);
+        }
+
+        TEST_METHOD(LocalActivityArgumentsNotEvaluatedWithoutTrace) {
+            // No trace session is listening to the provider during the tests.
+            Assert::IsFalse(IsTraceEnabled());
+
+            g_numEvaluations = 0;
+            {
+                TraceLocalActivity(local);
+                TraceLoggingLocalStart(local, "LogTests_Start", TLArg(CountEvaluation("start"), "Value"));
+
+                // The macros are single statements.
+                if (g_numEvaluations)
+                    TraceLoggingLocalStop(local, "LogTests_Stop", TLArg(CountEvaluation("stop"), "Value"));
+                else
+                    TraceLoggingLocalStop(local, "LogTests_Stop", TLArg(CountEvaluation("stop"), "Value"));
+            }
+            Assert::AreEqual(0u, g_numEvaluations);
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkLocalActivity)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkLocalActivity) {
+            // Registered like the layer does, but with no trace session listening.
+            TraceLoggingRegister(g_traceProvider);
+
+            constexpr uint32_t Iterations = 1000000;
+            const auto measure = [&](uint32_t (*hook)(void*, uint32_t)) {
+                uint32_t value = 0;
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (uint32_t i = 0; i < Iterations; i++) {
+                    value = hook(&value, value);
+                }
+                const auto duration = std::chrono::high_resolution_clock::now() - start;
+                Assert::AreNotEqual(0u, value);
+                return std::chrono::duration<double, std::nano>(duration).count() / Iterations;
+            };
+
+            const double activityNs = measure(HookWithActivity);
+            const double localActivityNs = measure(HookWithLocalActivity);
+
+            TraceLoggingUnregister(g_traceProvider);
+
+            Logger::WriteMessage(fmt::format("activity:       {:.1f} ns per call", activityNs).c_str());
+            Logger::WriteMessage(fmt::format("local activity: {:.1f} ns per call", localActivityNs).c_str());
+        }
+
+        BEGIN_TEST_METHOD_ATTRIBUTE(BenchmarkGeneratedHooks)
+        TEST_METHOD_ATTRIBUTE(L"TestCategory", L"Benchmark")
+        END_TEST_METHOD_ATTRIBUTE()
+        TEST_METHOD(BenchmarkGeneratedHooks) {
+            TraceLoggingRegister(g_traceProvider);
+            Assert::IsFalse(IsTraceEnabled());
+
+            // Resolve the generated wrappers like the loader does.
+            g_instance = std::make_unique<PassThroughLayer>();
+            const XrInstance instance = reinterpret_cast<XrInstance>(1);
+            g_instance->SetGetInstanceProcAddr(RuntimeGetInstanceProcAddr, instance);
+
+            PFN_xrLocateSpace xrLocateSpace = nullptr;
+            PFN_xrGetActionStateBoolean xrGetActionStateBoolean = nullptr;
+            Assert::IsTrue(XR_SUCCEEDED(g_instance->xrGetInstanceProcAddr(
+                instance, "xrLocateSpace", reinterpret_cast<PFN_xrVoidFunction*>(&xrLocateSpace))));
+            Assert::IsTrue(XR_SUCCEEDED(
+                g_instance->xrGetInstanceProcAddr(instance,
+                                                  "xrGetActionStateBoolean",
+                                                  reinterpret_cast<PFN_xrVoidFunction*>(&xrGetActionStateBoolean))));
+            Assert::IsTrue(xrLocateSpace != RuntimeLocateSpace);
+            Assert::IsTrue(xrGetActionStateBoolean != RuntimeGetActionStateBoolean);
+
+            constexpr uint32_t Iterations = 1000000;
+            const auto measure = [&](auto&& call) {
+                const auto start = std::chrono::high_resolution_clock::now();
+                for (uint32_t i = 0; i < Iterations; i++) {
+                    Assert::IsTrue(XR_SUCCEEDED(call(i)));
+                }
+                const auto duration = std::chrono::high_resolution_clock::now() - start;
+                return std::chrono::duration<double, std::nano>(duration).count() / Iterations;
+            };
+
+            // Call the runtime through a pointer, like the layer does.
+            const PFN_xrLocateSpace volatile runtimeLocateSpace = RuntimeLocateSpace;
+            const PFN_xrGetActionStateBoolean volatile runtimeGetActionStateBoolean = RuntimeGetActionStateBoolean;
+
+            const XrSpace space = reinterpret_cast<XrSpace>(2);
+            const XrSession session = reinterpret_cast<XrSession>(3);
+            XrSpaceLocation location{XR_TYPE_SPACE_LOCATION};
+            XrActionStateGetInfo getInfo{XR_TYPE_ACTION_STATE_GET_INFO};
+            XrActionStateBoolean state{XR_TYPE_ACTION_STATE_BOOLEAN};
+
+            const double locateRuntimeNs =
+                measure([&](uint32_t i) { return runtimeLocateSpace(space, space, i, &location); });
+            const double locateActivityNs =
+                measure([&](uint32_t i) { return LocateSpaceWithActivity(space, space, i, &location); });
+            const double locateHookNs = measure([&](uint32_t i) { return xrLocateSpace(space, space, i, &location); });
+
+            const double actionRuntimeNs =
+                measure([&](uint32_t) { return runtimeGetActionStateBoolean(session, &getInfo, &state); });
+            const double actionActivityNs =
+                measure([&](uint32_t) { return GetActionStateBooleanWithActivity(session, &getInfo, &state); });
+            const double actionHookNs =
+                measure([&](uint32_t) { return xrGetActionStateBoolean(session, &getInfo, &state); });
+
+            g_instance.reset();
+            TraceLoggingUnregister(g_traceProvider);
+
+            Logger::WriteMessage("Tracing disabled, ns per call (runtime alone / previous hook / generated hook):");
+            Logger::WriteMessage(fmt::format("xrLocateSpace:           {:.1f} / {:.1f} / {:.1f}",
+                                             locateRuntimeNs,
+                                             locateActivityNs,
+                                             locateHookNs)
+                                     .c_str());
+            Logger::WriteMessage(fmt::format("xrGetActionStateBoolean: {:.1f} / {:.1f} / {:.1f}",
+                                             actionRuntimeNs,
+                                             actionActivityNs,
+                                             actionHookNs)
+                                     .c_str());
+        }
+    };
+
+} // namespace tests
@@ -0,0 +1,526 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+
+#include "fakes.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace fakes;
+    using namespace toolkit::graphics;
+
+    // Rows of the readback textures are padded, like the D3D12 readback buffers.
+    constexpr uint32_t RowPitchAlignment = 256;
+
+    uint8_t ExpectedPixel(uint32_t x, uint32_t y, uint32_t component) {
+        return (uint8_t)(x * 5 + y * 3 + component * 64);
+    }
+
+    // A readback texture whose copy completes when the test decides so.
+    class FakeReadbackTexture : public IReadbackTexture {
+      public:
+        FakeReadbackTexture(const XrSwapchainCreateInfo& info) : m_info(info) {
+        }
+
+        Api getApi() const override {
+            return Api::D3D11;
+        }
+        std::shared_ptr<IDevice> getDevice() const override {
+            return nullptr;
+        }
+        const XrSwapchainCreateInfo& getInfo() const override {
+            return m_info;
+        }
+
+        void copyFrom(std::shared_ptr<ITexture> source, int32_t srcSlice, uint32_t srcX, uint32_t srcY) override {
+            Assert::IsFalse(m_isCopying);
+            m_source = source;
+            m_srcSlice = srcSlice;
+            m_srcX = srcX;
+            m_srcY = srcY;
+            m_isCopying = true;
+            m_isReady = false;
+        }
+
+        bool isReady() override {
+            Assert::IsTrue(m_isCopying);
+            return m_isReady;
+        }
+
+        // The pixels are those of the source region (4 bytes per pixel), and the padding is garbage.
+        void readback(std::vector<uint8_t>& data, uint32_t& rowPitch) override {
+            Assert::IsTrue(m_isReady);
+            rowPitch = alignTo(m_info.width * 4, RowPitchAlignment);
+            data.assign((size_t)rowPitch * m_info.height, 0xcd);
+            for (uint32_t y = 0; y < m_info.height; y++) {
+                for (uint32_t x = 0; x < m_info.width; x++) {
+                    for (uint32_t c = 0; c < 4; c++) {
+                        data[(size_t)y * rowPitch + x * 4 + c] = ExpectedPixel(m_srcX + x, m_srcY + y, c);
+                    }
+                }
+            }
+            m_isCopying = false;
+        }
+
+        void complete() {
+            m_isReady = true;
+        }
+
+        bool isCopying() const {
+            return m_isCopying;
+        }
+
+        std::shared_ptr<ITexture> m_source;
+        int32_t m_srcSlice{-1};
+        uint32_t m_srcX{0};
+        uint32_t m_srcY{0};
+
+      private:
+        const XrSwapchainCreateInfo m_info;
+        bool m_isCopying{false};
+        bool m_isReady{false};
+    };
+
+    // A device that can only create readback textures.
+    class FakeDevice : public IDevice {
+      public:
+        Api getApi() const override {
+            return Api::D3D11;
+        }
+        const std::string& getDeviceName() const override {
+            return m_deviceName;
+        }
+        GpuArchitecture GetGpuArchitecture() const override {
+            return GpuArchitecture::Unknown;
+        }
+        int64_t getTextureFormat(TextureFormat format) const override {
+            return DXGI_FORMAT_R8G8B8A8_UNORM;
+        }
+        bool isTextureFormatSRGB(int64_t format) const override {
+            return false;
+        }
+        void saveContext(bool clear) override {
+        }
+        void restoreContext() override {
+        }
+        void flushContext(bool blocking, bool isEndOfFrame) override {
+        }
+        std::shared_ptr<ITexture> createTexture(const XrSwapchainCreateInfo& info,
+                                                std::string_view debugName,
+                                                int64_t overrideFormat,
+                                                uint32_t rowPitch,
+                                                uint32_t imageSize,
+                                                const void* initialData) override {
+            return nullptr;
+        }
+        std::shared_ptr<IReadbackTexture> createReadbackTexture(const XrSwapchainCreateInfo& info,
+                                                                std::string_view debugName) override {
+            auto readback = std::make_shared<FakeReadbackTexture>(info);
+            m_readbacks.push_back(readback);
+            return readback;
+        }
+        std::shared_ptr<IShaderBuffer> createBuffer(size_t size,
+                                                    std::string_view debugName,
+                                                    const void* initialData,
+                                                    bool immutable) override {
+            return nullptr;
+        }
+        std::shared_ptr<ISimpleMesh> createSimpleMesh(std::vector<SimpleMeshVertex>& vertices,
+                                                      std::vector<uint16_t>& indices,
+                                                      std::string_view debugName) override {
+            return nullptr;
+        }
+        std::shared_ptr<IQuadShader> createQuadShader(const std::filesystem::path& shaderFile,
+                                                      const std::string& entryPoint,
+                                                      std::string_view debugName,
+                                                      const D3D_SHADER_MACRO* defines,
+                                                      std::filesystem::path includePath) override {
+            return nullptr;
+        }
+        std::shared_ptr<IComputeShader> createComputeShader(const std::filesystem::path& shaderFile,
+                                                            const std::string& entryPoint,
+                                                            std::string_view debugName,
+                                                            const std::array<unsigned int, 3>& threadGroups,
+                                                            const D3D_SHADER_MACRO* defines,
+                                                            std::filesystem::path includePath) override {
+            return nullptr;
+        }
+        std::shared_ptr<IGpuTimer> createTimer() override {
+            return nullptr;
+        }
+        void setShader(std::shared_ptr<IQuadShader> shader, SamplerType sampler) override {
+        }
+        void setShader(std::shared_ptr<IComputeShader> shader, SamplerType sampler) override {
+        }
+        void setShaderInput(uint32_t slot, std::shared_ptr<ITexture> input, int32_t slice) override {
+        }
+        void setShaderInput(uint32_t slot, std::shared_ptr<IShaderBuffer> input) override {
+        }
+        void setShaderOutput(uint32_t slot, std::shared_ptr<ITexture> output, int32_t slice) override {
+        }
+        void dispatchShader(bool doNotClear) const override {
+        }
+        void setRenderTargets(size_t numRenderTargets,
+                              std::shared_ptr<ITexture>* renderTargets,
+                              int32_t* renderSlices,
+                              const XrRect2Di* viewport0,
+                              std::shared_ptr<ITexture> depthBuffer,
+                              int32_t depthSlice) override {
+        }
+        void unsetRenderTargets() override {
+        }
+        XrExtent2Di getViewportSize() const override {
+            return {};
+        }
+        void clearColor(float top, float left, float bottom, float right, const XrColor4f& color) const override {
+        }
+        void clearDepth(float value) override {
+        }
+        void setViewProjection(const xr::math::ViewProjection& view) override {
+        }
+        void draw(std::shared_ptr<ISimpleMesh> mesh, const XrPosef& pose, XrVector3f scaling, bool noCulling) override {
+        }
+        float drawString(std::wstring_view string,
+                         TextStyle style,
+                         float size,
+                         float x,
+                         float y,
+                         uint32_t color,
+                         bool measure,
+                         int alignment) override {
+            return 0.f;
+        }
+        float drawString(std::string_view string,
+                         TextStyle style,
+                         float size,
+                         float x,
+                         float y,
+                         uint32_t color,
+                         bool measure,
+                         int alignment) override {
+            return 0.f;
+        }
+        float measureString(std::wstring_view string, TextStyle style, float size) const override {
+            return 0.f;
+        }
+        float measureString(std::string_view string, TextStyle style, float size) const override {
+            return 0.f;
+        }
+        void beginText(bool mustKeepOldContent) override {
+        }
+        void flushText() override {
+        }
+        void setMipMapBias(toolkit::config::MipMapBias biasing, float bias) override {
+        }
+        uint32_t getNumBiasedSamplersThisFrame() const override {
+            return 0;
+        }
+        void resolveQueries() override {
+        }
+        void blockCallbacks() override {
+        }
+        void unblockCallbacks() override {
+        }
+        void registerSetRenderTargetEvent(SetRenderTargetEvent event) override {
+        }
+        void registerUnsetRenderTargetEvent(UnsetRenderTargetEvent event) override {
+        }
+        void registerCopyTextureEvent(CopyTextureEvent event) override {
+        }
+        void getVRAMUsage(uint64_t& usage, uint8_t& percentUsed) const override {
+            usage = 0;
+            percentUsed = 0;
+        }
+        void shutdown() override {
+        }
+        bool isEventsSupported() const override {
+            return false;
+        }
+        uint32_t getBufferAlignmentConstraint() const override {
+            return 0;
+        }
+        uint32_t getTextureAlignmentConstraint() const override {
+            return 0;
+        }
+        void* getNativePtr() const override {
+            return nullptr;
+        }
+        void* getContextPtr() const override {
+            return nullptr;
+        }
+        void executeDebugWorkload() override {
+        }
+
+        // Expired once the service released the readback texture.
+        std::shared_ptr<FakeReadbackTexture> getReadback(size_t index) const {
+            return m_readbacks[index].lock();
+        }
+        size_t getNumReadbacks() const {
+            return m_readbacks.size();
+        }
+
+        void completeAll() {
+            for (const auto& weakReadback : m_readbacks) {
+                const auto readback = weakReadback.lock();
+                if (readback && readback->isCopying()) {
+                    readback->complete();
+                }
+            }
+        }
+
+      private:
+        const std::string m_deviceName = "FakeDevice";
+        std::vector<std::weak_ptr<FakeReadbackTexture>> m_readbacks;
+    };
+
+    // The writer thread is not observable otherwise.
+    bool WaitForWrites(const IScreenshotService& service) {
+        const auto deadline = std::chrono::steady_clock::now() + 10s;
+        while (service.getNumPending()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return true;
+    }
+
+    std::vector<uint8_t> ReadFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios_base::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    uint32_t ReadDword(const std::vector<uint8_t>& data, size_t offset) {
+        uint32_t value;
+        memcpy(&value, data.data() + offset, sizeof(value));
+        return value;
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(ScreenshotTests) {
+        const std::filesystem::path m_directory = std::filesystem::temp_directory_path() / "OXRTK_screenshot_tests";
+
+        std::shared_ptr<FakeDevice> m_device;
+        const std::shared_ptr<ITexture> m_swapchainImage =
+            std::make_shared<FakeTexture>(256, 128, DXGI_FORMAT_R8G8B8A8_UNORM, 2);
+
+      public:
+        TEST_METHOD_INITIALIZE(Setup) {
+            std::filesystem::remove_all(m_directory);
+            std::filesystem::create_directories(m_directory);
+            m_device = std::make_shared<FakeDevice>();
+        }
+
+        TEST_METHOD_CLEANUP(Cleanup) {
+            std::filesystem::remove_all(m_directory);
+        }
+
+        TEST_METHOD(PollsReadbackBeforeWriting) {
+            auto service = CreateScreenshotService(m_device);
+            const auto path = m_directory / "left.dds";
+
+            Assert::IsTrue(service->capture(m_swapchainImage, 1, {{16, 8}, {40, 20}}, path));
+            Assert::AreEqual((size_t)1, m_device->getNumReadbacks());
+            auto readback = m_device->getReadback(0);
+            Assert::AreEqual(40u, readback->getInfo().width);
+            Assert::AreEqual(20u, readback->getInfo().height);
+            Assert::AreEqual(1u, readback->getInfo().arraySize);
+            Assert::AreEqual((int64_t)DXGI_FORMAT_R8G8B8A8_UNORM, readback->getInfo().format);
+            Assert::IsTrue(readback->m_source == m_swapchainImage);
+            Assert::AreEqual(1, readback->m_srcSlice);
+            Assert::AreEqual(16u, readback->m_srcX);
+            Assert::AreEqual(8u, readback->m_srcY);
+
+            // Nothing happens until the copy completes.
+            for (int i = 0; i < 3; i++) {
+                service->update();
+                Assert::AreEqual(1u, service->getNumPending());
+            }
+            Assert::IsFalse(std::filesystem::exists(path));
+
+            readback->complete();
+            service->update();
+            Assert::IsTrue(WaitForWrites(*service));
+
+            // The DDS file has the DX10 header, then the rows without their padding.
+            const auto data = ReadFile(path);
+            Assert::AreEqual((size_t)148 + 40 * 20 * 4, data.size());
+            Assert::AreEqual(0x20534444u, ReadDword(data, 0));
+            Assert::AreEqual(20u, ReadDword(data, 12));
+            Assert::AreEqual(40u, ReadDword(data, 16));
+            Assert::AreEqual(40u * 4, ReadDword(data, 20));
+            Assert::AreEqual((uint32_t)DXGI_FORMAT_R8G8B8A8_UNORM, ReadDword(data, 128));
+            for (uint32_t y = 0; y < 20; y++) {
+                for (uint32_t x = 0; x < 40; x++) {
+                    for (uint32_t c = 0; c < 4; c++) {
+                        Assert::AreEqual(ExpectedPixel(16 + x, 8 + y, c), data[148 + (y * 40 + x) * 4 + c]);
+                    }
+                }
+            }
+        }
+
+        TEST_METHOD(RecyclesReadbackTextures) {
+            auto service = CreateScreenshotService(m_device);
+
+            Assert::IsTrue(service->capture(m_swapchainImage, 0, {{0, 0}, {64, 64}}, m_directory / "1.dds"));
+            Assert::IsTrue(service->capture(m_swapchainImage, 1, {{0, 0}, {32, 32}}, m_directory / "2.dds"));
+            m_device->completeAll();
+            service->update();
+
+            // Both sizes are available, and each capture picks the readback texture of its size.
+            Assert::IsTrue(service->capture(m_swapchainImage, 0, {{0, 0}, {32, 32}}, m_directory / "3.dds"));
+            Assert::IsTrue(service->capture(m_swapchainImage, 1, {{0, 0}, {64, 64}}, m_directory / "4.dds"));
+            Assert::AreEqual((size_t)2, m_device->getNumReadbacks());
+            Assert::AreEqual(1, m_device->getReadback(0)->m_srcSlice);
+            Assert::AreEqual(0, m_device->getReadback(1)->m_srcSlice);
+            m_device->completeAll();
+            service->update();
+
+            // A new size replaces a free readback texture.
+            Assert::IsTrue(service->capture(m_swapchainImage, 0, {{0, 0}, {16, 16}}, m_directory / "5.dds"));
+            Assert::AreEqual((size_t)3, m_device->getNumReadbacks());
+            Assert::IsTrue(!m_device->getReadback(0) || !m_device->getReadback(1));
+            m_device->completeAll();
+            service->update();
+
+            Assert::IsTrue(WaitForWrites(*service));
+            for (int i = 1; i <= 5; i++) {
+                Assert::IsTrue(std::filesystem::exists(m_directory / fmt::format("{}.dds", i)));
+            }
+        }
+
+        TEST_METHOD(DropsCapturesBeyondLimit) {
+            auto service = CreateScreenshotService(m_device);
+
+            const ScreenshotServiceParameters defaults;
+            for (uint32_t i = 0; i < defaults.maxCapturesInFlight; i++) {
+                const auto path = m_directory / fmt::format("{}.dds", i);
+                Assert::IsTrue(service->capture(m_swapchainImage, i % 2, {{0, 0}, {32, 32}}, path));
+            }
+            Assert::IsFalse(service->capture(m_swapchainImage, 0, {{0, 0}, {32, 32}}, m_directory / "dropped.dds"));
+            Assert::AreEqual((size_t)defaults.maxCapturesInFlight, m_device->getNumReadbacks());
+            Assert::AreEqual(defaults.maxCapturesInFlight, service->getNumPending());
+
+            // Completing a single capture makes room for another one.
+            m_device->getReadback(3)->complete();
+            service->update();
+            Assert::IsTrue(service->capture(m_swapchainImage, 0, {{0, 0}, {32, 32}}, m_directory / "more.dds"));
+            Assert::AreEqual((size_t)defaults.maxCapturesInFlight, m_device->getNumReadbacks());
+
+            m_device->completeAll();
+            service->update();
+            Assert::IsTrue(WaitForWrites(*service));
+            Assert::IsFalse(std::filesystem::exists(m_directory / "dropped.dds"));
+            Assert::IsTrue(std::filesystem::exists(m_directory / "more.dds"));
+            for (uint32_t i = 0; i < defaults.maxCapturesInFlight; i++) {
+                Assert::IsTrue(std::filesystem::exists(m_directory / fmt::format("{}.dds", i)));
+            }
+        }
+
+        TEST_METHOD(DropsWritesBeyondLimit) {
+            ScreenshotServiceParameters parameters;
+            parameters.maxPendingWrites = 0;
+            auto service = CreateScreenshotService(m_device, parameters);
+
+            Assert::IsTrue(service->capture(m_swapchainImage, 0, {{0, 0}, {32, 32}}, m_directory / "dropped.dds"));
+            m_device->completeAll();
+            service->update();
+            Assert::AreEqual(0u, service->getNumPending());
+            Assert::IsTrue(WaitForWrites(*service));
+            Assert::IsFalse(std::filesystem::exists(m_directory / "dropped.dds"));
+
+            // The readback texture was still released.
+            Assert::IsTrue(service->capture(m_swapchainImage, 0, {{0, 0}, {32, 32}}, m_directory / "dropped.dds"));
+            Assert::AreEqual((size_t)1, m_device->getNumReadbacks());
+        }
+
+        TEST_METHOD(EncodesWithWIC) {
+            auto service = CreateScreenshotService(m_device);
+
+            const std::pair<const char*, std::vector<uint8_t>> files[] = {
+                {"shot.png", {0x89, 'P', 'N', 'G'}},
+                {"shot.bmp", {'B', 'M'}},
+                {"shot.jpg", {0xff, 0xd8, 0xff}},
+            };
+            for (const auto& file : files) {
+                Assert::IsTrue(service->capture(m_swapchainImage, 0, {{0, 0}, {64, 32}}, m_directory / file.first));
+            }
+            m_device->completeAll();
+            service->update();
+            Assert::IsTrue(WaitForWrites(*service));
+
+            for (const auto& file : files) {
+                const auto data = ReadFile(m_directory / file.first);
+                Assert::IsTrue(data.size() > file.second.size());
+                Assert::IsTrue(std::equal(file.second.cbegin(), file.second.cend(), data.cbegin()));
+            }
+        }
+
+        TEST_METHOD(RemovesFileOnFailure) {
+            auto service = CreateScreenshotService(m_device);
+            const auto depthBuffer = std::make_shared<FakeTexture>(256, 128, DXGI_FORMAT_D32_FLOAT);
+
+            Assert::IsTrue(service->capture(depthBuffer, 0, {{0, 0}, {32, 32}}, m_directory / "depth.png"));
+            Assert::IsTrue(service->capture(m_swapchainImage, 0, {{0, 0}, {32, 32}}, m_directory / "color.png"));
+            m_device->completeAll();
+            service->update();
+            Assert::IsTrue(WaitForWrites(*service));
+
+            // The writer carries on after a failure.
+            Assert::IsFalse(std::filesystem::exists(m_directory / "depth.png"));
+            Assert::IsTrue(std::filesystem::exists(m_directory / "color.png"));
+        }
+
+        TEST_METHOD(ShutdownWithCapturesInFlight) {
+            auto service = CreateScreenshotService(m_device);
+
+            for (int i = 0; i < 4; i++) {
+                const auto path = m_directory / fmt::format("{}.png", i);
+                Assert::IsTrue(service->capture(m_swapchainImage, 0, {{0, 0}, {256, 128}}, path));
+            }
+            m_device->getReadback(0)->complete();
+            service->update();
+            m_device->getReadback(1)->complete();
+            m_device->getReadback(2)->complete();
+
+            // The completed captures are written before the service goes away, the others are lost.
+            service.reset();
+            for (int i = 0; i < 3; i++) {
+                Assert::IsTrue(std::filesystem::exists(m_directory / fmt::format("{}.png", i)));
+            }
+            Assert::IsFalse(std::filesystem::exists(m_directory / "3.png"));
+            for (size_t i = 0; i < m_device->getNumReadbacks(); i++) {
+                Assert::IsFalse((bool)m_device->getReadback(i));
+            }
+        }
+    };
+
+} // namespace tests
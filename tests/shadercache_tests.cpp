@@ -0,0 +1,221 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "shader_utilities.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::utilities::shader;
+
+    constexpr uint32_t CompilerVersion = 47;
+    constexpr uint32_t Flags = 0x800;
+
+    const std::string Source = "[numthreads(8, 8, 1)] void main() {}";
+
+    uint64_t GetKey(const std::string& source = Source,
+                    const D3D_SHADER_MACRO* defines = nullptr,
+                    const char* entryPoint = "main",
+                    const char* target = "cs_5_0",
+                    uint32_t flags = Flags,
+                    uint32_t compilerVersion = CompilerVersion) {
+        return ShaderCache::getKey(
+            source.data(), source.size(), defines, entryPoint, target, flags, compilerVersion);
+    }
+
+    // Resolve the dependencies from a name to hash table, like the include handler would.
+    ShaderCache::DependencyResolver ResolveFrom(const std::map<std::string, uint64_t>& includes) {
+        return [includes](const std::string& name) -> std::optional<uint64_t> {
+            const auto it = includes.find(name);
+            if (it == includes.end()) {
+                return {};
+            }
+            return it->second;
+        };
+    }
+
+    std::vector<char> ReadFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios_base::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    void WriteFile(const std::filesystem::path& path, const std::vector<char>& content) {
+        std::ofstream file(path, std::ios_base::binary | std::ios_base::trunc);
+        file.write(content.data(), content.size());
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(ShaderCacheTests) {
+        const std::filesystem::path m_directory = std::filesystem::temp_directory_path() / "OXRTK_shadercache_tests";
+        const std::vector<uint8_t> m_blob = {0x44, 0x58, 0x42, 0x43, 0x01, 0x00, 0x02, 0x00, 0xff};
+        const std::vector<ShaderCache::Dependency> m_dependencies = {{"common.hlsli", 0x1234}, {"math.hlsli", 0x5678}};
+
+        std::optional<std::vector<uint8_t>> load(uint64_t key) const {
+            return ShaderCache(m_directory).load(key, ResolveFrom({{"common.hlsli", 0x1234}, {"math.hlsli", 0x5678}}));
+        }
+
+        void store(uint64_t key) const {
+            ShaderCache(m_directory).store(key, m_dependencies, m_blob.data(), m_blob.size());
+        }
+
+      public:
+        TEST_METHOD_INITIALIZE(Setup) {
+            std::filesystem::remove_all(m_directory);
+        }
+
+        TEST_METHOD_CLEANUP(Cleanup) {
+            std::filesystem::remove_all(m_directory);
+        }
+
+        TEST_METHOD(KeyCoversCompilerInputs) {
+            const D3D_SHADER_MACRO defines[] = {{"A", "1"}, {"B", nullptr}, {nullptr, nullptr}};
+            const uint64_t key = GetKey(Source, defines);
+            Assert::AreEqual(key, GetKey(Source, defines));
+
+            const D3D_SHADER_MACRO otherValue[] = {{"A", "2"}, {"B", nullptr}, {nullptr, nullptr}};
+            const D3D_SHADER_MACRO otherName[] = {{"A", "1"}, {"C", nullptr}, {nullptr, nullptr}};
+            const D3D_SHADER_MACRO fewer[] = {{"A", "1"}, {nullptr, nullptr}};
+            const std::set<uint64_t> keys = {key,
+                                             GetKey(Source + " ", defines),
+                                             GetKey(Source, otherValue),
+                                             GetKey(Source, otherName),
+                                             GetKey(Source, fewer),
+                                             GetKey(Source, nullptr),
+                                             GetKey(Source, defines, "main2"),
+                                             GetKey(Source, defines, "main", "cs_5_1"),
+                                             GetKey(Source, defines, "main", "cs_5_0", Flags | 1),
+                                             GetKey(Source, defines, "main", "cs_5_0", Flags, CompilerVersion + 1)};
+            Assert::AreEqual((size_t)10, keys.size());
+
+            // A define without a value is the same as an empty value.
+            const D3D_SHADER_MACRO emptyValue[] = {{"A", "1"}, {"B", ""}, {nullptr, nullptr}};
+            Assert::AreEqual(key, GetKey(Source, emptyValue));
+        }
+
+        TEST_METHOD(KeyDoesNotAliasStrings) {
+            const D3D_SHADER_MACRO defines1[] = {{"AB", "C"}, {nullptr, nullptr}};
+            const D3D_SHADER_MACRO defines2[] = {{"A", "BC"}, {nullptr, nullptr}};
+            Assert::AreNotEqual(GetKey(Source, defines1), GetKey(Source, defines2));
+            Assert::AreNotEqual(GetKey(Source, nullptr, "mainc", "s_5_0"), GetKey(Source, nullptr, "main", "cs_5_0"));
+        }
+
+        TEST_METHOD(StoreThenLoad) {
+            const uint64_t key = GetKey();
+            Assert::IsFalse(load(key).has_value());
+
+            store(key);
+            const auto blob = load(key);
+            Assert::IsTrue(blob.has_value());
+            Assert::IsTrue(*blob == m_blob);
+
+            // Only the entry remains (no temporary file).
+            uint32_t numFiles = 0;
+            for (const auto& entry : std::filesystem::directory_iterator(m_directory)) {
+                Assert::IsTrue(entry.path() == ShaderCache(m_directory).getEntryPath(key));
+                numFiles++;
+            }
+            Assert::AreEqual(1u, numFiles);
+        }
+
+        TEST_METHOD(MissWhenIncludeChanges) {
+            const uint64_t key = GetKey();
+            store(key);
+
+            const ShaderCache cache(m_directory);
+            const auto loadWith = [&](const std::map<std::string, uint64_t>& includes) {
+                return cache.load(key, ResolveFrom(includes)).has_value();
+            };
+            Assert::IsTrue(loadWith({{"common.hlsli", 0x1234}, {"math.hlsli", 0x5678}}));
+            Assert::IsFalse(loadWith({{"common.hlsli", 0x1234}, {"math.hlsli", 0x5679}}));
+            Assert::IsFalse(loadWith({{"common.hlsli", 0x1234}}));
+        }
+
+        TEST_METHOD(MissWhenEntryIsForAnotherKey) {
+            const uint64_t key = GetKey();
+            const uint64_t otherKey = GetKey(Source + " ");
+            store(key);
+
+            const ShaderCache cache(m_directory);
+            std::filesystem::copy_file(cache.getEntryPath(key), cache.getEntryPath(otherKey));
+            Assert::IsFalse(load(otherKey).has_value());
+        }
+
+        TEST_METHOD(MissWhenEntryIsCorrupted) {
+            const uint64_t key = GetKey();
+            store(key);
+            const auto path = ShaderCache(m_directory).getEntryPath(key);
+            const std::vector<char> content = ReadFile(path);
+
+            // Flip each byte in turn: the header, the dependencies, the blob and its hash are all checked.
+            for (size_t i = 0; i < content.size(); i++) {
+                auto corrupted = content;
+                corrupted[i] ^= 0x10;
+                WriteFile(path, corrupted);
+                Assert::IsFalse(load(key).has_value());
+            }
+
+            // Truncate at every length.
+            for (size_t i = 0; i < content.size(); i++) {
+                WriteFile(path, std::vector<char>(content.begin(), content.begin() + i));
+                Assert::IsFalse(load(key).has_value());
+            }
+
+            WriteFile(path, content);
+            Assert::IsTrue(load(key).has_value());
+        }
+
+        TEST_METHOD(ConcurrentStores) {
+            const uint64_t key = GetKey();
+
+            std::vector<std::thread> writers;
+            for (int i = 0; i < 4; i++) {
+                writers.emplace_back([&] {
+                    for (int j = 0; j < 20; j++) {
+                        store(key);
+                    }
+                });
+            }
+            for (int i = 0; i < 100; i++) {
+                // A reader never sees a partial entry.
+                const auto blob = load(key);
+                Assert::IsTrue(!blob || *blob == m_blob);
+            }
+            for (auto& writer : writers) {
+                writer.join();
+            }
+
+            Assert::IsTrue(load(key).has_value());
+            uint32_t numFiles = 0;
+            for (const auto& entry : std::filesystem::directory_iterator(m_directory)) {
+                numFiles++;
+            }
+            Assert::AreEqual(1u, numFiles);
+        }
+    };
+
+} // namespace tests
@@ -0,0 +1,329 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::utilities;
+
+    // A record where every timing is derived from the frame index, so that a torn read can be detected.
+    FrameStatistics MakeRecord(uint64_t index) {
+        FrameStatistics stats;
+        stats.frameIndex = index;
+        stats.timestampUs = static_cast<int64_t>(index * 11111);
+        stats.appCpuTimeUs = index + 1;
+        stats.renderCpuTimeUs = index + 2;
+        stats.appGpuTimeUs = index + 3;
+        stats.waitCpuTimeUs = index + 4;
+        stats.endFrameCpuTimeUs = index + 5;
+        stats.processorGpuTimeUs[0] = index + 6;
+        stats.processorGpuTimeUs[1] = index + 7;
+        stats.overlayCpuTimeUs = index + 8;
+        stats.overlayGpuTimeUs = index + 9;
+        stats.handTrackingCpuTimeUs = index + 10;
+        stats.predictionTimeUs = index + 11;
+        return stats;
+    }
+
+    bool IsConsistent(const FrameStatistics& stats) {
+        const FrameStatistics expected = MakeRecord(stats.frameIndex);
+        return std::memcmp(&stats, &expected, sizeof(stats)) == 0;
+    }
+
+    // The exact quantile, using the same rounding as the estimator for small sample counts.
+    double ExactQuantile(std::vector<double> samples, double quantile) {
+        const size_t rank = static_cast<size_t>(std::round((samples.size() - 1) * quantile));
+        std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+        return samples[rank];
+    }
+
+    // Compare the estimated p50/p95/p99 to the exact ones, within a tolerance relative to the exact value.
+    template <typename Distribution>
+    void CheckQuantiles(Distribution distribution, double tolerance) {
+        std::mt19937 random(1);
+        std::vector<double> samples(20000);
+        for (auto& sample : samples) {
+            sample = distribution(random);
+        }
+
+        for (const double quantile : FrameTimingQuantiles) {
+            auto estimator = CreateQuantileEstimator(quantile);
+            for (const double sample : samples) {
+                estimator->addSample(sample);
+            }
+
+            const double exact = ExactQuantile(samples, quantile);
+            const double estimate = estimator->query();
+            Logger::WriteMessage(
+                fmt::format("p{:.0f}: exact {:.2f}, estimate {:.2f}", quantile * 100, exact, estimate).c_str());
+            Assert::AreEqual((uint64_t)samples.size(), estimator->getSampleCount());
+            Assert::AreEqual(exact, estimate, exact * tolerance);
+        }
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(FrameStatisticsHistoryTests) {
+      public:
+        TEST_METHOD(ReadsPushedRecords) {
+            auto history = CreateFrameStatisticsHistory(8);
+            FrameStatistics stats;
+            Assert::IsFalse(history->read(0, stats));
+
+            for (uint64_t i = 0; i < 5; i++) {
+                history->push(MakeRecord(i));
+            }
+
+            Assert::AreEqual((uint64_t)5, history->getHead());
+            for (uint64_t i = 0; i < 5; i++) {
+                Assert::IsTrue(history->read(i, stats));
+                Assert::AreEqual(i, stats.frameIndex);
+                Assert::IsTrue(IsConsistent(stats));
+            }
+            Assert::IsFalse(history->read(5, stats));
+        }
+
+        TEST_METHOD(WrapsAround) {
+            auto history = CreateFrameStatisticsHistory(8);
+            for (uint64_t i = 0; i < 21; i++) {
+                history->push(MakeRecord(i));
+            }
+
+            FrameStatistics stats;
+            for (uint64_t i = 0; i < 13; i++) {
+                // Overwritten by a more recent frame.
+                Assert::IsFalse(history->read(i, stats));
+            }
+            for (uint64_t i = 13; i < 21; i++) {
+                Assert::IsTrue(history->read(i, stats));
+                Assert::AreEqual(i, stats.frameIndex);
+                Assert::IsTrue(IsConsistent(stats));
+            }
+
+            // Same slot as index 13, not written yet.
+            Assert::IsFalse(history->read(21, stats));
+        }
+
+        TEST_METHOD(ReadersNeverSeeTornRecords) {
+            // The producer keeps overwriting the slot being read.
+            auto history = CreateFrameStatisticsHistory(1);
+            constexpr uint64_t NumReads = 200000;
+
+            std::atomic<bool> stop{false};
+            std::atomic<uint64_t> numReads{0};
+            std::atomic<uint64_t> numTornReads{0};
+            std::vector<std::thread> readers;
+            for (int i = 0; i < 3; i++) {
+                readers.emplace_back([&] {
+                    FrameStatistics stats;
+                    while (!stop) {
+                        const uint64_t head = history->getHead();
+                        if (head && history->read(head - 1, stats)) {
+                            numReads++;
+                            if (stats.frameIndex != head - 1 || !IsConsistent(stats)) {
+                                numTornReads++;
+                            }
+                        }
+                    }
+                });
+            }
+
+            // Keep overwriting the records until the readers got enough of them.
+            const auto timeout = std::chrono::steady_clock::now() + 10s;
+            uint64_t numRecords = 0;
+            while (numReads < NumReads && std::chrono::steady_clock::now() < timeout) {
+                history->push(MakeRecord(numRecords++));
+            }
+            stop = true;
+            for (auto& reader : readers) {
+                reader.join();
+            }
+
+            Logger::WriteMessage(
+                fmt::format("{} records pushed, {} successful reads", numRecords, numReads.load()).c_str());
+            Assert::AreEqual((uint64_t)0, numTornReads.load());
+            Assert::AreEqual(numRecords, history->getHead());
+            Assert::IsTrue(numReads >= NumReads);
+        }
+    };
+
+    TEST_CLASS(FrameStatisticsRecorderTests) {
+        const std::filesystem::path m_directory = std::filesystem::temp_directory_path() / "OXRTK_stats_tests";
+
+        std::vector<FrameStatistics> readRecords(const std::filesystem::path& path) const {
+            std::ifstream file(path, std::ios_base::binary);
+            FrameStatisticsFileHeader header{};
+            file.read(reinterpret_cast<char*>(&header), sizeof(header));
+            Assert::IsTrue(std::equal(
+                std::begin(header.magic), std::end(header.magic), std::begin(FrameStatisticsFileHeader::Magic)));
+            Assert::AreEqual(FrameStatisticsFileHeader::CurrentVersion, header.version);
+            Assert::AreEqual((uint32_t)sizeof(FrameStatistics), header.recordSize);
+
+            std::vector<FrameStatistics> records;
+            FrameStatistics stats;
+            while (file.read(reinterpret_cast<char*>(&stats), sizeof(stats))) {
+                records.push_back(stats);
+            }
+            return records;
+        }
+
+      public:
+        TEST_METHOD_INITIALIZE(Setup) {
+            std::filesystem::remove_all(m_directory);
+            std::filesystem::create_directories(m_directory);
+        }
+
+        TEST_METHOD_CLEANUP(Cleanup) {
+            std::filesystem::remove_all(m_directory);
+        }
+
+        TEST_METHOD(WritesEveryRecord) {
+            auto history = CreateFrameStatisticsHistory(1024);
+
+            // Frames from before the recording started are not written.
+            history->push(MakeRecord(0));
+
+            const auto path = m_directory / "stats.bin";
+            {
+                auto recorder = CreateFrameStatisticsRecorder(history, path);
+                for (uint64_t i = 1; i <= 500; i++) {
+                    history->push(MakeRecord(i));
+                }
+                // Stopping the recorder drains the history.
+                recorder.reset();
+            }
+
+            const auto records = readRecords(path);
+            Assert::AreEqual((size_t)500, records.size());
+            for (size_t i = 0; i < records.size(); i++) {
+                Assert::AreEqual((uint64_t)i + 1, records[i].frameIndex);
+                Assert::IsTrue(IsConsistent(records[i]));
+            }
+        }
+
+        TEST_METHOD(CountsDroppedRecords) {
+            // The recorder cannot keep up with a tiny history.
+            auto history = CreateFrameStatisticsHistory(4);
+            constexpr uint64_t NumRecords = 5000;
+
+            const auto path = m_directory / "stats.bin";
+            {
+                auto recorder = CreateFrameStatisticsRecorder(history, path);
+                for (uint64_t i = 0; i < NumRecords; i++) {
+                    history->push(MakeRecord(i));
+                }
+
+                // Wait for the recorder to notice.
+                const auto timeout = std::chrono::steady_clock::now() + 5s;
+                while (!recorder->getNumRecordsDropped() && std::chrono::steady_clock::now() < timeout) {
+                    std::this_thread::sleep_for(10ms);
+                }
+                Assert::IsTrue(recorder->getNumRecordsDropped() > 0);
+            }
+
+            // The gaps are visible in the frame indices, and the most recent records are never lost.
+            const auto records = readRecords(path);
+            Assert::IsTrue(records.size() >= history->getCapacity());
+            Assert::IsTrue(records.size() < NumRecords);
+            for (size_t i = 0; i < records.size(); i++) {
+                Assert::IsTrue(IsConsistent(records[i]));
+                if (i > 0) {
+                    Assert::IsTrue(records[i].frameIndex > records[i - 1].frameIndex);
+                }
+            }
+            Assert::AreEqual(NumRecords - 1, records.back().frameIndex);
+        }
+    };
+
+    TEST_CLASS(QuantileEstimatorTests) {
+      public:
+        TEST_METHOD(ExactWithFewSamples) {
+            auto estimator = CreateQuantileEstimator(0.5);
+            Assert::AreEqual(0.0, estimator->query());
+
+            estimator->addSample(30);
+            Assert::AreEqual(30.0, estimator->query());
+            estimator->addSample(10);
+            estimator->addSample(20);
+            Assert::AreEqual(20.0, estimator->query());
+
+            auto p95 = CreateQuantileEstimator(0.95);
+            for (const double sample : {5, 1, 4, 2, 3}) {
+                p95->addSample(sample);
+            }
+            Assert::AreEqual(5.0, p95->query());
+        }
+
+        TEST_METHOD(Reset) {
+            auto estimator = CreateQuantileEstimator(0.99);
+            for (int i = 0; i < 1000; i++) {
+                estimator->addSample(1000.0 + i);
+            }
+            estimator->reset();
+            Assert::AreEqual((uint64_t)0, estimator->getSampleCount());
+
+            // No trace of the previous window.
+            for (int i = 0; i < 1000; i++) {
+                estimator->addSample(i);
+            }
+            Assert::AreEqual(990.0, estimator->query(), 10.0);
+        }
+
+        TEST_METHOD(UniformDistribution) {
+            CheckQuantiles(std::uniform_real_distribution<double>(5000, 15000), 0.01);
+        }
+
+        TEST_METHOD(NormalDistribution) {
+            CheckQuantiles(std::normal_distribution<double>(11000, 500), 0.01);
+        }
+
+        TEST_METHOD(LongTailDistribution) {
+            // Frame times: mostly steady, with an exponential tail of hitches.
+            std::exponential_distribution<double> tail(1.0 / 2000);
+            CheckQuantiles([&](std::mt19937& random) { return 9000 + tail(random); }, 0.03);
+        }
+
+        TEST_METHOD(SortedSamples) {
+            // A worst case for the markers: monotonically increasing frame times.
+            std::vector<double> samples(5000);
+            std::iota(samples.begin(), samples.end(), 1000.0);
+            for (const double quantile : FrameTimingQuantiles) {
+                auto estimator = CreateQuantileEstimator(quantile);
+                for (const double sample : samples) {
+                    estimator->addSample(sample);
+                }
+                const double exact = ExactQuantile(samples, quantile);
+                Assert::AreEqual(exact, estimator->query(), exact * 0.01);
+            }
+        }
+    };
+
+} // namespace tests
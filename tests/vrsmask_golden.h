@@ -0,0 +1,451 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+// The expected VRS masks for a 1024x896 render target with 16x16 tiles, one hexadecimal digit per tile (NVAPI shading
+// rates: 4 is 1x, 5 is 1/2x, 7 is 1/4x, a is 1/16x). When a change to the masks is intended, the tests print the
+// actual masks in this format.
+
+namespace golden {
+
+    // Wide pattern (inner ring 55%, middle ring 80%), Quality rates (1x, 1/2x, 1/4x).
+    const char* const WideQuality[] = {
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777775555555555555555557777777777777777777777",
+        "7777777777777777777755555555555555555555555555777777777777777777",
+        "7777777777777777775555555555555555555555555555555777777777777777",
+        "7777777777777775555555555555555555555555555555555557777777777777",
+        "7777777777777555555555555555555555555555555555555555577777777777",
+        "7777777777775555555555555555555555555555555555555555555777777777",
+        "7777777777555555555555555555555555555555555555555555555577777777",
+        "7777777775555555555555555544444444444444455555555555555555777777",
+        "7777777755555555555555544444444444444444444455555555555555577777",
+        "7777777555555555555544444444444444444444444444555555555555557777",
+        "7777775555555555555444444444444444444444444444445555555555555777",
+        "7777755555555555544444444444444444444444444444444555555555555577",
+        "7777555555555555444444444444444444444444444444444445555555555577",
+        "7777555555555554444444444444444444444444444444444444555555555557",
+        "7775555555555544444444444444444444444444444444444444555555555557",
+        "7775555555555444444444444444444444444444444444444444455555555555",
+        "7755555555555444444444444444444444444444444444444444445555555555",
+        "7755555555554444444444444444444444444444444444444444445555555555",
+        "7755555555554444444444444444444444444444444444444444444555555555",
+        "7555555555554444444444444444444444444444444444444444444555555555",
+        "7555555555544444444444444444444444444444444444444444444555555555",
+        "7555555555544444444444444444444444444444444444444444444555555555",
+        "7555555555544444444444444444444444444444444444444444444555555555",
+        "7555555555544444444444444444444444444444444444444444444555555555",
+        "7555555555554444444444444444444444444444444444444444444555555555",
+        "7755555555554444444444444444444444444444444444444444444555555555",
+        "7755555555554444444444444444444444444444444444444444445555555555",
+        "7755555555555444444444444444444444444444444444444444445555555555",
+        "7775555555555444444444444444444444444444444444444444455555555555",
+        "7775555555555544444444444444444444444444444444444444555555555557",
+        "7777555555555554444444444444444444444444444444444444555555555557",
+        "7777555555555555444444444444444444444444444444444445555555555577",
+        "7777755555555555544444444444444444444444444444444555555555555577",
+        "7777775555555555555444444444444444444444444444445555555555555777",
+        "7777777555555555555544444444444444444444444444555555555555557777",
+        "7777777755555555555555544444444444444444444455555555555555577777",
+        "7777777775555555555555555544444444444444455555555555555555777777",
+        "7777777777555555555555555555555555555555555555555555555577777777",
+        "7777777777775555555555555555555555555555555555555555555777777777",
+        "7777777777777555555555555555555555555555555555555555577777777777",
+        "7777777777777775555555555555555555555555555555555557777777777777",
+        "7777777777777777775555555555555555555555555555555777777777777777",
+        "7777777777777777777755555555555555555555555555777777777777777777",
+        "7777777777777777777777775555555555555555557777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+    };
+
+    // Wide pattern, Performance rates (1x, 1/4x, 1/16x).
+    const char* const WidePerformance[] = {
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaa777777777777777777aaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaa77777777777777777777777777aaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaa7777777777777777777777777777777aaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaa777777777777777777777777777777777777aaaaaaaaaaaaa",
+        "aaaaaaaaaaaaa7777777777777777777777777777777777777777aaaaaaaaaaa",
+        "aaaaaaaaaaaa7777777777777777777777777777777777777777777aaaaaaaaa",
+        "aaaaaaaaaa7777777777777777777777777777777777777777777777aaaaaaaa",
+        "aaaaaaaaa7777777777777777744444444444444477777777777777777aaaaaa",
+        "aaaaaaaa777777777777777444444444444444444444777777777777777aaaaa",
+        "aaaaaaa77777777777774444444444444444444444444477777777777777aaaa",
+        "aaaaaa7777777777777444444444444444444444444444447777777777777aaa",
+        "aaaaa777777777777444444444444444444444444444444447777777777777aa",
+        "aaaa7777777777774444444444444444444444444444444444477777777777aa",
+        "aaaa77777777777444444444444444444444444444444444444477777777777a",
+        "aaa777777777774444444444444444444444444444444444444477777777777a",
+        "aaa7777777777444444444444444444444444444444444444444477777777777",
+        "aa77777777777444444444444444444444444444444444444444447777777777",
+        "aa77777777774444444444444444444444444444444444444444447777777777",
+        "aa77777777774444444444444444444444444444444444444444444777777777",
+        "a777777777774444444444444444444444444444444444444444444777777777",
+        "a777777777744444444444444444444444444444444444444444444777777777",
+        "a777777777744444444444444444444444444444444444444444444777777777",
+        "a777777777744444444444444444444444444444444444444444444777777777",
+        "a777777777744444444444444444444444444444444444444444444777777777",
+        "a777777777774444444444444444444444444444444444444444444777777777",
+        "aa77777777774444444444444444444444444444444444444444444777777777",
+        "aa77777777774444444444444444444444444444444444444444447777777777",
+        "aa77777777777444444444444444444444444444444444444444447777777777",
+        "aaa7777777777444444444444444444444444444444444444444477777777777",
+        "aaa777777777774444444444444444444444444444444444444477777777777a",
+        "aaaa77777777777444444444444444444444444444444444444477777777777a",
+        "aaaa7777777777774444444444444444444444444444444444477777777777aa",
+        "aaaaa777777777777444444444444444444444444444444447777777777777aa",
+        "aaaaaa7777777777777444444444444444444444444444447777777777777aaa",
+        "aaaaaaa77777777777774444444444444444444444444477777777777777aaaa",
+        "aaaaaaaa777777777777777444444444444444444444777777777777777aaaaa",
+        "aaaaaaaaa7777777777777777744444444444444477777777777777777aaaaaa",
+        "aaaaaaaaaa7777777777777777777777777777777777777777777777aaaaaaaa",
+        "aaaaaaaaaaaa7777777777777777777777777777777777777777777aaaaaaaaa",
+        "aaaaaaaaaaaaa7777777777777777777777777777777777777777aaaaaaaaaaa",
+        "aaaaaaaaaaaaaaa777777777777777777777777777777777777aaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaa7777777777777777777777777777777aaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaa77777777777777777777777777aaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaa777777777777777777aaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+    };
+
+    // Balanced pattern (inner ring 50%, middle ring 60%), Quality rates.
+    const char* const BalancedQuality[] = {
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777755555555577777777777777777777777777",
+        "7777777777777777777777775555555555555555555777777777777777777777",
+        "7777777777777777777775555555555555555555555557777777777777777777",
+        "7777777777777777777555555555444444444445555555557777777777777777",
+        "7777777777777777755555554444444444444444445555555777777777777777",
+        "7777777777777777555555444444444444444444444445555557777777777777",
+        "7777777777777775555544444444444444444444444444455555777777777777",
+        "7777777777777555555444444444444444444444444444445555577777777777",
+        "7777777777777555544444444444444444444444444444444555557777777777",
+        "7777777777775555444444444444444444444444444444444455555777777777",
+        "7777777777755555444444444444444444444444444444444445555777777777",
+        "7777777777755554444444444444444444444444444444444444555577777777",
+        "7777777777555544444444444444444444444444444444444444555577777777",
+        "7777777777555544444444444444444444444444444444444444455557777777",
+        "7777777777555544444444444444444444444444444444444444455557777777",
+        "7777777775555444444444444444444444444444444444444444455557777777",
+        "7777777775555444444444444444444444444444444444444444455557777777",
+        "7777777775555444444444444444444444444444444444444444455557777777",
+        "7777777775555444444444444444444444444444444444444444455557777777",
+        "7777777777555544444444444444444444444444444444444444455557777777",
+        "7777777777555544444444444444444444444444444444444444455557777777",
+        "7777777777555544444444444444444444444444444444444444555577777777",
+        "7777777777755554444444444444444444444444444444444444555577777777",
+        "7777777777755555444444444444444444444444444444444445555777777777",
+        "7777777777775555444444444444444444444444444444444455555777777777",
+        "7777777777777555544444444444444444444444444444444555557777777777",
+        "7777777777777555555444444444444444444444444444445555577777777777",
+        "7777777777777775555544444444444444444444444444455555777777777777",
+        "7777777777777777555555444444444444444444444445555557777777777777",
+        "7777777777777777755555554444444444444444445555555777777777777777",
+        "7777777777777777777555555555444444444445555555557777777777777777",
+        "7777777777777777777775555555555555555555555557777777777777777777",
+        "7777777777777777777777775555555555555555555777777777777777777777",
+        "7777777777777777777777777777755555555577777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+    };
+
+    // Balanced pattern, Performance rates.
+    const char* const BalancedPerformance[] = {
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaa777777777aaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaa7777777777777777777aaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaa777777777777777777777777aaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaa77777777744444444444777777777aaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaa77777774444444444444444447777777aaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaa77777744444444444444444444444777777aaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaa7777744444444444444444444444444477777aaaaaaaaaaaa",
+        "aaaaaaaaaaaaa7777774444444444444444444444444444477777aaaaaaaaaaa",
+        "aaaaaaaaaaaaa77774444444444444444444444444444444477777aaaaaaaaaa",
+        "aaaaaaaaaaaa7777444444444444444444444444444444444477777aaaaaaaaa",
+        "aaaaaaaaaaa77777444444444444444444444444444444444447777aaaaaaaaa",
+        "aaaaaaaaaaa777744444444444444444444444444444444444447777aaaaaaaa",
+        "aaaaaaaaaa7777444444444444444444444444444444444444447777aaaaaaaa",
+        "aaaaaaaaaa77774444444444444444444444444444444444444447777aaaaaaa",
+        "aaaaaaaaaa77774444444444444444444444444444444444444447777aaaaaaa",
+        "aaaaaaaaa777744444444444444444444444444444444444444447777aaaaaaa",
+        "aaaaaaaaa777744444444444444444444444444444444444444447777aaaaaaa",
+        "aaaaaaaaa777744444444444444444444444444444444444444447777aaaaaaa",
+        "aaaaaaaaa777744444444444444444444444444444444444444447777aaaaaaa",
+        "aaaaaaaaaa77774444444444444444444444444444444444444447777aaaaaaa",
+        "aaaaaaaaaa77774444444444444444444444444444444444444447777aaaaaaa",
+        "aaaaaaaaaa7777444444444444444444444444444444444444447777aaaaaaaa",
+        "aaaaaaaaaaa777744444444444444444444444444444444444447777aaaaaaaa",
+        "aaaaaaaaaaa77777444444444444444444444444444444444447777aaaaaaaaa",
+        "aaaaaaaaaaaa7777444444444444444444444444444444444477777aaaaaaaaa",
+        "aaaaaaaaaaaaa77774444444444444444444444444444444477777aaaaaaaaaa",
+        "aaaaaaaaaaaaa7777774444444444444444444444444444477777aaaaaaaaaaa",
+        "aaaaaaaaaaaaaaa7777744444444444444444444444444477777aaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaa77777744444444444444444444444777777aaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaa77777774444444444444444447777777aaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaa77777777744444444444777777777aaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaa777777777777777777777777aaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaa7777777777777777777aaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaa777777777aaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+    };
+
+    // Narrow pattern (inner ring 30%, middle ring 55%), Quality rates.
+    const char* const NarrowQuality[] = {
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777755555555555555577777777777777777777777",
+        "7777777777777777777777755555555555555555555577777777777777777777",
+        "7777777777777777777755555555555555555555555555777777777777777777",
+        "7777777777777777777555555555555555555555555555557777777777777777",
+        "7777777777777777755555555555555555555555555555555777777777777777",
+        "7777777777777777555555555555555555555555555555555557777777777777",
+        "7777777777777775555555555555555555555555555555555555777777777777",
+        "7777777777777755555555555555444444444445555555555555777777777777",
+        "7777777777777555555555555544444444444444455555555555577777777777",
+        "7777777777777555555555554444444444444444445555555555557777777777",
+        "7777777777775555555555544444444444444444444555555555557777777777",
+        "7777777777775555555555444444444444444444444455555555555777777777",
+        "7777777777775555555555444444444444444444444445555555555777777777",
+        "7777777777755555555554444444444444444444444445555555555777777777",
+        "7777777777755555555554444444444444444444444445555555555777777777",
+        "7777777777755555555554444444444444444444444445555555555777777777",
+        "7777777777755555555554444444444444444444444445555555555777777777",
+        "7777777777775555555555444444444444444444444445555555555777777777",
+        "7777777777775555555555444444444444444444444455555555555777777777",
+        "7777777777775555555555544444444444444444444555555555557777777777",
+        "7777777777777555555555554444444444444444445555555555557777777777",
+        "7777777777777555555555555544444444444444455555555555577777777777",
+        "7777777777777755555555555555444444444445555555555555777777777777",
+        "7777777777777775555555555555555555555555555555555555777777777777",
+        "7777777777777777555555555555555555555555555555555557777777777777",
+        "7777777777777777755555555555555555555555555555555777777777777777",
+        "7777777777777777777555555555555555555555555555557777777777777777",
+        "7777777777777777777755555555555555555555555555777777777777777777",
+        "7777777777777777777777755555555555555555555577777777777777777777",
+        "7777777777777777777777777755555555555555577777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+        "7777777777777777777777777777777777777777777777777777777777777777",
+    };
+
+    // Narrow pattern, Performance rates.
+    const char* const NarrowPerformance[] = {
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaa777777777777777aaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaa777777777777777777777aaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaa77777777777777777777777777aaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaa77777777777777777777777777777aaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaa77777777777777777777777777777777aaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaa77777777777777777777777777777777777aaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaa7777777777777777777777777777777777777aaaaaaaaaaaa",
+        "aaaaaaaaaaaaaa77777777777777444444444447777777777777aaaaaaaaaaaa",
+        "aaaaaaaaaaaaa7777777777777444444444444444777777777777aaaaaaaaaaa",
+        "aaaaaaaaaaaaa77777777777444444444444444444777777777777aaaaaaaaaa",
+        "aaaaaaaaaaaa777777777774444444444444444444477777777777aaaaaaaaaa",
+        "aaaaaaaaaaaa7777777777444444444444444444444477777777777aaaaaaaaa",
+        "aaaaaaaaaaaa7777777777444444444444444444444447777777777aaaaaaaaa",
+        "aaaaaaaaaaa77777777774444444444444444444444447777777777aaaaaaaaa",
+        "aaaaaaaaaaa77777777774444444444444444444444447777777777aaaaaaaaa",
+        "aaaaaaaaaaa77777777774444444444444444444444447777777777aaaaaaaaa",
+        "aaaaaaaaaaa77777777774444444444444444444444447777777777aaaaaaaaa",
+        "aaaaaaaaaaaa7777777777444444444444444444444447777777777aaaaaaaaa",
+        "aaaaaaaaaaaa7777777777444444444444444444444477777777777aaaaaaaaa",
+        "aaaaaaaaaaaa777777777774444444444444444444477777777777aaaaaaaaaa",
+        "aaaaaaaaaaaaa77777777777444444444444444444777777777777aaaaaaaaaa",
+        "aaaaaaaaaaaaa7777777777777444444444444444777777777777aaaaaaaaaaa",
+        "aaaaaaaaaaaaaa77777777777777444444444447777777777777aaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaa7777777777777777777777777777777777777aaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaa77777777777777777777777777777777777aaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaa77777777777777777777777777777777aaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaa77777777777777777777777777777aaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaa77777777777777777777777777aaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaa777777777777777777777aaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaa777777777777777aaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+    };
+
+    // Narrow pattern, Performance rates, gaze at (-0.4, -0.3) in NDC.
+    const char* const OffCenterGaze[] = {
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaa77777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaa7777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaa777777777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaa7777777777777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaa7777777777777777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aa7777777777777777777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "a777777777777777777777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "77777777777777744444444777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "777777777777444444444444447777777777777aaaaaaaaaaaaaaaaaaaaaaaaa",
+        "7777777777744444444444444444777777777777aaaaaaaaaaaaaaaaaaaaaaaa",
+        "7777777774444444444444444444477777777777aaaaaaaaaaaaaaaaaaaaaaaa",
+        "7777777774444444444444444444447777777777aaaaaaaaaaaaaaaaaaaaaaaa",
+        "77777777444444444444444444444477777777777aaaaaaaaaaaaaaaaaaaaaaa",
+        "77777777444444444444444444444447777777777aaaaaaaaaaaaaaaaaaaaaaa",
+        "77777774444444444444444444444447777777777aaaaaaaaaaaaaaaaaaaaaaa",
+        "77777774444444444444444444444447777777777aaaaaaaaaaaaaaaaaaaaaaa",
+        "77777774444444444444444444444447777777777aaaaaaaaaaaaaaaaaaaaaaa",
+        "77777777444444444444444444444447777777777aaaaaaaaaaaaaaaaaaaaaaa",
+        "77777777444444444444444444444477777777777aaaaaaaaaaaaaaaaaaaaaaa",
+        "7777777774444444444444444444447777777777aaaaaaaaaaaaaaaaaaaaaaaa",
+        "7777777777444444444444444444477777777777aaaaaaaaaaaaaaaaaaaaaaaa",
+        "777777777774444444444444444777777777777aaaaaaaaaaaaaaaaaaaaaaaaa",
+        "777777777777744444444444447777777777777aaaaaaaaaaaaaaaaaaaaaaaaa",
+        "77777777777777774444447777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "a777777777777777777777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaa777777777777777777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaa777777777777777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaa777777777777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaa77777777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaa777777777777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaa777777777aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa",
+    };
+
+} // namespace golden
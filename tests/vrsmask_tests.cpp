@@ -0,0 +1,155 @@
+// MIT License
+//
+// Copyright(c) 2021-2022 Matthieu Bucchianeri
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this softwareand associated documentation files(the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and /or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions :
+//
+// The above copyright noticeand this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "pch.h"
+
+#include "factories.h"
+#include "interfaces.h"
+
+#include "vrsmask_golden.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace {
+
+    using namespace toolkit::graphics;
+
+    // A 1024x896 render target with 16x16 tiles.
+    constexpr uint32_t WidthInTiles = 64;
+    constexpr uint32_t HeightInTiles = 56;
+
+    // The NVAPI (D3D11) shading rates used by the layer: 1x, 1/2x (2x1), 1/4x (2x2), 1/16x (4x4).
+    constexpr uint8_t RateX1 = 4;
+    constexpr uint8_t Rate2x1 = 5;
+    constexpr uint8_t Rate2x2 = 7;
+    constexpr uint8_t Rate4x4 = 10;
+
+    // Same as the VRS presets: the radii (in percent of the half-height) of the inner and middle rings, with the
+    // default horizontal scale of 125%.
+    ShadingRateMaskConstants
+    MakePresetConstants(uint32_t innerRadius, uint32_t middleRadius, bool isQuality, XrVector2f gaze = {0.04f, 0.f}) {
+        const auto makeRing = [](float a, float b) { return XrVector2f{1.f / (a * a), 1.f / (b * b)}; };
+        constexpr float semiMajorFactor = 125;
+
+        ShadingRateMaskConstants constants{};
+        constants.GazeXY = gaze;
+        constants.InvDim = {1.f / WidthInTiles, 1.f / HeightInTiles};
+        constants.Rings[0] = makeRing(innerRadius * semiMajorFactor * 0.0001f, innerRadius * 0.01f);
+        constants.Rings[1] = makeRing(middleRadius * semiMajorFactor * 0.0001f, middleRadius * 0.01f);
+        constants.Rings[2] = makeRing(100.f, 100.f);
+        constants.Rings[3] = makeRing(100.f, 100.f);
+        constants.Rates[0] = RateX1;
+        constants.Rates[1] = isQuality ? Rate2x1 : Rate2x2;
+        constants.Rates[2] = isQuality ? Rate2x2 : Rate4x4;
+        constants.Rates[3] = 11;
+        return constants;
+    }
+
+    // One character per tile, as a hexadecimal digit.
+    std::vector<std::string> RenderMask(const ShadingRateMaskConstants& constants, bool allowSimd) {
+        // Use a padded row pitch like the textures do.
+        const size_t rowPitch = alignTo(WidthInTiles, 256);
+        std::vector<uint8_t> mask(rowPitch * HeightInTiles, 255);
+        GenerateShadingRateMask(constants, 3, 0, WidthInTiles, HeightInTiles, mask.data(), rowPitch, allowSimd);
+
+        std::vector<std::string> rows;
+        for (uint32_t y = 0; y < HeightInTiles; y++) {
+            std::string row;
+            for (uint32_t x = 0; x < WidthInTiles; x++) {
+                row += "0123456789abcdef"[mask[y * rowPitch + x] & 0xf];
+            }
+            rows.push_back(row);
+        }
+        return rows;
+    }
+
+    void CompareToGolden(const ShadingRateMaskConstants& constants, const char* const (&golden)[HeightInTiles]) {
+        for (const bool allowSimd : {false, true}) {
+            const auto rows = RenderMask(constants, allowSimd);
+
+            bool matches = true;
+            for (uint32_t y = 0; y < HeightInTiles; y++) {
+                matches = matches && rows[y] == golden[y];
+            }
+
+            if (!matches) {
+                // Print the mask in the format of the golden file, for review (and update if the change is intended).
+                Logger::WriteMessage(allowSimd ? "Actual mask (SIMD):" : "Actual mask (scalar):");
+                for (const auto& row : rows) {
+                    Logger::WriteMessage(("    \"" + row + "\",").c_str());
+                }
+            }
+            Assert::IsTrue(matches, allowSimd ? L"SIMD mask differs from golden" : L"Scalar mask differs from golden");
+        }
+    }
+
+} // namespace
+
+namespace tests {
+
+    TEST_CLASS(ShadingRateMaskTests) {
+      public:
+        TEST_METHOD(WideQuality) {
+            CompareToGolden(MakePresetConstants(55, 80, true), golden::WideQuality);
+        }
+
+        TEST_METHOD(WidePerformance) {
+            CompareToGolden(MakePresetConstants(55, 80, false), golden::WidePerformance);
+        }
+
+        TEST_METHOD(BalancedQuality) {
+            CompareToGolden(MakePresetConstants(50, 60, true), golden::BalancedQuality);
+        }
+
+        TEST_METHOD(BalancedPerformance) {
+            CompareToGolden(MakePresetConstants(50, 60, false), golden::BalancedPerformance);
+        }
+
+        TEST_METHOD(NarrowQuality) {
+            CompareToGolden(MakePresetConstants(30, 55, true), golden::NarrowQuality);
+        }
+
+        TEST_METHOD(NarrowPerformance) {
+            CompareToGolden(MakePresetConstants(30, 55, false), golden::NarrowPerformance);
+        }
+
+        TEST_METHOD(OffCenterGaze) {
+            // Eye tracking, looking to the bottom left.
+            CompareToGolden(MakePresetConstants(30, 55, false, {-0.4f, -0.3f}), golden::OffCenterGaze);
+        }
+
+        TEST_METHOD(KeepsFinerExistingRate) {
+            // The mask is combined with its existing content (eg: the hidden area culling), the finest rate wins.
+            const auto constants = MakePresetConstants(55, 80, false);
+            const size_t rowPitch = WidthInTiles;
+            for (const bool allowSimd : {false, true}) {
+                std::vector<uint8_t> mask(rowPitch * HeightInTiles, 2);
+                mask[0] = 255;
+                GenerateShadingRateMask(
+                    constants, 3, 0, WidthInTiles, HeightInTiles, mask.data(), rowPitch, allowSimd);
+                Assert::AreEqual(Rate4x4, mask[0]);
+                Assert::IsTrue(std::all_of(mask.cbegin() + 1, mask.cend(), [](uint8_t rate) { return rate == 2; }));
+            }
+        }
+    };
+
+} // namespace tests